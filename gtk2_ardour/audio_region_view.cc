@@ -35,6 +35,7 @@
 #include "ardour/playlist.h"
 #include "ardour/audioregion.h"
 #include "ardour/audiosource.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/profile.h"
 #include "ardour/session.h"
 
@@ -1402,7 +1403,7 @@ AudioRegionView::add_gain_point_event (ArdourCanvas::Item *item, GdkEvent *ev, b
 			trackview.session()->add_command (region_memento);
 		}
 
-		trackview.session()->add_command (new MementoCommand<AutomationList>(*audio_region()->envelope().get(), &before, &after));
+		trackview.session()->add_command (new AutomationListDiffCommand (*audio_region()->envelope().get(), &before, &after));
 
 		gain_line->get_selectables (fx + region ()->position (), fx + region ()->position (), 0.0, 1.0, results);
 		trackview.editor ().get_selection ().set (results);
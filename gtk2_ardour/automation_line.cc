@@ -46,6 +46,7 @@
 #include "pbd/stacktrace.h"
 
 #include "ardour/automation_list.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/dB.h"
 #include "ardour/debug.h"
 #include "ardour/parameter_types.h"
@@ -92,6 +93,7 @@ AutomationLine::AutomationLine (const string&                              name,
 	, _time_converter (converter ? converter : new Evoral::IdentityConverter<double, samplepos_t>)
 	, _parent_group (parent)
 	, _offset (0)
+	, _drag_state (0)
 	, _maximum_time (max_samplepos)
 	, _fill (false)
 	, _desc (desc)
@@ -133,6 +135,7 @@ AutomationLine::~AutomationLine ()
 {
 	vector_delete (&control_points);
 	delete group;
+	delete _drag_state;
 
 	if (_our_time_converter) {
 		delete _time_converter;
@@ -296,8 +299,7 @@ AutomationLine::modify_point_y (ControlPoint& cp, double y)
 	double const x = trackview.editor().sample_to_pixel_unrounded (_time_converter->to((*cp.model())->when) - _offset);
 
 	trackview.editor().begin_reversible_command (_("automation event move"));
-	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder(), &get_state(), 0));
+	XMLNode& before = get_state ();
 
 	cp.move_to (x, y, ControlPoint::Full);
 
@@ -314,7 +316,7 @@ AutomationLine::modify_point_y (ControlPoint& cp, double y)
 	update_pending = false;
 
 	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder(), 0, &alist->get_state()));
+		new AutomationListDiffCommand (memento_command_binder(), &before, &alist->get_state()));
 
 	trackview.editor().commit_reversible_command ();
 	trackview.editor().session()->set_dirty ();
@@ -414,8 +416,8 @@ AutomationLine::string_to_fraction (string const & s) const
 void
 AutomationLine::start_drag_single (ControlPoint* cp, double x, float fraction)
 {
-	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder(), &get_state(), 0));
+	delete _drag_state;
+	_drag_state = &get_state ();
 
 	_drag_points.clear ();
 	_drag_points.push_back (cp);
@@ -439,8 +441,8 @@ AutomationLine::start_drag_single (ControlPoint* cp, double x, float fraction)
 void
 AutomationLine::start_drag_line (uint32_t i1, uint32_t i2, float fraction)
 {
-	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder (), &get_state(), 0));
+	delete _drag_state;
+	_drag_state = &get_state ();
 
 	_drag_points.clear ();
 
@@ -458,8 +460,8 @@ AutomationLine::start_drag_line (uint32_t i1, uint32_t i2, float fraction)
 void
 AutomationLine::start_drag_multiple (list<ControlPoint*> cp, float fraction, XMLNode* state)
 {
-	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder(), state, 0));
+	delete _drag_state;
+	_drag_state = state;
 
 	_drag_points = cp;
 	start_drag_common (0, fraction);
@@ -755,8 +757,11 @@ AutomationLine::end_drag (bool with_push, uint32_t final_index)
 		line->set_steps (line_points, is_stepped());
 	}
 
-	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList>(memento_command_binder (), 0, &alist->get_state()));
+	if (_drag_state) {
+		trackview.editor().session()->add_command (
+			new AutomationListDiffCommand (memento_command_binder (), _drag_state, &alist->get_state()));
+		_drag_state = 0;
+	}
 
 	trackview.editor().session()->set_dirty ();
 	did_push = false;
@@ -872,7 +877,7 @@ AutomationLine::remove_point (ControlPoint& cp)
 	alist->erase (cp.model());
 
 	trackview.editor().session()->add_command(
-		new MementoCommand<AutomationList> (memento_command_binder (), &before, &alist->get_state()));
+		new AutomationListDiffCommand (memento_command_binder (), &before, &alist->get_state()));
 
 	trackview.editor().commit_reversible_command ();
 	trackview.editor().session()->set_dirty ();
@@ -1102,7 +1107,7 @@ AutomationLine::clear ()
 	alist->clear();
 
 	trackview.editor().session()->add_command (
-		new MementoCommand<AutomationList> (memento_command_binder (), &before, &alist->get_state()));
+		new AutomationListDiffCommand (memento_command_binder (), &before, &alist->get_state()));
 }
 
 void
@@ -233,6 +233,8 @@ private:
 	 */
 	ARDOUR::samplecnt_t _offset;
 
+	XMLNode* _drag_state; ///< state of the list before the drag, for the undo record
+
 	bool is_stepped() const;
 	void update_visibility ();
 	void reset_line_coords (ControlPoint&);
@@ -25,6 +25,7 @@
 #include "pbd/memento_command.h"
 
 #include "ardour/automation_control.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/event_type_map.h"
 #include "ardour/midi_automation_list_binder.h"
 #include "ardour/midi_region.h"
@@ -201,7 +202,7 @@ AutomationRegionView::add_automation_event (GdkEvent *, samplepos_t when, double
 
 		XMLNode& after = _line->the_list()->get_state();
 
-		view->session()->add_command (new MementoCommand<ARDOUR::AutomationList> (_line->memento_command_binder(), &before, &after));
+		view->session()->add_command (new ARDOUR::AutomationListDiffCommand (_line->memento_command_binder(), &before, &after));
 		view->editor().commit_reversible_command ();
 
 		view->session()->set_dirty ();
@@ -243,7 +244,7 @@ AutomationRegionView::paste (samplepos_t                                     pos
 	XMLNode& before = my_list->get_state();
 	my_list->paste(*slist, model_pos, DoubleBeatsSamplesConverter (view->session()->tempo_map(), pos));
 	view->session()->add_command(
-		new MementoCommand<ARDOUR::AutomationList>(_line->memento_command_binder(), &before, &my_list->get_state()));
+		new ARDOUR::AutomationListDiffCommand (_line->memento_command_binder(), &before, &my_list->get_state()));
 
 	return true;
 }
@@ -42,6 +42,7 @@
 #include "pbd/unwind.h"
 
 #include "ardour/automation_control.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/beats_samples_converter.h"
 #include "ardour/event_type_map.h"
 #include "ardour/parameter_types.h"
@@ -777,7 +778,7 @@ AutomationTimeAxisView::add_automation_event (GdkEvent* event, samplepos_t sampl
 	if (list->editor_add (when.sample, y, with_guard_points)) {
 		XMLNode& after = list->get_state();
 		_editor.begin_reversible_command (_("add automation event"));
-		_session->add_command (new MementoCommand<ARDOUR::AutomationList> (*list.get (), &before, &after));
+		_session->add_command (new ARDOUR::AutomationListDiffCommand (*list.get (), &before, &after));
 
 		_line->get_selectables (when.sample, when.sample, 0.0, 1.0, results);
 		_editor.get_selection ().set (results);
@@ -847,7 +848,7 @@ AutomationTimeAxisView::paste_one (samplepos_t pos, unsigned paste_count, float
 
 	XMLNode &before = alist->get_state();
 	alist->paste (**p, model_pos, DoubleBeatsSamplesConverter (_session->tempo_map(), pos));
-	_session->add_command (new MementoCommand<AutomationList>(*alist.get(), &before, &alist->get_state()));
+	_session->add_command (new AutomationListDiffCommand (*alist.get(), &before, &alist->get_state()));
 
 	return true;
 }
@@ -1157,7 +1158,7 @@ AutomationTimeAxisView::cut_copy_clear_one (AutomationLine& line, Selection& sel
 	switch (op) {
 	case Delete:
 		if (alist->cut (start, end) != 0) {
-			_session->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &alist->get_state()));
+			_session->add_command(new AutomationListDiffCommand (*alist.get(), &before, &alist->get_state()));
 		}
 		break;
 
@@ -1165,7 +1166,7 @@ AutomationTimeAxisView::cut_copy_clear_one (AutomationLine& line, Selection& sel
 
 		if ((what_we_got = alist->cut (start, end)) != 0) {
 			_editor.get_cut_buffer().add (what_we_got);
-			_session->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &alist->get_state()));
+			_session->add_command(new AutomationListDiffCommand (*alist.get(), &before, &alist->get_state()));
 		}
 		break;
 	case Copy:
@@ -1176,7 +1177,7 @@ AutomationTimeAxisView::cut_copy_clear_one (AutomationLine& line, Selection& sel
 
 	case Clear:
 		if ((what_we_got = alist->cut (start, end)) != 0) {
-			_session->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &alist->get_state()));
+			_session->add_command(new AutomationListDiffCommand (*alist.get(), &before, &alist->get_state()));
 		}
 		break;
 	}
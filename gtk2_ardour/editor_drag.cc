@@ -40,6 +40,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/audioregion.h"
 #include "ardour/audio_track.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/dB.h"
 #include "ardour/midi_region.h"
 #include "ardour/midi_track.h"
@@ -4184,7 +4185,7 @@ FadeInDrag::finished (GdkEvent* event, bool movement_occurred)
 			in_command = true;
 		}
 		XMLNode &after = alist->get_state();
-		_editor->session()->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &after));
+		_editor->session()->add_command(new AutomationListDiffCommand (*alist.get(), &before, &after));
 	}
 
 	if (in_command) {
@@ -4309,7 +4310,7 @@ FadeOutDrag::finished (GdkEvent* event, bool movement_occurred)
 			in_command = true;
 		}
 		XMLNode &after = alist->get_state();
-		_editor->session()->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &after));
+		_editor->session()->add_command(new AutomationListDiffCommand (*alist.get(), &before, &after));
 	}
 
 	if (in_command) {
@@ -6386,7 +6387,7 @@ AutomationRangeDrag::motion (GdkEvent*, bool first_move)
 
 					if (add_p || add_q) {
 						_editor->session()->add_command (
-							new MementoCommand<AutomationList>(*the_list.get (), &before, &the_list->get_state()));
+							new AutomationListDiffCommand (*the_list.get (), &before, &the_list->get_state()));
 					}
 				}
 
@@ -6417,7 +6418,7 @@ AutomationRangeDrag::motion (GdkEvent*, bool first_move)
 
 					if (add_p || add_q) {
 						_editor->session()->add_command (
-							new MementoCommand<AutomationList>(*the_list.get (), &before, &the_list->get_state()));
+							new AutomationListDiffCommand (*the_list.get (), &before, &the_list->get_state()));
 					}
 				}
 			}
@@ -57,6 +57,7 @@
 
 #include "ardour/audio_track.h"
 #include "ardour/audioregion.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/boost_debug.h"
 #include "ardour/dB.h"
 #include "ardour/location.h"
@@ -3241,7 +3242,6 @@ Editor::separate_regions_between (const TimeSelection& ts)
 
 struct PlaylistState {
 	boost::shared_ptr<Playlist> playlist;
-	XMLNode*  before;
 };
 
 /** Take tracks from get_tracks_for_range_action and cut any regions
@@ -3362,7 +3362,6 @@ Editor::separate_under_selected_regions ()
 
 			PlaylistState before;
 			before.playlist = playlist;
-			before.before = &playlist->get_state();
 			playlist->clear_changes ();
 			playlist->freeze ();
 			playlists.push_back(before);
@@ -3379,7 +3378,7 @@ Editor::separate_under_selected_regions ()
 
 	for (pl = playlists.begin(); pl != playlists.end(); ++pl) {
 		(*pl).playlist->thaw ();
-		_session->add_command(new MementoCommand<Playlist>(*(*pl).playlist, (*pl).before, &(*pl).playlist->get_state()));
+		_session->add_command(new StatefulDiffCommand ((*pl).playlist));
 	}
 
 	commit_reversible_command ();
@@ -4412,7 +4411,7 @@ Editor::cut_copy_points (Editing::CutCopyOp op, Temporal::Beats earliest, bool m
 		for (Lists::iterator i = lists.begin(); i != lists.end(); ++i) {
 			boost::shared_ptr<AutomationList> al = i->first;
 			al->thaw ();
-			_session->add_command (new MementoCommand<AutomationList> (*al.get(), i->second.state, &(al->get_state ())));
+			_session->add_command (new AutomationListDiffCommand (*al.get(), i->second.state, &(al->get_state ())));
 		}
 	}
 }
@@ -5068,7 +5067,8 @@ Editor::reset_point_selection ()
 {
 	for (PointSelection::iterator i = selection->points.begin(); i != selection->points.end(); ++i) {
 		ARDOUR::AutomationList::iterator j = (*i)->model ();
-		(*j)->value = (*i)->line().the_list()->descriptor ().normal;
+		boost::shared_ptr<ARDOUR::AutomationList> al = (*i)->line().the_list();
+		al->modify (j, (*j)->when, al->descriptor ().normal);
 	}
 }
 
@@ -5879,7 +5879,7 @@ Editor::reset_region_gain_envelopes ()
 				begin_reversible_command (_("reset region gain"));
 				in_command = true;
 			}
-			_session->add_command (new MementoCommand<AutomationList>(*arv->audio_region()->envelope().get(), &before, &alist->get_state()));
+			_session->add_command (new AutomationListDiffCommand (*arv->audio_region()->envelope().get(), &before, &alist->get_state()));
 		}
 	}
 
@@ -6260,7 +6260,7 @@ Editor::set_fade_length (bool in)
 			in_command = true;
 		}
 		XMLNode &after = alist->get_state();
-		_session->add_command(new MementoCommand<AutomationList>(*alist, &before, &after));
+		_session->add_command(new AutomationListDiffCommand (*alist, &before, &after));
 	}
 
 	if (in_command) {
@@ -6295,7 +6295,7 @@ Editor::set_fade_in_shape (FadeShape shape)
 			in_command = true;
 		}
 		XMLNode &after = alist->get_state();
-		_session->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &after));
+		_session->add_command(new AutomationListDiffCommand (*alist.get(), &before, &after));
 	}
 
 	if (in_command) {
@@ -6330,7 +6330,7 @@ Editor::set_fade_out_shape (FadeShape shape)
 			in_command = true;
 		}
 		XMLNode &after = alist->get_state();
-		_session->add_command(new MementoCommand<AutomationList>(*alist.get(), &before, &after));
+		_session->add_command(new AutomationListDiffCommand (*alist.get(), &before, &after));
 	}
 
 	if (in_command) {
@@ -2147,6 +2147,19 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("General"), procs);
+
+		bo = new BoolOption (
+				"graph-work-stealing",
+				_("Schedule routes using per-thread work-queues (work-stealing)"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_work_stealing),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_work_stealing)
+				);
+
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, each DSP thread keeps its own queue of routes that are ready to run and idle threads take work from the others, rather than all threads sharing a single queue. This can reduce scheduling overhead with many DSP threads and small buffer sizes."));
+		bo->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
+
+		add_option (_("General"), bo);
 	}
 
 	/* Image cache size */
@@ -2814,6 +2827,42 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("Audio"), new BufferingOptions (_rc_config));
 
+	{
+		ComboOption<uint32_t>* iot = new ComboOption<uint32_t> (
+				"butler-io-threads",
+				_("Additional disk I/O threads"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_butler_io_threads),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_butler_io_threads)
+				);
+
+		iot->add (0, _("none (single disk thread)"));
+
+		for (uint32_t i = 1; i <= 8; ++i) {
+			iot->add (i, string_compose ("%1", i));
+		}
+
+		Gtkmm2ext::UI::instance()->set_tip (iot->tip_widget(),
+				_("Tracks are read and written by one queue per storage device, which are serviced by the disk thread and these additional threads in parallel. This helps with many tracks and sources spread over several disks."));
+		iot->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
+
+		add_option (_("Audio"), iot);
+	}
+
+	{
+		BoolOption* bo = new BoolOption (
+				"direct-audio-file-reads",
+				_("Read uncompressed audio files directly"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_direct_audio_file_reads),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_direct_audio_file_reads)
+				);
+
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, playback of WAV, RF64 and CAF files with 16, 24 or 32 bit integer or 32 bit float samples bypasses libsndfile and reads ahead of the playhead."));
+		bo->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
+
+		add_option (_("Audio"), bo);
+	}
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Denormals")));
 
 	add_option (_("Audio"),
@@ -3536,6 +3585,11 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_conceal_lv1_if_lv2_exists),
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_conceal_lv1_if_lv2_exists)
 		     ));
+
+	add_option (_("Plugins"),
+			new RcActionButton (_("Clear"),
+				sigc::mem_fun (*this, &RCOptionEditor::clear_plugin_scan_cache),
+				_("LV1/LV2 Cache:")));
 #endif
 
 #if (defined WINDOWS_VST_SUPPORT || defined LXVST_SUPPORT || defined MACVST_SUPPORT || defined AUDIOUNIT_SUPPORT || defined HAVE_LV2)
@@ -4124,6 +4178,10 @@ void RCOptionEditor::clear_au_blacklist () {
 	PluginManager::instance().clear_au_blacklist();
 }
 
+void RCOptionEditor::clear_plugin_scan_cache () {
+	PluginManager::instance().clear_plugin_scan_cache();
+}
+
 void RCOptionEditor::edit_lxvst_path () {
 	Glib::RefPtr<Gdk::Window> win = get_parent_window ();
 	PathsDialog *pd = new PathsDialog (
@@ -70,6 +70,7 @@ private:
 	void clear_vst_blacklist ();
 	void clear_au_cache ();
 	void clear_au_blacklist ();
+	void clear_plugin_scan_cache ();
 	void edit_lxvst_path ();
 	void edit_vst_path ();
 };
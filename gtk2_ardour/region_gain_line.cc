@@ -27,6 +27,7 @@
 #include "pbd/stateful_diff_command.h"
 
 #include "ardour/audioregion.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/session.h"
 
 #include "control_point.h"
@@ -88,7 +89,7 @@ AudioRegionGainLine::remove_point (ControlPoint& cp)
 	trackview.editor ().get_selection ().clear_points ();
 	alist->erase (cp.model());
 
-	trackview.editor().session()->add_command (new MementoCommand<AutomationList>(*alist.get(), &before, &alist->get_state()));
+	trackview.editor().session()->add_command (new AutomationListDiffCommand (*alist.get(), &before, &alist->get_state()));
 	trackview.editor().commit_reversible_command ();
 	trackview.editor().session()->set_dirty ();
 }
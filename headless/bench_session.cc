@@ -0,0 +1,436 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Roll a session on the Dummy backend's "Unbounded" driver, as fast as it
+ * can be processed, for a fixed number of cycles, and report how long the
+ * cycles took.
+ *
+ * The engine freewheels and, unless -A is given, waits for the Butler
+ * before every cycle (as an export does), so that disk I/O keeps up and
+ * every run does the same work. The generators of the Dummy backend's
+ * inputs are seeded the same way every run.
+ *
+ * Output is tab-separated, lines starting with '#' are comments:
+ *   throughput <cycles> <samples> <msec> <realtime factor>
+ *   <what> <name> <count> <min> <avg> <p50> <p99> <p99.9> <max>
+ * in usec, with <what> one of "process" (the session's process callback),
+ * "butler" (a pass of transport work and disk I/O) and "route", and with
+ * -H also the histograms as
+ *   histogram <what> <name> <usec> <count>
+ * one line per bucket which is not empty, <usec> being its upper limit.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#ifndef PLATFORM_WINDOWS
+#include <signal.h>
+#endif
+
+#include <glibmm.h>
+
+#include "pbd/crossthread.h"
+#include "pbd/debug.h"
+#include "pbd/error.h"
+#include "pbd/failed_constructor.h"
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audio_backend.h"
+#include "ardour/audioengine.h"
+#include "ardour/butler.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "misc.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+static CrossThreadChannel xthread (true);
+static TestReceiver       test_receiver;
+
+/** State of the benchmark, written by the process thread until done */
+struct Bench {
+	Bench ()
+		: session (0)
+		, n_warmup (100)
+		, n_cycles (10000)
+		, sync_butler (true)
+		, cycle (0)
+		, t_start (0)
+		, t_end (0)
+		, done (0)
+	{}
+
+	Session* session;
+	uint32_t n_warmup;
+	uint32_t n_cycles;
+	bool     sync_butler;
+
+	uint32_t     cycle;
+	int64_t      t_start;
+	int64_t      t_end;
+	volatile int done;
+
+	std::vector<boost::shared_ptr<Route> > routes;
+
+	TimingHistogram              process_stats;
+	TimingHistogram              butler_stats;
+	std::vector<TimingHistogram> route_stats;
+};
+
+static Bench bench;
+
+/** Connected to AudioEngine::Freewheel, called in the process thread instead
+ * of Session::process.
+ */
+static void
+bench_cycle (pframes_t nframes)
+{
+	if (bench.done) {
+		return;
+	}
+
+	if (bench.sync_butler) {
+		bench.session->butler ()->wait_until_finished ();
+	}
+
+	if (bench.cycle == bench.n_warmup) {
+		bench.process_stats.reset ();
+		bench.session->butler ()->clear_io_stats ();
+		bench.session->clear_route_dsp_stats ();
+		bench.t_start = g_get_monotonic_time ();
+	}
+
+	if (bench.cycle == bench.n_warmup + bench.n_cycles) {
+		bench.t_end        = g_get_monotonic_time ();
+		bench.butler_stats = bench.session->butler ()->io_histogram ();
+		for (size_t i = 0; i < bench.routes.size (); ++i) {
+			bench.route_stats[i] = bench.routes[i]->dsp_histogram ();
+		}
+		bench.done = 1;
+		xthread.deliver ('x');
+		return;
+	}
+
+	bench.process_stats.start ();
+	bench.session->process (nframes);
+	bench.process_stats.update ();
+
+	++bench.cycle;
+}
+
+static Session*
+load_session (string dir, string state, string device, uint32_t buffer_size)
+{
+	SessionEvent::create_per_thread_pool ("bench", 512);
+
+	test_receiver.listen_to (error);
+	test_receiver.listen_to (fatal);
+	test_receiver.listen_to (warning);
+
+	AudioEngine* engine = AudioEngine::create ();
+
+	if (!engine->set_backend ("None (Dummy)", "Benchmark", "")) {
+		cerr << "Cannot create Audio/MIDI engine\n";
+		return 0;
+	}
+
+	if (engine->current_backend ()->set_driver ("Unbounded")) {
+		cerr << "Cannot select the backend's Unbounded driver\n";
+		return 0;
+	}
+
+	if (engine->set_device_name (device)) {
+		cerr << "Cannot use device '" << device << "'\n";
+		return 0;
+	}
+
+	float        sr;
+	SampleFormat sf;
+	string       v;
+
+	string s = Glib::build_filename (dir, state + statefile_suffix);
+
+	if (Session::get_info_from_path (s, sr, sf, v) != 0) {
+		cerr << "Cannot read session '" << s << "'\n";
+		return 0;
+	}
+
+	if (engine->set_sample_rate (sr) || engine->set_buffer_size (buffer_size)) {
+		cerr << "Cannot set the session's samplerate or the buffer size\n";
+		return 0;
+	}
+
+	if (engine->start () != 0) {
+		cerr << "Cannot start Audio/MIDI engine\n";
+		return 0;
+	}
+
+	Session* session = new Session (*engine, dir, state);
+	engine->set_session (session);
+	return session;
+}
+
+static void
+engine_halted (const char* reason)
+{
+	cerr << "The audio backend has been shutdown";
+	if (reason && strlen (reason) > 0) {
+		cerr << ": " << reason;
+	} else {
+		cerr << ".";
+	}
+	cerr << endl;
+	xthread.deliver ('x');
+}
+
+#ifndef PLATFORM_WINDOWS
+static void
+wearedone (int)
+{
+	cerr << "caught signal - terminating." << endl;
+	xthread.deliver ('x');
+}
+#endif
+
+static void
+report (char const* what, string const& name, TimingHistogram const& h, bool histogram)
+{
+	uint64_t min = 0, max = 0;
+	double   avg = 0, dev;
+
+	h.get_stats (min, max, avg, dev);
+
+	cout << what << "\t" << name
+	     << "\t" << h.count ()
+	     << "\t" << min
+	     << "\t" << avg
+	     << "\t" << h.percentile (0.5)
+	     << "\t" << h.percentile (0.99)
+	     << "\t" << h.percentile (0.999)
+	     << "\t" << max
+	     << "\n";
+
+	if (!histogram) {
+		return;
+	}
+
+	for (int i = 0; i < TimingHistogram::n_buckets; ++i) {
+		if (h.bucket (i) > 0) {
+			cout << "histogram\t" << what << "\t" << name << "\t" << TimingHistogram::bucket_limit (i) << "\t" << h.bucket (i) << "\n";
+		}
+	}
+}
+
+static void
+print_help ()
+{
+	cout << "Usage: hardour-bench [OPTIONS]... DIR SNAPSHOT_NAME\n\n"
+	     << "  DIR                         Directory/Folder to load session from\n"
+	     << "  SNAPSHOT_NAME               Name of session/snapshot to load (without .ardour at end\n"
+	     << "  -h, --help                  Print this message\n"
+	     << "  -c, --cycles <num>          Number of cycles to measure, default 10000\n"
+	     << "  -w, --warmup <num>          Number of cycles to run before, default 100\n"
+	     << "  -b, --buffer-size <num>     Samples per cycle, default 1024\n"
+	     << "  -g, --generator <device>    Dummy backend device for the inputs, default \"Silence\"\n"
+	     << "  -A, --async-butler          Do not wait for the Butler before every cycle\n"
+	     << "  -H, --histogram             Also print the histograms\n"
+	     << "  -d, --disable-plugins       Disable all plugins in an existing session\n"
+	     << "  -D, --debug <options>       Set debug flags. Use \"-D list\" to see available options\n"
+	    ;
+}
+
+int
+main (int argc, char* argv[])
+{
+	const char* optstring = "hc:w:b:g:AHdD:";
+
+	/* clang-format off */
+	const struct option longopts[] = {
+		{ "help",            no_argument,       0, 'h' },
+		{ "cycles",          required_argument, 0, 'c' },
+		{ "warmup",          required_argument, 0, 'w' },
+		{ "buffer-size",     required_argument, 0, 'b' },
+		{ "generator",       required_argument, 0, 'g' },
+		{ "async-butler",    no_argument,       0, 'A' },
+		{ "histogram",       no_argument,       0, 'H' },
+		{ "disable-plugins", no_argument,       0, 'd' },
+		{ "debug",           required_argument, 0, 'D' },
+		{ 0, 0, 0, 0 }
+	};
+	/* clang-format on */
+
+	uint32_t buffer_size = 1024;
+	string   device      = "Silence";
+	bool     histogram   = false;
+
+	int c;
+	while ((c = getopt_long (argc, argv, optstring, longopts, (int*)0)) != EOF) {
+		switch (c) {
+			case 'h':
+				print_help ();
+				exit (EXIT_SUCCESS);
+				break;
+
+			case 'c':
+				bench.n_cycles = max (1, atoi (optarg));
+				break;
+
+			case 'w':
+				bench.n_warmup = max (0, atoi (optarg));
+				break;
+
+			case 'b':
+				buffer_size = atoi (optarg);
+				break;
+
+			case 'g':
+				device = optarg;
+				break;
+
+			case 'A':
+				bench.sync_butler = false;
+				break;
+
+			case 'H':
+				histogram = true;
+				break;
+
+			case 'd':
+				ARDOUR::Session::set_disable_all_loaded_plugins (true);
+				break;
+
+			case 'D':
+				if (PBD::parse_debug_options (optarg)) {
+					exit (EXIT_SUCCESS);
+				}
+				break;
+
+			default:
+				print_help ();
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	if (optind + 2 > argc) {
+		print_help ();
+		exit (EXIT_FAILURE);
+	}
+
+	if (!ARDOUR::init (false, true, localedir)) {
+		cerr << "Ardour failed to initialize\n"
+		     << endl;
+		exit (EXIT_FAILURE);
+	}
+
+	Session* s = 0;
+
+	try {
+		s = load_session (argv[optind], argv[optind + 1], device, buffer_size);
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what () << "\n";
+		exit (EXIT_FAILURE);
+	} catch (AudioEngine::PortRegistrationFailure& e) {
+		cerr << "PortRegistrationFailure: " << e.what () << "\n";
+		exit (EXIT_FAILURE);
+	} catch (exception& e) {
+		cerr << "exception: " << e.what () << "\n";
+		exit (EXIT_FAILURE);
+	} catch (...) {
+		cerr << "unknown exception.\n";
+		exit (EXIT_FAILURE);
+	}
+
+	if (!s) {
+		cerr << "failed_to load session\n";
+		exit (EXIT_FAILURE);
+	}
+
+	/* allow signal propagation, callback/thread-pool setup, etc
+	 * similar to to GUI "first idle"
+	 */
+	Glib::usleep (1000000); // 1 sec
+
+	AudioEngine* engine = AudioEngine::instance ();
+
+	{
+		boost::shared_ptr<RouteList> rl = s->get_routes ();
+		for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+			if (!(*i)->is_auditioner ()) {
+				bench.routes.push_back (*i);
+			}
+		}
+	}
+	bench.route_stats.resize (bench.routes.size ());
+	bench.session = s;
+
+	PBD::ScopedConnectionList con;
+	engine->Halted.connect_same_thread (con, boost::bind (&engine_halted, _1));
+	engine->Freewheel.connect_same_thread (con, boost::bind (&bench_cycle, _1));
+
+#ifndef PLATFORM_WINDOWS
+	signal (SIGINT, wearedone);
+	signal (SIGTERM, wearedone);
+#endif
+
+	s->request_transport_speed (1.0);
+	engine->freewheel (true);
+
+	char msg;
+	do {
+	} while (0 == xthread.receive (msg, true));
+
+	con.drop_connections ();
+	engine->freewheel (false);
+	s->request_stop ();
+
+	int rv = EXIT_FAILURE;
+
+	if (bench.done) {
+		const int64_t  usec    = bench.t_end - bench.t_start;
+		const uint64_t samples = (uint64_t) bench.n_cycles * engine->samples_per_cycle ();
+
+		cout << "# throughput\tcycles\tsamples\tmsec\trealtime-factor\n";
+		cout << "throughput\t" << bench.n_cycles << "\t" << samples << "\t" << usec / 1000.
+		     << "\t" << (samples * 1e6 / engine->sample_rate ()) / max<int64_t> (1, usec) << "\n";
+
+		cout << "# what\tname\tcount\tmin\tavg\tp50\tp99\tp99.9\tmax [usec]\n";
+		report ("process", "session", bench.process_stats, histogram);
+		report ("butler", "butler", bench.butler_stats, histogram);
+		for (size_t i = 0; i < bench.routes.size (); ++i) {
+			report ("route", bench.routes[i]->name (), bench.route_stats[i], histogram);
+		}
+		rv = EXIT_SUCCESS;
+	}
+
+	bench.routes.clear ();
+
+	engine->remove_session ();
+	delete s;
+	engine->stop ();
+
+	AudioEngine::destroy ();
+	return rv;
+}
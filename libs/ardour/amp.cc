@@ -45,6 +45,7 @@ using namespace PBD;
 Amp::Amp (Session& s, const std::string& name, boost::shared_ptr<GainControl> gc, bool control_midi_also)
 	: Processor(s, "Amp")
 	, _apply_gain_automation(false)
+	, _gain_automation_constant(false)
 	, _current_gain(GAIN_COEFF_ZERO)
 	, _current_automation_sample (INT64_MAX)
 	, _gain_control (gc)
@@ -109,22 +110,31 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 			}
 		}
 
-		const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
-		gain_t lpf = _current_gain;
+		if (_gain_automation_constant && fabsf (_current_gain - gab[0]) < GAIN_COEFF_DELTA) {
 
-		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			Sample* const sp = i->data();
-			lpf = _current_gain;
-			for (pframes_t nx = 0; nx < nframes; ++nx) {
-				sp[nx] *= lpf;
-				lpf += a * (gab[nx] - lpf);
-			}
-		}
+			/* flat automation, and the LPF has settled: a scalar gain will do */
+			_current_gain = gab[0];
+			apply_simple_gain (bufs, nframes, _current_gain, false);
 
-		if (fabsf (lpf) < GAIN_COEFF_SMALL) {
-			_current_gain = GAIN_COEFF_ZERO;
 		} else {
-			_current_gain = lpf;
+
+			const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
+			gain_t lpf = _current_gain;
+
+			for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
+				Sample* const sp = i->data();
+				lpf = _current_gain;
+				for (pframes_t nx = 0; nx < nframes; ++nx) {
+					sp[nx] *= lpf;
+					lpf += a * (gab[nx] - lpf);
+				}
+			}
+
+			if (fabsf (lpf) < GAIN_COEFF_SMALL) {
+				_current_gain = GAIN_COEFF_ZERO;
+			} else {
+				_current_gain = lpf;
+			}
 		}
 
 		/* used it, don't do it again until setup_gain_automation() is
@@ -183,13 +193,7 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		const gain_t lpf = apply_gain_ramp (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -265,11 +269,7 @@ Amp::apply_gain (AudioBuffer& buf, samplecnt_t sample_rate, samplecnt_t nframes,
 	Sample* const buffer = buf.data (offset);
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	gain_t lpf = initial;
-	for (pframes_t nx = 0; nx < nframes; ++nx) {
-		buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-	}
+	const gain_t lpf = apply_gain_ramp (buffer, nframes, initial, target, a);
 
 	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
 	return lpf;
@@ -372,7 +372,7 @@ Amp::setup_gain_automation (samplepos_t start_sample, samplepos_t end_sample, sa
 	{
 		assert (_gain_automation_buffer);
 
-		_apply_gain_automation = _gain_control->get_masters_curve ( start_sample, end_sample, _gain_automation_buffer, nframes);
+		_apply_gain_automation = _gain_control->get_masters_curve ( start_sample, end_sample, _gain_automation_buffer, nframes, &_gain_automation_constant);
 
 		if (start_sample != _current_automation_sample && _session.bounce_processing ()) {
 			_current_gain = _gain_automation_buffer[0];
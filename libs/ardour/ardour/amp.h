@@ -74,6 +74,7 @@ public:
 private:
 	bool   _denormal_protection;
 	bool   _apply_gain_automation;
+	bool   _gain_automation_constant;
 	float  _current_gain;
 	samplepos_t _current_automation_sample;
 
@@ -172,13 +172,7 @@ public:
 			return;
 		}
 
-		Sample* dst        = _data + dst_offset;
-		gain_t  gain_delta = (target - initial) / len;
-
-		for (samplecnt_t n = 0; n < len; ++n) {
-			*dst++ += (*src++ * initial);
-			initial += gain_delta;
-		}
+		mix_buffers_with_gain_ramp (_data + dst_offset, src, len, initial, target);
 
 		_silent  = (_silent && initial == 0 && target == 0);
 		_written = true;
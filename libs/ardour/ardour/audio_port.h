@@ -22,13 +22,57 @@
 #ifndef __ardour_audio_port_h__
 #define __ardour_audio_port_h__
 
-#include "zita-resampler/vmresampler.h"
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <glibmm/threads.h>
+
+#include "zita-resampler/vmmresampler.h"
 
 #include "ardour/port.h"
 #include "ardour/audio_buffer.h"
 
 namespace ARDOUR {
 
+/** The varispeed resampler of a group of AudioPorts which all receive or
+ *  all send. They share the ratio, phase and filter and are resampled
+ *  together, a port per channel.
+ */
+class LIBARDOUR_API AudioPortResampler
+{
+public:
+	enum { max_ports = 16 };
+
+	AudioPortResampler ();
+
+	void setup (uint32_t quality);
+	uint32_t quality () const { return _quality; }
+
+	/** Resample @param in to @param out for the port using @param lane
+	 *  in cycle @param cycle, and add this to @param list if it is the
+	 *  first port to do so in that cycle.  With @param restart, forget
+	 *  what was resampled for the lane before.  Realtime safe.
+	 */
+	void add (uint32_t lane, Sample* in, Sample* out, pframes_t inp_count, pframes_t out_count, uint64_t cycle, bool restart, AudioPortResampler*& list);
+
+	/** Resample the ports added in this cycle.  Realtime safe. */
+	void process ();
+
+	AudioPortResampler* next () const { return _next; }
+
+private:
+	friend class AudioPort;
+
+	ArdourZita::VMMResampler _src;
+	uint32_t                 _quality;
+	uint32_t                 _used; ///< lanes of existing ports, protected by AudioPort::_resampler_lock
+	uint64_t                 _cycle;
+	pframes_t                _inp_count;
+	pframes_t                _out_count;
+	AudioPortResampler*      _next;
+};
+
 class LIBARDOUR_API AudioPort : public Port
 {
 public:
@@ -56,11 +100,20 @@ protected:
 	/* special access for PortManager only (hah, C++) */
 	Sample* engine_get_whole_audio_buffer ();
 
+	/** Add this port to be resampled in @param cycle, see AudioPortResampler::add() */
+	void add_to_resampler (pframes_t nframes, uint64_t cycle, AudioPortResampler*& list);
+
 private:
-	AudioBuffer*            _buffer;
-	ArdourZita::VMResampler _src;
-	Sample*                 _data;
-	bool                    _buf_valid;
+	AudioBuffer*                          _buffer;
+	boost::shared_ptr<AudioPortResampler> _resampler;
+	uint32_t                              _resampler_lane;
+	uint64_t                              _resampler_cycle; ///< the last cycle this was resampled in
+	Sample*                               _data;
+	bool                                  _buf_valid;
+
+	/** resamplers of the receiving [0] and sending [1] ports */
+	static std::vector<boost::weak_ptr<AudioPortResampler> > _resamplers[2];
+	static Glib::Threads::Mutex _resampler_lock;
 };
 
 } // namespace ARDOUR
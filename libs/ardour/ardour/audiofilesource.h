@@ -107,6 +107,8 @@ protected:
 
 	int move_dependents_to_trash();
 
+	samplecnt_t peak_build_chunk_size () const;
+
 	static Sample* get_interleave_buffer (samplecnt_t size);
 
 	static char bwf_country_code[3];
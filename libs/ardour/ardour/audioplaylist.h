@@ -53,12 +53,31 @@ protected:
 	void post_combine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 	void pre_uncombine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 
+	void invalidate_region_index ();
+
 private:
 	int set_state (const XMLNode&, int version);
 	void dump () const;
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 	void source_offset_changed (boost::shared_ptr<AudioRegion>);
         void load_legacy_crossfades (const XMLNode&, int version);
+
+	/** The playlist's timeline cut into spans within each of which the same
+	 *  set of regions is audible, with those regions listed in the order in
+	 *  which they must be read (lowest layer first).  Computed once after
+	 *  each change, so that read() needs no sorting or allocation.
+	 */
+	struct Coverage {
+		std::vector<samplepos_t> from;   ///< start of each span; span n ends at from[n+1] - 1
+		std::vector<uint32_t>    offset; ///< span n reads regions[offset[n]] .. regions[offset[n+1] - 1]
+		std::vector<boost::shared_ptr<AudioRegion> > regions;
+	};
+
+	boost::shared_ptr<Coverage const> coverage () const;
+	samplecnt_t read_layered (Sample *dst, Sample *mixdown, float *gain_buffer, samplepos_t start, samplecnt_t cnt, uint32_t chan_n);
+
+	mutable Glib::Threads::Mutex              _coverage_lock;
+	mutable boost::shared_ptr<Coverage const> _coverage;
 };
 
 } /* namespace ARDOUR */
@@ -41,6 +41,8 @@
 
 namespace ARDOUR {
 
+class PeakPyramid;
+
 class LIBARDOUR_API AudioSource : virtual public Source,
 		public ARDOUR::Readable
 {
@@ -100,6 +102,11 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	int prepare_for_peakfile_writes ();
 	void done_with_peakfile_writes (bool done = true);
 
+	/** (re)build the coarse levels of the peakfile, see PeakPyramid.
+	 * This is called by the peak building threads.
+	 */
+	int build_peak_pyramid ();
+
 	/** @return true if the each source sample s must be clamped to -1 < s < 1 */
 	virtual bool clamped_at_unity () const = 0;
 
@@ -111,12 +118,15 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	/* these collections of working buffers for supporting
 	   playlist's reading from potentially nested/recursive
-	   sources assume SINGLE THREADED reads by the butler
-	   thread, or a lock around calls that use them.
+	   sources are shared by all sources of a given level.
+	   Readers hold that level's lock in _level_read_locks
+	   while using them, since the Butler may read from
+	   several threads at once.
 	*/
 
 	static std::vector<boost::shared_array<Sample> > _mixdown_buffers;
 	static std::vector<boost::shared_array<gain_t> > _gain_buffers;
+	static std::vector<boost::shared_ptr<Glib::Threads::Mutex> > _level_read_locks;
 	static Glib::Threads::Mutex    _level_buffer_lock;
 
 	static void ensure_buffers_for_level (uint32_t, samplecnt_t);
@@ -127,9 +137,12 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	int initialize_peakfile (const std::string& path, const bool in_session = false);
 	int build_peaks_from_scratch ();
+	/** @return number of samples to read at a time when building peaks */
+	virtual samplecnt_t peak_build_chunk_size () const { return 65536; } // 256kB per disk read for mono data is about ideal
 	int compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, samplecnt_t cnt,
 	bool force, bool intermediate_peaks_ready_signal);
 	void truncate_peakfile();
+	int unlink_peakfile ();
 
 	mutable off_t _peak_byte_max; // modified in compute_and_write_peak()
 
@@ -167,6 +180,14 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* memory-mapped peakfile, opened on demand by read_peaks() */
+	mutable Glib::Threads::Mutex _peak_pyramid_lock;
+	mutable boost::shared_ptr<PeakPyramid> _peak_pyramid;
+	mutable bool _peak_pyramid_queued;
+
+	boost::shared_ptr<PeakPyramid> peak_pyramid () const;
+	void drop_peak_pyramid ();
 };
 
 }
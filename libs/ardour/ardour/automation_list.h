@@ -102,6 +102,11 @@ public:
 
 	static PBD::Signal1<void,AutomationList*> AutomationListCreated;
 
+	/** Free the event text that all lists kept from their last
+	 * serialization. Called once a session has been saved.
+	 */
+	static void drop_events_caches ();
+
 	void start_write_pass (double when);
 	void write_pass_finished (double when, double thinning_factor=0.0);
 
@@ -132,11 +137,18 @@ private:
 	XMLNode& serialize_events (bool need_lock);
 
 	void maybe_signal_changed ();
+	void drop_events_cache ();
+
+	static PBD::Signal0<void> DropEventsCaches;
 
 	AutoState    _state;
 	gint         _touching;
 
 	PBD::ScopedConnection _writepass_connection;
+	PBD::ScopedConnectionList _state_connections;
+
+	std::string          _events_cache; ///< formatted events, while !state_dirty(), until the next session save
+	Glib::Threads::Mutex _events_cache_lock;
 
 	bool operator== (const AutomationList&) const { /* not called */ abort(); return false; }
 	XMLNode* _before; //used for undo of touch start/stop pairs.
@@ -0,0 +1,80 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_automation_list_diff_command_h__
+#define __ardour_automation_list_diff_command_h__
+
+#include <stdint.h>
+#include <string>
+
+#include "pbd/command.h"
+#include "pbd/memento_command.h"
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+
+namespace ARDOUR {
+
+class AutomationList;
+
+/** An undo record for an AutomationList edit.
+ *
+ *  Like MementoCommand<AutomationList> it is built from the list's state
+ *  before and after the edit, but it only keeps the part of the events
+ *  that differs (and the list's attributes), so that editing a few points
+ *  of a long list does not keep two copies of the whole list in the
+ *  history.  Undo and redo splice the difference into the list's current
+ *  state, which therefore must be the one the command left it in.
+ */
+class LIBARDOUR_API AutomationListDiffCommand : public Command
+{
+public:
+	/** @param before state before the edit, owned by the command
+	 *  @param after state after the edit, owned by the command
+	 */
+	AutomationListDiffCommand (AutomationList&, XMLNode* before, XMLNode* after);
+	AutomationListDiffCommand (MementoCommandBinder<AutomationList>*, XMLNode* before, XMLNode* after);
+	/** Restore from a history file */
+	AutomationListDiffCommand (MementoCommandBinder<AutomationList>*, XMLNode const&);
+	~AutomationListDiffCommand ();
+
+	void operator() ();
+	void undo ();
+
+	XMLNode& get_state ();
+
+	bool empty () const;
+
+private:
+	void init (XMLNode* before, XMLNode* after);
+	void apply (XMLNode const& attributes, std::string const& from, std::string const& to);
+	void binder_dying ();
+
+	MementoCommandBinder<AutomationList>* _binder;
+
+	XMLNode*    _before; ///< attributes of the list before the edit, no events
+	XMLNode*    _after;  ///< attributes of the list after the edit, no events
+	uint64_t    _offset; ///< where the events differ, in bytes of their serialized form
+	std::string _removed;
+	std::string _added;
+
+	PBD::ScopedConnection _binder_death_connection;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_automation_list_diff_command_h__ */
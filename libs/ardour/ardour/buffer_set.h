@@ -140,6 +140,7 @@ public:
 	void read_from(const BufferSet& in, samplecnt_t nframes);
 	void read_from(const BufferSet& in, samplecnt_t nframes, DataType);
 	void merge_from(const BufferSet& in, samplecnt_t nframes);
+	void merge_from(BufferSet const* const* in, size_t n_in, samplecnt_t nframes);
 
 	template <typename BS, typename B>
 	class iterator_base {
@@ -25,11 +25,19 @@
 
 #include <pthread.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+
 #include <glibmm/threads.h>
 
 #include "pbd/crossthread.h"
+#include "pbd/id.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/timing.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
@@ -38,6 +46,8 @@
 
 namespace ARDOUR {
 
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -68,6 +78,14 @@ class LIBARDOUR_API Butler : public SessionHandleRef
 
 	bool flush_tracks_to_disk_after_locate (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	/** Reset the statistics of the Butler's passes, see io_histogram() */
+	void clear_io_stats ();
+
+	/** @return the times the Butler's passes (transport work and disk I/O) took,
+	 * only to be read while the Butler is paused
+	 */
+	PBD::TimingHistogram const& io_histogram () const { return _io_stats; }
+
 	static void* _thread_work(void *arg);
 	void*         thread_work();
 
@@ -94,7 +112,70 @@ private:
 	void empty_pool_trash ();
 	void config_changed (std::string);
 
-	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
+	/* Disk I/O (refill and write-behind) is distributed over the butler
+	 * thread and a small pool of I/O threads. Tracks are queued per
+	 * device (mountpoint), each queue ordered by urgency: the emptiest
+	 * playback- and the fullest capture-buffers first. Every thread
+	 * starts at a different device's queue and moves on to the next
+	 * once it is drained.
+	 */
+	/* both, the refill and the flush of a track are done by the same
+	 * job, so that they never run concurrently.
+	 */
+	struct IOJob {
+		IOJob (boost::shared_ptr<Track> t, bool r, bool f, float u)
+			: track (t), refill (r), flush (f), urgency (u), refill_result (0), flush_result (0), done (false) {}
+
+		boost::shared_ptr<Track> track;
+		bool  refill;   ///< read-ahead
+		bool  flush;    ///< write-behind
+		float urgency;  ///< lower values are served first
+		int   refill_result;
+		int   flush_result;
+		bool  done;
+
+		bool operator< (IOJob const& other) const { return urgency < other.urgency; }
+	};
+
+	struct IOQueue {
+		std::vector<IOJob> jobs;
+		volatile gint      next;
+	};
+
+	struct IOThread {
+		IOThread (Butler* b, uint32_t n) : butler (b), id (n) {}
+		Butler*   butler;
+		uint32_t  id;
+		pthread_t thread;
+	};
+
+	void start_io_threads ();
+	void terminate_io_threads ();
+	static void* _io_thread_work (void* arg);
+	void io_thread_work (uint32_t id);
+
+	void queue_io (boost::shared_ptr<RouteList>);
+	bool run_io (uint32_t& errors);
+	void io_work (uint32_t first_queue, Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
+	uint32_t io_queue_for (boost::shared_ptr<Track>);
+	void invalidate_io_queues ();
+
+	std::vector<IOQueue>                _io_queues;
+	std::vector<IOThread*>              _io_threads;
+	std::map<std::string, uint32_t>     _io_devices;       ///< mountpoint -> queue
+	std::map<PBD::ID, uint32_t>         _io_track_queue;   ///< cached io_queue_for()
+	boost::weak_ptr<RouteList>          _io_routes;        ///< routes that _io_track_queue is valid for
+	volatile gint                       _io_track_queue_invalid;
+	PBD::ScopedConnectionList           _io_track_connections;
+	Glib::Threads::Mutex                _io_lock;
+	Glib::Threads::Cond                 _io_start;
+	Glib::Threads::Cond                 _io_idle;
+	uint32_t                            _io_generation;
+	uint32_t                            _io_busy;
+	bool                                _io_open;
+	bool                                _io_quit;
+	PBD::TimingHistogram                _io_stats;
+	volatile gint                       _io_stats_reset;
 
 	/**
 	 * Add request to butler thread request queue
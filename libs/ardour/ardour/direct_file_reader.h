@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_direct_file_reader_h__
+#define __ardour_direct_file_reader_h__
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <glib.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+class DirectFileReaderTest;
+
+namespace ARDOUR {
+
+/** Reads samples of uncompressed WAV, RF64 and CAF files (16, 24 and
+ * 32 bit integer or 32 bit float) directly from the file, bypassing
+ * libsndfile for playback.
+ *
+ * Interleaved data of all channels is read with a single pread(2) per
+ * request, and a small window after the end of the last request is kept
+ * (and, if io_uring is available, read asynchronously ahead of time)
+ * so that the next refill, or the next of several contiguous regions
+ * on the same source, is served from memory.
+ *
+ * The reader shares the file descriptor of its owner, and is not
+ * thread-safe: callers serialize access (AudioSource::_lock).
+ */
+class LIBARDOUR_API DirectFileReader : public boost::noncopyable
+{
+public:
+	/** @return a reader for @a fd, which libsndfile opened as
+	 * @a sf_format with @a channels, or 0 if the file layout is not
+	 * supported.
+	 */
+	static DirectFileReader* create (int fd, int sf_format, uint32_t channels);
+
+	~DirectFileReader ();
+
+	/** Read @a cnt samples of @a channel, starting at @a start, into @a dst,
+	 * scaled by @a gain. @a length is the number of frames in the file.
+	 *
+	 * @param scratch at least cnt * channels * sizeof (Sample) bytes.
+	 * @return number of samples read, < 0 on error.
+	 */
+	samplecnt_t read (Sample* dst, samplepos_t start, samplecnt_t cnt, samplecnt_t length,
+	                  uint32_t channel, gain_t gain, void* scratch);
+
+	/** true if reads ahead are issued through io_uring */
+	static bool async_available ();
+
+private:
+	friend class ::DirectFileReaderTest;
+
+	enum Encoding {
+		Int16,
+		Int24,
+		Int32,
+		Float32
+	};
+
+	struct Request {
+		Request () : done (1), result (0) {}
+		volatile gint done;
+		ssize_t       result;
+	};
+
+	DirectFileReader (int fd, off_t data_offset, Encoding, bool little_endian, uint32_t channels);
+
+	static bool probe_wav (int fd, off_t& data_offset, uint32_t& bits, bool& is_float, uint32_t& channels);
+	static bool probe_caf (int fd, off_t& data_offset, uint32_t& bits, bool& is_float, bool& little_endian, uint32_t& channels);
+
+	void decode (Sample* dst, uint8_t const* src, samplecnt_t cnt, uint32_t channel, gain_t gain) const;
+	ssize_t read_frames (uint8_t* buf, samplepos_t start, samplecnt_t cnt, samplecnt_t length) const;
+	void prefetch (samplepos_t start, samplecnt_t length);
+	void wait_for_prefetch ();
+
+	static bool submit (Request&, int fd, void* buf, size_t len, off_t offset);
+	static void wait (Request&);
+
+	int      _fd;
+	off_t    _data_offset;
+	Encoding _encoding;
+	bool     _little_endian;
+	uint32_t _channels;
+	uint32_t _bytes_per_frame;
+
+	/* the window that holds [_win_start, _win_start + _win_count) */
+	uint8_t*    _win;
+	samplecnt_t _win_frames; ///< capacity
+	samplepos_t _win_start;
+	samplecnt_t _win_count;
+	Request     _win_req;    ///< pending asynchronous read into the window
+	samplecnt_t _win_req_frames;
+
+	static const samplecnt_t window_frames = 32768;
+
+	/** false to read synchronously only, even if io_uring is available */
+	static bool _async_enabled;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_direct_file_reader_h__ */
@@ -66,6 +66,13 @@ public:
 		return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0);
 	}
 
+	/** As do_refill() but using caller-owned working buffers, each
+	 * at least working_buffer_size() long (Butler I/O workers).
+	 */
+	int do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer) {
+		return refill (sum_buffer, mixdown_buffer, gain_buffer, 0);
+	}
+
 	/** For non-butler contexts (allocates temporary working buffers)
 	 *
 	 * This accessible method has a default argument; derived classes
@@ -81,6 +88,7 @@ public:
 	// Working buffers for do_refill (butler thread)
 	static void allocate_working_buffers();
 	static void free_working_buffers();
+	static samplecnt_t working_buffer_size () { return 2 * 1048576; }
 
 	void adjust_buffering ();
 
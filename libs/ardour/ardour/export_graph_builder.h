@@ -29,6 +29,7 @@
 
 #include <boost/ptr_container/ptr_list.hpp>
 #include <glibmm/threadpool.h>
+#include <glibmm/threads.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
@@ -43,8 +44,11 @@ namespace AudioGrapher {
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	template <typename T> class SpillBuffer;
 	template <typename T> class Threader;
 	template <typename T> class AllocatingProcessContext;
+	class ThreaderException;
+	class MemoryBudget;
 }
 
 namespace ARDOUR
@@ -89,6 +93,9 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	void add_split_config (FileSpec const & config);
 
+	void update_channel_groups ();
+	void encode_channel_group (size_t group, samplecnt_t samples, bool last_cycle);
+
 	class Encoder {
             public:
 		template <typename T> boost::shared_ptr<AudioGrapher::Sink<T> > init (FileSpec const & new_config);
@@ -172,9 +179,13 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::Normalizer> NormalizerPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef boost::shared_ptr<AudioGrapher::SpillBuffer<Sample> > SpillBufferPtr;
 		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
+		FloatSinkPtr storage () const;
+		samplecnt_t  samples_stored () const;
+
 		void prepare_post_processing ();
 		void start_post_processing ();
 
@@ -186,7 +197,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		bool            use_peak;
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
-		TmpFilePtr      tmp_file;
+		TmpFilePtr      tmp_file;     // realtime export
+		SpillBufferPtr  spill_buffer; // freewheeling export
 		NormalizerPtr   normalizer;
 		ThreaderPtr     threader;
 
@@ -247,6 +259,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		void remove_children (bool remove_out_files);
 		bool operator== (FileSpec const & other_config) const;
 
+		ExportChannelConfigPtr channel_config () const { return config.channel_config; }
+
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::Interleaver<Sample> > InterleaverPtr;
 		typedef boost::shared_ptr<AudioGrapher::Chunker<Sample> > ChunkerPtr;
@@ -271,12 +285,37 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	samplecnt_t process_buffer_samples;
 
+	/* Parallel encoding of export channel groups: channels that feed a
+	 * common channel configuration (interleaver) form a group. Groups
+	 * share no processing state, so when not exporting in realtime their
+	 * encoder chains run concurrently, within each freewheel cycle.
+	 */
+	struct GroupChannel {
+		GroupChannel (ChannelMap::iterator i) : it (i), buffer (0) {}
+		ChannelMap::iterator it;
+		Sample const *       buffer;
+	};
+	typedef std::vector<std::vector<GroupChannel> > ChannelGroups;
+
+	ChannelGroups channel_groups;
+	bool          channel_groups_dirty;
+
+	Glib::Threads::Mutex group_lock;
+	Glib::Threads::Cond  group_cond;
+	gint                 pending_groups;
+	Glib::Threads::Mutex group_exception_lock;
+	boost::shared_ptr<AudioGrapher::ThreaderException> group_exception;
+
 	std::list<Intermediate *> intermediates;
+	Glib::Threads::Mutex      intermediates_lock;
 
 	AnalysisMap analysis_map;
 
 	bool _realtime;
 
+	/* memory for all SpillBuffers of normalized exports */
+	boost::shared_ptr<AudioGrapher::MemoryBudget> normalize_budget;
+
 	Glib::ThreadPool thread_pool;
 };
 
@@ -44,7 +44,7 @@ class LIBARDOUR_API GainControl : public SlavableAutomationControl {
 
 protected:
 	void post_add_master (boost::shared_ptr<AutomationControl>);
-	bool get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t) const;
+	bool get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t, bool& constant) const;
 };
 
 } /* namespace */
@@ -32,6 +32,7 @@
 
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
+#include "pbd/ws_deque.h"
 
 #include "ardour/audio_backend.h"
 #include "ardour/libardour_visibility.h"
@@ -76,6 +77,9 @@ public:
 
 	bool in_process_thread () const;
 
+	/** @return the nodes of the most expensive path through the graph, from input to output */
+	node_list_t critical_path () const;
+
 protected:
 	virtual void session_going_away ();
 
@@ -83,15 +87,45 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 	void run_one ();
+	void run_one_shared ();
+	void run_one_stealing ();
+	GraphNode* steal_work (size_t self);
+	void setup_worker (size_t id);
+	void wake_idle_threads (guint work_avail);
 	void main_thread ();
 	void prep ();
 	void dump (int chain) const;
+	void update_priorities (int chain);
+	void mark_critical_path (int chain);
+
+	node_list_t _nodes_rt[2];          ///< all nodes, in topological order
+	node_list_t _init_trigger_list[2]; ///< nodes without input, in the order in which they are triggered
 
-	node_list_t _nodes_rt[2];
-	node_list_t _init_trigger_list[2];
+	/** Cycles until the trigger order is updated according to the measured DSP cost of the nodes */
+	int _priority_countdown;
 
 	PBD::MPMCQueue<GraphNode*> _trigger_queue;      ///< nodes that can be processed
-	volatile guint             _trigger_queue_size; ///< number of entries in trigger-queue
+	volatile guint             _trigger_queue_size; ///< number of entries in trigger-queue (or all work-queues)
+
+	/** Use per-thread work-queues with work-stealing instead of the shared _trigger_queue.
+	 * Set from the "graph-work-stealing" config when the threads are (re)created.
+	 */
+	bool _work_stealing;
+
+	struct Worker {
+		Worker (size_t i, size_t sz) : id (i), queue (sz) {}
+		size_t                                 id;
+		PBD::WorkStealingDeque<GraphNode*> queue;
+	};
+
+	/** One per process thread; [0] is the main thread */
+	std::vector<Worker*> _workers;
+
+	/** The calling process thread's Worker */
+	static Glib::Threads::Private<Worker> _thread_worker;
+
+	/** The number of processing threads looking for work before going to sleep */
+	volatile guint _spinning_thread_cnt;
 
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
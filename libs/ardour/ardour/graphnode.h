@@ -27,6 +27,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include "pbd/timing.h"
+
 namespace ARDOUR
 {
 class Graph;
@@ -42,8 +44,14 @@ protected:
 	friend class Graph;
 	/** Nodes that we directly feed */
 	node_set_t _activation_set[2];
+	/** The nodes of _activation_set, in the order in which they are triggered */
+	std::vector<GraphNode*> _activation_order[2];
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
+	/** The cost of the most expensive path from this node to a terminal node, this node included [usec] */
+	float _path_cost;
+	/** Set if this node is on the most expensive path through the graph */
+	volatile gint _critical;
 };
 
 /** A node on our processing graph, ie a Route */
@@ -59,17 +67,42 @@ public:
 	void
 	run (int chain)
 	{
+		_dsp_stats.start ();
 		process ();
+		_dsp_stats.update ();
+		update_dsp_cost ();
 		finish (chain);
 	}
 
+	/** @return rolling average of the time it takes to process this node [usec] */
+	float dsp_cost () const { return _dsp_cost; }
+
+	/** @return true if this node is on the most expensive path through the process graph,
+	 * which determines the time it takes to complete a cycle.
+	 */
+	bool on_critical_path () const { return g_atomic_int_get (&_critical); }
+
+	/** @return the cost of the most expensive path from this node to the end of the graph [usec] */
+	float path_cost () const { return _path_cost; }
+
+	bool get_dsp_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const;
+	void clear_dsp_stats ();
+
+	/** @return the times it took to process this node, only to be read while it is not processed */
+	PBD::TimingHistogram const& dsp_histogram () const { return _dsp_stats; }
+
 private:
 	void finish (int chain);
 	void process ();
+	void update_dsp_cost ();
 
 	boost::shared_ptr<Graph> _graph;
 
 	gint _refcount;
+
+	PBD::TimingHistogram _dsp_stats;
+	float                _dsp_cost;
+	volatile gint        _dsp_stats_reset;
 };
 }
 
@@ -53,6 +53,8 @@ private:
 	std::list<InternalSend*> _sends;
 	/** mutex to protect _sends */
 	Glib::Threads::Mutex _sends_mutex;
+	/** buffers of the active sends, reserved for all of them */
+	std::vector<BufferSet const*> _send_buffers;
 };
 
 } // namespace ARDOUR
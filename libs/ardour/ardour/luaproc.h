@@ -134,6 +134,16 @@ private:
 public:
 	void set_origin (std::string& path) { _origin = path; }
 
+	/* Pass the same, preallocated tables to dsp_run() every cycle and
+	 * update them in place (default), rather than creating new ones.
+	 * With this, scripts must not keep references to the tables or to
+	 * MIDI events across cycles. This is saved with the plugin's state.
+	 */
+	void set_reuse_tables (bool yn) { _reuse_tables = yn; }
+	bool reuse_tables () const { return _reuse_tables; }
+
+	LuaState* lua_state () { return &lua; }
+
 protected:
 	const std::string& script() const { return _script; }
 	const std::string& origin() const { return _origin; }
@@ -162,6 +172,10 @@ private:
 
 	void init ();
 	bool load_script ();
+
+	void run_with_new_tables (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
+	void run_with_reused_tables (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
+	void copy_midi_out (luabridge::LuaRef&, BufferSet&, ChanMapping const&, pframes_t);
 	void lua_print (std::string s);
 
 	std::string preset_name_to_uri (const std::string&) const;
@@ -193,6 +207,14 @@ private:
 	bool _has_midi_input;
 	bool _has_midi_output;
 
+	/* arguments of dsp_run(), see run_with_reused_tables() */
+	bool _reuse_tables;
+	luabridge::LuaRef* _in_map;
+	luabridge::LuaRef* _out_map;
+	luabridge::LuaRef* _midi_in;
+	luabridge::LuaRef* _midi_out;
+	luabridge::LuaRef* _midi_pool; // event tables, referenced by _midi_in
+	int                _midi_in_cnt;
 
 #ifdef WITH_LUAPROC_STATS
 	int64_t _stats_avg[2];
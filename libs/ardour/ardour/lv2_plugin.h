@@ -55,6 +55,7 @@ const void* lv2plugin_get_port_value(const char* port_symbol,
                                      uint32_t*   type);
 
 class AudioEngine;
+class PluginScanCache;
 class Session;
 
 class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
@@ -381,7 +382,10 @@ public:
 	LV2PluginInfo (const char* plugin_uri);
 	~LV2PluginInfo ();
 
-	static PluginInfoList* discover ();
+	/** @param cache if given, bundles which did not change since they
+	 *  were recorded in it are not scanned again, and scanned ones are added.
+	 */
+	static PluginInfoList* discover (PluginScanCache* cache = 0);
 
 	PluginPtr load (Session& session);
 	std::vector<Plugin::PresetRecord> get_presets (bool user_only) const;
@@ -65,6 +65,18 @@ public:
 	bool insert_event(const Evoral::Event<TimeType>& event);
 	bool merge_in_place(const MidiBuffer &other);
 
+	/** Merge the events of @param n_others buffers into this one, in one
+	 *  pass over all of them.  Realtime safe.
+	 *  @return false if they do not all fit, in which case those which
+	 *  still fit are merged one at a time, in order, and the others dropped.
+	 */
+	bool merge_in_place (MidiBuffer const* const* others, size_t n_others);
+
+	/** The number of buffers that merge_in_place() merges in one pass;
+	 *  more are merged in groups of this size.
+	 */
+	static const size_t max_merge_sources = 32;
+
 	/** EventSink interface for non-RT use (export, bounce). */
 	uint32_t write(TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
 
@@ -183,6 +195,8 @@ private:
 	friend class iterator_base< MidiBuffer, Evoral::Event<TimeType> >;
 	friend class iterator_base< const MidiBuffer, const Evoral::Event<TimeType> >;
 
+	void merge_sorted (MidiBuffer const* const* others, size_t n_others);
+
 	uint8_t* _data; ///< timestamp, event, timestamp, event, ...
 	pframes_t _size;
 };
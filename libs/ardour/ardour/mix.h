@@ -45,6 +45,26 @@ extern "C" {
 LIBARDOUR_API void  x86_sse_find_peaks                 (const float * buf, uint32_t nsamples, float *min, float *max);
 LIBARDOUR_API void  x86_sse_avx_find_peaks             (const float * buf, uint32_t nsamples, float *min, float *max);
 
+/* AVX2 + FMA functions */
+LIBARDOUR_API float x86_fma_compute_peak                (const float * buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_fma_find_peaks                  (const float * buf, uint32_t nsamples, float *min, float *max);
+LIBARDOUR_API void  x86_fma_apply_gain_to_buffer        (float * buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float * dst, const float * src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_fma_mix_buffers_no_gain         (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_fma_copy_vector                 (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API float x86_fma_apply_gain_ramp             (float * buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_fma_mix_buffers_with_gain_ramp  (float * dst, const float * src, uint32_t nframes, float initial, float target);
+
+/* AVX-512F functions */
+LIBARDOUR_API float x86_avx512f_compute_peak               (const float * buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx512f_find_peaks                 (const float * buf, uint32_t nsamples, float *min, float *max);
+LIBARDOUR_API void  x86_avx512f_apply_gain_to_buffer       (float * buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain      (float * dst, const float * src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain        (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_copy_vector                (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp            (float * buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain_ramp (float * dst, const float * src, uint32_t nframes, float initial, float target);
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float current);
@@ -73,5 +93,7 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARD
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_ramp           (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  default_mix_buffers_with_gain_ramp(ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float initial, float target);
 
 #endif /* __ardour_mix_h__ */
@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_peak_pyramid_h__
+#define __ardour_peak_pyramid_h__
+
+#include <string>
+#include <stdint.h>
+#include <time.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <glib.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Read-only, memory-mapped multi-resolution view of a peakfile.
+ *
+ * Level 0 is the peakfile itself (a plain array of PeakData, one per
+ * `fpp' samples), which is also what capture and build_peaks_from_scratch()
+ * write and what older versions read.
+ *
+ * Coarser levels, each `level_factor' times the previous one, live in a
+ * separate file next to it (peakpath + peak_pyramid_suffix). That file is
+ * built from level 0 after the fact, by build(), and is only used as long
+ * as it matches the size and modification time of the peakfile.
+ *
+ * read() reduces directly from the mapped file(s) into the caller's buffer.
+ */
+class LIBARDOUR_API PeakPyramid : public boost::noncopyable
+{
+public:
+	PeakPyramid (std::string const& peakpath, samplecnt_t fpp);
+	~PeakPyramid ();
+
+	/** map the peakfile and, if it is up to date, the pyramid file.
+	 * @return 0 if at least level 0 could be mapped
+	 */
+	int open ();
+
+	/** true if open() found no usable pyramid file for a peakfile
+	 * that is large enough to benefit from one.
+	 */
+	bool needs_build () const { return _needs_build; }
+
+	/** number of peaks stored at level 0 */
+	samplecnt_t base_count () const { return _levels[0].count; }
+
+	uint32_t n_levels () const { return _n_levels; }
+
+	/** Fill @a peaks with @a npeaks visual peaks, each covering
+	 * @a samples_per_visual_peak samples starting at @a start,
+	 * from the coarsest level that is still accurate enough.
+	 *
+	 * @return false if the requested range is not covered by level 0,
+	 * in which case nothing is written.
+	 */
+	bool read (PeakData* peaks, samplecnt_t npeaks, samplepos_t start, double samples_per_visual_peak) const;
+
+	/** (Re)build the pyramid file for @a peakpath. The file is written
+	 * under a temporary name and renamed, so that concurrent readers
+	 * only ever map complete files.
+	 */
+	static int build (std::string const& peakpath, samplecnt_t fpp);
+
+	/** Update the pyramid file for @a peakpath after the peakfile's
+	 * modification time was changed from @a from to @a to without
+	 * changing its content.
+	 */
+	static void retime (std::string const& peakpath, time_t from, time_t to);
+
+	static std::string pyramid_path (std::string const& peakpath);
+
+	static const uint32_t level_factor = 16;
+	static const uint32_t max_levels   = 3;
+
+private:
+	struct Level {
+		samplecnt_t     fpp;
+		PeakData const* data;
+		samplecnt_t     count;
+	};
+
+	std::string  _peakpath;
+	samplecnt_t  _fpp;
+	GMappedFile* _base;
+	GMappedFile* _pyramid;
+	Level        _levels[max_levels];
+	uint32_t     _n_levels;
+	bool         _needs_build;
+
+	void close ();
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_peak_pyramid_h__ */
@@ -49,6 +49,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/region.h"
+#include "ardour/region_index.h"
 #include "ardour/session_object.h"
 #include "ardour/data_type.h"
 
@@ -355,6 +356,16 @@ protected:
 
 	boost::shared_ptr<RegionList> regions_touched_locked (samplepos_t start, samplepos_t end);
 
+	/** @return position index of the current regions, built on demand.
+	 *  Caller must hold the region lock.
+	 */
+	boost::shared_ptr<RegionIndex const> region_index () const;
+
+	/** Discard the region index (and anything derived from it); called
+	 *  whenever regions are added, removed, moved, trimmed or relayered.
+	 */
+	virtual void invalidate_region_index ();
+
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
 	void notify_layering_changed ();
@@ -427,6 +438,12 @@ private:
 	friend class RegionWriteLock;
 	mutable Glib::Threads::RWLock region_lock;
 
+	/* the index is rebuilt lazily by readers, which may run concurrently
+	 * under the (shared) region lock, so it has its own.
+	 */
+	mutable Glib::Threads::Mutex                 _region_index_lock;
+	mutable boost::shared_ptr<RegionIndex const> _region_index;
+
 private:
 	void setup_layering_indices (RegionList const &);
 	void coalesce_and_check_crossfades (std::list<Evoral::Range<samplepos_t> >);
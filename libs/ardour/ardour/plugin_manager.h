@@ -37,6 +37,7 @@
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_scan_cache.h"
 
 namespace ARDOUR {
 
@@ -64,6 +65,7 @@ public:
 	void clear_vst_blacklist ();
 	void clear_au_cache ();
 	void clear_au_blacklist ();
+	void clear_plugin_scan_cache ();
 
 	const std::string get_default_windows_vst_path() const { return windows_vst_path; }
 	const std::string get_default_lxvst_path() const { return lxvst_path; }
@@ -185,6 +187,9 @@ private:
 	ARDOUR::PluginInfoList* _au_plugin_info;
 	ARDOUR::PluginInfoList* _lua_plugin_info;
 
+	PluginScanCache _ladspa_cache;
+	PluginScanCache _lv2_cache;
+
 	std::map<uint32_t, std::string> rdf_type;
 
 	std::string windows_vst_path;
@@ -221,6 +226,7 @@ private:
 	int lxvst_discover (std::string path, bool cache_only = false);
 
 	int ladspa_discover (std::string path);
+	void ladspa_add (std::string const& path, PluginScanCache::Entries const&);
 
 	std::string get_ladspa_category (uint32_t id);
 	std::vector<uint32_t> ladspa_plugin_whitelist;
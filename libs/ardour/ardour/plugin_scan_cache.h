@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_plugin_scan_cache_h__
+#define __ardour_plugin_scan_cache_h__
+
+#include <stdint.h>
+#include <time.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/chan_count.h"
+
+namespace ARDOUR {
+
+/** A persistent record of the plugins found in each plugin file or bundle
+ *  (LADSPA modules, LV2 bundles), so that a refresh only needs to examine
+ *  the files which changed since they were last scanned.
+ *
+ *  Files are identified by their path and modification time; for a
+ *  directory, the latest modification time of anything inside it.
+ */
+class LIBARDOUR_API PluginScanCache
+{
+public:
+	/** What discovery learnt about one plugin */
+	struct Entry {
+		Entry () : index (0) {}
+
+		std::string name;
+		std::string category;
+		std::string creator;
+		std::string unique_id;
+		uint32_t    index;
+		ChanCount   n_inputs;
+		ChanCount   n_outputs;
+	};
+
+	typedef std::vector<Entry> Entries;
+
+	/** @param name file name of the cache, in the user's cache directory */
+	PluginScanCache (std::string const& name);
+
+	/** Read the cache file, if any. Caches written by another version
+	 *  of the program are ignored, since what it accepts may differ.
+	 */
+	void load ();
+
+	/** Drop the files which were not looked up since the last save,
+	 *  and write the cache file if anything changed.
+	 */
+	void save ();
+
+	/** Forget all files and remove the cache file */
+	void clear ();
+
+	/** @return the plugins which were found in @param path, or 0 if it
+	 *  was not scanned yet or was modified since.
+	 */
+	Entries const* lookup (std::string const& path);
+
+	/** Record the plugins found in @param path, which was looked up before. */
+	void set (std::string const& path, Entries const&);
+
+	/** @return the paths of all files which are known, regardless of
+	 *  whether they were modified since.
+	 */
+	std::vector<std::string> paths () const;
+
+	/** @return the modification time of @param path, which for a
+	 *  directory is the latest one of the directory and its contents.
+	 */
+	static time_t modification_time (std::string const& path);
+
+private:
+	struct File {
+		File () : mtime (0), valid (false), seen (false) {}
+
+		time_t  mtime;
+		bool    valid; ///< entries were set for this mtime
+		bool    seen;  ///< looked up or set since the last save
+		Entries entries;
+	};
+
+	typedef std::map<std::string, File> Files;
+
+	std::string cache_path () const;
+
+	std::string _name;
+	Files       _files;
+	bool        _dirty;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_plugin_scan_cache_h__ */
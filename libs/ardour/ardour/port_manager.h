@@ -211,6 +211,8 @@ class LIBARDOUR_API PortManager
 
 	void cycle_end_fade_out (gain_t, gain_t, pframes_t, Session* s = 0);
 
+	void resample_audio_ports (bool inputs, pframes_t nframes, Session* s);
+
 	typedef std::map<std::string,MidiPortInformation> MidiPortInfo;
 
 	mutable Glib::Threads::Mutex midi_port_info_mutex;
@@ -218,6 +220,7 @@ class LIBARDOUR_API PortManager
 
 	static std::string midi_port_info_file ();
 	bool midi_info_dirty;
+	uint64_t _resample_cycle; ///< counts cycles for AudioPortResampler
 	void save_midi_port_info ();
 	void load_midi_port_info ();
 	void fill_midi_port_info_locked ();
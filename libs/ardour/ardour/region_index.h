@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libardour_region_index_h__
+#define __libardour_region_index_h__
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class Region;
+
+/** An immutable snapshot of a playlist's regions, sorted by position, which
+ *  answers range and point queries in O(log n + k) rather than O(n).
+ *
+ *  The regions are kept in an array sorted by first sample. The array is
+ *  treated as an implicit balanced binary tree (the root of [lo, hi) is
+ *  the middle element) and every node records the largest last sample of its
+ *  subtree, so that whole subtrees which end before the query can be skipped.
+ *
+ *  Playlist builds one of these lazily, the first time it is needed after the
+ *  region list or any region's bounds have changed.
+ */
+class LIBARDOUR_API RegionIndex
+{
+  public:
+	RegionIndex (RegionList const &);
+
+	typedef std::vector<boost::shared_ptr<Region> > Regions;
+
+	Regions const & regions () const { return _regions; }
+	size_t size () const { return _regions.size (); }
+
+	samplepos_t first_sample (size_t n) const { return _first[n]; }
+	samplepos_t last_sample (size_t n) const { return _last[n]; }
+
+	/** Call @param f with the index of every region which has some part
+	 *  within [@param start, @param end], in position order.
+	 */
+	template<typename F>
+	void foreach_touched (samplepos_t start, samplepos_t end, F& f) const {
+		if (start > end || _regions.empty ()) {
+			return;
+		}
+		visit (0, _regions.size (), start, end, f);
+	}
+
+	/** Call @param f with the index of every region covering @param sample, in position order */
+	template<typename F>
+	void foreach_covering (samplepos_t sample, F& f) const {
+		foreach_touched (sample, sample, f);
+	}
+
+	/** @return index of the first region whose first sample is >= @param pos */
+	size_t lower_bound (samplepos_t pos) const;
+	/** @return index of the first region whose first sample is > @param pos */
+	size_t upper_bound (samplepos_t pos) const;
+
+  private:
+	Regions                  _regions;
+	std::vector<samplepos_t> _first;
+	std::vector<samplepos_t> _last;
+	std::vector<samplepos_t> _max_last; ///< max of _last over the implicit subtree rooted at each index
+
+	samplepos_t build (size_t lo, size_t hi);
+
+	template<typename F>
+	void visit (size_t lo, size_t hi, samplepos_t start, samplepos_t end, F& f) const {
+		while (lo < hi) {
+			size_t const mid = lo + (hi - lo) / 2;
+			if (_max_last[mid] < start) {
+				/* nothing in this subtree reaches the query */
+				return;
+			}
+			visit (lo, mid, start, end, f);
+			if (_first[mid] > end) {
+				/* neither this region nor any to its right can reach the query */
+				return;
+			}
+			if (_last[mid] >= start && _first[mid] <= _last[mid]) {
+				f (mid);
+			}
+			lo = mid + 1;
+		}
+	}
+};
+
+} // namespace
+
+#endif /* __libardour_region_index_h__ */
@@ -31,6 +31,8 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef float (*apply_gain_ramp_t)       (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*mix_buffers_with_gain_ramp_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float, float);
 
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
@@ -38,6 +40,17 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+
+	/** Apply a gain that follows a one-pole low-pass from @a initial towards @a target:
+	 *  buf[n] *= g[n]; g[n+1] = g[n] + coeff * (target - g[n]).
+	 *  @return the gain for the sample after the last one (g[nframes])
+	 */
+	LIBARDOUR_API extern apply_gain_ramp_t       apply_gain_ramp;
+
+	/** Mix @a src into @a dst, with a gain linearly interpolated from @a initial
+	 *  (at the first sample) towards @a target (reached after the last one).
+	 */
+	LIBARDOUR_API extern mix_buffers_with_gain_ramp_t mix_buffers_with_gain_ramp;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
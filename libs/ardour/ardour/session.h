@@ -331,6 +331,14 @@ public:
 
 	bool plot_process_graph (std::string const& file_name) const;
 
+	/** @return the routes on the most expensive path through the process graph, from
+	 * input to output, according to their measured DSP load. Empty unless the session
+	 * is processed by more than one thread.
+	 */
+	boost::shared_ptr<RouteList> critical_path () const;
+	/** Reset the DSP load statistics of all routes, see GraphNode::get_dsp_stats */
+	void clear_route_dsp_stats ();
+
 	boost::shared_ptr<BundleList> bundles () {
 		return _bundles.reader ();
 	}
@@ -1025,6 +1033,7 @@ public:
 	// these commands are implemented in libs/ardour/session_command.cc
 	Command* memento_command_factory(XMLNode* n);
 	Command* stateful_diff_command_factory (XMLNode *);
+	Command* automation_list_diff_command_factory (XMLNode *);
 	void register_with_memento_command_factory(PBD::ID, PBD::StatefulDestructible*);
 
 	/* clicking */
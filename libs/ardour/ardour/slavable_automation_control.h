@@ -59,9 +59,15 @@ public:
 		return reduce_by_masters_locked (val, ignore_automation_state);
 	}
 
-	bool get_masters_curve (samplepos_t s, samplepos_t e, float* v, samplecnt_t l) const {
+	/** if @a constant is given, it is set to true if all values of @a v are identical */
+	bool get_masters_curve (samplepos_t s, samplepos_t e, float* v, samplecnt_t l, bool* constant = 0) const {
 		Glib::Threads::RWLock::ReaderLock lm (master_lock);
-		return get_masters_curve_locked (s, e, v, l);
+		bool c = false;
+		const bool rv = get_masters_curve_locked (s, e, v, l, c);
+		if (constant) {
+			*constant = c;
+		}
+		return rv;
 	}
 
 	/* for toggled/boolean controls, returns a count of the number of
@@ -135,7 +141,7 @@ protected:
 	void   actually_set_value (double value, PBD::Controllable::GroupControlDisposition);
 	void   update_boolean_masters_records (boost::shared_ptr<AutomationControl>);
 
-	virtual bool get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t) const;
+	virtual bool get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t, bool& constant) const;
 	bool masters_curve_multiply (samplepos_t, samplepos_t, float*, samplecnt_t) const;
 
 	virtual double reduce_by_masters_locked (double val, bool) const;
@@ -33,6 +33,8 @@
 
 namespace ARDOUR {
 
+class DirectFileReader;
+
 class LIBARDOUR_API SndFileSource : public AudioFileSource {
   public:
 	/** Constructor to be called for existing external-to-session files */
@@ -94,6 +96,7 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SNDFILE* _sndfile;
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
+	DirectFileReader* _direct_reader; ///< playback of uncompressed, read-only files
 
 	void init_sndfile ();
 	int open();
@@ -67,9 +67,20 @@ class LIBARDOUR_API SourceFactory {
         static Glib::Threads::Cond                       PeaksToBuild;
         static Glib::Threads::Mutex                      peak_building_lock;
 	static std::list< boost::weak_ptr<AudioSource> > files_with_peaks;
+	static std::list< boost::weak_ptr<AudioSource> > files_with_peak_pyramids;
 
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+
+	/** move a source that is waiting for its peakfile to the front of the queue,
+	 * e.g. because it is about to be displayed.
+	 */
+	static void prioritize_peakfile (boost::shared_ptr<AudioSource>);
+
+	/** queue building the coarse peak levels of a source, this has lower
+	 * priority than setup_peakfile() and is not counted by peak_work_queue_length()
+	 */
+	static void build_peak_pyramid (boost::shared_ptr<AudioSource>);
 };
 
 }
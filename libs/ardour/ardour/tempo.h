@@ -34,6 +34,7 @@
 
 #include "pbd/undo.h"
 #include "pbd/enum_convert.h"
+#include "pbd/rcu.h"
 
 #include "pbd/stateful.h"
 #include "pbd/statefuldestructible.h"
@@ -330,6 +331,55 @@ class LIBARDOUR_API TempoMetric {
 	double             _pulse;
 };
 
+/** An immutable copy of the active tempo sections and the meter sections of
+ *  a TempoMap, in arrays ordered as the map. Conversions are binary searches
+ *  which give the same results as the walks over the map's Metrics, without
+ *  taking its lock, so they may be used from any thread.
+ */
+class LIBARDOUR_API TempoMapSnapshot {
+  public:
+	TempoMapSnapshot () {}
+	TempoMapSnapshot (const Metrics&);
+
+	double beat_at_minute (const double& minute) const;
+	double minute_at_beat (const double& beat) const;
+
+	double pulse_at_beat (const double& beat) const;
+	double beat_at_pulse (const double& pulse) const;
+
+	double pulse_at_minute (const double& minute) const;
+	double minute_at_pulse (const double& pulse) const;
+
+	Tempo tempo_at_minute (const double& minute) const;
+	Tempo tempo_at_pulse (const double& pulse) const;
+
+	Timecode::BBT_Time bbt_at_minute (const double& minute) const;
+	double minute_at_bbt (const Timecode::BBT_Time&) const;
+
+	double beat_at_bbt (const Timecode::BBT_Time& bbt) const;
+	Timecode::BBT_Time bbt_at_beat (const double& beats) const;
+
+	double pulse_at_bbt (const Timecode::BBT_Time& bbt) const;
+	Timecode::BBT_Time bbt_at_pulse (const double& pulse) const;
+
+	double quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const;
+	double exact_qn_at_minute (const double& minute, const int32_t sub_num) const;
+
+	const TempoSection& tempo_section_at_minute (double minute) const;
+	/** @param next set to the tempo section after the returned one, or 0 */
+	const TempoSection& tempo_section_at_sample (samplepos_t sample, const TempoSection** next) const;
+
+	const MeterSection& meter_section_at_minute (double minute) const;
+	const MeterSection& meter_section_at_beat (const double& beat) const;
+
+  private:
+	typedef std::vector<boost::shared_ptr<const TempoSection> > Tempos;
+	typedef std::vector<boost::shared_ptr<const MeterSection> > Meters;
+
+	Tempos _tempos;
+	Meters _meters;
+};
+
 /** Tempo Map - mapping of timecode to musical time.
  * convert audio-samples, sample-rate to Bar/Beat/Tick, Meter/Tempo
  */
@@ -599,6 +649,24 @@ private:
 	samplecnt_t                   _sample_rate;
 	mutable Glib::Threads::RWLock lock;
 
+	/* the state of _metrics, for conversions which do not take the lock */
+	SerializedRCUManager<TempoMapSnapshot> _snapshot;
+
+	void publish_snapshot ();
+
+	/** Holds the write lock while _metrics are modified, and publishes
+	 *  their new state when done.
+	 */
+	class MetricsWriter {
+	  public:
+		MetricsWriter (TempoMap& map) : _map (map), _lm (map.lock) {}
+		~MetricsWriter () { _map.publish_snapshot (); }
+
+	  private:
+		TempoMap&                         _map;
+		Glib::Threads::RWLock::WriterLock _lm;
+	};
+
 	void recompute_tempi (Metrics& metrics);
 	void recompute_meters (Metrics& metrics);
 	void recompute_map (Metrics& metrics, samplepos_t end = -1);
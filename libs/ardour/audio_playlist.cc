@@ -192,6 +192,76 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 
 	Playlist::RegionReadLock rl (this);
 
+	if (_session.solo_selection_active() && SoloSelectedActive()) {
+		/* which regions are transparent depends on the selection at
+		 * the time of the read, so the cached coverage can't be used.
+		 */
+		return read_layered (buf, mixdown_buffer, gain_buffer, start, cnt, chan_n);
+	}
+
+	boost::shared_ptr<Coverage const> cov (coverage ());
+
+	if (cov->from.empty ()) {
+		return cnt;
+	}
+
+	samplepos_t const end = start + cnt - 1;
+
+	/* find the span containing start (or the first one, if start is before it) */
+	size_t n = upper_bound (cov->from.begin(), cov->from.end(), start) - cov->from.begin();
+	if (n > 0) {
+		--n;
+	}
+
+	for (; n + 1 < cov->from.size() && cov->from[n] <= end; ++n) {
+
+		samplepos_t const span_start = max (start, cov->from[n]);
+		samplepos_t const span_end = min (end, cov->from[n + 1] - 1);
+
+		for (uint32_t r = cov->offset[n]; r < cov->offset[n + 1]; ++r) {
+
+			AudioRegion const & ar (*cov->regions[r]);
+
+			/* the region may have been moved since the coverage was
+			 * computed, but before we have been told about it.
+			 */
+			samplepos_t const from = max (span_start, ar.first_sample ());
+			samplepos_t const to = min (span_end, ar.last_sample ());
+
+			if (from > to) {
+				continue;
+			}
+
+			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
+									   name(), ar.name(), from, to - from + 1, (int) chan_n, buf, from - start));
+			ar.read_at (buf + from - start, mixdown_buffer, gain_buffer, from, to - from + 1, chan_n);
+		}
+	}
+
+	return cnt;
+}
+
+/** RegionIndex visitor collecting the unmuted regions it is given */
+struct CoverageCollector {
+	CoverageCollector (RegionIndex const & i, RegionList& l) : index (i), rlist (l) {}
+
+	void operator() (size_t n) {
+		if (!index.regions()[n]->muted()) {
+			rlist.push_back (index.regions()[n]);
+		}
+	}
+
+	RegionIndex const & index;
+	RegionList& rlist;
+};
+
+/** Read without the cached coverage, working out the layering from scratch.
+ *  Caller must hold the region lock and have zeroed @param buf.
+ */
+ARDOUR::samplecnt_t
+AudioPlaylist::read_layered (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, samplepos_t start,
+			     samplecnt_t cnt, unsigned chan_n)
+{
 	/* Find all the regions that are involved in the bit we are reading,
 	   and sort them by descending layer and ascending position.
 	*/
@@ -265,6 +335,106 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 	return cnt;
 }
 
+void
+AudioPlaylist::invalidate_region_index ()
+{
+	Playlist::invalidate_region_index ();
+
+	Glib::Threads::Mutex::Lock lm (_coverage_lock);
+	_coverage.reset ();
+}
+
+/** Caller must hold the region lock */
+boost::shared_ptr<AudioPlaylist::Coverage const>
+AudioPlaylist::coverage () const
+{
+	Glib::Threads::Mutex::Lock lm (_coverage_lock);
+
+	if (_coverage) {
+		return _coverage;
+	}
+
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
+	RegionIndex::Regions const & all (idx->regions ());
+	boost::shared_ptr<Coverage> cov (new Coverage);
+
+	/* Every point at which the set of audible regions may change: region
+	 * boundaries and, for opaque regions, the ends of their bodies (the
+	 * parts that hide everything beneath them).
+	 */
+	vector<samplepos_t> bounds;
+	bounds.reserve (all.size() * 4);
+
+	for (size_t n = 0; n < all.size(); ++n) {
+		if (all[n]->muted() || idx->first_sample (n) > idx->last_sample (n)) {
+			continue;
+		}
+		bounds.push_back (idx->first_sample (n));
+		bounds.push_back (idx->last_sample (n) + 1);
+		if (all[n]->opaque()) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (all[n]);
+			Evoral::Range<samplepos_t> const body = ar->body_range ();
+			if (body.from <= body.to) {
+				bounds.push_back (max (body.from, idx->first_sample (n)));
+				bounds.push_back (min (body.to + 1, idx->last_sample (n) + 1));
+			}
+		}
+	}
+
+	sort (bounds.begin(), bounds.end());
+	bounds.erase (unique (bounds.begin(), bounds.end()), bounds.end());
+
+	RegionList here;
+	vector<boost::shared_ptr<AudioRegion> > stack;
+
+	for (size_t b = 0; b + 1 < bounds.size(); ++b) {
+
+		samplepos_t const from = bounds[b];
+		samplepos_t const to = bounds[b + 1] - 1;
+
+		/* regions covering this span, topmost first */
+		here.clear ();
+		CoverageCollector c (*idx, here);
+		idx->foreach_covering (from, c);
+		here.sort (ReadSorter ());
+
+		/* everything down to (and including) the first opaque region
+		 * whose body covers the whole span is audible.
+		 */
+		stack.clear ();
+		for (RegionList::const_iterator i = here.begin(); i != here.end(); ++i) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+			stack.push_back (ar);
+			if (ar->opaque ()) {
+				Evoral::Range<samplepos_t> const body = ar->body_range ();
+				if (body.from <= from && to <= body.to) {
+					break;
+				}
+			}
+		}
+
+		/* the same regions as the previous span: just extend it */
+		if (!cov->from.empty() && uint32_t (stack.size()) == cov->regions.size() - cov->offset.back()
+		    && equal (stack.rbegin(), stack.rend(), cov->regions.begin() + cov->offset.back())) {
+			continue;
+		}
+
+		cov->from.push_back (from);
+		cov->offset.push_back (cov->regions.size());
+		/* read bottom-up */
+		cov->regions.insert (cov->regions.end(), stack.rbegin(), stack.rend());
+	}
+
+	if (!bounds.empty ()) {
+		/* sentinels marking the end of the last span */
+		cov->from.push_back (bounds.back ());
+		cov->offset.push_back (cov->regions.size());
+	}
+
+	_coverage = cov;
+	return _coverage;
+}
+
 void
 AudioPlaylist::dump () const
 {
@@ -127,6 +127,7 @@ AudioPlaylistSource::read_unlocked (Sample* dst, samplepos_t start, samplecnt_t
 {
 	boost::shared_array<Sample> sbuf;
 	boost::shared_array<gain_t> gbuf;
+	boost::shared_ptr<Glib::Threads::Mutex> rlock;
 	samplecnt_t to_read;
 	samplecnt_t to_zero;
 
@@ -152,9 +153,17 @@ AudioPlaylistSource::read_unlocked (Sample* dst, samplepos_t start, samplecnt_t
 		Glib::Threads::Mutex::Lock lm (_level_buffer_lock);
 		sbuf = _mixdown_buffers[_level-1];
 		gbuf = _gain_buffers[_level-1];
+		rlock = _level_read_locks[_level-1];
 	}
 
-	boost::dynamic_pointer_cast<AudioPlaylist>(_playlist)->read (dst, sbuf.get(), gbuf.get(), start+_playlist_offset, to_read, _playlist_channel);
+	{
+		/* other sources at this level share the buffers. Nested
+		   sources are always at a lower level, so this cannot
+		   deadlock.
+		*/
+		Glib::Threads::Mutex::Lock lm (*rlock);
+		boost::dynamic_pointer_cast<AudioPlaylist>(_playlist)->read (dst, sbuf.get(), gbuf.get(), start+_playlist_offset, to_read, _playlist_channel);
+	}
 
 	if (to_zero) {
 		memset (dst+to_read, 0, sizeof (Sample) * to_zero);
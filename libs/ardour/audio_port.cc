@@ -37,20 +37,122 @@ using namespace std;
 #define ENGINE AudioEngine::instance()
 #define port_engine AudioEngine::instance()->port_engine()
 
+vector<boost::weak_ptr<AudioPortResampler> > AudioPort::_resamplers[2];
+Glib::Threads::Mutex AudioPort::_resampler_lock;
+
+AudioPortResampler::AudioPortResampler ()
+	: _quality (0)
+	, _used (0)
+	, _cycle (0)
+	, _inp_count (0)
+	, _out_count (0)
+	, _next (0)
+{
+}
+
+void
+AudioPortResampler::setup (uint32_t quality)
+{
+	_src.setup (max_ports, quality);
+	_src.set_rrfilt (10);
+	_quality = quality;
+}
+
+void
+AudioPortResampler::add (uint32_t lane, Sample* in, Sample* out, pframes_t inp_count, pframes_t out_count, uint64_t cycle, bool restart, AudioPortResampler*& list)
+{
+	assert (lane < max_ports);
+
+	if (_cycle != cycle) {
+		for (uint32_t c = 0; c < max_ports; ++c) {
+			_src.inp_list[c] = 0;
+			_src.out_list[c] = 0;
+		}
+		_cycle     = cycle;
+		_inp_count = inp_count;
+		_out_count = out_count;
+		_next      = list;
+		list       = this;
+	}
+
+	assert (_inp_count == inp_count && _out_count == out_count);
+
+	if (restart) {
+		_src.reset_channel (lane);
+	}
+
+	_src.inp_list[lane] = in;
+	_src.out_list[lane] = out;
+}
+
+void
+AudioPortResampler::process ()
+{
+	_src.inp_count = _inp_count;
+	_src.out_count = _out_count;
+	_src.set_rratio (_out_count / (double) _inp_count);
+	_src.process ();
+
+	if (_src.out_count == 0) {
+		return;
+	}
+
+	for (uint32_t c = 0; c < max_ports; ++c) {
+		Sample* out = _src.out_list[c];
+		if (!out) {
+			continue;
+		}
+		for (pframes_t n = 0; n < _src.out_count; ++n) {
+			out[n] = out[-1];
+		}
+	}
+}
+
 AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
+	, _resampler_lane (0)
+	, _resampler_cycle (0)
 	, _data (0)
 {
 	assert (name.find_first_of (':') == string::npos);
-	_src.setup (_resampler_quality);
-	_src.set_rrfilt (10);
+
+	/* share the resampler of other ports in the same direction */
+	Glib::Threads::Mutex::Lock lm (_resampler_lock);
+	vector<boost::weak_ptr<AudioPortResampler> >& resamplers (_resamplers[sends_output () ? 1 : 0]);
+
+	for (vector<boost::weak_ptr<AudioPortResampler> >::iterator i = resamplers.begin (); i != resamplers.end () && !_resampler;) {
+		boost::shared_ptr<AudioPortResampler> r (i->lock ());
+		if (!r) {
+			i = resamplers.erase (i);
+			continue;
+		}
+		for (uint32_t lane = 0; lane < AudioPortResampler::max_ports; ++lane) {
+			if (!(r->_used & (1 << lane))) {
+				r->_used |= 1 << lane;
+				_resampler = r;
+				_resampler_lane = lane;
+				break;
+			}
+		}
+		++i;
+	}
+
+	if (!_resampler) {
+		_resampler.reset (new AudioPortResampler);
+		_resampler->setup (_resampler_quality);
+		_resampler->_used = 1;
+		resamplers.push_back (_resampler);
+	}
 }
 
 AudioPort::~AudioPort ()
 {
 	if (_data) cache_aligned_free (_data);
 	delete _buffer;
+
+	Glib::Threads::Mutex::Lock lm (_resampler_lock);
+	_resampler->_used &= ~(1 << _resampler_lane);
 }
 
 void
@@ -58,6 +160,11 @@ AudioPort::set_buffer_size (pframes_t nframes)
 {
 	if (_data) cache_aligned_free (_data);
 	cache_aligned_malloc ((void**) &_data, sizeof (Sample) * lrint (floor (nframes * Config->get_max_transport_speed())));
+
+	if (_resampler->quality () != _resampler_quality) {
+		/* the quality only changes while the engine is stopped */
+		_resampler->setup (_resampler_quality);
+	}
 }
 
 void
@@ -70,22 +177,9 @@ AudioPort::cycle_start (pframes_t nframes)
 		_buffer->prepare ();
 	} else if (!externally_connected ()) {
 		/* ardour internal port, just silence input, don't resample */
-		// TODO reset resampler only once
-		_src.reset ();
 		memset (_data, 0, _cycle_nframes * sizeof (float));
-	} else {
-		_src.inp_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
-		_src.inp_count = nframes;
-		_src.out_count = _cycle_nframes;
-		_src.set_rratio (_cycle_nframes / (double)nframes);
-		_src.out_data  = _data;
-		_src.process ();
-		while (_src.out_count > 0) {
-			*_src.out_data =  _src.out_data[-1];
-			++_src.out_data;
-			--_src.out_count;
-		}
 	}
+	/* else PortManager resamples the input, see add_to_resampler() */
 }
 
 void
@@ -100,27 +194,27 @@ AudioPort::cycle_end (pframes_t nframes)
 		}
 	}
 
-	if (sends_output() && _port_handle) {
-
-		if (!externally_connected ()) {
-			/* ardour internal port, data goes nowhere, skip resampling */
-			// TODO reset resampler only once
-			_src.reset ();
-			return;
-		}
+	/* PortManager resamples the output of externally connected ports
+	 * after this, see add_to_resampler()
+	 */
+}
 
-		_src.inp_count = _cycle_nframes;
-		_src.out_count = nframes;
-		_src.set_rratio (nframes / (double)_cycle_nframes);
-		_src.inp_data  = _data;
-		_src.out_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
-		_src.process ();
-		while (_src.out_count > 0) {
-			*_src.out_data =  _src.out_data[-1];
-			++_src.out_data;
-			--_src.out_count;
-		}
+void
+AudioPort::add_to_resampler (pframes_t nframes, uint64_t cycle, AudioPortResampler*& list)
+{
+	/* start over if this was not resampled in the last cycle, e.g. while
+	 * it was not connected, or if the lane was used by another port
+	 */
+	const bool restart = _resampler_cycle + 1 != cycle;
+	Sample* engine_buffer = (Sample*) port_engine.get_buffer (_port_handle, nframes);
+
+	if (receives_input ()) {
+		_resampler->add (_resampler_lane, engine_buffer, _data, nframes, _cycle_nframes, cycle, restart, list);
+	} else {
+		_resampler->add (_resampler_lane, _data, engine_buffer, _cycle_nframes, nframes, cycle, restart, list);
 	}
+
+	_resampler_cycle = cycle;
 }
 
 void
@@ -909,6 +909,8 @@ AudioEngine::start (bool for_latency)
 	_processed_samples = 0;
 	last_monitor_check = 0;
 
+	Port::setup_resampler (Config->get_port_resampler_quality ());
+
 	int error_code = _backend->start (for_latency);
 
 	if (error_code != 0) {
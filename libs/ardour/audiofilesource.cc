@@ -163,7 +163,7 @@ AudioFileSource::~AudioFileSource ()
 	DEBUG_TRACE (DEBUG::Destruction, string_compose ("AudioFileSource destructor %1, removable? %2\n", _path, removable()));
 	if (removable()) {
 		::g_unlink (_path.c_str());
-		::g_unlink (_peakpath.c_str());
+		unlink_peakfile ();
 	}
 }
 
@@ -248,7 +248,7 @@ AudioFileSource::mark_streaming_write_completed (const Lock& lock)
 int
 AudioFileSource::move_dependents_to_trash()
 {
-	return ::g_unlink (_peakpath.c_str());
+	return unlink_peakfile ();
 }
 
 void
@@ -272,6 +272,25 @@ AudioFileSource::is_empty (Session& /*s*/, string path)
 	return info.length == 0;
 }
 
+samplecnt_t
+AudioFileSource::peak_build_chunk_size () const
+{
+	samplecnt_t chunk = AudioSource::peak_build_chunk_size ();
+
+#ifndef PLATFORM_WINDOWS
+	/* read at least a few of the filesystem's preferred blocks at a time,
+	 * which matters for network or RAID storage with large block sizes.
+	 */
+	GStatBuf statbuf;
+	if (g_stat (_path.c_str(), &statbuf) == 0 && statbuf.st_blksize > 0) {
+		chunk = std::max (chunk, (samplecnt_t) (4 * statbuf.st_blksize / sizeof (Sample)));
+		chunk = std::min (chunk, (samplecnt_t) 1048576);
+	}
+#endif
+
+	return chunk;
+}
+
 int
 AudioFileSource::setup_peakfile ()
 {
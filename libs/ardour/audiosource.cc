@@ -60,9 +60,11 @@
 #include "pbd/xml++.h"
 
 #include "ardour/audiosource.h"
+#include "ardour/peak_pyramid.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -75,6 +77,7 @@ using namespace PBD;
 Glib::Threads::Mutex AudioSource::_level_buffer_lock;
 vector<boost::shared_array<Sample> > AudioSource::_mixdown_buffers;
 vector<boost::shared_array<gain_t> > AudioSource::_gain_buffers;
+vector<boost::shared_ptr<Glib::Threads::Mutex> > AudioSource::_level_read_locks;
 bool AudioSource::_build_missing_peakfiles = false;
 
 /** true if we want peakfiles (e.g. if we are displaying a GUI) */
@@ -95,6 +98,7 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_pyramid_queued (false)
 {
 }
 
@@ -111,6 +115,7 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_pyramid_queued (false)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -197,6 +202,13 @@ AudioSource::peaks_ready (boost::function<void()> doThisWhenReady, ScopedConnect
 		PeaksReady.connect (**connect_here_if_not, MISSING_INVALIDATOR, doThisWhenReady, event_loop);
 	}
 
+	lm.release ();
+
+	if (!ret) {
+		/* someone is waiting to display this, build it next */
+		SourceFactory::prioritize_peakfile (boost::dynamic_pointer_cast<AudioSource> (const_cast<AudioSource*>(this)->shared_from_this ()));
+	}
+
 	return ret;
 }
 
@@ -214,7 +226,10 @@ AudioSource::touch_peakfile ()
 	tbuf.actime = statbuf.st_atime;
 	tbuf.modtime = time ((time_t*) 0);
 
-	g_utime (_peakpath.c_str(), &tbuf);
+	if (g_utime (_peakpath.c_str(), &tbuf) == 0) {
+		/* the data did not change, keep the pyramid valid */
+		PeakPyramid::retime (_peakpath, statbuf.st_mtime, tbuf.modtime);
+	}
 }
 
 int
@@ -224,6 +239,8 @@ AudioSource::rename_peakfile (string newpath)
 
 	string oldpath = _peakpath;
 
+	drop_peak_pyramid ();
+
 	if (Glib::file_test (oldpath, Glib::FILE_TEST_EXISTS)) {
 		if (g_rename (oldpath.c_str(), newpath.c_str()) != 0) {
 			error << string_compose (_("cannot rename peakfile for %1 from %2 to %3 (%4)"), _name, oldpath, newpath, strerror (errno)) << endmsg;
@@ -231,6 +248,11 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	/* renaming keeps the size and mtime of the peakfile, so the
+	 * pyramid remains valid if it moves along.
+	 */
+	g_rename (PeakPyramid::pyramid_path (oldpath).c_str(), PeakPyramid::pyramid_path (newpath).c_str());
+
 	_peakpath = newpath;
 
 	return 0;
@@ -452,6 +474,21 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		return 0;
 	}
 
+	if (scale <= 1.0 && samples_per_file_peak == _FPP && _peaks_built && _peakfile_fd < 0) {
+
+		/* serve from the mapped peakfile, or the closest coarser level */
+
+		boost::shared_ptr<PeakPyramid> pyr (peak_pyramid ());
+
+		if (pyr && pyr->read (peaks, read_npeaks, start, samples_per_visual_peak)) {
+			DEBUG_TRACE (DEBUG::Peaks, "MAPPED PEAKS\n");
+			if (zero_fill) {
+				memset (&peaks[read_npeaks], 0, sizeof (PeakData) * zero_fill);
+			}
+			return 0;
+		}
+	}
+
 	if (scale == 1.0) {
 		off_t first_peak_byte = (start / samples_per_file_peak) * sizeof (PeakData);
 		size_t bytes_to_read = sizeof (PeakData) * read_npeaks;
@@ -722,7 +759,8 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 int
 AudioSource::build_peaks_from_scratch ()
 {
-	const samplecnt_t bufsize = 65536; // 256kB per disk read for mono data is about ideal
+	/* whole peaks only, so that nothing is left over between reads */
+	const samplecnt_t bufsize = std::max ((samplecnt_t) _FPP, peak_build_chunk_size () & ~((samplecnt_t) _FPP - 1));
 
 	DEBUG_TRACE (DEBUG::Peaks, "Building peaks from scratch\n");
 
@@ -787,7 +825,7 @@ AudioSource::build_peaks_from_scratch ()
   out:
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
-		::g_unlink (_peakpath.c_str());
+		unlink_peakfile ();
 	}
 
 	return ret;
@@ -802,12 +840,78 @@ AudioSource::close_peakfile ()
 		_peakfile_fd = -1;
 	}
 	if (!_peakpath.empty()) {
-		::g_unlink (_peakpath.c_str());
+		unlink_peakfile ();
 	}
 	_peaks_built = false;
 	return 0;
 }
 
+int
+AudioSource::unlink_peakfile ()
+{
+	drop_peak_pyramid ();
+	::g_unlink (PeakPyramid::pyramid_path (_peakpath).c_str());
+	return ::g_unlink (_peakpath.c_str());
+}
+
+boost::shared_ptr<PeakPyramid>
+AudioSource::peak_pyramid () const
+{
+	Glib::Threads::Mutex::Lock lm (_peak_pyramid_lock);
+
+	if (_peak_pyramid) {
+		return _peak_pyramid;
+	}
+
+	boost::shared_ptr<PeakPyramid> pyr (new PeakPyramid (_peakpath, _FPP));
+
+	if (pyr->open ()) {
+		return boost::shared_ptr<PeakPyramid> ();
+	}
+
+	if (pyr->needs_build () && !_peak_pyramid_queued && _build_peakfiles) {
+		/* keep using level 0 until it is done */
+		_peak_pyramid_queued = true;
+		SourceFactory::build_peak_pyramid (boost::dynamic_pointer_cast<AudioSource> (const_cast<AudioSource*>(this)->shared_from_this ()));
+	}
+
+	_peak_pyramid = pyr;
+	return pyr;
+}
+
+void
+AudioSource::drop_peak_pyramid ()
+{
+	Glib::Threads::Mutex::Lock lm (_peak_pyramid_lock);
+	_peak_pyramid.reset ();
+	_peak_pyramid_queued = false;
+}
+
+int
+AudioSource::build_peak_pyramid ()
+{
+	string peakpath;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (!_peaks_built || _peakfile_fd >= 0 || _session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
+			return -1;
+		}
+		peakpath = _peakpath;
+	}
+
+	if (PeakPyramid::build (peakpath, _FPP)) {
+		/* leave _peak_pyramid_queued set, so that we don't retry
+		 * until the peakfile is written again.
+		 */
+		return -1;
+	}
+
+	/* re-open with all levels on the next read */
+	drop_peak_pyramid ();
+	return 0;
+}
+
 int
 AudioSource::prepare_for_peakfile_writes ()
 {
@@ -815,6 +919,8 @@ AudioSource::prepare_for_peakfile_writes ()
 		return -1;
 	}
 
+	drop_peak_pyramid ();
+
 	if ((_peakfile_fd = g_open (_peakpath.c_str(), O_CREAT|O_RDWR, 0664)) < 0) {
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
@@ -1139,4 +1245,9 @@ AudioSource::ensure_buffers_for_level_locked (uint32_t level, samplecnt_t sample
 		_mixdown_buffers.push_back (boost::shared_array<Sample> (new Sample[nframes]));
 		_gain_buffers.push_back (boost::shared_array<gain_t> (new gain_t[nframes]));
 	}
+
+	/* readers may still hold the lock of a level they copied, keep those */
+	while (_level_read_locks.size() < limit) {
+		_level_read_locks.push_back (boost::shared_ptr<Glib::Threads::Mutex> (new Glib::Threads::Mutex));
+	}
 }
@@ -390,8 +390,8 @@ Automatable::non_realtime_locate (samplepos_t now)
 				const bool list_did_write = !l->in_new_write_pass ();
 				c->stop_touch (-1); // time is irrelevant
 				l->stop_touch (-1);
-				c->commit_transaction (list_did_write);
 				l->write_pass_finished (now, Config->get_automation_thinning_factor ());
+				c->commit_transaction (list_did_write);
 
 				if (l->automation_state () == Write) {
 					l->set_automation_state (Touch);
@@ -437,10 +437,13 @@ Automatable::non_realtime_transport_stop (samplepos_t now, bool /*flush_processo
 		c->stop_touch (now);
 		l->stop_touch (now);
 
-		c->commit_transaction (list_did_write);
-
+		/* thin the list before the undo record is taken, which
+		 * has to match the list's state
+		 */
 		l->write_pass_finished (now, Config->get_automation_thinning_factor ());
 
+		c->commit_transaction (list_did_write);
+
 		if (l->automation_state () == Write) {
 			l->set_automation_state (Touch);
 		}
@@ -658,10 +661,26 @@ Automatable::find_next_ac_event (boost::shared_ptr<AutomationControl> c, double
 		return;
 	}
 
-	for (i = lower_bound (alist->begin(), alist->end(), &cp, Evoral::ControlList::time_comparator); i != alist->end() && (*i)->when < end; ++i) {
-		if ((*i)->when > start) {
+	i = lower_bound (alist->begin(), alist->end(), &cp, Evoral::ControlList::time_comparator);
+
+	/* the value of the last point at or before start */
+	double value = 0;
+	if (i != alist->begin()) {
+		Evoral::ControlList::const_iterator p = i;
+		value = (*--p)->value;
+	} else if (i != alist->end()) {
+		value = (*i)->value;
+	}
+
+	for (; i != alist->end() && (*i)->when < end; ++i) {
+		/* points at the end of a constant segment do not change the
+		 * value that was set at the start of the cycle, don't split
+		 * the cycle there.
+		 */
+		if ((*i)->when > start && (*i)->value != value) {
 			break;
 		}
+		value = (*i)->value;
 	}
 
 	if (i != alist->end() && (*i)->when < end) {
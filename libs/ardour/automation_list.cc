@@ -28,6 +28,7 @@
 #include <sstream>
 #include <algorithm>
 #include "ardour/automation_list.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/beats_samples_converter.h"
 #include "ardour/event_type_map.h"
 #include "ardour/parameter_descriptor.h"
@@ -47,6 +48,7 @@ using namespace ARDOUR;
 using namespace PBD;
 
 PBD::Signal1<void,AutomationList *> AutomationList::AutomationListCreated;
+PBD::Signal0<void> AutomationList::DropEventsCaches;
 
 #if 0
 static void dumpit (const AutomationList& al, string prefix = "")
@@ -167,6 +169,11 @@ AutomationList::create_curve_if_necessary()
 	}
 
 	WritePassStarted.connect_same_thread (_writepass_connection, boost::bind (&AutomationList::snapshot_history, this, false));
+
+	/* all changes to the events go through mark_dirty() */
+	Dirty.connect_same_thread (_state_connections, boost::bind (&AutomationList::state_changed, this));
+	InterpolationChanged.connect_same_thread (_state_connections, boost::bind (&AutomationList::state_changed, this));
+	DropEventsCaches.connect_same_thread (_state_connections, boost::bind (&AutomationList::drop_events_cache, this));
 }
 
 AutomationList&
@@ -180,6 +187,7 @@ AutomationList::operator= (const AutomationList& other)
 		ControlList::operator= (other);
 		_state = other._state;
 		_touching = other._touching;
+		state_changed ();
 		ControlList::thaw ();
 	}
 
@@ -213,6 +221,7 @@ AutomationList::set_automation_state (AutoState s)
 			return;
 		}
 		_state = s;
+		state_changed ();
 		if (s == Write && _desc.toggled) {
 			snapshot_history (true);
 		}
@@ -338,6 +347,18 @@ AutomationList::paste (const ControlList& alist, double pos, DoubleBeatsSamplesC
 Command*
 AutomationList::memento_command (XMLNode* before, XMLNode* after)
 {
+	if (before && after) {
+		/* the difference can only be spliced into the state it was
+		 * taken from, otherwise keep both states in full.
+		 */
+		XMLNode& current (get_state ());
+		const bool is_current = (current == *after);
+		delete &current;
+
+		if (is_current) {
+			return new AutomationListDiffCommand (*this, before, after);
+		}
+	}
 	return new MementoCommand<AutomationList> (*this, before, after);
 }
 
@@ -385,29 +406,73 @@ XMLNode&
 AutomationList::serialize_events (bool need_lock)
 {
 	XMLNode* node = new XMLNode (X_("events"));
-	stringstream str;
+	std::string str;
+	char buf[64];
+
+	/* XML is a bit wierd */
+
+	XMLNode* content_node = new XMLNode (X_("foo")); /* it gets renamed by libxml when we set content */
+	node->add_child_nocopy (*content_node);
 
 	Glib::Threads::RWLock::ReaderLock lm (Evoral::ControlList::_lock, Glib::Threads::NOT_LOCK);
 	if (need_lock) {
 		lm.acquire ();
 	}
-	for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
-		str << PBD::to_string ((*xx)->when);
-		str << ' ';
-		str << PBD::to_string ((*xx)->value);
-		str << '\n';
+
+	/* formatting the events is the largest share of saving automation,
+	 * keep the text until they change. Not during a write pass though,
+	 * the events are changing as we speak.
+	 */
+	const bool cache = !in_write_pass ();
+	const gint generation = state_generation ();
+
+	if (cache) {
+		Glib::Threads::Mutex::Lock cl (_events_cache_lock);
+		if (!state_dirty ()) {
+			content_node->set_content (_events_cache);
+			return *node;
+		}
 	}
 
-	/* XML is a bit wierd */
+	/* this can be millions of points, format them in place */
+	str.reserve (_events.size () * 32);
+	for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
+		str.append (buf, PBD::double_to_cstr ((*xx)->when, buf, sizeof (buf)));
+		str += ' ';
+		str.append (buf, PBD::double_to_cstr ((*xx)->value, buf, sizeof (buf)));
+		str += '\n';
+	}
 
-	XMLNode* content_node = new XMLNode (X_("foo")); /* it gets renamed by libxml when we set content */
-	content_node->set_content (str.str());
+	content_node->set_content (str);
 
-	node->add_child_nocopy (*content_node);
+	if (cache) {
+		Glib::Threads::Mutex::Lock cl (_events_cache_lock);
+		_events_cache.swap (str);
+		state_cached (generation);
+	}
 
 	return *node;
 }
 
+void
+AutomationList::drop_events_caches ()
+{
+	DropEventsCaches (); /* EMIT SIGNAL */
+}
+
+/* The text is reused by get_state() calls between saves (e.g. undo
+ * mementos of edits), and by the next save if the list did not change
+ * since. It is let go once the session is saved, rather than keeping a
+ * second copy of the events of every list for the session's lifetime.
+ */
+void
+AutomationList::drop_events_cache ()
+{
+	Glib::Threads::Mutex::Lock cl (_events_cache_lock);
+	std::string ().swap (_events_cache);
+	state_cached (0); /* no generation is 0, nothing is cached */
+}
+
 int
 AutomationList::deserialize_events (const XMLNode& node)
 {
@@ -539,6 +604,8 @@ AutomationList::set_state (const XMLNode& node, int version)
 		_state = Off;
 	}
 
+	state_changed ();
+
 	bool have_events = false;
 
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
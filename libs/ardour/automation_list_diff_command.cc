@@ -0,0 +1,237 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/types_convert.h"
+#include "pbd/xml++.h"
+
+#include "ardour/automation_list.h"
+#include "ardour/automation_list_diff_command.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+/** @return the serialized events of AutomationList state @param node,
+ *  which are removed from the node.
+ */
+static string
+take_events (XMLNode* node)
+{
+	string str;
+	XMLNode* events = node->child (X_("events"));
+
+	if (events && !events->children ().empty ()) {
+		str = events->children ().front ()->content ();
+	}
+
+	node->remove_nodes_and_delete (X_("events"));
+	return str;
+}
+
+static string
+content_of (XMLNode const* node)
+{
+	if (!node || node->children ().empty ()) {
+		return string ();
+	}
+	return node->children ().front ()->content ();
+}
+
+static bool
+line_start (string const& str, size_t pos)
+{
+	return pos == 0 || str[pos - 1] == '\n';
+}
+
+AutomationListDiffCommand::AutomationListDiffCommand (AutomationList& al, XMLNode* before, XMLNode* after)
+	: _binder (new SimpleMementoCommandBinder<AutomationList> (al))
+	, _before (0)
+	, _after (0)
+	, _offset (0)
+{
+	init (before, after);
+}
+
+AutomationListDiffCommand::AutomationListDiffCommand (MementoCommandBinder<AutomationList>* b, XMLNode* before, XMLNode* after)
+	: _binder (b)
+	, _before (0)
+	, _after (0)
+	, _offset (0)
+{
+	init (before, after);
+}
+
+AutomationListDiffCommand::AutomationListDiffCommand (MementoCommandBinder<AutomationList>* b, XMLNode const& node)
+	: _binder (b)
+	, _before (0)
+	, _after (0)
+	, _offset (0)
+{
+	node.get_property (X_("offset"), _offset);
+
+	for (XMLNodeConstIterator i = node.children ().begin (); i != node.children ().end (); ++i) {
+		if ((*i)->name () == X_("AutomationList")) {
+			if (!_before) {
+				_before = new XMLNode (**i);
+			} else {
+				_after = new XMLNode (**i);
+			}
+		} else if ((*i)->name () == X_("Removed")) {
+			_removed = content_of (*i);
+		} else if ((*i)->name () == X_("Added")) {
+			_added = content_of (*i);
+		}
+	}
+
+	if (!_after) {
+		/* should never happen, but keep undo/redo harmless */
+		_after = _before ? new XMLNode (*_before) : 0;
+	}
+
+	_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&AutomationListDiffCommand::binder_dying, this));
+}
+
+AutomationListDiffCommand::~AutomationListDiffCommand ()
+{
+	drop_references ();
+	delete _before;
+	delete _after;
+	delete _binder;
+}
+
+void
+AutomationListDiffCommand::init (XMLNode* before, XMLNode* after)
+{
+	_before = before;
+	_after  = after;
+
+	string const a = take_events (_before);
+	string const b = take_events (_after);
+
+	/* keep whole lines (events), so that the history file remains readable */
+
+	size_t const n = min (a.size (), b.size ());
+	size_t pre = 0;
+
+	while (pre < n && a[pre] == b[pre]) {
+		++pre;
+	}
+	while (!line_start (a, pre)) {
+		--pre;
+	}
+
+	size_t suf = 0;
+
+	while (suf < n - pre && a[a.size () - suf - 1] == b[b.size () - suf - 1]) {
+		++suf;
+	}
+	while (suf > 0 && (!line_start (a, a.size () - suf) || !line_start (b, b.size () - suf))) {
+		--suf;
+	}
+
+	_offset  = pre;
+	_removed = a.substr (pre, a.size () - suf - pre);
+	_added   = b.substr (pre, b.size () - suf - pre);
+
+	_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&AutomationListDiffCommand::binder_dying, this));
+}
+
+void
+AutomationListDiffCommand::binder_dying ()
+{
+	delete this;
+}
+
+void
+AutomationListDiffCommand::operator() ()
+{
+	if (_after) {
+		apply (*_after, _removed, _added);
+	}
+}
+
+void
+AutomationListDiffCommand::undo ()
+{
+	if (_before) {
+		apply (*_before, _added, _removed);
+	}
+}
+
+void
+AutomationListDiffCommand::apply (XMLNode const& attributes, string const& from, string const& to)
+{
+	AutomationList* al = _binder->get ();
+	XMLNode* current = &al->get_state ();
+	string events = take_events (current);
+	delete current;
+
+	size_t const offset = _offset;
+
+	if (events.size () < offset + from.size () || events.compare (offset, from.size (), from) != 0) {
+		error << string_compose (_("Automation of %1 does not match its undo history, not changed"), al->id ()) << endmsg;
+		return;
+	}
+
+	events.replace (offset, from.size (), to);
+
+	XMLNode state (attributes);
+	if (!events.empty ()) {
+		state.add_child (X_("events"))->add_content (events);
+	}
+
+	al->set_state (state, Stateful::current_state_version);
+}
+
+XMLNode&
+AutomationListDiffCommand::get_state ()
+{
+	XMLNode* node = new XMLNode (X_("AutomationListDiffCommand"));
+
+	_binder->add_state (node);
+	node->set_property ("type-name", _binder->type_name ());
+	node->set_property ("offset", _offset);
+
+	if (_before) {
+		node->add_child_copy (*_before);
+	}
+	if (_after) {
+		node->add_child_copy (*_after);
+	}
+
+	XMLNode* removed = node->add_child (X_("Removed"));
+	if (!_removed.empty ()) {
+		removed->add_content (_removed);
+	}
+	XMLNode* added = node->add_child (X_("Added"));
+	if (!_added.empty ()) {
+		added->add_content (_added);
+	}
+
+	return *node;
+}
+
+bool
+AutomationListDiffCommand::empty () const
+{
+	return _removed.empty () && _added.empty () && _before && _after && *_before == *_after;
+}
@@ -484,6 +484,40 @@ BufferSet::merge_from (const BufferSet& in, samplecnt_t nframes)
 	}
 }
 
+/** Merge all of the sets @a in into our existing buffers, as merge_from()
+ * for each of them, but merge the MIDI buffers of all sets at once.
+ */
+void
+BufferSet::merge_from (BufferSet const* const* in, size_t n_in, samplecnt_t nframes)
+{
+	for (size_t n = 0; n < n_in; ++n) {
+		BufferSet::iterator o = begin (DataType::AUDIO);
+		for (BufferSet::const_iterator i = in[n]->begin (DataType::AUDIO); i != in[n]->end (DataType::AUDIO) && o != end (DataType::AUDIO); ++i, ++o) {
+			o->merge_from (*i, nframes);
+		}
+	}
+
+	for (size_t b = 0; b < _count.n_midi(); ++b) {
+		MidiBuffer const* srcs[MidiBuffer::max_merge_sources];
+		size_t n_srcs = 0;
+
+		for (size_t n = 0; n < n_in; ++n) {
+			if (b >= in[n]->count().n_midi()) {
+				continue;
+			}
+			srcs[n_srcs++] = &in[n]->get_midi (b);
+			if (n_srcs == MidiBuffer::max_merge_sources) {
+				get_midi (b).merge_in_place (srcs, n_srcs);
+				n_srcs = 0;
+			}
+		}
+
+		if (n_srcs) {
+			get_midi (b).merge_in_place (srcs, n_srcs);
+		}
+	}
+}
+
 void
 BufferSet::silence (samplecnt_t nframes, samplecnt_t offset)
 {
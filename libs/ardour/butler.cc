@@ -28,15 +28,26 @@
 #include <poll.h>
 #endif
 
+#include <algorithm>
+
+#include <boost/scoped_array.hpp>
+
+#include <glibmm/miscutils.h>
+
 #include "pbd/error.h"
+#include "pbd/mountpoint.h"
 #include "pbd/pthread_utils.h"
 
 #include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
 #include "ardour/disk_reader.h"
+#include "ardour/file_source.h"
 #include "ardour/io.h"
+#include "ardour/playlist.h"
+#include "ardour/region.h"
 #include "ardour/session.h"
+#include "ardour/session_directory.h"
 #include "ardour/track.h"
 #include "ardour/auditioner.h"
 
@@ -54,6 +65,12 @@ Butler::Butler(Session& s)
 	, audio_dstream_playback_buffer_size(0)
 	, midi_dstream_buffer_size(0)
 	, pool_trash(16)
+	, _io_track_queue_invalid (0)
+	, _io_generation (0)
+	, _io_busy (0)
+	, _io_open (false)
+	, _io_quit (false)
+	, _io_stats_reset (0)
 	, _xthread (true)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
@@ -61,6 +78,9 @@ Butler::Butler(Session& s)
 
         /* catch future changes to parameters */
         Config->ParameterChanged.connect_same_thread (*this, boost::bind (&Butler::config_changed, this, _1));
+
+	/* the first source of a track may be a different one now */
+	Source::SourcePropertyChanged.connect_same_thread (*this, boost::bind (&Butler::invalidate_io_queues, this));
 }
 
 Butler::~Butler()
@@ -131,6 +151,8 @@ Butler::start_thread()
 	//pthread_detach (thread);
 	have_thread = true;
 
+	start_io_threads ();
+
 	// we are ready to request buffer adjustments
 	_session.adjust_capture_buffering ();
 	_session.adjust_playback_buffering ();
@@ -147,6 +169,7 @@ Butler::terminate_thread ()
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
 	}
+	terminate_io_threads ();
 }
 
 void *
@@ -163,7 +186,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -204,8 +226,15 @@ Butler::thread_work ()
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
 		disk_work_outstanding = false;
 
+		if (g_atomic_int_compare_and_exchange (&_io_stats_reset, 1, 0)) {
+			_io_stats.reset ();
+		}
+		_io_stats.start ();
+
 		if (transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, string_compose ("do transport work @ %1\n", g_get_monotonic_time()));
+			/* may have changed playlists or the position, find out again which device tracks read from */
+			_io_routes.reset ();
 			_session.butler_transport_work ();
 			DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttransport work complete @ %1, twr = %2\n", g_get_monotonic_time(), transport_work_requested()));
 		}
@@ -219,58 +248,12 @@ Butler::thread_work ()
 			_session.the_auditioner()->seek_response(audition_seek);
 		}
 
-		boost::shared_ptr<RouteList> rl = _session.get_routes();
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts disk i/o, twr = %1\n", transport_work_requested()));
 
-		RouteList rl_with_auditioner = *rl;
-		rl_with_auditioner.push_back (_session.the_auditioner());
-
-		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
-
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
+		queue_io (_session.get_routes());
+		disk_work_outstanding = run_io (err);
 
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
-		}
-
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
-		}
-
-		if (!err && transport_work_requested()) {
-			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
-			goto restart;
-		}
-
-		disk_work_outstanding = disk_work_outstanding || flush_tracks_to_disk_normal (rl, err);
+		_io_stats.update ();
 
 		if (err && _session.actively_recording()) {
 			/* stop the transport and try to catch as much possible
@@ -281,7 +264,7 @@ Butler::thread_work ()
 		}
 
 		if (!err && transport_work_requested()) {
-			DEBUG_TRACE (DEBUG::Butler, "transport work requested during flush, back to restart\n");
+			DEBUG_TRACE (DEBUG::Butler, "transport work requested during disk i/o, back to restart\n");
 			goto restart;
 		}
 
@@ -309,14 +292,166 @@ Butler::thread_work ()
 	return (0);
 }
 
-bool
-Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+void
+Butler::start_io_threads ()
 {
-	bool disk_work_outstanding = false;
+	const uint32_t n = Config->get_butler_io_threads ();
 
-	for (RouteList::iterator i = rl->begin(); !transport_work_requested() && should_run && i != rl->end(); ++i) {
+	_io_quit = false;
 
-		// cerr << "write behind for " << (*i)->name () << endl;
+	for (uint32_t i = 0; i < n; ++i) {
+		IOThread* t = new IOThread (this, i);
+		if (pthread_create_and_store ("disk io", &t->thread, _io_thread_work, t)) {
+			error << _("Session: could not create disk i/o thread") << endmsg;
+			delete t;
+			break;
+		}
+		_io_threads.push_back (t);
+	}
+}
+
+void
+Butler::terminate_io_threads ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_io_lock);
+		_io_quit = true;
+		_io_start.broadcast ();
+	}
+
+	for (std::vector<IOThread*>::iterator i = _io_threads.begin(); i != _io_threads.end(); ++i) {
+		void* status;
+		pthread_join ((*i)->thread, &status);
+		delete *i;
+	}
+
+	_io_threads.clear ();
+}
+
+void*
+Butler::_io_thread_work (void* arg)
+{
+	IOThread* t = (IOThread*) arg;
+	SessionEvent::create_per_thread_pool ("butler i/o events", 64);
+	pthread_set_name (X_("disk io"));
+	t->butler->io_thread_work (t->id);
+	return 0;
+}
+
+void
+Butler::io_thread_work (uint32_t id)
+{
+	/* the butler thread uses DiskReader's static working buffers, each I/O thread needs its own */
+	boost::scoped_array<Sample> sum_buffer (new Sample[DiskReader::working_buffer_size ()]);
+	boost::scoped_array<Sample> mixdown_buffer (new Sample[DiskReader::working_buffer_size ()]);
+	boost::scoped_array<gain_t> gain_buffer (new gain_t[DiskReader::working_buffer_size ()]);
+
+	uint32_t seen = 0;
+
+	Glib::Threads::Mutex::Lock lm (_io_lock);
+
+	while (true) {
+		while (!_io_quit && (!_io_open || _io_generation == seen)) {
+			_io_start.wait (_io_lock);
+		}
+
+		if (_io_quit) {
+			break;
+		}
+
+		seen = _io_generation;
+		++_io_busy;
+		lm.release ();
+
+		io_work (id, sum_buffer.get(), mixdown_buffer.get(), gain_buffer.get());
+
+		lm.acquire ();
+		if (--_io_busy == 0) {
+			_io_idle.signal ();
+		}
+	}
+}
+
+/** @return the index of the queue for the device that @param tr reads from,
+ *  which is the one of the first region's source, or of the session's
+ *  sound folder if it has none (new recordings go there).
+ */
+uint32_t
+Butler::io_queue_for (boost::shared_ptr<Track> tr)
+{
+	std::map<PBD::ID, uint32_t>::const_iterator i = _io_track_queue.find (tr->id ());
+
+	if (i != _io_track_queue.end ()) {
+		return i->second;
+	}
+
+	std::string path = _session.session_directory().sound_path ();
+	boost::shared_ptr<Playlist> pl = tr->playlist ();
+
+	if (pl) {
+		boost::shared_ptr<RegionList> regions = pl->region_list ();
+		for (RegionList::const_iterator r = regions->begin(); r != regions->end(); ++r) {
+			boost::shared_ptr<FileSource> fs = boost::dynamic_pointer_cast<FileSource> ((*r)->source (0));
+			if (fs) {
+				path = Glib::path_get_dirname (fs->path ());
+				break;
+			}
+		}
+	}
+
+	std::string const mp = mountpoint (path);
+	std::map<std::string, uint32_t>::const_iterator d = _io_devices.find (mp);
+	uint32_t q;
+
+	if (d == _io_devices.end ()) {
+		q = _io_devices.size ();
+		_io_devices.insert (std::make_pair (mp, q));
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("disk i/o queue %1 for %2\n", q, mp));
+	} else {
+		q = d->second;
+	}
+
+	_io_track_queue[tr->id ()] = q;
+
+	tr->PlaylistChanged.connect_same_thread (_io_track_connections, boost::bind (&Butler::invalidate_io_queues, this));
+	if (pl) {
+		pl->RegionAdded.connect_same_thread (_io_track_connections, boost::bind (&Butler::invalidate_io_queues, this));
+		pl->RegionRemoved.connect_same_thread (_io_track_connections, boost::bind (&Butler::invalidate_io_queues, this));
+	}
+
+	return q;
+}
+
+/** Find out again which device tracks read from, on the next pass.
+ *  Called from any thread.
+ */
+void
+Butler::invalidate_io_queues ()
+{
+	g_atomic_int_set (&_io_track_queue_invalid, 1);
+}
+
+void
+Butler::queue_io (boost::shared_ptr<RouteList> rl)
+{
+	if (g_atomic_int_compare_and_exchange (&_io_track_queue_invalid, 1, 0) || _io_routes.lock () != rl) {
+		/* tracks were added or removed, their playlists or regions
+		 * changed, or transport work happened
+		 */
+		_io_track_connections.drop_connections ();
+		_io_track_queue.clear ();
+		_io_routes = rl;
+	}
+
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+		q->jobs.clear ();
+		g_atomic_int_set (&q->next, 0);
+	}
+
+	RouteList rl_with_auditioner = *rl;
+	rl_with_auditioner.push_back (_session.the_auditioner());
+
+	for (RouteList::iterator i = rl_with_auditioner.begin(); i != rl_with_auditioner.end(); ++i) {
 
 		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -324,31 +459,151 @@ Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t&
 			continue;
 		}
 
-		/* note that we still try to flush diskstreams attached to inactive routes
+		uint32_t const q = io_queue_for (tr);
+
+		if (q >= _io_queues.size ()) {
+			_io_queues.resize (q + 1);
+			g_atomic_int_set (&_io_queues[q].next, 0);
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		/* don't read inactive tracks */
+		bool const refill = !io || io->active();
+		/* note that we still try to flush diskstreams attached to inactive routes */
+		bool const flush = *i != _session.the_auditioner();
+
+		float urgency = 1.f;
+		if (refill) {
+			urgency = tr->playback_buffer_load ();
+		}
+		if (flush) {
+			urgency = std::min (urgency, 1.f - tr->capture_buffer_load ());
+		}
+
+		if (refill || flush) {
+			_io_queues[q].jobs.push_back (IOJob (tr, refill, flush, urgency));
+		}
+	}
+
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+		std::stable_sort (q->jobs.begin(), q->jobs.end());
+	}
+}
+
+/** Work on the queues until they are all drained, starting with @param first_queue.
+ *  Called by the butler and all I/O threads during a pass of run_io().
+ *  Without working buffers, DiskReader's (butler-only) static ones are used.
+ */
+void
+Butler::io_work (uint32_t first_queue, Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	size_t const n_queues = _io_queues.size ();
+
+	for (size_t n = 0; n < n_queues; ++n) {
+
+		IOQueue& q = _io_queues[(first_queue + n) % n_queues];
+		gint     j;
+
+		while ((j = g_atomic_int_add (&q.next, 1)) < (gint) q.jobs.size ()) {
+
+			if (transport_work_requested() || !should_run) {
+				/* leave the rest for the next time around */
+				continue;
+			}
+
+			IOJob& job (q.jobs[j]);
+
+			if (job.refill) {
+				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", job.track->name(), job.track->playback_buffer_load()));
+				if (sum_buffer) {
+					job.refill_result = job.track->do_refill (sum_buffer, mixdown_buffer, gain_buffer);
+				} else {
+					job.refill_result = job.track->do_refill ();
+				}
+			}
+
+			if (job.flush) {
+				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", job.track->name(), job.track->capture_buffer_load()));
+				job.flush_result = job.track->do_flush (ButlerContext, false);
+			}
+
+			job.done = true;
+		}
+	}
+}
+
+/** Run all queued refills and flushes.
+ *  @return true if there is more disk work to do.
+ */
+bool
+Butler::run_io (uint32_t& errors)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_io_lock);
+		++_io_generation;
+		_io_open = true;
+		_io_start.broadcast ();
+	}
+
+	io_work (_io_threads.size (), 0, 0, 0);
+
+	{
+		/* once the butler found all queues empty, all jobs are either done
+		 * or being worked on by a busy I/O thread.
 		 */
+		Glib::Threads::Mutex::Lock lm (_io_lock);
+		while (_io_busy > 0) {
+			_io_idle.wait (_io_lock);
+		}
+		_io_open = false;
+	}
 
-		int ret;
+	bool disk_work_outstanding = false;
 
-		// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
-		ret = tr->do_flush (ButlerContext, false);
-		switch (ret) {
-		case 0:
-			//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
-			break;
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+		for (std::vector<IOJob>::iterator j = q->jobs.begin(); j != q->jobs.end(); ++j) {
 
-		case 1:
-			//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
-			disk_work_outstanding = true;
-			break;
+			if (!j->done) {
+				/* we didn't get to all the streams */
+				disk_work_outstanding = true;
+				continue;
+			}
 
-		default:
-			errors++;
-			error << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << endmsg;
-			std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << std::endl;
-			/* don't break - try to flush all streams in case they
-			   are split across disks.
-			*/
+			switch (j->refill_result) {
+			case 0:
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", j->track->name()));
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				error << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << std::endl;
+				break;
+			}
+
+			switch (j->flush_result) {
+			case 0:
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack flush unfinished %1\n", j->track->name()));
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				errors++;
+				error << string_compose(_("Butler write-behind failure on dstream %1"), j->track->name()) << endmsg;
+				std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), j->track->name()) << std::endl;
+				break;
+			}
 		}
+
+		/* don't keep tracks alive until the next pass */
+		q->jobs.clear ();
 	}
 
 	return disk_work_outstanding;
@@ -430,6 +685,12 @@ Butler::queue_request (Request::Type r)
 	}
 }
 
+void
+Butler::clear_io_stats ()
+{
+	g_atomic_int_set (&_io_stats_reset, 1);
+}
+
 void
 Butler::summon ()
 {
@@ -0,0 +1,617 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include <sndfile.h>
+
+#include <glibmm/threads.h>
+
+#include "pbd/compose.h"
+#include "pbd/malign.h"
+
+#include "ardour/debug.h"
+#include "ardour/direct_file_reader.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+#ifdef HAVE_LIBURING
+
+/* One ring for all readers. Submission and completion are
+ * locked separately, a thread that waits for its own request
+ * reaps (and flags) whatever completes in the mean time.
+ */
+static struct io_uring      ring;
+static bool                 ring_ok = false;
+static bool                 ring_initialized = false;
+static Glib::Threads::Mutex ring_init_lock;
+static Glib::Threads::Mutex ring_submit_lock;
+static Glib::Threads::Mutex ring_complete_lock;
+
+/* times to retry a submission which was interrupted */
+static const int max_submit_tries = 8;
+
+/* push out every queued sqe; call with ring_submit_lock held */
+static bool
+ring_submit_pending ()
+{
+	for (int tries = 0; io_uring_sq_ready (&ring) > 0; ++tries) {
+		if (tries == max_submit_tries) {
+			return false;
+		}
+		int const rv = io_uring_submit (&ring);
+		if (rv < 0 && rv != -EINTR && rv != -EAGAIN) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool
+ring_available ()
+{
+	Glib::Threads::Mutex::Lock lm (ring_init_lock);
+
+	if (!ring_initialized) {
+		ring_initialized = true;
+		int rv = io_uring_queue_init (256, &ring, 0);
+		ring_ok = (rv == 0);
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("io_uring %1 (%2)\n", ring_ok ? "available" : "not available", rv));
+	}
+
+	return ring_ok;
+}
+
+#endif
+
+bool
+DirectFileReader::async_available ()
+{
+#ifdef HAVE_LIBURING
+	return _async_enabled && ring_available ();
+#else
+	return false;
+#endif
+}
+
+bool
+DirectFileReader::submit (Request& req, int fd, void* buf, size_t len, off_t offset)
+{
+#ifdef HAVE_LIBURING
+	if (!async_available ()) {
+		return false;
+	}
+
+	Glib::Threads::Mutex::Lock lm (ring_submit_lock);
+
+	struct io_uring_sqe* sqe = io_uring_get_sqe (&ring);
+
+	if (!sqe) {
+		/* queue full, push out what is there and retry once */
+		ring_submit_pending ();
+		if (!(sqe = io_uring_get_sqe (&ring))) {
+			return false;
+		}
+	}
+
+	g_atomic_int_set (&req.done, 0);
+	req.result = 0;
+
+	io_uring_prep_read (sqe, fd, buf, len, offset);
+	io_uring_sqe_set_data (sqe, &req);
+
+	if (!ring_submit_pending ()) {
+		/* the sqe cannot be taken back, but the kernel does not look at
+		 * it before the next submit: turn it into a no-op that does not
+		 * refer to the request or the buffer, and let the caller read
+		 * synchronously instead of waiting for a read which never started.
+		 */
+		io_uring_prep_nop (sqe);
+		io_uring_sqe_set_data (sqe, 0);
+		g_atomic_int_set (&req.done, 1);
+		DEBUG_TRACE (DEBUG::AudioPlayback, "io_uring submit failed, reading synchronously\n");
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void
+DirectFileReader::wait (Request& req)
+{
+#ifdef HAVE_LIBURING
+	if (g_atomic_int_get (&req.done)) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (ring_complete_lock);
+
+	while (!g_atomic_int_get (&req.done)) {
+		{
+			/* the request went out when it was submitted, but no-ops
+			 * of failed submissions may still be queued
+			 */
+			Glib::Threads::Mutex::Lock sl (ring_submit_lock);
+			ring_submit_pending ();
+		}
+		struct io_uring_cqe* cqe;
+		int rv = io_uring_wait_cqe (&ring, &cqe);
+		if (rv < 0) {
+			continue;
+		}
+		Request* r = (Request*) io_uring_cqe_get_data (cqe);
+		if (r) {
+			r->result = cqe->res;
+		}
+		io_uring_cqe_seen (&ring, cqe);
+		if (r) {
+			g_atomic_int_set (&r->done, 1);
+		}
+	}
+#endif
+}
+
+static inline uint16_t rd16le (uint8_t const* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t rd32le (uint8_t const* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24); }
+static inline uint32_t rd32be (uint8_t const* p) { return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+static inline uint64_t rd64be (uint8_t const* p) { return ((uint64_t) rd32be (p) << 32) | rd32be (p + 4); }
+
+static bool
+read_at (int fd, off_t offset, void* buf, size_t len)
+{
+#ifdef PLATFORM_WINDOWS
+	return false;
+#else
+	ssize_t rv;
+	do {
+		rv = ::pread (fd, buf, len, offset);
+	} while (rv < 0 && errno == EINTR);
+	return rv == (ssize_t) len;
+#endif
+}
+
+/* maximum number of chunks to look at before "data" */
+static const int max_chunks = 64;
+
+bool
+DirectFileReader::probe_wav (int fd, off_t& data_offset, uint32_t& bits, bool& is_float, uint32_t& channels)
+{
+	uint8_t hdr[40];
+
+	if (!read_at (fd, 0, hdr, 12)) {
+		return false;
+	}
+
+	if ((memcmp (hdr, "RIFF", 4) && memcmp (hdr, "RF64", 4) && memcmp (hdr, "BW64", 4)) || memcmp (hdr + 8, "WAVE", 4)) {
+		return false;
+	}
+
+	off_t pos       = 12;
+	bool  found_fmt = false;
+
+	for (int n = 0; n < max_chunks; ++n) {
+		if (!read_at (fd, pos, hdr, 8)) {
+			return false;
+		}
+
+		uint32_t const size = rd32le (hdr + 4);
+
+		if (!memcmp (hdr, "fmt ", 4)) {
+			if (size < 16 || !read_at (fd, pos + 8, hdr, std::min<uint32_t> (size, 40))) {
+				return false;
+			}
+			uint16_t tag = rd16le (hdr);
+			if (tag == 0xfffe && size >= 26) {
+				/* WAVE_FORMAT_EXTENSIBLE, the tag is at the start of the sub-format GUID */
+				tag = rd16le (hdr + 24);
+			}
+			channels  = rd16le (hdr + 2);
+			bits      = rd16le (hdr + 14);
+			is_float  = (tag == 3);
+			found_fmt = (tag == 1 || tag == 3);
+			if (!found_fmt) {
+				return false;
+			}
+		} else if (!memcmp (hdr, "data", 4)) {
+			/* the size may be a placeholder (RF64), libsndfile knows the length */
+			data_offset = pos + 8;
+			return found_fmt;
+		}
+
+		pos += 8 + (off_t) size + (size & 1);
+	}
+
+	return false;
+}
+
+bool
+DirectFileReader::probe_caf (int fd, off_t& data_offset, uint32_t& bits, bool& is_float, bool& little_endian, uint32_t& channels)
+{
+	uint8_t hdr[32];
+
+	if (!read_at (fd, 0, hdr, 8) || memcmp (hdr, "caff", 4)) {
+		return false;
+	}
+
+	off_t pos        = 8;
+	bool  found_desc = false;
+
+	for (int n = 0; n < max_chunks; ++n) {
+		if (!read_at (fd, pos, hdr, 12)) {
+			return false;
+		}
+
+		int64_t const size = (int64_t) rd64be (hdr + 4);
+
+		if (!memcmp (hdr, "desc", 4)) {
+			if (size < 32 || !read_at (fd, pos + 12, hdr, 32)) {
+				return false;
+			}
+			if (memcmp (hdr + 8, "lpcm", 4)) {
+				return false;
+			}
+			uint32_t const flags = rd32be (hdr + 12);
+			is_float      = flags & 1;
+			little_endian = flags & 2;
+			channels      = rd32be (hdr + 24);
+			bits          = rd32be (hdr + 28);
+			found_desc    = true;
+		} else if (!memcmp (hdr, "data", 4)) {
+			/* the chunk starts with a 32 bit edit count */
+			data_offset = pos + 12 + 4;
+			return found_desc;
+		}
+
+		if (size < 0) {
+			/* only "data" may have an unspecified size */
+			return false;
+		}
+
+		pos += 12 + (off_t) size;
+	}
+
+	return false;
+}
+
+bool DirectFileReader::_async_enabled = true;
+
+DirectFileReader*
+DirectFileReader::create (int fd, int sf_format, uint32_t channels)
+{
+#ifdef PLATFORM_WINDOWS
+	return 0;
+#else
+	off_t    data_offset   = 0;
+	uint32_t bits          = 0;
+	bool     is_float      = false;
+	bool     little_endian = true;
+	uint32_t n_channels    = 0;
+	Encoding enc;
+
+	switch (sf_format & SF_FORMAT_SUBMASK) {
+		case SF_FORMAT_PCM_16:
+			enc = Int16;
+			break;
+		case SF_FORMAT_PCM_24:
+			enc = Int24;
+			break;
+		case SF_FORMAT_PCM_32:
+			enc = Int32;
+			break;
+		case SF_FORMAT_FLOAT:
+			enc = Float32;
+			break;
+		default:
+			return 0;
+	}
+
+	switch (sf_format & SF_FORMAT_TYPEMASK) {
+		case SF_FORMAT_WAV:
+		case SF_FORMAT_WAVEX:
+		case SF_FORMAT_RF64:
+			if ((sf_format & SF_FORMAT_ENDMASK) == SF_ENDIAN_BIG) {
+				/* RIFX */
+				return 0;
+			}
+			if (!probe_wav (fd, data_offset, bits, is_float, n_channels)) {
+				return 0;
+			}
+			break;
+		case SF_FORMAT_CAF:
+			if (!probe_caf (fd, data_offset, bits, is_float, little_endian, n_channels)) {
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+	}
+
+	/* both need to agree on what is in the file */
+	if (is_float != (enc == Float32) || n_channels != channels) {
+		return 0;
+	}
+
+	switch (enc) {
+		case Int16:
+			if (bits != 16) return 0;
+			break;
+		case Int24:
+			if (bits != 24) return 0;
+			break;
+		default:
+			if (bits != 32) return 0;
+			break;
+	}
+
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("direct reads for fd %1: data @ %2, %3 bits, %4 channels\n", fd, data_offset, bits, channels));
+
+	return new DirectFileReader (fd, data_offset, enc, little_endian, channels);
+#endif
+}
+
+DirectFileReader::DirectFileReader (int fd, off_t data_offset, Encoding enc, bool little_endian, uint32_t channels)
+	: _fd (fd)
+	, _data_offset (data_offset)
+	, _encoding (enc)
+	, _little_endian (little_endian)
+	, _channels (channels)
+	, _win (0)
+	, _win_frames (0)
+	, _win_start (0)
+	, _win_count (0)
+	, _win_req_frames (0)
+{
+	switch (enc) {
+		case Int16:
+			_bytes_per_frame = 2 * channels;
+			break;
+		case Int24:
+			_bytes_per_frame = 3 * channels;
+			break;
+		default:
+			_bytes_per_frame = 4 * channels;
+			break;
+	}
+}
+
+DirectFileReader::~DirectFileReader ()
+{
+	/* the kernel may still write into the window */
+	wait_for_prefetch ();
+	cache_aligned_free (_win);
+}
+
+ssize_t
+DirectFileReader::read_frames (uint8_t* buf, samplepos_t start, samplecnt_t cnt, samplecnt_t length) const
+{
+#ifdef PLATFORM_WINDOWS
+	return -1;
+#else
+	cnt = std::min (cnt, length - start);
+
+	if (cnt <= 0) {
+		return 0;
+	}
+
+	size_t const len    = cnt * _bytes_per_frame;
+	off_t const  offset = _data_offset + (off_t) start * _bytes_per_frame;
+	size_t       got    = 0;
+
+	while (got < len) {
+		ssize_t rv = ::pread (_fd, buf + got, len - got, offset + got);
+		if (rv < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		if (rv == 0) {
+			break;
+		}
+		got += rv;
+	}
+
+	return got / _bytes_per_frame;
+#endif
+}
+
+void
+DirectFileReader::decode (Sample* dst, uint8_t const* src, samplecnt_t cnt, uint32_t channel, gain_t gain) const
+{
+	const bool native = _little_endian == (G_BYTE_ORDER == G_LITTLE_ENDIAN);
+	const uint32_t stride = _bytes_per_frame;
+
+	switch (_encoding) {
+		case Float32:
+			src += channel * 4;
+			for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+				uint32_t v;
+				float    f;
+				memcpy (&v, src, 4);
+				if (!native) {
+					v = GUINT32_SWAP_LE_BE (v);
+				}
+				memcpy (&f, &v, 4);
+				dst[n] = f * gain;
+			}
+			break;
+
+		case Int16:
+			/* same scaling as libsndfile */
+			src += channel * 2;
+			for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+				uint16_t v;
+				memcpy (&v, src, 2);
+				if (!native) {
+					v = GUINT16_SWAP_LE_BE (v);
+				}
+				dst[n] = (float) (int16_t) v * (gain / 32768.f);
+			}
+			break;
+
+		case Int24:
+			src += channel * 3;
+			for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+				uint32_t v;
+				if (_little_endian) {
+					v = (src[0] << 8) | (src[1] << 16) | ((uint32_t) src[2] << 24);
+				} else {
+					v = (src[2] << 8) | (src[1] << 16) | ((uint32_t) src[0] << 24);
+				}
+				dst[n] = (float) (int32_t) v * (gain / 2147483648.f);
+			}
+			break;
+
+		case Int32:
+			src += channel * 4;
+			for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+				uint32_t v;
+				memcpy (&v, src, 4);
+				if (!native) {
+					v = GUINT32_SWAP_LE_BE (v);
+				}
+				dst[n] = (float) (int32_t) v * (gain / 2147483648.f);
+			}
+			break;
+	}
+}
+
+void
+DirectFileReader::wait_for_prefetch ()
+{
+	if (_win_req_frames == 0) {
+		return;
+	}
+
+	wait (_win_req);
+
+	if (_win_req.result < 0) {
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("read ahead failed (%1)\n", strerror (-_win_req.result)));
+		_win_count = 0;
+	} else {
+		_win_count = std::min ((samplecnt_t) (_win_req.result / _bytes_per_frame), _win_req_frames);
+	}
+
+	_win_req_frames = 0;
+}
+
+void
+DirectFileReader::prefetch (samplepos_t start, samplecnt_t length)
+{
+	wait_for_prefetch ();
+
+	samplecnt_t const cnt = std::min (_win_frames, length - start);
+
+	if (cnt <= 0) {
+		return;
+	}
+
+	_win_start = start;
+	_win_count = 0;
+
+	if (submit (_win_req, _fd, _win, cnt * _bytes_per_frame, _data_offset + (off_t) start * _bytes_per_frame)) {
+		_win_req_frames = cnt;
+	}
+}
+
+samplecnt_t
+DirectFileReader::read (Sample* dst, samplepos_t start, samplecnt_t cnt, samplecnt_t length,
+                        uint32_t channel, gain_t gain, void* scratch)
+{
+	if (!_win) {
+		_win_frames = window_frames;
+		cache_aligned_malloc ((void**) &_win, _win_frames * _bytes_per_frame);
+	}
+
+	if (_win_req_frames > 0 && start >= _win_start && start < _win_start + _win_req_frames) {
+		/* read ahead for exactly this */
+		wait_for_prefetch ();
+	}
+
+	samplecnt_t done = 0;
+
+	if (_win_req_frames == 0 && start >= _win_start && start < _win_start + _win_count) {
+		samplecnt_t const n = std::min (cnt, _win_start + _win_count - start);
+		decode (dst, _win + (start - _win_start) * _bytes_per_frame, n, channel, gain);
+		done = n;
+	}
+
+	if (done < cnt) {
+		samplepos_t const pos       = start + done;
+		samplecnt_t const remaining = cnt - done;
+
+		if (remaining < _win_frames) {
+			/* read a whole window, the next region or refill may continue here */
+			wait_for_prefetch ();
+
+			ssize_t const got = read_frames (_win, pos, _win_frames, length);
+
+			if (got < 0) {
+				_win_count = 0;
+				return done > 0 ? done : -1;
+			}
+
+			_win_start = pos;
+			_win_count = got;
+
+			samplecnt_t const n = std::min (remaining, (samplecnt_t) got);
+			decode (dst + done, _win, n, channel, gain);
+			done += n;
+
+		} else {
+			ssize_t const got = read_frames ((uint8_t*) scratch, pos, remaining, length);
+
+			if (got < 0) {
+				return done > 0 ? done : -1;
+			}
+
+			decode (dst + done, (uint8_t const*) scratch, got, channel, gain);
+			done += got;
+		}
+	}
+
+	samplepos_t const end = start + done;
+
+	if (end < length && async_available ()) {
+		bool const covered = (_win_req_frames > 0)
+			? (end >= _win_start && end < _win_start + _win_req_frames)
+			: (end >= _win_start && end < _win_start + _win_count);
+
+		if (!covered) {
+			prefetch (end, length);
+		}
+	}
+
+	return done;
+}
@@ -20,13 +20,13 @@
 #include <boost/smart_ptr/scoped_array.hpp>
 
 #include "pbd/enumwriter.h"
-#include "pbd/memento_command.h"
 #include "pbd/playback_buffer.h"
 
 #include "ardour/amp.h"
 #include "ardour/audioengine.h"
 #include "ardour/audioplaylist.h"
 #include "ardour/audio_buffer.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
@@ -101,9 +101,9 @@ DiskReader::allocate_working_buffers()
 	   need to reflect the maximum size we could use, which is 4MB reads, or 2M samples
 	   using 16 bit samples.
 	*/
-	_sum_buffer           = new Sample[2*1048576];
-	_mixdown_buffer       = new Sample[2*1048576];
-	_gain_buffer          = new gain_t[2*1048576];
+	_sum_buffer           = new Sample[working_buffer_size ()];
+	_mixdown_buffer       = new Sample[working_buffer_size ()];
+	_gain_buffer          = new gain_t[working_buffer_size ()];
 }
 
 void
@@ -823,9 +823,9 @@ DiskReader::_do_refill_with_alloc (bool partial_fill)
 	*/
 
 	{
-		boost::scoped_array<Sample> sum_buf (new Sample[2*1048576]);
-		boost::scoped_array<Sample> mix_buf (new Sample[2*1048576]);
-		boost::scoped_array<float>  gain_buf (new float[2*1048576]);
+		boost::scoped_array<Sample> sum_buf (new Sample[working_buffer_size ()]);
+		boost::scoped_array<Sample> mix_buf (new Sample[working_buffer_size ()]);
+		boost::scoped_array<float>  gain_buf (new float[working_buffer_size ()]);
 
 		int ret = refill_audio (sum_buf.get(), mix_buf.get(), gain_buf.get(), (partial_fill ? _chunk_samples : 0));
 
@@ -1071,7 +1071,7 @@ DiskReader::playlist_ranges_moved (list< Evoral::RangeMove<samplepos_t> > const
                 XMLNode & before = alist->get_state ();
                 bool const things_moved = alist->move_ranges (movements);
                 if (things_moved) {
-                        _session.add_command (new MementoCommand<AutomationList> (
+                        _session.add_command (new AutomationListDiffCommand (
                                                       *alist.get(), &before, &alist->get_state ()));
                 }
         }
@@ -1103,7 +1103,7 @@ DiskReader::move_processor_automation (boost::weak_ptr<Processor> p, list< Evora
 		bool const things_moved = al->move_ranges (movements);
 		if (things_moved) {
 			_session.add_command (
-				new MementoCommand<AutomationList> (
+				new AutomationListDiffCommand (
 					*al.get(), &before, &al->get_state ()
 					)
 				);
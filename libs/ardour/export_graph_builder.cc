@@ -41,10 +41,10 @@
 #include "audiographer/general/sample_format_converter.h"
 #include "audiographer/general/sr_converter.h"
 #include "audiographer/general/silence_trimmer.h"
+#include "audiographer/general/spill_buffer.h"
 #include "audiographer/general/threader.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
-#include "audiographer/sndfile/tmp_file_sync.h"
 #include "audiographer/sndfile/sndfile_writer.h"
 
 #include "ardour/audioengine.h"
@@ -55,6 +55,7 @@
 #include "ardour/export_graph_builder.h"
 #include "ardour/export_timespan.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/sndfile_helpers.h"
@@ -67,9 +68,12 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
+	, channel_groups_dirty (true)
+	, pending_groups (0)
 	, thread_pool (hardware_concurrency())
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
+	normalize_budget.reset (new MemoryBudget ((size_t) Config->get_export_normalize_ram () * 1048576));
 }
 
 ExportGraphBuilder::~ExportGraphBuilder ()
@@ -81,17 +85,133 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 {
 	assert(samples <= process_buffer_samples);
 
-	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
-		Sample const * process_buffer = 0;
-		it->first->read (process_buffer, samples);
-		ConstProcessContext<Sample> context(process_buffer, samples, 1);
-		if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
-		it->second->process (context);
+	if (channel_groups_dirty) {
+		update_channel_groups ();
+	}
+
+	if (_realtime || channel_groups.size () < 2) {
+		/* realtime export runs in the process callback, which must not
+		 * wait for the thread-pool. */
+		for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+			Sample const * process_buffer = 0;
+			it->first->read (process_buffer, samples);
+			ConstProcessContext<Sample> context(process_buffer, samples, 1);
+			if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+			it->second->process (context);
+		}
+		return 0;
+	}
+
+	/* read all channels in this thread, ports and region-readers are not
+	 * thread-safe, then run the (independent) encoder chains concurrently.
+	 */
+	for (ChannelGroups::iterator g = channel_groups.begin(); g != channel_groups.end(); ++g) {
+		for (std::vector<GroupChannel>::iterator c = g->begin(); c != g->end(); ++c) {
+			c->it->first->read (c->buffer, samples);
+		}
+	}
+
+	group_lock.lock ();
+	group_exception.reset ();
+
+	g_atomic_int_set (&pending_groups, channel_groups.size ());
+	for (size_t g = 0; g < channel_groups.size (); ++g) {
+		thread_pool.push (sigc::bind (sigc::mem_fun (*this, &ExportGraphBuilder::encode_channel_group), g, samples, last_cycle));
+	}
+
+	while (g_atomic_int_get (&pending_groups) != 0) {
+		group_cond.wait_until (group_lock, g_get_monotonic_time () + 500 * G_TIME_SPAN_MILLISECOND);
+	}
+
+	group_lock.unlock ();
+
+	if (group_exception) {
+		throw *group_exception;
 	}
 
 	return 0;
 }
 
+void
+ExportGraphBuilder::encode_channel_group (size_t group, samplecnt_t samples, bool last_cycle)
+{
+	try {
+		std::vector<GroupChannel> const & g (channel_groups[group]);
+		for (std::vector<GroupChannel>::const_iterator c = g.begin(); c != g.end(); ++c) {
+			ConstProcessContext<Sample> context(c->buffer, samples, 1);
+			if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+			c->it->second->process (context);
+		}
+	} catch (std::exception const & e) {
+		// Only first exception will be passed on
+		Glib::Threads::Mutex::Lock lm (group_exception_lock);
+		if (!group_exception) {
+			group_exception.reset (new ThreaderException (*this, e));
+		}
+	}
+
+	if (g_atomic_int_dec_and_test (&pending_groups)) {
+		Glib::Threads::Mutex::Lock lm (group_lock);
+		group_cond.signal ();
+	}
+}
+
+void
+ExportGraphBuilder::update_channel_groups ()
+{
+	/* channels feeding the same channel-config (interleaver) must be
+	 * processed in the same thread: union-find over channel-configs.
+	 */
+	std::vector<ChannelMap::iterator> chan;
+	std::map<ExportChannelPtr, size_t> index;
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+		index[it->first] = chan.size ();
+		chan.push_back (it);
+	}
+
+	std::vector<size_t> root (chan.size ());
+	for (size_t i = 0; i < root.size (); ++i) {
+		root[i] = i;
+	}
+
+	for (ChannelConfigList::const_iterator cc = channel_configs.begin(); cc != channel_configs.end(); ++cc) {
+		ExportChannelConfiguration::ChannelList const & cl = cc->channel_config()->get_channels();
+		size_t first = chan.size ();
+		for (ExportChannelConfiguration::ChannelList::const_iterator it = cl.begin(); it != cl.end(); ++it) {
+			std::map<ExportChannelPtr, size_t>::const_iterator i = index.find (*it);
+			if (i == index.end ()) {
+				continue;
+			}
+			size_t r = i->second;
+			while (root[r] != r) {
+				r = root[r];
+			}
+			if (first == chan.size ()) {
+				first = r;
+			} else if (r != first) {
+				root[r] = first;
+			}
+		}
+	}
+
+	channel_groups.clear ();
+	std::map<size_t, size_t> group_of_root;
+	for (size_t i = 0; i < chan.size (); ++i) {
+		size_t r = i;
+		while (root[r] != r) {
+			r = root[r];
+		}
+		std::map<size_t, size_t>::const_iterator g = group_of_root.find (r);
+		if (g == group_of_root.end ()) {
+			g = group_of_root.insert (std::make_pair (r, channel_groups.size ())).first;
+			channel_groups.push_back (std::vector<GroupChannel> ());
+		}
+		channel_groups[g->second].push_back (GroupChannel (chan[i]));
+	}
+
+	channel_groups_dirty = false;
+}
+
 bool
 ExportGraphBuilder::post_process ()
 {
@@ -124,7 +244,10 @@ ExportGraphBuilder::reset ()
 	channels.clear ();
 	intermediates.clear ();
 	analysis_map.clear();
+	channel_groups.clear ();
+	channel_groups_dirty = true;
 	_realtime = false;
+	normalize_budget.reset (new MemoryBudget ((size_t) Config->get_export_normalize_ram () * 1048576));
 }
 
 void
@@ -136,6 +259,8 @@ ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 		iter->remove_children(remove_out_files);
 		iter = channel_configs.erase(iter);
 	}
+	channel_groups.clear ();
+	channel_groups_dirty = true;
 }
 
 void
@@ -212,6 +337,7 @@ ExportGraphBuilder::add_split_config (FileSpec const & config)
 
 	// No duplicate channel config found, create new one
 	channel_configs.push_back (new ChannelConfig (*this, config, channels));
+	channel_groups_dirty = true;
 }
 
 /* Encoder */
@@ -512,7 +638,7 @@ ExportGraphBuilder::SFC::operator== (FileSpec const & other_config) const
 	return config.format->sample_format() == other_config.format->sample_format();
 }
 
-/* Intermediate (Normalizer, TmpFile) */
+/* Intermediate (Normalizer, TmpFile or SpillBuffer) */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, samplecnt_t max_samples)
 	: parent (parent)
@@ -545,28 +671,52 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 	normalizer->alloc_buffer (max_samples_out);
 	normalizer->add_output (threader);
 
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
-
 	if (parent._realtime) {
+		/* written by the disk-thread, the process callback must not allocate */
+		int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
 		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+
+		tmp_file->FileWritten.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::prepare_post_processing, this));
+		tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::start_post_processing, this));
 	} else {
-		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	}
+		/* keep the data in memory, only spill large exports to disk.
+		 * All normalized exports, which may run concurrently, share the memory.
+		 */
+		spill_buffer.reset (new SpillBuffer<float> (tmpfile_path, parent.normalize_budget));
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::start_post_processing, this));
+		spill_buffer->Written.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::prepare_post_processing, this));
+	}
 
 	add_child (new_config);
 
 	if (use_loudness) {
-		loudness_reader->add_output (tmp_file);
+		loudness_reader->add_output (storage ());
 	} else if (use_peak) {
-		peak_reader->add_output (tmp_file);
+		peak_reader->add_output (storage ());
 	}
 }
 
+ExportGraphBuilder::FloatSinkPtr
+ExportGraphBuilder::Intermediate::storage () const
+{
+	if (spill_buffer) {
+		return spill_buffer;
+	}
+	return tmp_file;
+}
+
+samplecnt_t
+ExportGraphBuilder::Intermediate::samples_stored () const
+{
+	if (spill_buffer) {
+		return spill_buffer->get_samples_written ();
+	}
+	return tmp_file->get_samples_written ();
+}
+
 ExportGraphBuilder::FloatSinkPtr
 ExportGraphBuilder::Intermediate::sink ()
 {
@@ -575,7 +725,7 @@ ExportGraphBuilder::Intermediate::sink ()
 	} else if (use_peak) {
 		return peak_reader;
 	}
-	return tmp_file;
+	return storage ();
 }
 
 void
@@ -619,14 +769,19 @@ ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) con
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
+	return static_cast<unsigned>(std::ceil(static_cast<float>(samples_stored ()) /
 	                                       max_samples_out));
 }
 
 bool
 ExportGraphBuilder::Intermediate::process()
 {
-	samplecnt_t samples_read = tmp_file->read (*buffer);
+	samplecnt_t samples_read;
+	if (spill_buffer) {
+		samples_read = spill_buffer->read (*buffer);
+	} else {
+		samples_read = tmp_file->read (*buffer);
+	}
 	return samples_read != buffer->samples();
 }
 
@@ -648,7 +803,15 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 			(*i).set_peak (gain);
 		}
 	}
-	tmp_file->add_output (normalizer);
+	if (spill_buffer) {
+		spill_buffer->add_output (normalizer);
+		spill_buffer->rewind ();
+	} else {
+		tmp_file->add_output (normalizer);
+	}
+
+	// may be called concurrently for different channel groups
+	Glib::Threads::Mutex::Lock lm (parent.intermediates_lock);
 	parent.intermediates.push_back (this);
 }
 
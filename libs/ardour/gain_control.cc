@@ -70,11 +70,12 @@ GainControl::post_add_master (boost::shared_ptr<AutomationControl> m)
 }
 
 bool
-GainControl::get_masters_curve_locked (samplepos_t start, samplepos_t end, float* vec, samplecnt_t veclen) const
+GainControl::get_masters_curve_locked (samplepos_t start, samplepos_t end, float* vec, samplecnt_t veclen, bool& constant) const
 {
 	if (_masters.empty()) {
-		return list()->curve().rt_safe_get_vector (start, end, vec, veclen);
+		return list()->curve().rt_safe_get_vector (start, end, vec, veclen, &constant);
 	}
+	constant = false;
 	for (samplecnt_t i = 0; i < veclen; ++i) {
 		vec[i] = 1.f;
 	}
@@ -154,6 +154,8 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t           ARDOUR::copy_vector = 0;
+apply_gain_ramp_t       ARDOUR::apply_gain_ramp = 0;
+mix_buffers_with_gain_ramp_t ARDOUR::mix_buffers_with_gain_ramp = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -187,6 +189,41 @@ setup_hardware_optimization (bool try_optimization)
 
 #if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
 
+		/* AVX-512 and AVX2/FMA variants are only preferred where
+		 * test/profiling/mix_kernels shows that they are faster; use
+		 * ARDOUR_FPU_FLAGS to mask CPU features for comparison.
+		 */
+		if (fpu->has_avx512f ()) {
+
+			info << "Using AVX-512F optimized routines" << endmsg;
+
+			compute_peak               = x86_avx512f_compute_peak;
+			find_peaks                 = x86_avx512f_find_peaks;
+			apply_gain_to_buffer       = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain      = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain        = x86_avx512f_mix_buffers_no_gain;
+			copy_vector                = default_copy_vector;
+			apply_gain_ramp            = x86_avx512f_apply_gain_ramp;
+			mix_buffers_with_gain_ramp = x86_avx512f_mix_buffers_with_gain_ramp;
+
+			generic_mix_functions = false;
+
+		} else if (fpu->has_avx2 () && fpu->has_fma ()) {
+
+			info << "Using AVX2/FMA optimized routines" << endmsg;
+
+			compute_peak               = x86_fma_compute_peak;
+			find_peaks                 = x86_fma_find_peaks;
+			apply_gain_to_buffer       = x86_fma_apply_gain_to_buffer;
+			mix_buffers_with_gain      = x86_fma_mix_buffers_with_gain;
+			mix_buffers_no_gain        = x86_fma_mix_buffers_no_gain;
+			copy_vector                = default_copy_vector;
+			apply_gain_ramp            = x86_fma_apply_gain_ramp;
+			mix_buffers_with_gain_ramp = x86_fma_mix_buffers_with_gain_ramp;
+
+			generic_mix_functions = false;
+
+		} else
 #ifdef PLATFORM_WINDOWS
 		/* We have AVX-optimized code for Windows */
 		if (fpu->has_avx())
@@ -204,6 +241,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
 
 			generic_mix_functions = false;
 
@@ -218,6 +257,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
 
 			generic_mix_functions = false;
 
@@ -232,6 +273,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain  = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
+			apply_gain_ramp        = default_apply_gain_ramp;
+			mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
 
 			generic_mix_functions = false;
 
@@ -252,6 +295,8 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		apply_gain_ramp       = default_apply_gain_ramp;
+		mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -20,9 +20,18 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 #include <stdio.h>
 
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define graph_cpu_relax() _mm_pause ()
+#else
+#define graph_cpu_relax()
+#endif
+
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
 #include "pbd/pthread_utils.h"
@@ -31,6 +40,7 @@
 #include "ardour/debug.h"
 #include "ardour/graph.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
@@ -56,8 +66,24 @@ alloc_allowed ()
 
 #define g_atomic_uint_get(x) static_cast<guint> (g_atomic_int_get (x))
 
+/** How often an idle thread looks for work to steal before it goes to sleep */
+static const int graph_spin_iterations = 1024;
+
+/** How often (in process cycles) the trigger order is updated from the measured DSP load */
+static const int graph_priority_interval = 128;
+
+static void
+do_not_delete_the_worker (void*)
+{
+	/* Workers are owned by the Graph */
+}
+
+Glib::Threads::Private<Graph::Worker> Graph::_thread_worker (do_not_delete_the_worker);
+
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
+	, _priority_countdown (0)
+	, _work_stealing (false)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
@@ -71,6 +97,7 @@ Graph::Graph (Session& session)
 	g_atomic_int_set (&_n_workers, 0);
 	g_atomic_int_set (&_idle_thread_cnt, 0);
 	g_atomic_int_set (&_trigger_queue_size, 0);
+	g_atomic_int_set (&_spinning_thread_cnt, 0);
 
 	_n_terminal_nodes[0] = 0;
 	_n_terminal_nodes[1] = 0;
@@ -128,6 +155,21 @@ Graph::reset_thread_list ()
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
+	/* (Re)create per-thread work-queues, sized to hold every node */
+	for (vector<Worker*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		delete *i;
+	}
+	_workers.clear ();
+
+	_work_stealing = Config->get_graph_work_stealing ();
+
+	if (_work_stealing) {
+		size_t n_nodes = max (_nodes_rt[0].size (), _nodes_rt[1].size ());
+		for (uint32_t i = 0; i < num_threads; ++i) {
+			_workers.push_back (new Worker (i, max (n_nodes, (size_t) 1024)));
+		}
+	}
+
 	if (AudioEngine::instance ()->create_process_thread (boost::bind (&Graph::main_thread, this)) != 0) {
 		throw failed_constructor ();
 	}
@@ -148,6 +190,11 @@ Graph::session_going_away ()
 {
 	drop_threads ();
 
+	for (vector<Worker*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		delete *i;
+	}
+	_workers.clear ();
+
 	// now drop all references on the nodes.
 	_nodes_rt[0].clear ();
 	_nodes_rt[1].clear ();
@@ -162,6 +209,12 @@ Graph::drop_threads ()
 {
 	Glib::Threads::Mutex::Lock ls (_swap_mutex);
 
+	/* Let threads that are looking for work go to sleep,
+	 * so that they are woken up below */
+	while (g_atomic_uint_get (&_spinning_thread_cnt) > 0) {
+		sched_yield ();
+	}
+
 	/* Flag threads to terminate */
 	g_atomic_int_set (&_terminate, 1);
 
@@ -210,6 +263,7 @@ Graph::clear_other_chain ()
 		if (_setup_chain != _pending_chain) {
 			for (node_list_t::iterator ni = _nodes_rt[_setup_chain].begin (); ni != _nodes_rt[_setup_chain].end (); ++ni) {
 				(*ni)->_activation_set[_setup_chain].clear ();
+				(*ni)->_activation_order[_setup_chain].clear ();
 			}
 
 			_nodes_rt[_setup_chain].clear ();
@@ -234,8 +288,12 @@ Graph::prep ()
 			_current_chain = _pending_chain;
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (vector<Worker*>::iterator w = _workers.begin (); w != _workers.end (); ++w) {
+				(*w)->queue.reserve (_nodes_rt[_current_chain].size ());
+			}
 			assert (g_atomic_uint_get (&_trigger_queue_size) == 0);
 			_cleanup_cond.signal ();
+			_priority_countdown = 0;
 		}
 		_swap_mutex.unlock ();
 	}
@@ -244,6 +302,13 @@ Graph::prep ()
 
 	int chain = _current_chain;
 
+	/* All other threads are idle, the trigger order can be changed */
+	if (--_priority_countdown <= 0) {
+		_priority_countdown = graph_priority_interval;
+		update_priorities (chain);
+		mark_critical_path (chain);
+	}
+
 	node_list_t::iterator i;
 	for (i = _nodes_rt[chain].begin (); i != _nodes_rt[chain].end (); ++i) {
 		(*i)->prep (chain);
@@ -254,10 +319,15 @@ Graph::prep ()
 
 	g_atomic_int_set (&_terminal_refcnt, _n_terminal_nodes[chain]);
 
+	/* All other threads are asleep and all queues are empty,
+	 * rewind them, so that their indices never wrap. */
+	for (vector<Worker*>::iterator w = _workers.begin (); w != _workers.end (); ++w) {
+		(*w)->queue.reset ();
+	}
+
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); i++) {
-		g_atomic_int_inc (&_trigger_queue_size);
-		_trigger_queue.push_back (i->get ());
+		trigger (i->get ());
 	}
 }
 
@@ -265,7 +335,16 @@ void
 Graph::trigger (GraphNode* n)
 {
 	g_atomic_int_inc (&_trigger_queue_size);
-	_trigger_queue.push_back (n);
+	if (_work_stealing) {
+		/* this is always called from a process thread: by prep() or
+		 * when a node that feeds n has completed. Queue n locally,
+		 * it can be processed by this thread without any handover,
+		 * or be stolen by an idle one.
+		 */
+		_thread_worker.get ()->queue.push (n);
+	} else {
+		_trigger_queue.push_back (n);
+	}
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
@@ -347,6 +426,7 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 	for (RouteList::iterator ri = routelist->begin (); ri != routelist->end (); ri++) {
 		(*ri)->_init_refcount[chain] = 0;
 		(*ri)->_activation_set[chain].clear ();
+		(*ri)->_activation_order[chain].clear ();
 		_nodes_rt[chain].push_back (*ri);
 	}
 
@@ -364,6 +444,7 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 		/* Set up r's activation set */
 		for (set<GraphVertex>::iterator i = fed_from_r.begin (); i != fed_from_r.end (); ++i) {
 			r->_activation_set[chain].insert (*i);
+			r->_activation_order[chain].push_back (i->get ());
 		}
 
 		/* r has an input if there are some incoming edges to r in the graph */
@@ -387,13 +468,133 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 		}
 	}
 
+	/* Sort the nodes topologically, so that a node's cost-to-finish can be
+	 * calculated from the nodes it feeds in a single pass.
+	 */
+	node_list_t                sorted;
+	std::map<GraphNode*, gint> refcount;
+	for (node_list_t::iterator ni = _init_trigger_list[chain].begin (); ni != _init_trigger_list[chain].end (); ++ni) {
+		sorted.push_back (*ni);
+	}
+	for (node_list_t::iterator ni = sorted.begin (); ni != sorted.end (); ++ni) {
+		for (node_set_t::iterator ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ++ai) {
+			if (refcount.find (ai->get ()) == refcount.end ()) {
+				refcount[ai->get ()] = (*ai)->_init_refcount[chain];
+			}
+			if (--refcount[ai->get ()] == 0) {
+				sorted.push_back (*ai);
+			}
+		}
+	}
+	assert (sorted.size () == _nodes_rt[chain].size ());
+	if (sorted.size () == _nodes_rt[chain].size ()) {
+		_nodes_rt[chain].swap (sorted);
+	}
+
+	update_priorities (chain);
+
 	_pending_chain = chain;
 	dump (chain);
 }
 
+namespace {
+struct GraphNodePriority {
+	GraphNodePriority (bool lifo) : _lifo (lifo) {}
+	bool operator() (GraphNode const* a, GraphNode const* b) const {
+		return _lifo ? a->path_cost () < b->path_cost () : a->path_cost () > b->path_cost ();
+	}
+	bool operator() (node_ptr_t const& a, node_ptr_t const& b) const {
+		return (*this) (a.get (), b.get ());
+	}
+	bool _lifo;
+};
+}
+
+/** Order nodes by their cost-to-finish, so that when several nodes become ready at the
+ * same time, the ones heading the longest (slowest) chains are started first.
+ *
+ * This does not allocate memory and is called by prep () every graph_priority_interval
+ * cycles, when all other threads are idle.
+ */
+void
+Graph::update_priorities (int chain)
+{
+	/* Nodes are picked from the shared trigger-queue in FIFO order,
+	 * but from a thread's own work-queue in LIFO order.
+	 */
+	GraphNodePriority cmp (_work_stealing);
+
+	/* visit nodes after all nodes that they feed */
+	for (node_list_t::reverse_iterator ni = _nodes_rt[chain].rbegin (); ni != _nodes_rt[chain].rend (); ++ni) {
+		GraphNode*               n     = ni->get ();
+		std::vector<GraphNode*>& order = n->_activation_order[chain];
+		float                    tail  = 0;
+		for (std::vector<GraphNode*>::const_iterator ai = order.begin (); ai != order.end (); ++ai) {
+			tail = std::max (tail, (*ai)->_path_cost);
+		}
+		n->_path_cost = n->dsp_cost () + tail;
+		std::sort (order.begin (), order.end (), cmp);
+	}
+
+	_init_trigger_list[chain].sort (cmp);
+}
+
+void
+Graph::mark_critical_path (int chain)
+{
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ++ni) {
+		g_atomic_int_set (&(*ni)->_critical, 0);
+	}
+
+	/* follow the most expensive node at each level */
+	GraphNode* n = 0;
+	for (node_list_t::iterator ni = _init_trigger_list[chain].begin (); ni != _init_trigger_list[chain].end (); ++ni) {
+		if (!n || (*ni)->_path_cost > n->_path_cost) {
+			n = ni->get ();
+		}
+	}
+
+	while (n) {
+		g_atomic_int_set (&n->_critical, 1);
+		GraphNode* next = 0;
+		for (std::vector<GraphNode*>::const_iterator ai = n->_activation_order[chain].begin (); ai != n->_activation_order[chain].end (); ++ai) {
+			if (!next || (*ai)->_path_cost > next->_path_cost) {
+				next = *ai;
+			}
+		}
+		n = next;
+	}
+}
+
+node_list_t
+Graph::critical_path () const
+{
+	Glib::Threads::Mutex::Lock ls (_swap_mutex);
+	int chain = _current_chain;
+
+	node_list_t rv;
+	for (node_list_t::const_iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ++ni) {
+		if ((*ni)->on_critical_path ()) {
+			rv.push_back (*ni);
+		}
+	}
+	return rv;
+}
+
 /** Called by both the main thread and all helpers. */
 void
 Graph::run_one ()
+{
+	if (_work_stealing) {
+		run_one_stealing ();
+	} else {
+		run_one_shared ();
+	}
+}
+
+/** Take work from the shared trigger queue */
+void
+Graph::run_one_shared ()
 {
 	GraphNode* to_run = NULL;
 
@@ -444,11 +645,122 @@ Graph::run_one ()
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
 }
 
+/** Take a node from any other thread's work-queue, or return NULL */
+GraphNode*
+Graph::steal_work (size_t self)
+{
+	GraphNode*   n        = 0;
+	size_t const n_queues = _workers.size ();
+
+	for (size_t i = 1; i < n_queues; ++i) {
+		if (_workers[(self + i) % n_queues]->queue.steal (n)) {
+			return n;
+		}
+	}
+	return 0;
+}
+
+/** Wake up sleeping threads for work that spinning threads will not pick up */
+void
+Graph::wake_idle_threads (guint work_avail)
+{
+	guint spinning = g_atomic_uint_get (&_spinning_thread_cnt);
+
+	if (work_avail <= spinning) {
+		return;
+	}
+
+	guint wakeup = std::min (g_atomic_uint_get (&_idle_thread_cnt), work_avail - spinning);
+
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 signals %2 threads\n", pthread_name (), wakeup));
+	for (guint i = 0; i < wakeup; ++i) {
+		_execution_sem.signal ();
+	}
+}
+
+/** Take work from this thread's own queue, else steal it from others */
+void
+Graph::run_one_stealing ()
+{
+	Worker*    self   = _thread_worker.get ();
+	GraphNode* to_run = NULL;
+
+	if (g_atomic_int_get (&_terminate)) {
+		return;
+	}
+
+	if (!self->queue.pop (to_run)) {
+		to_run = steal_work (self->id);
+	}
+
+	if (!to_run) {
+		/* Look for work for a little while before going to sleep;
+		 * nodes fed by the ones currently being processed usually become
+		 * ready within microseconds, which is much less than it takes
+		 * to wake up a thread sleeping on the semaphore.
+		 */
+		g_atomic_int_inc (&_spinning_thread_cnt);
+		for (int i = 0; i < graph_spin_iterations && !to_run; ++i) {
+			if (g_atomic_int_get (&_terminate)) {
+				g_atomic_int_dec_and_test (&_spinning_thread_cnt);
+				return;
+			}
+			if (g_atomic_uint_get (&_trigger_queue_size) > 0) {
+				/* our own queue is empty, only this thread adds to it */
+				to_run = steal_work (self->id);
+			} else {
+				graph_cpu_relax ();
+			}
+		}
+		g_atomic_int_dec_and_test (&_spinning_thread_cnt);
+	}
+
+	while (!to_run) {
+		/* Wait for work, fall asleep */
+		g_atomic_int_inc (&_idle_thread_cnt);
+		assert (g_atomic_uint_get (&_idle_thread_cnt) <= _n_workers);
+
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name ()));
+		_execution_sem.wait ();
+
+		if (g_atomic_int_get (&_terminate)) {
+			return;
+		}
+
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name ()));
+
+		g_atomic_int_dec_and_test (&_idle_thread_cnt);
+
+		if (!self->queue.pop (to_run)) {
+			to_run = steal_work (self->id);
+		}
+	}
+
+	g_atomic_int_dec_and_test (&_trigger_queue_size);
+
+	wake_idle_threads (g_atomic_uint_get (&_trigger_queue_size));
+
+	/* Process the graph-node */
+	to_run->run (_current_chain);
+
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
+}
+
+void
+Graph::setup_worker (size_t id)
+{
+	if (_work_stealing) {
+		assert (id < _workers.size ());
+		_thread_worker.set (_workers[id]);
+	}
+}
+
 void
 Graph::helper_thread ()
 {
-	g_atomic_int_inc (&_n_workers);
-	guint id = g_atomic_uint_get (&_n_workers);
+	guint id = g_atomic_int_add (&_n_workers, 1) + 1;
+
+	setup_worker (id);
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -496,6 +808,8 @@ Graph::main_thread ()
 
 	pt->get_buffers ();
 
+	setup_worker (0);
+
 	/* Wait for initial process callback */
 again:
 	_callback_start_sem.wait ();
@@ -508,6 +822,13 @@ again:
 		return;
 	}
 
+	if (_work_stealing) {
+		/* prep() rewinds the work-queues, helpers must not look at them */
+		while (g_atomic_uint_get (&_idle_thread_cnt) != g_atomic_uint_get (&_n_workers) && !g_atomic_int_get (&_terminate)) {
+			sched_yield ();
+		}
+	}
+
 	/* Bootstrap the trigger-list
 	 * (later this is done by Graph_reached_terminal_node) */
 	prep ();
@@ -26,7 +26,11 @@ using namespace ARDOUR;
 
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
 	: _graph (graph)
+	, _dsp_cost (0)
+	, _dsp_stats_reset (0)
 {
+	_path_cost = 0;
+	_critical  = 0;
 }
 
 GraphNode::~GraphNode ()
@@ -58,11 +62,13 @@ GraphNode::trigger ()
 void
 GraphNode::finish (int chain)
 {
-	node_set_t::iterator i;
-	bool                 feeds = false;
+	std::vector<GraphNode*>::const_iterator i;
+	bool                                    feeds = false;
 
-	/* Notify downstream nodes that depend on this node */
-	for (i = _activation_set[chain].begin (); i != _activation_set[chain].end (); ++i) {
+	/* Notify downstream nodes that depend on this node,
+	 * in the order of priority that the Graph assigned.
+	 */
+	for (i = _activation_order[chain].begin (); i != _activation_order[chain].end (); ++i) {
 		(*i)->trigger ();
 		feeds = true;
 	}
@@ -79,3 +85,27 @@ GraphNode::process ()
 {
 	_graph->process_one_route (dynamic_cast<Route*> (this));
 }
+
+void
+GraphNode::update_dsp_cost ()
+{
+	if (g_atomic_int_compare_and_exchange (&_dsp_stats_reset, 1, 0)) {
+		_dsp_stats.reset ();
+		_dsp_cost = 0;
+		return;
+	}
+	/* exponential moving average, time-constant ~32 cycles */
+	_dsp_cost += ((float)_dsp_stats.elapsed () - _dsp_cost) / 32.f;
+}
+
+bool
+GraphNode::get_dsp_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const
+{
+	return _dsp_stats.get_stats (min, max, avg, dev);
+}
+
+void
+GraphNode::clear_dsp_stats ()
+{
+	g_atomic_int_set (&_dsp_stats_reset, 1);
+}
@@ -48,11 +48,17 @@ InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t
 		return;
 	}
 
+	_send_buffers.clear ();
+
 	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
 		if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-			bufs.merge_from ((*i)->get_buffers(), nframes);
+			_send_buffers.push_back (&(*i)->get_buffers());
 		}
 	}
+
+	if (!_send_buffers.empty ()) {
+		bufs.merge_from (&_send_buffers[0], _send_buffers.size(), nframes);
+	}
 }
 
 void
@@ -60,6 +66,7 @@ InternalReturn::add_send (InternalSend* send)
 {
 	Glib::Threads::Mutex::Lock lm (_sends_mutex);
 	_sends.push_back (send);
+	_send_buffers.reserve (_sends.size ());
 }
 
 void
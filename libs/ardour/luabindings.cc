@@ -1478,6 +1478,8 @@ LuaBindings::common (lua_State* L)
 		.deriveWSPtrClass <LuaProc, Plugin> ("LuaProc")
 		.addFunction ("shmem", &LuaProc::instance_shm)
 		.addFunction ("table", &LuaProc::instance_ref)
+		.addFunction ("set_reuse_tables", &LuaProc::set_reuse_tables)
+		.addFunction ("reuse_tables", &LuaProc::reuse_tables)
 		.endClass ()
 
 		.deriveWSPtrClass <PluginInsert, Processor> ("PluginInsert")
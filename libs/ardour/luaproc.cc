@@ -67,6 +67,13 @@ LuaProc::LuaProc (AudioEngine& engine,
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _reuse_tables (true)
+	, _in_map (0)
+	, _out_map (0)
+	, _midi_in (0)
+	, _midi_out (0)
+	, _midi_pool (0)
+	, _midi_in_cnt (0)
 {
 	init ();
 
@@ -101,6 +108,13 @@ LuaProc::LuaProc (const LuaProc &other)
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _reuse_tables (other._reuse_tables)
+	, _in_map (0)
+	, _out_map (0)
+	, _midi_in (0)
+	, _midi_out (0)
+	, _midi_pool (0)
+	, _midi_in_cnt (0)
 {
 	init ();
 
@@ -132,6 +146,11 @@ LuaProc::~LuaProc () {
 	lua.do_command ("collectgarbage();");
 	delete (_lua_dsp);
 	delete (_lua_latency);
+	delete (_in_map);
+	delete (_out_map);
+	delete (_midi_in);
+	delete (_midi_out);
+	delete (_midi_pool);
 	delete [] _control_data;
 	delete [] _shadow_data;
 }
@@ -244,6 +263,14 @@ LuaProc::load_script ()
 		return true;
 	}
 
+	if (!_lua_does_channelmapping) {
+		_in_map    = new luabridge::LuaRef (luabridge::newTable (L));
+		_out_map   = new luabridge::LuaRef (luabridge::newTable (L));
+		_midi_in   = new luabridge::LuaRef (luabridge::newTable (L));
+		_midi_out  = new luabridge::LuaRef (luabridge::newTable (L));
+		_midi_pool = new luabridge::LuaRef (luabridge::newTable (L));
+	}
+
 	luabridge::LuaRef lua_dsp_latency = luabridge::getGlobal (L, "dsp_latency");
 	if (lua_dsp_latency.type () == LUA_TFUNCTION) {
 		_lua_latency = new luabridge::LuaRef (lua_dsp_latency);
@@ -553,6 +580,18 @@ LuaProc::can_support_io_configuration (const ChanCount& in, ChanCount& out, Chan
 	return true;
 }
 
+/* remove t[n + 1] .. t[#t] */
+static void
+truncate_table (lua_State* L, luabridge::LuaRef& t, uint32_t n)
+{
+	t.push (L);
+	for (size_t i = lua_rawlen (L, -1); i > n; --i) {
+		lua_pushnil (L);
+		lua_rawseti (L, -2, i);
+	}
+	lua_pop (L, 1);
+}
+
 bool
 LuaProc::configure_io (ChanCount in, ChanCount out)
 {
@@ -616,6 +655,15 @@ LuaProc::configure_io (ChanCount in, ChanCount out)
 	_configured_in = in;
 	_configured_out = out;
 
+	if (_in_map) {
+		/* with fewer channels than before, dsp_run() must not
+		 * be passed the buffers of the former configuration
+		 */
+		lua_State* L = lua.getState ();
+		truncate_table (L, *_in_map, in.n_audio ());
+		truncate_table (L, *_out_map, out.n_audio ());
+	}
+
 	return true;
 }
 
@@ -649,103 +697,10 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		if (_lua_does_channelmapping) {
 			// run the DSP function
 			(*_lua_dsp)(&bufs, in, out, nframes, offset);
+		} else if (_reuse_tables) {
+			run_with_reused_tables (bufs, in, out, nframes, offset);
 		} else {
-			// map buffers
-			BufferSet& silent_bufs  = _session.get_silent_buffers (ChanCount (DataType::AUDIO, 1));
-			BufferSet& scratch_bufs = _session.get_scratch_buffers (ChanCount (DataType::AUDIO, 1));
-
-			lua_State* L = lua.getState ();
-			luabridge::LuaRef in_map (luabridge::newTable (L));
-			luabridge::LuaRef out_map (luabridge::newTable (L));
-
-			const uint32_t audio_in = _configured_in.n_audio ();
-			const uint32_t audio_out = _configured_out.n_audio ();
-			const uint32_t midi_in = _configured_in.n_midi ();
-
-			for (uint32_t ap = 0; ap < audio_in; ++ap) {
-				bool valid;
-				const uint32_t buf_index = in.get(DataType::AUDIO, ap, &valid);
-				if (valid) {
-					in_map[ap + 1] = bufs.get_audio (buf_index).data (offset);
-				} else {
-					in_map[ap + 1] = silent_bufs.get_audio (0).data (offset);
-				}
-			}
-			for (uint32_t ap = 0; ap < audio_out; ++ap) {
-				bool valid;
-				const uint32_t buf_index = out.get(DataType::AUDIO, ap, &valid);
-				if (valid) {
-					out_map[ap + 1] = bufs.get_audio (buf_index).data (offset);
-				} else {
-					out_map[ap + 1] = scratch_bufs.get_audio (0).data (offset);
-				}
-			}
-
-			luabridge::LuaRef lua_midi_src_tbl (luabridge::newTable (L));
-			int e = 1; // > 1 port, we merge events (unsorted)
-			for (uint32_t mp = 0; mp < midi_in; ++mp) {
-				bool valid;
-				const uint32_t idx = in.get(DataType::MIDI, mp, &valid);
-				if (valid) {
-					for (MidiBuffer::iterator m = bufs.get_midi(idx).begin();
-							m != bufs.get_midi(idx).end(); ++m, ++e) {
-						const Evoral::Event<samplepos_t> ev(*m, false);
-						luabridge::LuaRef lua_midi_data (luabridge::newTable (L));
-						const uint8_t* data = ev.buffer();
-						for (uint32_t i = 0; i < ev.size(); ++i) {
-							lua_midi_data [i + 1] = data[i];
-						}
-						luabridge::LuaRef lua_midi_event (luabridge::newTable (L));
-						lua_midi_event["time"] = 1 + (*m).time();
-						lua_midi_event["data"] = lua_midi_data;
-						lua_midi_event["bytes"] = data;
-						lua_midi_event["size"] = ev.size();
-						lua_midi_src_tbl[e] = lua_midi_event;
-					}
-				}
-			}
-
-			if (_has_midi_input) {
-				// XXX TODO This needs a better solution than global namespace
-				luabridge::push (L, lua_midi_src_tbl);
-				lua_setglobal (L, "midiin");
-			}
-
-			luabridge::LuaRef lua_midi_sink_tbl (luabridge::newTable (L));
-			if (_has_midi_output) {
-				luabridge::push (L, lua_midi_sink_tbl);
-				lua_setglobal (L, "midiout");
-			}
-
-			// run the DSP function
-			(*_lua_dsp)(in_map, out_map, nframes);
-
-			// copy back midi events
-			if (_has_midi_output && lua_midi_sink_tbl.isTable ()) {
-				bool valid;
-				const uint32_t idx = out.get(DataType::MIDI, 0, &valid);
-				if (valid && bufs.count().n_midi() > idx) {
-					MidiBuffer& mbuf = bufs.get_midi(idx);
-					mbuf.silence(0, 0);
-					for (luabridge::Iterator i (lua_midi_sink_tbl); !i.isNil (); ++i) {
-						if (!i.key ().isNumber ()) { continue; }
-						if (!i.value ()["time"].isNumber ()) { continue; }
-						if (!i.value ()["data"].isTable ()) { continue; }
-						luabridge::LuaRef data_tbl (i.value ()["data"]);
-						samplepos_t tme = i.value ()["time"];
-						if (tme < 1 || tme > nframes) { continue; }
-						uint8_t data[64];
-						size_t size = 0;
-						for (luabridge::Iterator di (data_tbl); !di.isNil () && size < sizeof(data); ++di, ++size) {
-							data[size] = di.value ();
-						}
-						if (size > 0 && size < 64) {
-							mbuf.push_back(tme - 1, size, data);
-						}
-					}
-
-				}
-			}
+			run_with_new_tables (bufs, in, out, nframes, offset);
 		}
 
 		if (_lua_latency) {
@@ -765,7 +720,7 @@ LuaProc::connect_and_run (BufferSet& bufs,
 	int64_t t1 = g_get_monotonic_time ();
 #endif
 
-	lua.collect_garbage_step ();
+	lua.collect_garbage_rt_step ();
 #ifdef WITH_LUAPROC_STATS
 	if (++_stats_cnt > 0) {
 		int64_t t2 = g_get_monotonic_time ();
@@ -781,6 +736,261 @@ LuaProc::connect_and_run (BufferSet& bufs,
 }
 
 
+void
+LuaProc::run_with_new_tables (BufferSet& bufs, ChanMapping const& in, ChanMapping const& out, pframes_t nframes, samplecnt_t offset)
+{
+	// map buffers
+	BufferSet& silent_bufs  = _session.get_silent_buffers (ChanCount (DataType::AUDIO, 1));
+	BufferSet& scratch_bufs = _session.get_scratch_buffers (ChanCount (DataType::AUDIO, 1));
+
+	lua_State* L = lua.getState ();
+	luabridge::LuaRef in_map (luabridge::newTable (L));
+	luabridge::LuaRef out_map (luabridge::newTable (L));
+
+	const uint32_t audio_in = _configured_in.n_audio ();
+	const uint32_t audio_out = _configured_out.n_audio ();
+	const uint32_t midi_in = _configured_in.n_midi ();
+
+	for (uint32_t ap = 0; ap < audio_in; ++ap) {
+		bool valid;
+		const uint32_t buf_index = in.get(DataType::AUDIO, ap, &valid);
+		if (valid) {
+			in_map[ap + 1] = bufs.get_audio (buf_index).data (offset);
+		} else {
+			in_map[ap + 1] = silent_bufs.get_audio (0).data (offset);
+		}
+	}
+	for (uint32_t ap = 0; ap < audio_out; ++ap) {
+		bool valid;
+		const uint32_t buf_index = out.get(DataType::AUDIO, ap, &valid);
+		if (valid) {
+			out_map[ap + 1] = bufs.get_audio (buf_index).data (offset);
+		} else {
+			out_map[ap + 1] = scratch_bufs.get_audio (0).data (offset);
+		}
+	}
+
+	luabridge::LuaRef lua_midi_src_tbl (luabridge::newTable (L));
+	int e = 1; // > 1 port, we merge events (unsorted)
+	for (uint32_t mp = 0; mp < midi_in; ++mp) {
+		bool valid;
+		const uint32_t idx = in.get(DataType::MIDI, mp, &valid);
+		if (valid) {
+			for (MidiBuffer::iterator m = bufs.get_midi(idx).begin();
+					m != bufs.get_midi(idx).end(); ++m, ++e) {
+				const Evoral::Event<samplepos_t> ev(*m, false);
+				luabridge::LuaRef lua_midi_data (luabridge::newTable (L));
+				const uint8_t* data = ev.buffer();
+				for (uint32_t i = 0; i < ev.size(); ++i) {
+					lua_midi_data [i + 1] = data[i];
+				}
+				luabridge::LuaRef lua_midi_event (luabridge::newTable (L));
+				lua_midi_event["time"] = 1 + (*m).time();
+				lua_midi_event["data"] = lua_midi_data;
+				lua_midi_event["bytes"] = data;
+				lua_midi_event["size"] = ev.size();
+				lua_midi_src_tbl[e] = lua_midi_event;
+			}
+		}
+	}
+
+	if (_has_midi_input) {
+		// XXX TODO This needs a better solution than global namespace
+		luabridge::push (L, lua_midi_src_tbl);
+		lua_setglobal (L, "midiin");
+	}
+
+	luabridge::LuaRef lua_midi_sink_tbl (luabridge::newTable (L));
+	if (_has_midi_output) {
+		luabridge::push (L, lua_midi_sink_tbl);
+		lua_setglobal (L, "midiout");
+	}
+
+	// run the DSP function
+	(*_lua_dsp)(in_map, out_map, nframes);
+
+	// copy back midi events
+	copy_midi_out (lua_midi_sink_tbl, bufs, out, nframes);
+}
+
+/* set t[i] = p, re-using the userdata that is already there if possible */
+template <typename T>
+static void
+set_pointer (lua_State* L, int t, int i, T* p)
+{
+	lua_rawgeti (L, t, i);
+	const bool reused = luabridge::UserdataPtr::rebind (L, -1, p);
+	lua_pop (L, 1);
+	if (!reused) {
+		luabridge::Stack<T*>::push (L, p);
+		lua_rawseti (L, t, i);
+	}
+}
+
+/* update the event table pool[e] (created if needed) in place, and leave it on the stack */
+static void
+set_midi_event (lua_State* L, int pool, int e, samplepos_t time, uint8_t const* data, uint32_t size)
+{
+	lua_rawgeti (L, pool, e);
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_createtable (L, 0, 4);
+		lua_pushvalue (L, -1);
+		lua_rawseti (L, pool, e);
+	}
+	const int ev = lua_gettop (L);
+
+	lua_getfield (L, ev, "data");
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_createtable (L, 3, 0);
+		lua_pushvalue (L, -1);
+		lua_setfield (L, ev, "data");
+	}
+	const size_t old_size = lua_rawlen (L, -1);
+	for (uint32_t i = 0; i < size; ++i) {
+		lua_pushinteger (L, data[i]);
+		lua_rawseti (L, -2, i + 1);
+	}
+	for (size_t i = size; i < old_size; ++i) {
+		lua_pushnil (L);
+		lua_rawseti (L, -2, i + 1);
+	}
+	lua_pop (L, 1);
+
+	lua_pushinteger (L, 1 + time);
+	lua_setfield (L, ev, "time");
+	lua_pushinteger (L, size);
+	lua_setfield (L, ev, "size");
+
+	lua_getfield (L, ev, "bytes");
+	const bool reused = luabridge::UserdataPtr::rebind (L, -1, data);
+	lua_pop (L, 1);
+	if (!reused) {
+		luabridge::Stack<uint8_t const*>::push (L, data);
+		lua_setfield (L, ev, "bytes");
+	}
+}
+
+/** Same as run_with_new_tables(), except that the tables passed to the
+ * script are allocated once and updated in place: buffer pointers are
+ * re-pointed, MIDI events are taken from a pool of event tables that
+ * only ever grows. Apart from what the script itself does, a cycle does
+ * not allocate memory, and hence produces no garbage.
+ */
+void
+LuaProc::run_with_reused_tables (BufferSet& bufs, ChanMapping const& in, ChanMapping const& out, pframes_t nframes, samplecnt_t offset)
+{
+	BufferSet& silent_bufs  = _session.get_silent_buffers (ChanCount (DataType::AUDIO, 1));
+	BufferSet& scratch_bufs = _session.get_scratch_buffers (ChanCount (DataType::AUDIO, 1));
+
+	lua_State* L = lua.getState ();
+
+	const uint32_t audio_in = _configured_in.n_audio ();
+	const uint32_t audio_out = _configured_out.n_audio ();
+	const uint32_t midi_in = _configured_in.n_midi ();
+
+	_in_map->push (L);
+	int t = lua_gettop (L);
+	for (uint32_t ap = 0; ap < audio_in; ++ap) {
+		bool valid;
+		const uint32_t buf_index = in.get(DataType::AUDIO, ap, &valid);
+		set_pointer (L, t, ap + 1, valid ? bufs.get_audio (buf_index).data (offset) : silent_bufs.get_audio (0).data (offset));
+	}
+	lua_pop (L, 1);
+
+	_out_map->push (L);
+	t = lua_gettop (L);
+	for (uint32_t ap = 0; ap < audio_out; ++ap) {
+		bool valid;
+		const uint32_t buf_index = out.get(DataType::AUDIO, ap, &valid);
+		set_pointer (L, t, ap + 1, valid ? bufs.get_audio (buf_index).data (offset) : scratch_bufs.get_audio (0).data (offset));
+	}
+	lua_pop (L, 1);
+
+	if (_has_midi_input) {
+		_midi_in->push (L);
+		_midi_pool->push (L);
+		const int t_midi = lua_gettop (L) - 1;
+		const int t_pool = lua_gettop (L);
+
+		int e = 1; // > 1 port, we merge events (unsorted)
+		for (uint32_t mp = 0; mp < midi_in; ++mp) {
+			bool valid;
+			const uint32_t idx = in.get(DataType::MIDI, mp, &valid);
+			if (valid) {
+				for (MidiBuffer::iterator m = bufs.get_midi(idx).begin();
+						m != bufs.get_midi(idx).end(); ++m, ++e) {
+					const Evoral::Event<samplepos_t> ev(*m, false);
+					set_midi_event (L, t_pool, e, (*m).time(), ev.buffer(), ev.size());
+					lua_rawseti (L, t_midi, e);
+				}
+			}
+		}
+		/* remove the events of the previous cycle */
+		for (int i = e; i < _midi_in_cnt; ++i) {
+			lua_pushnil (L);
+			lua_rawseti (L, t_midi, i);
+		}
+		_midi_in_cnt = e;
+
+		lua_pop (L, 1);
+		lua_setglobal (L, "midiin");
+	}
+
+	if (_has_midi_output) {
+		_midi_out->push (L);
+		/* clear, assigning nil to existing fields is fine while traversing */
+		lua_pushnil (L);
+		while (lua_next (L, -2)) {
+			lua_pop (L, 1);
+			lua_pushvalue (L, -1);
+			lua_pushnil (L);
+			lua_rawset (L, -4);
+		}
+		lua_setglobal (L, "midiout");
+	}
+
+	// run the DSP function
+	(*_lua_dsp)(*_in_map, *_out_map, nframes);
+
+	// copy back midi events
+	copy_midi_out (*_midi_out, bufs, out, nframes);
+}
+
+void
+LuaProc::copy_midi_out (luabridge::LuaRef& lua_midi_sink_tbl, BufferSet& bufs, ChanMapping const& out, pframes_t nframes)
+{
+	if (!_has_midi_output || !lua_midi_sink_tbl.isTable ()) {
+		return;
+	}
+
+	bool valid;
+	const uint32_t idx = out.get(DataType::MIDI, 0, &valid);
+	if (!valid || bufs.count().n_midi() <= idx) {
+		return;
+	}
+
+	MidiBuffer& mbuf = bufs.get_midi(idx);
+	mbuf.silence(0, 0);
+	for (luabridge::Iterator i (lua_midi_sink_tbl); !i.isNil (); ++i) {
+		if (!i.key ().isNumber ()) { continue; }
+		if (!i.value ()["time"].isNumber ()) { continue; }
+		if (!i.value ()["data"].isTable ()) { continue; }
+		luabridge::LuaRef data_tbl (i.value ()["data"]);
+		samplepos_t tme = i.value ()["time"];
+		if (tme < 1 || tme > nframes) { continue; }
+		uint8_t data[64];
+		size_t size = 0;
+		for (luabridge::Iterator di (data_tbl); !di.isNil () && size < sizeof(data); ++di, ++size) {
+			data[size] = di.value ();
+		}
+		if (size > 0 && size < 64) {
+			mbuf.push_back(tme - 1, size, data);
+		}
+	}
+}
+
 void
 LuaProc::add_state (XMLNode* root) const
 {
@@ -795,6 +1005,8 @@ LuaProc::add_state (XMLNode* root) const
 	script_node->add_content (b64s);
 	root->add_child_nocopy (*script_node);
 
+	root->set_property (X_("reuse-tables"), _reuse_tables);
+
 	for (uint32_t i = 0; i < parameter_count(); ++i) {
 		if (parameter_is_input(i) && parameter_is_control(i)) {
 			child = new XMLNode("Port");
@@ -866,6 +1078,10 @@ LuaProc::set_state (const XMLNode& node, int version)
 		return -1;
 	}
 
+	if (!node.get_property (X_("reuse-tables"), _reuse_tables)) {
+		_reuse_tables = true;
+	}
+
 	nodes = node.children ("Port");
 	for (iter = nodes.begin(); iter != nodes.end(); ++iter) {
 		child = *iter;
@@ -25,7 +25,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cctype>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <limits>
@@ -43,6 +46,7 @@
 #include "pbd/file_utils.h"
 #include "pbd/stl_delete.h"
 #include "pbd/compose.h"
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/locale_guard.h"
 #include "pbd/pthread_utils.h"
@@ -64,6 +68,7 @@
 #include "ardour/debug.h"
 #include "ardour/lv2_plugin.h"
 #include "ardour/midi_patch_manager.h"
+#include "ardour/plugin_scan_cache.h"
 #include "ardour/session.h"
 #include "ardour/tempo.h"
 #include "ardour/types.h"
@@ -3405,6 +3410,8 @@ LV2PluginInfo::load(Session& session)
 {
 	try {
 		PluginPtr plugin;
+		/* discovery may have found all plugins in the cache */
+		_world.load_bundled_plugins();
 		const LilvPlugins* plugins = lilv_world_get_all_plugins(_world.world);
 		LilvNode* uri = lilv_new_uri(_world.world, _plugin_uri);
 		if (!uri) { throw failed_constructor(); }
@@ -3429,6 +3436,7 @@ LV2PluginInfo::get_presets (bool /*user_only*/) const
 	const LilvPlugin* lp = NULL;
 	try {
 		PluginPtr plugin;
+		_world.load_bundled_plugins();
 		const LilvPlugins* plugins = lilv_world_get_all_plugins(_world.world);
 		LilvNode* uri = lilv_new_uri(_world.world, _plugin_uri);
 		if (!uri) { throw failed_constructor(); }
@@ -3472,162 +3480,469 @@ LV2PluginInfo::get_presets (bool /*user_only*/) const
 	return p;
 }
 
-PluginInfoList*
-LV2PluginInfo::discover()
+/** Examine @param p of @param world, which may belong to a worker thread,
+ *  so warnings are added to @param msgs rather than logged.
+ *  @return true if the plugin can be used, @param e is filled in then.
+ */
+static bool
+lv2_plugin_entry (LV2World& world, const LilvPlugin* p, PluginScanCache::Entry& e, vector<string>& msgs)
+{
+	LilvNode* name = lilv_plugin_get_name(p);
+	if (!name || !lilv_plugin_get_port_by_index(p, 0)) {
+		msgs.push_back (string_compose ("Ignoring invalid LV2 plugin %1",
+		                                lilv_node_as_string(lilv_plugin_get_uri(p))));
+		lilv_node_free(name);
+		return false;
+	}
+
+	if (lilv_plugin_has_feature(p, world.lv2_inPlaceBroken)) {
+		msgs.push_back (string_compose(
+		    _("Ignoring LV2 plugin \"%1\" since it cannot do inplace processing."),
+		    lilv_node_as_string(name)));
+		lilv_node_free(name);
+		return false;
+	}
+
+	int err = 0;
+	LilvNodes* required_features = lilv_plugin_get_required_features (p);
+	LILV_FOREACH(nodes, i, required_features) {
+			const char* rf = lilv_node_as_uri (lilv_nodes_get (required_features, i));
+			bool ok = false;
+			if (!strcmp (rf, "http://lv2plug.in/ns/ext/instance-access")) { ok = true; }
+			if (!strcmp (rf, "http://lv2plug.in/ns/ext/data-access")) { ok = true; }
+			if (!strcmp (rf, LV2_STATE__makePath)) { ok = true; }
+			if (!strcmp (rf, LV2_LOG__log)) { ok = true; }
+			if (!strcmp (rf, LV2_WORKER__schedule)) { ok = true; }
+			if (!strcmp (rf, LV2_STATE_PREFIX "loadDefaultState")) { ok = true; }
+			if (!strcmp (rf, LV2_URID_MAP_URI)) { ok = true; }
+			if (!strcmp (rf, LV2_URID_UNMAP_URI)) { ok = true; }
+			if (!strcmp (rf, "http://lv2plug.in/ns/lv2core#isLive")) { ok = true; }
+			if (!strcmp (rf, LV2_BUF_SIZE__boundedBlockLength)) { ok = true; }
+			if (!strcmp (rf, "http://lv2plug.in/ns/ext/buf-size#coarseBlockLength" /*LV2_BUF_SIZE__coarseBlockLength*/)) { ok = true; }
+			if (!strcmp (rf, LV2_OPTIONS__options)) { ok = true; }
+#ifdef LV2_EXTENDED
+			if (!strcmp (rf, LV2_INLINEDISPLAY__queue_draw)) { ok = true; }
+			if (!strcmp (rf, LV2_MIDNAM__update)) { ok = true; }
+			if (!strcmp (rf, LV2_BANKPATCH__notify)) { ok = true; }
+#endif
+			if (!ok) {
+				msgs.push_back (string_compose (
+						_("Unsupported required LV2 feature: '%1' in '%2'."),
+						rf, lilv_node_as_string(name)));
+				err = 1;
+			}
+	}
+	lilv_nodes_free (required_features);
+
+	if (err) {
+		lilv_node_free(name);
+		return false;
+	}
+
+	LilvNodes* required_options = lilv_world_find_nodes (world.world, lilv_plugin_get_uri (p), world.opts_requiredOptions, NULL);
+	if (required_options) {
+		LILV_FOREACH(nodes, i, required_options) {
+			const char* ro = lilv_node_as_uri (lilv_nodes_get (required_options, i));
+			bool ok = false;
+			if (!strcmp (ro, LV2_PARAMETERS__sampleRate)) { ok = true; }
+			if (!strcmp (ro, LV2_BUF_SIZE__minBlockLength)) { ok = true; }
+			if (!strcmp (ro, LV2_BUF_SIZE__maxBlockLength)) { ok = true; }
+			if (!strcmp (ro, LV2_BUF_SIZE__sequenceSize)) { ok = true; }
+			if (!ok) {
+				msgs.push_back (string_compose (
+						_("Unsupported required LV2 option: '%1' in '%2'."),
+						ro, lilv_node_as_string(name)));
+				err = 1;
+			}
+		}
+	}
+	lilv_nodes_free(required_options);
+
+	if (err) {
+		lilv_node_free(name);
+		return false;
+	}
+
+	e.name = string(lilv_node_as_string(name));
+	lilv_node_free(name);
+
+	const LilvPluginClass* pclass = lilv_plugin_get_class(p);
+	const LilvNode*        label  = lilv_plugin_class_get_label(pclass);
+	e.category = lilv_node_as_string(label);
+
+	LilvNode* author_name = lilv_plugin_get_author_name(p);
+	e.creator = author_name ? string(lilv_node_as_string(author_name)) : "Unknown";
+	lilv_node_free(author_name);
+
+	/* count atom-event-ports that feature
+	 * atom:supports <http://lv2plug.in/ns/ext/midi#MidiEvent>
+	 *
+	 * TODO: nicely ask drobilla to make a lilv_ call for that
+	 */
+	int count_midi_out = 0;
+	int count_midi_in = 0;
+	for (uint32_t i = 0; i < lilv_plugin_get_num_ports(p); ++i) {
+		const LilvPort* port  = lilv_plugin_get_port_by_index(p, i);
+		if (lilv_port_is_a(p, port, world.atom_AtomPort)) {
+			LilvNodes* buffer_types = lilv_port_get_value(
+				p, port, world.atom_bufferType);
+			LilvNodes* atom_supports = lilv_port_get_value(
+				p, port, world.atom_supports);
+
+			if (lilv_nodes_contains(buffer_types, world.atom_Sequence)
+					&& lilv_nodes_contains(atom_supports, world.midi_MidiEvent)) {
+				if (lilv_port_is_a(p, port, world.lv2_InputPort)) {
+					count_midi_in++;
+				}
+				if (lilv_port_is_a(p, port, world.lv2_OutputPort)) {
+					count_midi_out++;
+				}
+			}
+			lilv_nodes_free(buffer_types);
+			lilv_nodes_free(atom_supports);
+		}
+	}
+
+	e.n_inputs.set_audio(
+		lilv_plugin_get_num_ports_of_class(
+			p, world.lv2_InputPort, world.lv2_AudioPort, NULL));
+	e.n_inputs.set_midi(
+		lilv_plugin_get_num_ports_of_class(
+			p, world.lv2_InputPort, world.ev_EventPort, NULL)
+		+ count_midi_in);
+
+	e.n_outputs.set_audio(
+		lilv_plugin_get_num_ports_of_class(
+			p, world.lv2_OutputPort, world.lv2_AudioPort, NULL));
+	e.n_outputs.set_midi(
+		lilv_plugin_get_num_ports_of_class(
+			p, world.lv2_OutputPort, world.ev_EventPort, NULL)
+		+ count_midi_out);
+
+	e.unique_id = lilv_node_as_uri(lilv_plugin_get_uri(p));
+	e.index     = 0; // Meaningless for LV2
+
+	return true;
+}
+
+namespace {
+/** The plugins of one LV2 bundle, and what discovery found out about them */
+struct LV2Bundle {
+	LV2Bundle (std::string const& u, std::string const& p) : uri (u), path (p), cached (false) {}
+
+	std::string              uri;
+	std::string              path;
+	std::vector<std::string> uris;
+	bool                     cached;
+	PluginScanCache::Entries entries;
+	std::vector<std::string> msgs;
+};
+
+/** What the threads of lv2_scan_bundles() share */
+struct LV2ScanJob {
+	std::vector<LV2Bundle*>  bundles;
+	std::vector<std::string> spec_uris; ///< bundles with specifications, e.g. plugin classes
+	gint                     next;
+};
+}
+
+/** @return the URI of the bundle which @param file_uri is in */
+static std::string
+lv2_bundle_of (std::string const& file_uri)
+{
+	std::string::size_type const slash = file_uri.rfind ('/');
+	return slash == std::string::npos ? file_uri : file_uri.substr (0, slash + 1);
+}
+
+/** @return the URIs of the bundles which hold specifications that
+ *  @param world (with all manifests loaded) knows about.
+ */
+static std::vector<std::string>
+lv2_specification_bundles (LilvWorld* world)
+{
+	std::set<std::string> bundles;
+
+	LilvNode* rdf_type          = lilv_new_uri(world, LILV_NS_RDF "type");
+	LilvNode* rdfs_seeAlso      = lilv_new_uri(world, LILV_NS_RDFS "seeAlso");
+	LilvNode* lv2_Specification = lilv_new_uri(world, LILV_NS_LV2 "Specification");
+
+	LilvNodes* specs = lilv_world_find_nodes (world, NULL, rdf_type, lv2_Specification);
+	LILV_FOREACH(nodes, i, specs) {
+		LilvNodes* files = lilv_world_find_nodes (world, lilv_nodes_get (specs, i), rdfs_seeAlso, NULL);
+		LILV_FOREACH(nodes, f, files) {
+			const LilvNode* file = lilv_nodes_get (files, f);
+			if (lilv_node_is_uri (file)) {
+				bundles.insert (lv2_bundle_of (lilv_node_as_uri (file)));
+			}
+		}
+		lilv_nodes_free (files);
+	}
+	lilv_nodes_free (specs);
+
+	lilv_node_free (lv2_Specification);
+	lilv_node_free (rdfs_seeAlso);
+	lilv_node_free (rdf_type);
+
+	return std::vector<std::string> (bundles.begin (), bundles.end ());
+}
+
+/** Scan bundles of @param job until none are left.
+ *  Each thread uses a world of its own, lilv worlds are not thread-safe,
+ *  and loads only the specifications and the bundles it scans.
+ */
+static void
+lv2_scan_bundles (LV2ScanJob* job)
 {
 	LV2World world;
-	world.load_bundled_plugins();
+
+	for (std::vector<std::string>::const_iterator u = job->spec_uris.begin(); u != job->spec_uris.end(); ++u) {
+		LilvNode* node = lilv_new_uri(world.world, u->c_str());
+		lilv_world_load_bundle(world.world, node);
+		lilv_node_free(node);
+	}
+	lilv_world_load_specifications (world.world);
+	lilv_world_load_plugin_classes (world.world);
+
+	gint b;
+
+	while ((b = g_atomic_int_add (&job->next, 1)) < (gint) job->bundles.size ()) {
+		LV2Bundle& bundle (*job->bundles[b]);
+
+		LilvNode* node = lilv_new_uri(world.world, bundle.uri.c_str());
+		lilv_world_load_bundle(world.world, node);
+		lilv_node_free(node);
+
+		const LilvPlugins* plugins = lilv_world_get_all_plugins(world.world);
+
+		for (std::vector<std::string>::const_iterator u = bundle.uris.begin(); u != bundle.uris.end(); ++u) {
+			LilvNode* uri = lilv_new_uri(world.world, u->c_str());
+			const LilvPlugin* p = lilv_plugins_get_by_uri(plugins, uri);
+			lilv_node_free(uri);
+
+			PluginScanCache::Entry e;
+			if (p && lv2_plugin_entry (world, p, e, bundle.msgs)) {
+				bundle.entries.push_back (e);
+			}
+		}
+	}
+}
+
+/** @return the directories that lilv looks for bundles in by default,
+ *  see LILV_DEFAULT_LV2_PATH, or LV2_PATH; and those of bundled plugins.
+ */
+static std::vector<std::string>
+lv2_search_dirs ()
+{
+	bool defined = false;
+	Searchpath spath (Glib::getenv ("LV2_PATH", defined));
+
+	if (!defined) {
+#if defined PLATFORM_WINDOWS
+		spath.push_back (Glib::build_filename (PBD::get_win_special_folder_path (CSIDL_APPDATA), "LV2"));
+		spath.push_back (Glib::build_filename (PBD::get_win_special_folder_path (CSIDL_PROGRAM_FILES_COMMON), "LV2"));
+#elif defined __APPLE__
+		spath.push_back (Glib::build_filename (Glib::get_home_dir (), "Library/Audio/Plug-Ins/LV2"));
+		spath.push_back (Glib::build_filename (Glib::get_home_dir (), ".lv2"));
+		spath.push_back ("/usr/local/lib/lv2");
+		spath.push_back ("/usr/lib/lv2");
+		spath.push_back ("/Library/Audio/Plug-Ins/LV2");
+#else
+		spath.push_back (Glib::build_filename (Glib::get_home_dir (), ".lv2"));
+		spath.push_back ("/usr/local/lib/lv2");
+		spath.push_back ("/usr/lib/lv2");
+#endif
+	}
+
+	spath += ARDOUR::lv2_bundled_search_path ();
+
+	return std::vector<std::string> (spath.begin (), spath.end ());
+}
+
+/** Directories are kept in the cache, without plugins, to notice bundles
+ *  which were added. These are the default search directories and the
+ *  parent directories of all bundles (lilv may have been built to look
+ *  elsewhere).
+ *
+ *  @return true if neither a directory nor a bundle changed since the
+ *  last scan, @param entries are all plugins then.
+ */
+static bool
+lv2_cache_is_current (PluginScanCache& cache, PluginScanCache::Entries& entries)
+{
+	std::vector<std::string> const known = cache.paths ();
+
+	if (known.empty ()) {
+		return false;
+	}
+
+	std::vector<std::string> const dirs = lv2_search_dirs ();
+
+	for (std::vector<std::string>::const_iterator d = dirs.begin(); d != dirs.end(); ++d) {
+		if (std::find (known.begin (), known.end (), *d) == known.end ()) {
+			return false;
+		}
+	}
+
+	bool current = true;
+
+	/* look up all of them, so that none is dropped from the cache */
+	for (std::vector<std::string>::const_iterator p = known.begin(); p != known.end(); ++p) {
+		PluginScanCache::Entries const* cached = cache.lookup (*p);
+		if (!cached) {
+			current = false;
+		} else if (current) {
+			entries.insert (entries.end (), cached->begin (), cached->end ());
+		}
+	}
+
+	return current;
+}
+
+static void
+lv2_add_plugin_info (PluginInfoList* plugs, PluginScanCache::Entries const& entries, bool scanned)
+{
+	for (PluginScanCache::Entries::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+		if (scanned) {
+			ARDOUR::PluginScanMessage(_("LV2"), e->name, false);
+		}
+
+		LV2PluginInfoPtr info(new LV2PluginInfo(e->unique_id.c_str()));
+
+		info->type      = LV2;
+		info->name      = e->name;
+		info->category  = e->category;
+		info->creator   = e->creator;
+		info->path      = "/NOPATH"; // Meaningless for LV2
+		info->n_inputs  = e->n_inputs;
+		info->n_outputs = e->n_outputs;
+		info->unique_id = e->unique_id;
+		info->index     = e->index;
+
+		plugs->push_back(info);
+	}
+}
+
+PluginInfoList*
+LV2PluginInfo::discover (PluginScanCache* cache)
+{
+	PluginInfoList* plugs = new PluginInfoList;
+	PluginScanCache::Entries all_cached;
+
+	if (cache && lv2_cache_is_current (*cache, all_cached)) {
+		/* nothing was added, removed or modified: lilv does not need to
+		 * read any manifest until a plugin is instantiated.
+		 */
+		lv2_add_plugin_info (plugs, all_cached, false);
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("LV2: %1 plugins, all cached\n", plugs->size ()));
+		return plugs;
+	}
+
 	_world.load_bundled_plugins(true);
 
-	PluginInfoList*    plugs   = new PluginInfoList;
-	const LilvPlugins* plugins = lilv_world_get_all_plugins(world.world);
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(_world.world);
+
+	/* Listing the plugins and their bundles only needs the manifests,
+	 * which lilv has read already. Plugin data is only loaded for
+	 * bundles which changed since they were last scanned.
+	 */
+	std::map<std::string, LV2Bundle> bundles;
 
 	LILV_FOREACH(plugins, i, plugins) {
 		const LilvPlugin* p = lilv_plugins_get(plugins, i);
 		const LilvNode* pun = lilv_plugin_get_uri(p);
 		if (!pun) continue;
-		LV2PluginInfoPtr info(new LV2PluginInfo(lilv_node_as_string(pun)));
 
-		LilvNode* name = lilv_plugin_get_name(p);
-		if (!name || !lilv_plugin_get_port_by_index(p, 0)) {
-			warning << "Ignoring invalid LV2 plugin "
-			        << lilv_node_as_string(lilv_plugin_get_uri(p))
-			        << endmsg;
-			continue;
-		}
+		std::string const uri (lilv_node_as_uri(lilv_plugin_get_bundle_uri(p)));
 
-		if (lilv_plugin_has_feature(p, world.lv2_inPlaceBroken)) {
-			warning << string_compose(
-			    _("Ignoring LV2 plugin \"%1\" since it cannot do inplace processing."),
-			    lilv_node_as_string(name)) << endmsg;
-			lilv_node_free(name);
-			continue;
+		std::map<std::string, LV2Bundle>::iterator b = bundles.find (uri);
+		if (b == bundles.end ()) {
+			char* bp = lilv_file_uri_parse(uri.c_str(), NULL);
+			std::string const path (bp ? bp : "");
+			free (bp);
+			b = bundles.insert (make_pair (uri, LV2Bundle (uri, path))).first;
 		}
+		b->second.uris.push_back (lilv_node_as_string(pun));
+	}
 
-		int err = 0;
-		LilvNodes* required_features = lilv_plugin_get_required_features (p);
-		LILV_FOREACH(nodes, i, required_features) {
-				const char* rf = lilv_node_as_uri (lilv_nodes_get (required_features, i));
-				bool ok = false;
-				if (!strcmp (rf, "http://lv2plug.in/ns/ext/instance-access")) { ok = true; }
-				if (!strcmp (rf, "http://lv2plug.in/ns/ext/data-access")) { ok = true; }
-				if (!strcmp (rf, LV2_STATE__makePath)) { ok = true; }
-				if (!strcmp (rf, LV2_LOG__log)) { ok = true; }
-				if (!strcmp (rf, LV2_WORKER__schedule)) { ok = true; }
-				if (!strcmp (rf, LV2_STATE_PREFIX "loadDefaultState")) { ok = true; }
-				if (!strcmp (rf, LV2_URID_MAP_URI)) { ok = true; }
-				if (!strcmp (rf, LV2_URID_UNMAP_URI)) { ok = true; }
-				if (!strcmp (rf, "http://lv2plug.in/ns/lv2core#isLive")) { ok = true; }
-				if (!strcmp (rf, LV2_BUF_SIZE__boundedBlockLength)) { ok = true; }
-				if (!strcmp (rf, "http://lv2plug.in/ns/ext/buf-size#coarseBlockLength" /*LV2_BUF_SIZE__coarseBlockLength*/)) { ok = true; }
-				if (!strcmp (rf, LV2_OPTIONS__options)) { ok = true; }
-#ifdef LV2_EXTENDED
-				if (!strcmp (rf, LV2_INLINEDISPLAY__queue_draw)) { ok = true; }
-				if (!strcmp (rf, LV2_MIDNAM__update)) { ok = true; }
-				if (!strcmp (rf, LV2_BANKPATCH__notify)) { ok = true; }
-#endif
-				if (!ok) {
-					warning << string_compose (
-							_("Unsupported required LV2 feature: '%1' in '%2'."),
-							rf, lilv_node_as_string(name)) << endmsg;
-					err = 1;
-				}
-		}
+	LV2ScanJob job;
+	job.next = 0;
 
-		if (err) {
+	for (std::map<std::string, LV2Bundle>::iterator b = bundles.begin(); b != bundles.end(); ++b) {
+		LV2Bundle& bundle (b->second);
+		PluginScanCache::Entries const* cached = (cache && !bundle.path.empty()) ? cache->lookup (bundle.path) : 0;
+
+		if (!cached) {
+			job.bundles.push_back (&bundle);
 			continue;
 		}
 
-		lilv_nodes_free (required_features);
-
-		LilvNodes* required_options = lilv_world_find_nodes (world.world, lilv_plugin_get_uri (p), world.opts_requiredOptions, NULL);
-		if (required_options) {
-			LILV_FOREACH(nodes, i, required_options) {
-				const char* ro = lilv_node_as_uri (lilv_nodes_get (required_options, i));
-				bool ok = false;
-				if (!strcmp (ro, LV2_PARAMETERS__sampleRate)) { ok = true; }
-				if (!strcmp (ro, LV2_BUF_SIZE__minBlockLength)) { ok = true; }
-				if (!strcmp (ro, LV2_BUF_SIZE__maxBlockLength)) { ok = true; }
-				if (!strcmp (ro, LV2_BUF_SIZE__sequenceSize)) { ok = true; }
-				if (!ok) {
-					warning << string_compose (
-							_("Unsupported required LV2 option: '%1' in '%2'."),
-							ro, lilv_node_as_string(name)) << endmsg;
-					err = 1;
+		/* plugins which were not found usable have no entry */
+		bundle.cached = true;
+		for (std::vector<std::string>::const_iterator u = bundle.uris.begin(); u != bundle.uris.end(); ++u) {
+			for (PluginScanCache::Entries::const_iterator e = cached->begin(); e != cached->end(); ++e) {
+				if (e->unique_id == *u) {
+					bundle.entries.push_back (*e);
+					break;
 				}
 			}
 		}
-		lilv_nodes_free(required_options);
+	}
 
-		if (err) {
-			continue;
-		}
+	if (!job.bundles.empty ()) {
+		uint32_t const n_threads = std::min ((uint32_t) job.bundles.size (), std::max (1u, hardware_concurrency ()));
+		std::vector<Glib::Threads::Thread*> threads;
 
-		info->type = LV2;
+		job.spec_uris = lv2_specification_bundles (_world.world);
 
-		info->name = string(lilv_node_as_string(name));
-		lilv_node_free(name);
-		ARDOUR::PluginScanMessage(_("LV2"), info->name, false);
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("LV2: scanning %1 of %2 bundles using %3 threads\n", job.bundles.size (), bundles.size (), n_threads));
 
-		const LilvPluginClass* pclass = lilv_plugin_get_class(p);
-		const LilvNode*        label  = lilv_plugin_class_get_label(pclass);
-		info->category = lilv_node_as_string(label);
+		for (uint32_t n = 1; n < n_threads; ++n) {
+			try {
+				threads.push_back (Glib::Threads::Thread::create (sigc::bind (sigc::ptr_fun (&lv2_scan_bundles), &job)));
+			} catch (Glib::Threads::ThreadError const&) {
+				break;
+			}
+		}
 
-		LilvNode* author_name = lilv_plugin_get_author_name(p);
-		info->creator = author_name ? string(lilv_node_as_string(author_name)) : "Unknown";
-		lilv_node_free(author_name);
+		lv2_scan_bundles (&job);
 
-		info->path = "/NOPATH"; // Meaningless for LV2
+		for (std::vector<Glib::Threads::Thread*>::iterator t = threads.begin(); t != threads.end(); ++t) {
+			(*t)->join ();
+		}
+	}
 
-		/* count atom-event-ports that feature
-		 * atom:supports <http://lv2plug.in/ns/ext/midi#MidiEvent>
-		 *
-		 * TODO: nicely ask drobilla to make a lilv_ call for that
-		 */
-		int count_midi_out = 0;
-		int count_midi_in = 0;
-		for (uint32_t i = 0; i < lilv_plugin_get_num_ports(p); ++i) {
-			const LilvPort* port  = lilv_plugin_get_port_by_index(p, i);
-			if (lilv_port_is_a(p, port, world.atom_AtomPort)) {
-				LilvNodes* buffer_types = lilv_port_get_value(
-					p, port, world.atom_bufferType);
-				LilvNodes* atom_supports = lilv_port_get_value(
-					p, port, world.atom_supports);
-
-				if (lilv_nodes_contains(buffer_types, world.atom_Sequence)
-						&& lilv_nodes_contains(atom_supports, world.midi_MidiEvent)) {
-					if (lilv_port_is_a(p, port, world.lv2_InputPort)) {
-						count_midi_in++;
-					}
-					if (lilv_port_is_a(p, port, world.lv2_OutputPort)) {
-						count_midi_out++;
-					}
-				}
-				lilv_nodes_free(buffer_types);
-				lilv_nodes_free(atom_supports);
-			}
+	std::set<std::string> dirs;
+
+	for (std::map<std::string, LV2Bundle>::const_iterator b = bundles.begin(); b != bundles.end(); ++b) {
+		LV2Bundle const& bundle (b->second);
+
+		for (std::vector<std::string>::const_iterator m = bundle.msgs.begin(); m != bundle.msgs.end(); ++m) {
+			warning << *m << endmsg;
 		}
 
-		info->n_inputs.set_audio(
-			lilv_plugin_get_num_ports_of_class(
-				p, world.lv2_InputPort, world.lv2_AudioPort, NULL));
-		info->n_inputs.set_midi(
-			lilv_plugin_get_num_ports_of_class(
-				p, world.lv2_InputPort, world.ev_EventPort, NULL)
-			+ count_midi_in);
+		lv2_add_plugin_info (plugs, bundle.entries, !bundle.cached);
 
-		info->n_outputs.set_audio(
-			lilv_plugin_get_num_ports_of_class(
-				p, world.lv2_OutputPort, world.lv2_AudioPort, NULL));
-		info->n_outputs.set_midi(
-			lilv_plugin_get_num_ports_of_class(
-				p, world.lv2_OutputPort, world.ev_EventPort, NULL)
-			+ count_midi_out);
+		if (cache && !bundle.path.empty()) {
+			if (!bundle.cached) {
+				cache->set (bundle.path, bundle.entries);
+			}
+			std::string dir (bundle.path);
+			if (dir.size () > 1 && dir[dir.size () - 1] == G_DIR_SEPARATOR) {
+				dir.erase (dir.size () - 1);
+			}
+			dirs.insert (Glib::path_get_dirname (dir));
+		}
+	}
 
-		info->unique_id = lilv_node_as_uri(lilv_plugin_get_uri(p));
-		info->index     = 0; // Meaningless for LV2
+	if (cache) {
+		std::vector<std::string> const search_dirs = lv2_search_dirs ();
+		dirs.insert (search_dirs.begin (), search_dirs.end ());
 
-		plugs->push_back(info);
+		for (std::set<std::string>::const_iterator d = dirs.begin(); d != dirs.end(); ++d) {
+			if (!cache->lookup (*d)) {
+				cache->set (*d, PluginScanCache::Entries ());
+			}
+		}
 	}
 
 	return plugs;
@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <iostream>
 
 #include "pbd/malign.h"
@@ -35,6 +36,8 @@ using namespace std;
 using namespace ARDOUR;
 using namespace PBD;
 
+const size_t MidiBuffer::max_merge_sources;
+
 // FIXME: mirroring for MIDI buffers?
 MidiBuffer::MidiBuffer(size_t capacity)
 	: Buffer (DataType::MIDI)
@@ -458,149 +461,216 @@ MidiBuffer::merge_in_place (const MidiBuffer &other)
 		return true;
 	}
 
-	if (size() + other.size() > _capacity) {
+	const MidiBuffer* others[] = { &other };
+	return merge_in_place (others, 1);
+}
+
+bool
+MidiBuffer::merge_in_place (MidiBuffer const* const* others, size_t n_others)
+{
+	size_t total = _size;
+
+	for (size_t i = 0; i < n_others; ++i) {
+		assert (others[i] != this);
+		total += others[i]->size();
+	}
+
+	if (total > _capacity) {
+		/* merge those which fit, one at a time, so that one buffer
+		 * which does not fit (e.g. a dense send) does not drop the
+		 * events (e.g. note-offs) of all the others.
+		 */
+		for (size_t i = 0; i < n_others; ++i) {
+			if (others[i]->size() > 0 && _size + others[i]->size() <= _capacity) {
+				merge_sorted (others + i, 1);
+			}
+		}
 		return false;
 	}
 
-	const_iterator them = other.begin();
-	iterator us = begin();
+	for (size_t i = 0; i < n_others; i += max_merge_sources) {
+		merge_sorted (others + i, min (n_others - i, max_merge_sources));
+	}
 
-	while (them != other.end()) {
+	return true;
+}
 
-		size_t bytes_to_merge;
-		ssize_t merge_offset;
+namespace {
 
-		/* gather up total size of events that are earlier than
-		   the event referenced by "us"
-		*/
+/** The order of channel messages of the same channel at the same time, as
+ *  defined by MidiBuffer::second_simultaneous_midi_byte_is_first().  The
+ *  order of other messages does not matter.
+ */
+uint8_t
+simultaneous_midi_priority (uint8_t status)
+{
+	switch (status & 0xf0) {
+	case MIDI_CMD_PGM_CHANGE:
+		return 1;
+	case MIDI_CMD_NOTE_OFF:
+		return 2;
+	case MIDI_CMD_NOTE_ON:
+		return 3;
+	case MIDI_CMD_NOTE_PRESSURE:
+		return 4;
+	case MIDI_CMD_CHANNEL_PRESSURE:
+		return 5;
+	case MIDI_CMD_BENDER:
+		return 6;
+	default:
+		return 0;
+	}
+}
 
-		merge_offset = -1;
-		bytes_to_merge = 0;
+/** The next event of one of the buffers being merged */
+struct MergeSource {
+	const uint8_t*       data;
+	size_t               offset;
+	size_t               end;
+	size_t               index; ///< events which may go either way are taken from the lower index first
+	MidiBuffer::TimeType time;
+	uint8_t              priority;
 
-		while (them != other.end() && (*them).time() < (*us).time()) {
-			if (merge_offset == -1) {
-				merge_offset = them.offset;
-			}
-			bytes_to_merge += sizeof (TimeType) + (*them).size();
-			++them;
-		}
+	bool at_end () const { return offset == end; }
 
-		/* "them" now points to either:
-		 *
-		 * 1) an event that has the same or later timestamp than the
-		 *        event pointed to by "us"
-		 *
-		 * OR
-		 *
-		 * 2) the end of the "other" buffer
-		 *
-		 * if "sz" is non-zero, there is data to be merged from "other"
-		 * into this buffer before we do anything else, corresponding
-		 * to the events from "other" that we skipped while advancing
-		 * "them".
-		 */
+	void load () {
+		time = *(reinterpret_cast<const MidiBuffer::TimeType*>((uintptr_t)(data + offset)));
+		priority = simultaneous_midi_priority (data[offset + sizeof (MidiBuffer::TimeType)]);
+	}
 
-		if (bytes_to_merge) {
-			assert(merge_offset >= 0);
-			/* move existing */
-			memmove (_data + us.offset + bytes_to_merge, _data + us.offset, _size - us.offset);
-			/* increase _size */
-			_size += bytes_to_merge;
-			assert (_size <= _capacity);
-			/* insert new stuff */
-			memcpy  (_data + us.offset, other._data + merge_offset, bytes_to_merge);
-			/* update iterator to our own events. this is a miserable hack */
-			us.offset += bytes_to_merge;
+	void next () {
+		const int event_size = Evoral::midi_event_size (data + offset + sizeof (MidiBuffer::TimeType));
+		assert (event_size >= 0);
+		offset += sizeof (MidiBuffer::TimeType) + event_size;
+		if (offset < end) {
+			load ();
+		} else {
+			offset = end;
 		}
+	}
 
-		/* if we're at the end of the other buffer, we're done */
+	bool precedes (const MergeSource& other) const {
+		if (time != other.time) {
+			return time < other.time;
+		}
+		if (priority != other.priority) {
+			return priority < other.priority;
+		}
+		return index < other.index;
+	}
+};
+
+/** Restore the order of the binary heap @param heap of @param n elements
+ *  after its element @param i changed.
+ */
+void
+sift_down (MergeSource* heap, size_t n, size_t i)
+{
+	while (true) {
+		const size_t l = 2 * i + 1;
+		const size_t r = l + 1;
+		size_t first = i;
 
-		if (them == other.end()) {
+		if (l < n && heap[l].precedes (heap[first])) {
+			first = l;
+		}
+		if (r < n && heap[r].precedes (heap[first])) {
+			first = r;
+		}
+		if (first == i) {
 			break;
 		}
+		swap (heap[i], heap[first]);
+		i = first;
+	}
+}
 
-		/* if we have two messages messages with the same timestamp. we
-		 * must order them correctly.
-		 */
+} // anon namespace
 
-		if ((*us).time() == (*them).time()) {
+/** Merge up to max_merge_sources buffers, which fit, into this one.
+ *
+ * Our own events are first moved to the end of the buffer, then all events
+ * are copied to the start in order, taking runs of events from a heap of
+ * the buffers ordered by their next event.  Our own events are never
+ * overwritten before they are copied, since everything written before them
+ * comes from the other buffers, which they were moved up by.
+ */
+void
+MidiBuffer::merge_sorted (MidiBuffer const* const* others, size_t n_others)
+{
+	assert (n_others <= max_merge_sources);
 
-			DEBUG_TRACE (DEBUG::MidiIO,
-				     string_compose ("simultaneous MIDI events discovered during merge, times %1/%2 status %3/%4\n",
-						     (*us).time(), (*them).time(),
-						     (int) *(_data + us.offset + sizeof (TimeType)),
-						     (int) *(other._data + them.offset + sizeof (TimeType))));
+	MergeSource heap[max_merge_sources + 1];
+	size_t n_heap = 0;
+	size_t moved = 0;
 
-			uint8_t our_midi_status_byte = *(_data + us.offset + sizeof (TimeType));
-			uint8_t their_midi_status_byte = *(other._data + them.offset + sizeof (TimeType));
-			bool them_first = second_simultaneous_midi_byte_is_first (our_midi_status_byte, their_midi_status_byte);
+	for (size_t i = 0; i < n_others; ++i) {
+		moved += others[i]->size();
+	}
 
-			DEBUG_TRACE (DEBUG::MidiIO, string_compose ("other message came first ? %1\n", them_first));
+	if (moved == 0) {
+		return;
+	}
 
-			if (!them_first) {
-				/* skip past our own event */
-				++us;
-			}
+	if (_size) {
+		memmove (_data + moved, _data, _size);
 
-			bytes_to_merge = sizeof (TimeType) + (*them).size();
-
-			/* move our remaining events later in the buffer by
-			 * enough to fit the one message we're going to merge
-			 */
-
-			memmove (_data + us.offset + bytes_to_merge, _data + us.offset, _size - us.offset);
-			/* increase _size */
-			_size += bytes_to_merge;
-			assert(_size <= _capacity);
-			/* insert new stuff */
-			memcpy  (_data + us.offset, other._data + them.offset, bytes_to_merge);
-			/* update iterator to our own events. this is a miserable hack */
-			us.offset += bytes_to_merge;
-			/* 'us' is now an iterator to the event right after the
-			   new ones that we merged
-			*/
-			if (them_first) {
-				/* need to skip the event pointed to by 'us'
-				   since its at the same time as 'them'
-				   (still), and we'll enter
-				*/
-
-				if (us != end()) {
-					++us;
-				}
-			}
+		MergeSource& ours (heap[n_heap++]);
+		ours.data   = _data;
+		ours.offset = moved;
+		ours.end    = moved + _size;
+		ours.index  = 0;
+		ours.load ();
+	}
 
-			/* we merged one event from the other buffer, so
-			 * advance the iterator there.
-			 */
+	for (size_t i = 0; i < n_others; ++i) {
+		if (others[i]->size() == 0) {
+			continue;
+		}
+		MergeSource& theirs (heap[n_heap++]);
+		theirs.data   = others[i]->_data;
+		theirs.offset = 0;
+		theirs.end    = others[i]->size();
+		theirs.index  = i + 1;
+		theirs.load ();
+	}
 
-			++them;
+	for (size_t i = n_heap / 2; i > 0; --i) {
+		sift_down (heap, n_heap, i - 1);
+	}
 
-		} else {
+	size_t write = 0;
 
-			/* advance past our own events to get to the correct insertion
-			   point for the next event(s) from "other"
-			*/
+	while (n_heap > 0) {
+		MergeSource& src (heap[0]);
+		const size_t run_start = src.offset;
 
-			while (us != end() && (*us).time() <= (*them).time()) {
-				++us;
-			}
+		if (n_heap == 1) {
+			/* everything else is merged, append the rest */
+			src.offset = src.end;
+		} else {
+			/* take events while they still precede the next event of any other buffer */
+			const MergeSource& next (n_heap == 2 || heap[1].precedes (heap[2]) ? heap[1] : heap[2]);
+			do {
+				src.next ();
+			} while (!src.at_end () && src.precedes (next));
 		}
 
-		/* check to see if we reached the end of this buffer while
-		 * looking for the insertion point.
-		 */
-
-		if (us == end()) {
+		const size_t run = src.offset - run_start;
 
-			/* just append the rest of other and we're done*/
+		if (src.data == _data) {
+			memmove (_data + write, _data + run_start, run);
+		} else {
+			memcpy (_data + write, src.data + run_start, run);
+		}
+		write += run;
 
-			memcpy (_data + us.offset, other._data + them.offset, other._size - them.offset);
-			_size += other._size - them.offset;
-			assert(_size <= _capacity);
-			break;
+		if (src.at_end ()) {
+			heap[0] = heap[--n_heap];
 		}
+		sift_down (heap, n_heap, 0);
 	}
 
-	return true;
+	assert (write == _size + moved);
+	_size += moved;
 }
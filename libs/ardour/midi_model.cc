@@ -38,6 +38,7 @@
 #include "midi++/events.h"
 
 #include "ardour/automation_control.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/evoral_types_convert.h"
 #include "ardour/midi_automation_list_binder.h"
 #include "ardour/midi_model.h"
@@ -296,7 +297,7 @@ MidiModel::NoteDiffCommand::operator() ()
 				break;
 
 			case Length:
-				i->note->set_length (i->new_value.get_beats());
+				_model->set_note_length_unlocked (i->note, i->new_value.get_beats());
 				break;
 
 			}
@@ -411,7 +412,7 @@ MidiModel::NoteDiffCommand::undo ()
 				break;
 
 			case Length:
-				i->note->set_length (i->old_value.get_beats());
+				_model->set_note_length_unlocked (i->note, i->old_value.get_beats());
 				break;
 			}
 		}
@@ -1463,8 +1464,12 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	TimeType sa = note->time();
 	TimeType ea  = note->end_time();
 
+	/* only notes that start in this range can overlap the new one */
+	const TimeType max_length = max_note_length (note->channel());
+	const TimeType earliest   = sa > max_length ? sa - max_length : TimeType();
+
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<TimeType>(0, TimeType(), TimeType(), note->note()));
+	NotePtr search_note(new Note<TimeType>(0, earliest, TimeType(), note->note()));
 	set<NotePtr> to_be_deleted;
 	bool set_note_length = false;
 	bool set_note_time = false;
@@ -1474,7 +1479,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 checking overlaps for note %2 @ %3\n", this, (int)note->note(), note->time()));
 
 	for (Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	     i != p.end() && (*i)->note() == note->note() && (*i)->time() <= ea; ++i) {
 
 		TimeType sb = (*i)->time();
 		TimeType eb = (*i)->end_time();
@@ -1514,7 +1519,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 				if (cmd) {
 					cmd->change (*i, NoteDiffCommand::Length, (note->time() - (*i)->time()));
 				}
-				(*i)->set_length (note->time() - (*i)->time());
+				set_note_length_unlocked (*i, note->time() - (*i)->time());
 				break;
 			case InsertMergeTruncateAddition:
 				set_note_time = true;
@@ -1526,7 +1531,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 				if (cmd) {
 					cmd->change ((*i), NoteDiffCommand::Length, note->end_time() - (*i)->time());
 				}
-				(*i)->set_length (note->end_time() - (*i)->time());
+				set_note_length_unlocked (*i, note->end_time() - (*i)->time());
 				return -1; /* do not add the new note */
 				break;
 			default:
@@ -1784,7 +1789,7 @@ MidiModel::insert_silence_at_start (TimeType t)
 		XMLNode& before = ac->alist()->get_state ();
 		i->second->list()->shift (0, t.to_double());
 		XMLNode& after = ac->alist()->get_state ();
-		s->session().add_command (new MementoCommand<AutomationList> (new MidiAutomationListBinder (s, i->first), &before, &after));
+		s->session().add_command (new AutomationListDiffCommand (new MidiAutomationListBinder (s, i->first), &before, &after));
 	}
 
 	/* Sys-ex */
@@ -145,6 +145,26 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+float
+default_apply_gain_ramp (ARDOUR::Sample * buf, pframes_t nframes, float initial, float target, float coeff)
+{
+	float g = initial;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] *= g;
+		g += coeff * (target - g);
+	}
+	return g;
+}
+
+void
+default_mix_buffers_with_gain_ramp (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float initial, float target)
+{
+	const float delta = (target - initial) / nframes;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] += src[i] * (initial + i * delta);
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
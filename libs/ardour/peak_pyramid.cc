@@ -0,0 +1,371 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "ardour/debug.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/peak_pyramid.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+/* On-disk layout of the pyramid file, native byte order (as is the
+ * peakfile itself). Level data follows the header, each level is a
+ * plain array of PeakData.
+ */
+struct PyramidHeader {
+	char    magic[8];
+	int32_t version;
+	int32_t n_levels;   // not including level 0, which is the peakfile
+	int64_t base_size;  // size of the peakfile that this was built from
+	int64_t base_mtime; // and its modification time
+	int64_t fpp;        // samples per peak at level 0
+	struct {
+		int64_t offset;
+		int64_t count;
+	} level[PeakPyramid::max_levels - 1];
+};
+
+static const char     pyramid_magic[8]   = { 'A', 'R', 'D', 'P', 'K', 'M', 'I', 'P' };
+static const int32_t  pyramid_version    = 1;
+
+/* peakfiles with fewer peaks are cheap enough to reduce directly */
+static const samplecnt_t min_build_count = 4096;
+
+/* use a coarser level only if each visual peak still spans at least
+ * this many of its stored peaks, to keep the error at the edges small.
+ */
+static const double min_stored_per_visual = 4.0;
+
+PeakPyramid::PeakPyramid (string const& peakpath, samplecnt_t fpp)
+	: _peakpath (peakpath)
+	, _fpp (fpp)
+	, _base (0)
+	, _pyramid (0)
+	, _n_levels (0)
+	, _needs_build (false)
+{
+	memset (_levels, 0, sizeof (_levels));
+}
+
+PeakPyramid::~PeakPyramid ()
+{
+	close ();
+}
+
+string
+PeakPyramid::pyramid_path (string const& peakpath)
+{
+	return peakpath + peak_pyramid_suffix;
+}
+
+void
+PeakPyramid::close ()
+{
+	if (_pyramid) {
+		g_mapped_file_unref (_pyramid);
+		_pyramid = 0;
+	}
+	if (_base) {
+		g_mapped_file_unref (_base);
+		_base = 0;
+	}
+	memset (_levels, 0, sizeof (_levels));
+	_n_levels = 0;
+	_needs_build = false;
+}
+
+int
+PeakPyramid::open ()
+{
+	close ();
+
+	GStatBuf statbuf;
+	GError*  err = 0;
+
+	if (g_stat (_peakpath.c_str (), &statbuf) != 0) {
+		return -1;
+	}
+
+	if (!(_base = g_mapped_file_new (_peakpath.c_str (), FALSE, &err))) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Cannot map peakfile %1 (%2)\n", _peakpath, err->message));
+		g_error_free (err);
+		return -1;
+	}
+
+	const size_t base_size = g_mapped_file_get_length (_base);
+
+	if (base_size < sizeof (PeakData)) {
+		close ();
+		return -1;
+	}
+
+	_levels[0].fpp   = _fpp;
+	_levels[0].data  = (PeakData const*) g_mapped_file_get_contents (_base);
+	_levels[0].count = base_size / sizeof (PeakData);
+	_n_levels = 1;
+
+	if (_levels[0].count < min_build_count) {
+		return 0;
+	}
+
+	_needs_build = true;
+
+	string const path = pyramid_path (_peakpath);
+
+	if (!g_file_test (path.c_str (), G_FILE_TEST_EXISTS)) {
+		return 0;
+	}
+
+	if (!(_pyramid = g_mapped_file_new (path.c_str (), FALSE, &err))) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Cannot map peak pyramid %1 (%2)\n", path, err->message));
+		g_error_free (err);
+		return 0;
+	}
+
+	const size_t  size = g_mapped_file_get_length (_pyramid);
+	char const*   addr = g_mapped_file_get_contents (_pyramid);
+	PyramidHeader hdr;
+
+	if (size < sizeof (hdr)) {
+		goto stale;
+	}
+
+	memcpy (&hdr, addr, sizeof (hdr));
+
+	if (memcmp (hdr.magic, pyramid_magic, sizeof (pyramid_magic))
+	    || hdr.version != pyramid_version
+	    || hdr.n_levels < 1 || hdr.n_levels > (int32_t) max_levels - 1
+	    || hdr.fpp != _fpp
+	    || hdr.base_size != (int64_t) base_size
+	    || hdr.base_mtime != (int64_t) statbuf.st_mtime) {
+		goto stale;
+	}
+
+	for (int32_t l = 0; l < hdr.n_levels; ++l) {
+		if (hdr.level[l].offset < (int64_t) sizeof (hdr)
+		    || hdr.level[l].count < 1
+		    || hdr.level[l].offset + hdr.level[l].count * (int64_t) sizeof (PeakData) > (int64_t) size) {
+			goto stale;
+		}
+		_levels[l + 1].fpp   = _levels[l].fpp * level_factor;
+		_levels[l + 1].data  = (PeakData const*) (addr + hdr.level[l].offset);
+		_levels[l + 1].count = hdr.level[l].count;
+	}
+
+	_n_levels    = hdr.n_levels + 1;
+	_needs_build = false;
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Mapped %1 with %2 levels\n", _peakpath, _n_levels));
+	return 0;
+
+  stale:
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak pyramid %1 is out of date\n", path));
+	g_mapped_file_unref (_pyramid);
+	_pyramid = 0;
+	return 0;
+}
+
+bool
+PeakPyramid::read (PeakData* peaks, samplecnt_t npeaks, samplepos_t start, double samples_per_visual_peak) const
+{
+	if (_n_levels == 0 || npeaks <= 0) {
+		return _n_levels > 0;
+	}
+
+	/* the last visual peak may overlap the final, partial stored peak,
+	 * anything beyond that is not (yet) in the peakfile.
+	 */
+	const double end = start + npeaks * samples_per_visual_peak;
+	if ((samplepos_t) floor ((end - 1) / _levels[0].fpp) > _levels[0].count) {
+		return false;
+	}
+
+	uint32_t l = 0;
+	while (l + 1 < _n_levels && _levels[l + 1].fpp * min_stored_per_visual <= samples_per_visual_peak) {
+		++l;
+	}
+
+	Level const&    lvl   = _levels[l];
+	PeakData const* data  = lvl.data;
+	const double    fpp   = lvl.fpp;
+
+	for (samplecnt_t n = 0; n < npeaks; ++n) {
+		const double s0 = start + n * samples_per_visual_peak;
+		samplepos_t  i0 = (samplepos_t) floor (s0 / fpp);
+		samplepos_t  i1 = (samplepos_t) ceil ((s0 + samples_per_visual_peak) / fpp);
+
+		i1 = std::min (std::max (i1, i0 + 1), lvl.count);
+
+		if (i0 >= lvl.count) {
+			peaks[n].max = 0;
+			peaks[n].min = 0;
+			continue;
+		}
+
+		PeakData::PeakDatum xmax = data[i0].max;
+		PeakData::PeakDatum xmin = data[i0].min;
+
+		for (samplepos_t i = i0 + 1; i < i1; ++i) {
+			xmax = std::max (xmax, data[i].max);
+			xmin = std::min (xmin, data[i].min);
+		}
+
+		peaks[n].max = xmax;
+		peaks[n].min = xmin;
+	}
+
+	return true;
+}
+
+static void
+reduce (vector<PeakData>& dst, PeakData const* src, samplecnt_t count, uint32_t factor)
+{
+	dst.resize ((count + factor - 1) / factor);
+
+	for (size_t n = 0; n < dst.size (); ++n) {
+		const samplecnt_t i0 = n * factor;
+		const samplecnt_t i1 = std::min (i0 + (samplecnt_t) factor, count);
+
+		PeakData p = src[i0];
+		for (samplecnt_t i = i0 + 1; i < i1; ++i) {
+			p.max = std::max (p.max, src[i].max);
+			p.min = std::min (p.min, src[i].min);
+		}
+		dst[n] = p;
+	}
+}
+
+int
+PeakPyramid::build (string const& peakpath, samplecnt_t fpp)
+{
+	GStatBuf statbuf;
+	GError*  err = 0;
+
+	if (g_stat (peakpath.c_str (), &statbuf) != 0) {
+		return -1;
+	}
+
+	GMappedFile* base = g_mapped_file_new (peakpath.c_str (), FALSE, &err);
+
+	if (!base) {
+		error << string_compose (_("Cannot map peakfile %1 (%2)"), peakpath, err->message) << endmsg;
+		g_error_free (err);
+		return -1;
+	}
+
+	const size_t base_size = g_mapped_file_get_length (base);
+
+	if ((int64_t) base_size != (int64_t) statbuf.st_size || base_size / sizeof (PeakData) < (size_t) min_build_count) {
+		/* being rewritten, or not worth it */
+		g_mapped_file_unref (base);
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak pyramid for %1\n", peakpath));
+
+	vector<PeakData> levels[max_levels - 1];
+
+	reduce (levels[0], (PeakData const*) g_mapped_file_get_contents (base), base_size / sizeof (PeakData), level_factor);
+	g_mapped_file_unref (base);
+
+	for (uint32_t l = 1; l < max_levels - 1; ++l) {
+		reduce (levels[l], &levels[l - 1][0], levels[l - 1].size (), level_factor);
+	}
+
+	PyramidHeader hdr;
+	memset (&hdr, 0, sizeof (hdr));
+	memcpy (hdr.magic, pyramid_magic, sizeof (pyramid_magic));
+	hdr.version    = pyramid_version;
+	hdr.n_levels   = max_levels - 1;
+	hdr.base_size  = base_size;
+	hdr.base_mtime = statbuf.st_mtime;
+	hdr.fpp        = fpp;
+
+	int64_t offset = sizeof (hdr);
+	for (uint32_t l = 0; l < max_levels - 1; ++l) {
+		hdr.level[l].offset = offset;
+		hdr.level[l].count  = levels[l].size ();
+		offset += levels[l].size () * sizeof (PeakData);
+	}
+
+	string const path = pyramid_path (peakpath);
+	string const tmp  = path + temp_suffix;
+
+	FILE* f = g_fopen (tmp.c_str (), "wb");
+
+	if (!f) {
+		error << string_compose (_("Cannot open peak pyramid %1 for writing (%2)"), tmp, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	bool ok = fwrite (&hdr, sizeof (hdr), 1, f) == 1;
+
+	for (uint32_t l = 0; ok && l < max_levels - 1; ++l) {
+		ok = fwrite (&levels[l][0], sizeof (PeakData), levels[l].size (), f) == levels[l].size ();
+	}
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+	if (!ok || g_rename (tmp.c_str (), path.c_str ()) != 0) {
+		error << string_compose (_("Cannot write peak pyramid %1 (%2)"), path, strerror (errno)) << endmsg;
+		::g_unlink (tmp.c_str ());
+		return -1;
+	}
+
+	return 0;
+}
+
+void
+PeakPyramid::retime (string const& peakpath, time_t from, time_t to)
+{
+	string const path = pyramid_path (peakpath);
+	FILE*        f    = g_fopen (path.c_str (), "r+b");
+
+	if (!f) {
+		return;
+	}
+
+	PyramidHeader hdr;
+
+	if (fread (&hdr, sizeof (hdr), 1, f) == 1
+	    && !memcmp (hdr.magic, pyramid_magic, sizeof (pyramid_magic))
+	    && hdr.version == pyramid_version
+	    && hdr.base_mtime == (int64_t) from) {
+		hdr.base_mtime = to;
+		if (fseek (f, 0, SEEK_SET) == 0) {
+			fwrite (&hdr, sizeof (hdr), 1, f);
+		}
+	}
+
+	fclose (f);
+}
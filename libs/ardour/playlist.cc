@@ -473,6 +473,8 @@ Playlist::notify_layering_changed ()
 void
 Playlist::notify_region_removed (boost::shared_ptr<Region> r)
 {
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_removes.insert (r);
 		pending_contents_change = true;
@@ -491,6 +493,8 @@ Playlist::notify_region_moved (boost::shared_ptr<Region> r)
 {
 	Evoral::RangeMove<samplepos_t> const move (r->last_position (), r->length (), r->position ());
 
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 
 		pending_range_moves.push_back (move);
@@ -556,6 +560,8 @@ Playlist::notify_region_added (boost::shared_ptr<Region> r)
 	 * as though it could be.
 	 */
 
+	invalidate_region_index ();
+
 	if (holding_state()) {
 		pending_adds.insert (r);
 		pending_contents_change = true;
@@ -767,6 +773,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, samplepos_t pos
 
 	regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
 	all_regions.insert (region);
+	invalidate_region_index ();
 
 	possibly_splice_unlocked (position, region->length(), region);
 
@@ -828,6 +835,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region)
 			samplecnt_t distance = (*i)->length();
 
 			regions.erase (i);
+			invalidate_region_index ();
 
 			possibly_splice_unlocked (pos, -distance);
 
@@ -1753,6 +1761,11 @@ Playlist::region_changed_proxy (const PropertyChange& what_changed, boost::weak_
 		return;
 	}
 
+	/* any change may alter bounds, layering, opacity or fades, all of
+	 * which the index or the data derived from it depend on.
+	 */
+	invalidate_region_index ();
+
 	/* this makes a virtual call to the right kind of playlist ... */
 
 	region_changed (what_changed, region);
@@ -1811,6 +1824,7 @@ Playlist::drop_regions ()
 	RegionWriteLock rl (this);
 	regions.clear ();
 	all_regions.clear ();
+	invalidate_region_index ();
 }
 
 void
@@ -1839,6 +1853,7 @@ Playlist::clear (bool with_signals)
 		}
 
 		regions.clear ();
+		invalidate_region_index ();
 
 		for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin(); s != pending_removes.end(); ++s) {
 			remove_dependents (*s);
@@ -1887,19 +1902,63 @@ Playlist::regions_at (samplepos_t sample)
 	return find_regions_at (sample);
 }
 
+namespace {
+
+/** RegionIndex visitor which re-checks each candidate against the region's
+ *  current bounds (a region may have moved since the index was built, before
+ *  its change has been signalled) and collects or counts the survivors.
+ */
+struct RegionIndexCollector {
+	RegionIndexCollector (RegionIndex const & i, samplepos_t s, samplepos_t e, RegionList* l)
+		: index (i), start (s), end (e), rlist (l), cnt (0) {}
+
+	void operator() (size_t n) {
+		boost::shared_ptr<Region> const & r (index.regions()[n]);
+		if (r->coverage (start, end) == Evoral::OverlapNone) {
+			return;
+		}
+		if (rlist) {
+			rlist->push_back (r);
+		}
+		++cnt;
+	}
+
+	RegionIndex const & index;
+	samplepos_t start;
+	samplepos_t end;
+	RegionList* rlist;
+	uint32_t cnt;
+};
+
+}
+
+boost::shared_ptr<RegionIndex const>
+Playlist::region_index () const
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	if (!_region_index) {
+		_region_index.reset (new RegionIndex (regions.rlist ()));
+	}
+	return _region_index;
+}
+
+void
+Playlist::invalidate_region_index ()
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index.reset ();
+}
+
 uint32_t
 Playlist::count_regions_at (samplepos_t sample) const
 {
 	RegionReadLock rlock (const_cast<Playlist*>(this));
-	uint32_t cnt = 0;
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
 
-	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->covers (sample)) {
-			cnt++;
-		}
-	}
+	RegionIndexCollector c (*idx, sample, sample, 0);
+	idx->foreach_covering (sample, c);
 
-	return cnt;
+	return c.cnt;
 }
 
 boost::shared_ptr<Region>
@@ -1954,12 +2013,10 @@ Playlist::find_regions_at (samplepos_t sample)
 	/* Caller must hold lock */
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->covers (sample)) {
-			rlist->push_back (*i);
-		}
-	}
+	RegionIndexCollector c (*idx, sample, sample, rlist.get ());
+	idx->foreach_covering (sample, c);
 
 	return rlist;
 }
@@ -1969,10 +2026,12 @@ Playlist::regions_with_start_within (Evoral::Range<samplepos_t> range)
 {
 	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->first_sample() >= range.from && (*i)->first_sample() <= range.to) {
-			rlist->push_back (*i);
+	for (size_t n = idx->lower_bound (range.from); n < idx->size() && idx->first_sample (n) <= range.to; ++n) {
+		boost::shared_ptr<Region> const & r (idx->regions()[n]);
+		if (r->first_sample() >= range.from && r->first_sample() <= range.to) {
+			rlist->push_back (r);
 		}
 	}
 
@@ -1984,8 +2043,10 @@ Playlist::regions_with_end_within (Evoral::Range<samplepos_t> range)
 {
 	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionList> touched (regions_touched_locked (range.from, range.to));
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+	/* any region ending within the range also touches it */
+	for (RegionList::iterator i = touched->begin(); i != touched->end(); ++i) {
 		if ((*i)->last_sample() >= range.from && (*i)->last_sample() <= range.to) {
 			rlist->push_back (*i);
 		}
@@ -2005,12 +2066,10 @@ boost::shared_ptr<RegionList>
 Playlist::regions_touched_locked (samplepos_t start, samplepos_t end)
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
-			rlist->push_back (*i);
-		}
-	}
+	RegionIndexCollector c (*idx, start, end, rlist.get ());
+	idx->foreach_touched (start, end, c);
 
 	return rlist;
 }
@@ -2672,6 +2731,7 @@ Playlist::relayer ()
 	 * probably keep a note of the top layer last time we relayered, and check that,
 	 * but premature optimisation &c...
 	 */
+	invalidate_region_index ();
 	notify_layering_changed ();
 
 	/* This relayer() may have been called as a result of a region removal, in which
@@ -3030,14 +3090,13 @@ Playlist::foreach_region (boost::function<void(boost::shared_ptr<Region>)> s)
 bool
 Playlist::has_region_at (samplepos_t const p) const
 {
-	RegionReadLock (const_cast<Playlist *> (this));
+	RegionReadLock rlock (const_cast<Playlist *> (this));
+	boost::shared_ptr<RegionIndex const> idx (region_index ());
 
-	RegionList::const_iterator i = regions.begin ();
-	while (i != regions.end() && !(*i)->covers (p)) {
-		++i;
-	}
+	RegionIndexCollector c (*idx, p, p, 0);
+	idx->foreach_covering (p, c);
 
-	return (i != regions.end());
+	return c.cnt > 0;
 }
 
 /** Look from a session sample time and find the start time of the next region
@@ -89,6 +89,7 @@
 #include "ardour/luaproc.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_manager.h"
+#include "ardour/plugin_scan_cache.h"
 #include "ardour/rc_configuration.h"
 
 #include "ardour/search_paths.h"
@@ -141,6 +142,8 @@ PluginManager::PluginManager ()
 	, _lv2_plugin_info(0)
 	, _au_plugin_info(0)
 	, _lua_plugin_info(0)
+	, _ladspa_cache (X_("ladspa_cache"))
+	, _lv2_cache (X_("lv2_cache"))
 	, _cancel_scan(false)
 	, _cancel_timeout(false)
 {
@@ -182,6 +185,9 @@ PluginManager::PluginManager ()
 
 	load_tags ();
 
+	_ladspa_cache.load ();
+	_lv2_cache.load ();
+
 	if ((s = getenv ("LADSPA_RDF_PATH"))){
 		lrdf_path = s;
 	}
@@ -524,6 +530,13 @@ PluginManager::clear_au_blacklist ()
 #endif
 }
 
+void
+PluginManager::clear_plugin_scan_cache ()
+{
+	_ladspa_cache.clear ();
+	_lv2_cache.clear ();
+}
+
 void
 PluginManager::lua_refresh ()
 {
@@ -575,9 +588,17 @@ PluginManager::ladspa_refresh ()
 	find_files_matching_pattern (ladspa_modules, ladspa_search_path (), "*.dll");
 
 	for (vector<std::string>::iterator i = ladspa_modules.begin(); i != ladspa_modules.end(); ++i) {
+		/* only modules which changed since they were last scanned are loaded */
+		PluginScanCache::Entries const* cached = _ladspa_cache.lookup (*i);
+		if (cached) {
+			ladspa_add (*i, *cached);
+			continue;
+		}
 		ARDOUR::PluginScanMessage(_("LADSPA"), *i, false);
 		ladspa_discover (*i);
 	}
+
+	_ladspa_cache.save ();
 }
 
 #ifdef HAVE_LRDF
@@ -686,6 +707,8 @@ PluginManager::ladspa_discover (string path)
 
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("LADSPA plugin found at %1\n", path));
 
+	PluginScanCache::Entries entries;
+
 	for (uint32_t i = 0; ; ++i) {
 		/* if a ladspa plugin allocates memory here
 		 * it is never free()ed (or plugin-dependent only when unloading).
@@ -696,20 +719,9 @@ PluginManager::ladspa_discover (string path)
 			break;
 		}
 
-		if (!ladspa_plugin_whitelist.empty()) {
-			if (find (ladspa_plugin_whitelist.begin(), ladspa_plugin_whitelist.end(), descriptor->UniqueID) == ladspa_plugin_whitelist.end()) {
-				continue;
-			}
-		}
-
-		PluginInfoPtr info(new LadspaPluginInfo);
-		info->name = descriptor->Name;
-		info->category = get_ladspa_category(descriptor->UniqueID);
-		info->path = path;
-		info->index = i;
-		info->n_inputs = ChanCount();
-		info->n_outputs = ChanCount();
-		info->type = ARDOUR::LADSPA;
+		PluginScanCache::Entry e;
+		e.name = descriptor->Name;
+		e.index = i;
 
 		string::size_type pos = 0;
 		string creator = descriptor->Maker;
@@ -724,31 +736,60 @@ PluginManager::ladspa_discover (string path)
 		 * meaningful name, mark this creator as 'Unknown'
 		 */
 		if (creator.length() < 2 || pos < 3) {
-			info->creator = "Unknown";
+			e.creator = "Unknown";
 		} else{
-			info->creator = creator.substr (0, pos);
-			strip_whitespace_edges (info->creator);
+			e.creator = creator.substr (0, pos);
+			strip_whitespace_edges (e.creator);
 		}
 
 		char buf[32];
 		snprintf (buf, sizeof (buf), "%lu", descriptor->UniqueID);
-		info->unique_id = buf;
+		e.unique_id = buf;
 
 		for (uint32_t n=0; n < descriptor->PortCount; ++n) {
 			if (LADSPA_IS_PORT_AUDIO (descriptor->PortDescriptors[n])) {
 				if (LADSPA_IS_PORT_INPUT (descriptor->PortDescriptors[n])) {
-					info->n_inputs.set_audio(info->n_inputs.n_audio() + 1);
+					e.n_inputs.set_audio(e.n_inputs.n_audio() + 1);
 				}
 				else if (LADSPA_IS_PORT_OUTPUT (descriptor->PortDescriptors[n])) {
-					info->n_outputs.set_audio(info->n_outputs.n_audio() + 1);
+					e.n_outputs.set_audio(e.n_outputs.n_audio() + 1);
 				}
 			}
 		}
 
-		if(_ladspa_plugin_info->empty()){
-			_ladspa_plugin_info->push_back (info);
+		entries.push_back (e);
+	}
+
+	_ladspa_cache.set (path, entries);
+	ladspa_add (path, entries);
+
+	return 0;
+}
+
+void
+PluginManager::ladspa_add (string const& path, PluginScanCache::Entries const& entries)
+{
+	for (PluginScanCache::Entries::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+		uint32_t const id = strtoul (e->unique_id.c_str(), 0, 10);
+
+		if (!ladspa_plugin_whitelist.empty()) {
+			if (find (ladspa_plugin_whitelist.begin(), ladspa_plugin_whitelist.end(), id) == ladspa_plugin_whitelist.end()) {
+				continue;
+			}
 		}
 
+		PluginInfoPtr info(new LadspaPluginInfo);
+		info->name = e->name;
+		/* the RDF data may have changed independently of the module */
+		info->category = get_ladspa_category(id);
+		info->creator = e->creator;
+		info->path = path;
+		info->index = e->index;
+		info->n_inputs = e->n_inputs;
+		info->n_outputs = e->n_outputs;
+		info->type = ARDOUR::LADSPA;
+		info->unique_id = e->unique_id;
+
 		//Ensure that the plugin is not already in the plugin list.
 
 		bool found = false;
@@ -766,8 +807,6 @@ PluginManager::ladspa_discover (string path)
 
 		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Found LADSPA plugin, name: %1, Inputs: %2, Outputs: %3\n", info->name, info->n_inputs, info->n_outputs));
 	}
-
-	return 0;
 }
 
 string
@@ -842,7 +881,8 @@ PluginManager::lv2_refresh ()
 {
 	DEBUG_TRACE (DEBUG::PluginManager, "LV2: refresh\n");
 	delete _lv2_plugin_info;
-	_lv2_plugin_info = LV2PluginInfo::discover();
+	_lv2_plugin_info = LV2PluginInfo::discover (&_lv2_cache);
+	_lv2_cache.save ();
 
 	for (PluginInfoList::iterator i = _lv2_plugin_info->begin(); i != _lv2_plugin_info->end(); ++i) {
 		set_tags ((*i)->type, (*i)->unique_id, (*i)->category, (*i)->name, FromPlug);
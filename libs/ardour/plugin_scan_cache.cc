@@ -0,0 +1,266 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/xml++.h"
+
+#include "ardour/filesystem_paths.h"
+#include "ardour/plugin_scan_cache.h"
+#include "ardour/revision.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+#define PLUGIN_SCAN_CACHE_VERSION "1"
+
+PluginScanCache::PluginScanCache (string const& name)
+	: _name (name)
+	, _dirty (false)
+{
+}
+
+string
+PluginScanCache::cache_path () const
+{
+	return Glib::build_filename (ARDOUR::user_cache_directory (), _name);
+}
+
+void
+PluginScanCache::load ()
+{
+	string const path = cache_path ();
+	XMLTree tree;
+
+	_files.clear ();
+	_dirty = false;
+
+	if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		return;
+	}
+
+	if (!tree.read (path)) {
+		warning << string_compose (_("Plugin cache %1 is not a valid XML file, plugins will be re-scanned"), path) << endmsg;
+		return;
+	}
+
+	XMLNode const* root (tree.root ());
+	string version;
+	string rev;
+
+	if (root->name () != X_("PluginScanCache")
+	    || !root->get_property (X_("version"), version) || version != PLUGIN_SCAN_CACHE_VERSION
+	    || !root->get_property (X_("revision"), rev) || rev != revision) {
+		return;
+	}
+
+	for (XMLNodeConstIterator i = root->children ().begin (); i != root->children ().end (); ++i) {
+		string  fpath;
+		int64_t mtime;
+
+		if ((*i)->name () != X_("File") || !(*i)->get_property (X_("path"), fpath) || !(*i)->get_property (X_("mtime"), mtime)) {
+			continue;
+		}
+
+		File& f (_files[fpath]);
+		f.mtime = mtime;
+		f.valid = true;
+
+		for (XMLNodeConstIterator j = (*i)->children ().begin (); j != (*i)->children ().end (); ++j) {
+			XMLNode const& node (**j);
+			Entry    e;
+			uint32_t n;
+
+			if (node.name () != X_("Plugin") || !node.get_property (X_("unique-id"), e.unique_id)) {
+				continue;
+			}
+
+			node.get_property (X_("name"), e.name);
+			node.get_property (X_("category"), e.category);
+			node.get_property (X_("creator"), e.creator);
+			node.get_property (X_("index"), e.index);
+
+			if (node.get_property (X_("audio-in"), n))  { e.n_inputs.set_audio (n); }
+			if (node.get_property (X_("midi-in"), n))   { e.n_inputs.set_midi (n); }
+			if (node.get_property (X_("audio-out"), n)) { e.n_outputs.set_audio (n); }
+			if (node.get_property (X_("midi-out"), n))  { e.n_outputs.set_midi (n); }
+
+			f.entries.push_back (e);
+		}
+	}
+}
+
+void
+PluginScanCache::save ()
+{
+	for (Files::iterator i = _files.begin (); i != _files.end ();) {
+		if (!i->second.seen || !i->second.valid) {
+			_files.erase (i++);
+			_dirty = true;
+		} else {
+			i->second.seen = false;
+			++i;
+		}
+	}
+
+	if (!_dirty) {
+		return;
+	}
+
+	XMLNode* root = new XMLNode (X_("PluginScanCache"));
+	root->set_property (X_("version"), PLUGIN_SCAN_CACHE_VERSION);
+	root->set_property (X_("revision"), revision);
+
+	for (Files::const_iterator i = _files.begin (); i != _files.end (); ++i) {
+		XMLNode* file = root->add_child (X_("File"));
+		file->set_property (X_("path"), i->first);
+		file->set_property (X_("mtime"), (int64_t) i->second.mtime);
+
+		for (Entries::const_iterator e = i->second.entries.begin (); e != i->second.entries.end (); ++e) {
+			XMLNode* node = file->add_child (X_("Plugin"));
+			node->set_property (X_("unique-id"), e->unique_id);
+			node->set_property (X_("name"), e->name);
+			node->set_property (X_("category"), e->category);
+			node->set_property (X_("creator"), e->creator);
+			node->set_property (X_("index"), e->index);
+			node->set_property (X_("audio-in"), e->n_inputs.n_audio ());
+			node->set_property (X_("midi-in"), e->n_inputs.n_midi ());
+			node->set_property (X_("audio-out"), e->n_outputs.n_audio ());
+			node->set_property (X_("midi-out"), e->n_outputs.n_midi ());
+		}
+	}
+
+	string const path = cache_path ();
+	XMLTree tree;
+	tree.set_root (root);
+
+	if (!tree.write (path)) {
+		error << string_compose (_("Could not save plugin cache to %1"), path) << endmsg;
+		g_unlink (path.c_str ());
+		return;
+	}
+
+	_dirty = false;
+}
+
+void
+PluginScanCache::clear ()
+{
+	_files.clear ();
+	_dirty = false;
+
+	string const path = cache_path ();
+	if (Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		::g_unlink (path.c_str ());
+	}
+}
+
+PluginScanCache::Entries const*
+PluginScanCache::lookup (string const& path)
+{
+	time_t const mtime = modification_time (path);
+	File& f (_files[path]);
+
+	f.seen = true;
+
+	if (f.valid && f.mtime == mtime) {
+		return &f.entries;
+	}
+
+	f.mtime = mtime;
+	f.valid = false;
+	f.entries.clear ();
+	return 0;
+}
+
+void
+PluginScanCache::set (string const& path, Entries const& entries)
+{
+	File& f (_files[path]);
+
+	if (!f.seen) {
+		f.mtime = modification_time (path);
+	}
+
+	f.entries = entries;
+	f.valid   = true;
+	f.seen    = true;
+	_dirty    = true;
+}
+
+vector<string>
+PluginScanCache::paths () const
+{
+	vector<string> rv;
+	for (Files::const_iterator i = _files.begin (); i != _files.end (); ++i) {
+		if (i->second.valid) {
+			rv.push_back (i->first);
+		}
+	}
+	return rv;
+}
+
+/* Limit the depth, symbolic links may form a loop */
+static time_t
+latest_modification (string const& path, int depth)
+{
+	GStatBuf statbuf;
+
+	if (g_stat (path.c_str (), &statbuf) != 0) {
+		return 0;
+	}
+
+	time_t mtime = statbuf.st_mtime;
+
+	if (!S_ISDIR (statbuf.st_mode) || depth == 0) {
+		return mtime;
+	}
+
+	/* a bundle is modified in place, which only changes the
+	 * modification time of the directory the changed file is in.
+	 */
+	GDir* dir = g_dir_open (path.c_str (), 0, 0);
+
+	if (!dir) {
+		return mtime;
+	}
+
+	const gchar* name;
+
+	while ((name = g_dir_read_name (dir))) {
+		mtime = max (mtime, latest_modification (Glib::build_filename (path, name), depth - 1));
+	}
+
+	g_dir_close (dir);
+	return mtime;
+}
+
+time_t
+PluginScanCache::modification_time (string const& path)
+{
+	return latest_modification (path, 8);
+}
@@ -47,7 +47,7 @@ pframes_t    Port::_global_port_buffer_offset = 0;
 pframes_t    Port::_cycle_nframes = 0;
 double       Port::_speed_ratio = 1.0;
 std::string  Port::state_node_name = X_("Port");
-const uint32_t Port::_resampler_quality = 12;
+uint32_t     Port::_resampler_quality = 12;
 
 /* a handy define to shorten what would otherwise be a needlessly verbose
  * repeated phrase
@@ -55,6 +55,13 @@ const uint32_t Port::_resampler_quality = 12;
 #define port_engine AudioEngine::instance()->port_engine()
 #define port_manager AudioEngine::instance()
 
+/*static*/ void
+Port::setup_resampler (uint32_t q)
+{
+	/* see ArdourZita::VMResampler::setup() */
+	_resampler_quality = std::min<uint32_t> (96, std::max<uint32_t> (8, q));
+}
+
 /** @param n Port short name */
 Port::Port (std::string const & n, DataType t, PortFlags f)
 	: _name (n)
@@ -58,6 +58,7 @@ PortManager::PortManager ()
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
 	, midi_info_dirty (true)
+	, _resample_cycle (0)
 {
 	load_midi_port_info ();
 }
@@ -783,39 +784,60 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	Port::set_cycle_samplecnt (nframes);
 
 	_cycle_ports = ports.reader ();
+	++_resample_cycle;
 
 	/* TODO optimize
-	 *  - when speed == 1.0, the resampler copies data without processing
-	 *   it may (or may not) be more efficient to just run all in sequence.
-	 *
-	 *  - single sequential task for 'lightweight' tasks would make sense
-	 *    (run it in parallel with 'heavy' resampling.
-	 *    * output ports (sends_output()) only set a flag
-	 *    * midi-ports only scale event timestamps
-	 *
-	 *  - a threshold parallel vs searial processing may be appropriate.
-	 *    amount of work (how many connected ports are there, how
-	 *    many resamplers need to run) vs. available CPU cores and semaphore
-	 *    synchronization overhead.
-	 *
 	 *  - input ports: it would make sense to resample each input only once
 	 *    (rather than resample into each ardour-owned input port).
 	 *    A single external source-port may be connected to many ardour
 	 *    input-ports. Currently re-sampling is per input.
 	 */
-	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
+	resample_audio_ports (true, nframes, s);
+
+	/* what remains is lightweight: output ports only set a flag,
+	 * midi-ports only scale event timestamps
+	 */
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		if (!(p->second->flags() & TransportMasterPort)) {
+			p->second->cycle_start (nframes);
+		}
+	}
+}
+
+/* Varispeed resample the externally connected audio ports of one direction,
+ * their engine buffers to or from the buffers used by ardour. Ports share
+ * resamplers, see AudioPortResampler, each of which is processed as a task.
+ */
+void
+PortManager::resample_audio_ports (bool inputs, pframes_t nframes, Session* s)
+{
+	AudioPortResampler* list = 0;
+	size_t n_resamplers = 0;
+
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		Port* port = p->second.get ();
+		if (port->type () != DataType::AUDIO || (port->flags() & TransportMasterPort) || !port->port_handle ()) {
+			continue;
+		}
+		if (port->receives_input () != inputs || !port->externally_connected ()) {
+			continue;
+		}
+		AudioPortResampler* head = list;
+		static_cast<AudioPort*> (port)->add_to_resampler (nframes, _resample_cycle, list);
+		if (list != head) {
+			++n_resamplers;
+		}
+	}
+
+	if (n_resamplers > 1 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
 		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
-			}
+		for (AudioPortResampler* r = list; r; r = r->next ()) {
+			tl.push_back (boost::bind (&AudioPortResampler::process, r));
 		}
 		s->rt_tasklist()->process (tl);
 	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				p->second->cycle_start (nframes);
-			}
+		for (AudioPortResampler* r = list; r; r = r->next ()) {
+			r->process ();
 		}
 	}
 }
@@ -823,23 +845,14 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 void
 PortManager::cycle_end (pframes_t nframes, Session* s)
 {
-	// see optimzation note in ::cycle_start()
-	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-			}
-		}
-		s->rt_tasklist()->process (tl);
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				p->second->cycle_end (nframes);
-			}
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		if (!(p->second->flags() & TransportMasterPort)) {
+			p->second->cycle_end (nframes);
 		}
 	}
 
+	resample_audio_ports (false, nframes, s);
+
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		p->second->flush_buffers (nframes);
 	}
@@ -930,23 +943,14 @@ PortManager::check_monitoring ()
 void
 PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t nframes, Session* s)
 {
-	// see optimzation note in ::cycle_start()
-	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-			}
-		}
-		s->rt_tasklist()->process (tl);
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportMasterPort)) {
-				p->second->cycle_end (nframes);
-			}
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		if (!(p->second->flags() & TransportMasterPort)) {
+			p->second->cycle_end (nframes);
 		}
 	}
 
+	resample_audio_ports (false, nframes, s);
+
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		p->second->flush_buffers (nframes);
 
@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "ardour/region.h"
+#include "ardour/region_index.h"
+#include "ardour/region_sorters.h"
+
+using namespace ARDOUR;
+using std::max;
+
+RegionIndex::RegionIndex (RegionList const & rl)
+	: _regions (rl.begin (), rl.end ())
+{
+	/* stable, so that regions at the same position keep the order they
+	 * have in the playlist, which is the order callers have always seen.
+	 */
+	std::stable_sort (_regions.begin (), _regions.end (), RegionSortByPosition ());
+
+	size_t const n = _regions.size ();
+
+	_first.resize (n);
+	_last.resize (n);
+	_max_last.resize (n);
+
+	for (size_t i = 0; i < n; ++i) {
+		_first[i] = _regions[i]->first_sample ();
+		_last[i] = _regions[i]->last_sample ();
+	}
+
+	build (0, n);
+}
+
+samplepos_t
+RegionIndex::build (size_t lo, size_t hi)
+{
+	if (lo >= hi) {
+		return std::numeric_limits<samplepos_t>::min ();
+	}
+
+	size_t const mid = lo + (hi - lo) / 2;
+
+	samplepos_t m = _last[mid];
+	m = max (m, build (lo, mid));
+	m = max (m, build (mid + 1, hi));
+
+	_max_last[mid] = m;
+	return m;
+}
+
+size_t
+RegionIndex::lower_bound (samplepos_t pos) const
+{
+	return std::lower_bound (_first.begin (), _first.end (), pos) - _first.begin ();
+}
+
+size_t
+RegionIndex::upper_bound (samplepos_t pos) const
+{
+	return std::upper_bound (_first.begin (), _first.end (), pos) - _first.begin ();
+}
@@ -43,7 +43,6 @@
 #include "pbd/xml++.h"
 #include "pbd/enumwriter.h"
 #include "pbd/locale_guard.h"
-#include "pbd/memento_command.h"
 #include "pbd/stacktrace.h"
 #include "pbd/types_convert.h"
 #include "pbd/unwind.h"
@@ -53,6 +52,7 @@
 #include "ardour/audio_track.h"
 #include "ardour/audio_port.h"
 #include "ardour/audioengine.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/boost_debug.h"
 #include "ardour/buffer.h"
 #include "ardour/buffer_set.h"
@@ -4252,7 +4252,7 @@ Route::shift (samplepos_t pos, samplecnt_t samples)
 				XMLNode& before = al->get_state ();
 				al->shift (pos, samples);
 				XMLNode& after = al->get_state ();
-				_session.add_command (new MementoCommand<AutomationList> (*al.get(), &before, &after));
+				_session.add_command (new AutomationListDiffCommand (*al.get(), &before, &after));
 			}
 		}
 	}
@@ -4276,7 +4276,7 @@ Route::shift (samplepos_t pos, samplecnt_t samples)
 					XMLNode &before = al->get_state ();
 					al->shift (pos, samples);
 					XMLNode &after = al->get_state ();
-					_session.add_command (new MementoCommand<AutomationList> (*al.get(), &before, &after));
+					_session.add_command (new AutomationListDiffCommand (*al.get(), &before, &after));
 				}
 			}
 		}
@@ -6298,6 +6298,32 @@ Session::plot_process_graph (std::string const& file_name) const {
 	return _process_graph ? _process_graph->plot (file_name) : false;
 }
 
+boost::shared_ptr<RouteList>
+Session::critical_path () const
+{
+	boost::shared_ptr<RouteList> rl (new RouteList);
+	if (!_process_graph) {
+		return rl;
+	}
+	node_list_t nodes = _process_graph->critical_path ();
+	for (node_list_t::const_iterator i = nodes.begin (); i != nodes.end (); ++i) {
+		boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route> (*i);
+		if (r) {
+			rl->push_back (r);
+		}
+	}
+	return rl;
+}
+
+void
+Session::clear_route_dsp_stats ()
+{
+	boost::shared_ptr<RouteList> rl = routes.reader ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		(*i)->clear_dsp_stats ();
+	}
+}
+
 void
 Session::add_automation_list(AutomationList *al)
 {
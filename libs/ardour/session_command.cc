@@ -22,6 +22,7 @@
 #include <string>
 
 #include "ardour/automation_list.h"
+#include "ardour/automation_list_diff_command.h"
 #include "ardour/location.h"
 #include "ardour/midi_automation_list_binder.h"
 #include "ardour/playlist.h"
@@ -183,3 +184,22 @@ Session::stateful_diff_command_factory (XMLNode* n)
 
 	return 0;
 }
+
+Command *
+Session::automation_list_diff_command_factory (XMLNode* n)
+{
+	PBD::ID id;
+
+	if (n->get_property ("obj-id", id)) {
+		std::map<PBD::ID, AutomationList*>::iterator i = automation_lists.find (id);
+		if (i != automation_lists.end ()) {
+			return new AutomationListDiffCommand (new SimpleMementoCommandBinder<AutomationList> (*i->second), *n);
+		}
+	} else {
+		return new AutomationListDiffCommand (new MidiAutomationListBinder (n, sources), *n);
+	}
+
+	info << string_compose (_("Could not reconstitute AutomationListDiffCommand from XMLNode. id = %1"), id.to_s ()) << endmsg;
+
+	return 0;
+}
@@ -179,6 +179,13 @@ Session::start_audio_export (samplepos_t position, bool realtime, bool region_ex
 		return -1;
 	}
 
+	/* XXX all exports are rendered by the engine, one timespan after
+	 * another, at the backend's period size. An offline render, running
+	 * the session Graph on the DSP worker pool without a backend, in
+	 * large blocks and for several timespans concurrently, is not
+	 * implemented. ExportGraphBuilder only encodes the channel groups
+	 * of a timespan concurrently.
+	 */
 	_engine.Freewheel.connect_same_thread (export_freewheel_connection, boost::bind (&Session::process_export_fw, this, _1));
 
 	if (_realtime_export) {
@@ -848,6 +848,9 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		tree.set_root (&state (false, fork_state, only_used_assets));
 	}
 
+	/* the tree has its own copy of the automation events now */
+	AutomationList::drop_events_caches ();
+
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
 	} else if (switch_to_snapshot) {
@@ -3956,6 +3959,10 @@ Session::restore_history (string snapshot_name)
 				if ((c = stateful_diff_command_factory (n))) {
 					ut->add_command (c);
 				}
+			} else if (n->name() == "AutomationListDiffCommand") {
+				if ((c = automation_list_diff_command_factory (n))) {
+					ut->add_command (c);
+				}
 			} else {
 				error << string_compose(_("Couldn't figure out how to make a Command out of a %1 XMLNode."), n->name()) << endmsg;
 			}
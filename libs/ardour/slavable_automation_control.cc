@@ -121,7 +121,7 @@ SlavableAutomationControl::get_value() const
 }
 
 bool
-SlavableAutomationControl::get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t) const
+SlavableAutomationControl::get_masters_curve_locked (samplepos_t, samplepos_t, float*, samplecnt_t, bool&) const
 {
 	/* Every AutomationControl needs to implement this as-needed.
 	 *
@@ -41,6 +41,8 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/direct_file_reader.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -68,6 +70,7 @@ SndFileSource::SndFileSource (Session& s, const XMLNode& node)
 	, AudioFileSource (s, node)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _direct_reader (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -92,6 +95,7 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn, Flag flag
 	, AudioFileSource (s, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _direct_reader (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -118,6 +122,7 @@ SndFileSource::SndFileSource (Session& s, const string& path, const string& orig
 	, AudioFileSource (s, path, origin, flags, sfmt, hf)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _direct_reader (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -230,6 +235,7 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn)
 	, AudioFileSource (s, path, Flag (0))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _direct_reader (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -253,6 +259,7 @@ SndFileSource::SndFileSource (Session& s, const AudioFileSource& other, const st
 	, AudioFileSource (s, path, "", Flag ((other.flags () | default_writable_flags | NoPeakFile) & ~RF64_RIFF), /*unused*/ FormatFloat, /*unused*/ WAVE64)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _direct_reader (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -364,6 +371,9 @@ SndFileSource::init_sndfile ()
 void
 SndFileSource::close ()
 {
+	delete _direct_reader;
+	_direct_reader = 0;
+
 	if (_sndfile) {
 		sf_close (_sndfile);
 		_sndfile = 0;
@@ -431,6 +441,11 @@ SndFileSource::open ()
 
 	_length = _info.frames;
 
+	if (!writable() && Config->get_direct_audio_file_reads()) {
+		/* shares fd, which libsndfile owns */
+		_direct_reader = DirectFileReader::create (fd, _info.format, _info.channels);
+	}
+
 #ifdef HAVE_RF64_RIFF
 	if (_file_is_new && _length == 0 && writable()) {
 		if (_flags & RF64_RIFF) {
@@ -569,6 +584,14 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (file_cnt && _direct_reader) {
+		samplecnt_t ret = _direct_reader->read (dst, start, file_cnt, _length, _channel, _gain, get_interleave_buffer (file_cnt * _info.channels));
+		if (ret == file_cnt) {
+			return ret;
+		}
+		/* let libsndfile try (and report) */
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -24,6 +24,7 @@
 #include "libardour-config.h"
 #endif
 
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/convert.h"
 #include "pbd/pthread_utils.h"
@@ -56,6 +57,7 @@ PBD::Signal1<void,boost::shared_ptr<Source> > SourceFactory::SourceCreated;
 Glib::Threads::Cond SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
+std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peak_pyramids;
 
 static int active_threads = 0;
 
@@ -69,12 +71,24 @@ peak_thread_work ()
 		SourceFactory::peak_building_lock.lock ();
 
 	  wait:
-		if (SourceFactory::files_with_peaks.empty()) {
+		if (SourceFactory::files_with_peaks.empty() && SourceFactory::files_with_peak_pyramids.empty()) {
 			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
 		}
 
 		if (SourceFactory::files_with_peaks.empty()) {
-			goto wait;
+			if (SourceFactory::files_with_peak_pyramids.empty()) {
+				goto wait;
+			}
+
+			/* nothing more urgent to do, build coarse peak levels */
+			boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peak_pyramids.front().lock());
+			SourceFactory::files_with_peak_pyramids.pop_front ();
+			SourceFactory::peak_building_lock.unlock ();
+
+			if (as) {
+				as->build_peak_pyramid ();
+			}
+			continue;
 		}
 
 		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front().lock());
@@ -104,7 +118,12 @@ SourceFactory::peak_work_queue_length ()
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	/* peak building is mostly I/O bound beyond a handful of threads,
+	 * but short of that it scales with the number of cores.
+	 */
+	const uint32_t n_threads = std::max (2u, std::min (8u, hardware_concurrency ()));
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
@@ -135,6 +154,27 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 	return 0;
 }
 
+void
+SourceFactory::prioritize_peakfile (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	for (std::list<boost::weak_ptr<AudioSource> >::iterator i = files_with_peaks.begin(); i != files_with_peaks.end(); ++i) {
+		if (i->lock() == as) {
+			files_with_peaks.splice (files_with_peaks.begin(), files_with_peaks, i);
+			break;
+		}
+	}
+}
+
+void
+SourceFactory::build_peak_pyramid (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	files_with_peak_pyramids.push_back (boost::weak_ptr<AudioSource> (as));
+	PeaksToBuild.signal ();
+}
+
 boost::shared_ptr<Source>
 SourceFactory::createSilent (Session& s, const XMLNode& node, samplecnt_t nframes, float sr)
 {
@@ -722,7 +722,404 @@ struct MetricSectionFrameSorter {
 	}
 };
 
+/* Binary searches over the sections of a TempoMapSnapshot, equivalent to the
+ * walks over Metrics in TempoMap: @return the index of the section before
+ * the first one after @a x by @a key, not counting the first section, which
+ * is used for anything before it.
+ */
+template<typename Key, typename T>
+static size_t
+section_index_at (size_t n_sections, Key const& key, T x)
+{
+	size_t lo = 1;
+	size_t hi = n_sections;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (key (mid) > x) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return lo - 1;
+}
+
+template<typename Sections>
+struct MinuteKey {
+	MinuteKey (Sections const& s) : sections (s) {}
+	double operator() (size_t i) const { return sections[i]->minute(); }
+	Sections const& sections;
+};
+
+template<typename Sections>
+struct PulseKey {
+	PulseKey (Sections const& s) : sections (s) {}
+	double operator() (size_t i) const { return sections[i]->pulse(); }
+	Sections const& sections;
+};
+
+template<typename Sections>
+struct SampleKey {
+	SampleKey (Sections const& s) : sections (s) {}
+	samplepos_t operator() (size_t i) const { return sections[i]->sample(); }
+	Sections const& sections;
+};
+
+template<typename Meters>
+struct BeatKey {
+	BeatKey (Meters const& m) : meters (m) {}
+	double operator() (size_t i) const { return meters[i]->beat(); }
+	Meters const& meters;
+};
+
+template<typename Meters>
+struct BarKey {
+	BarKey (Meters const& m) : meters (m) {}
+	uint32_t operator() (size_t i) const { return meters[i]->bbt().bars; }
+	Meters const& meters;
+};
+
+/* the zero-based bar of a meter, as counted from the previous one */
+template<typename Meters>
+struct BarsToMeterKey {
+	BarsToMeterKey (Meters const& m) : meters (m) {}
+	double operator() (size_t i) const {
+		const double bars_to_m = (meters[i]->beat() - meters[i - 1]->beat()) / meters[i - 1]->divisions_per_bar();
+		return bars_to_m + (meters[i - 1]->bbt().bars - 1);
+	}
+	Meters const& meters;
+};
+
+template<typename Meters>
+struct PulsesToMeterKey {
+	PulsesToMeterKey (Meters const& m) : meters (m) {}
+	double operator() (size_t i) const {
+		double const pulses_to_m = meters[i]->pulse() - meters[i - 1]->pulse();
+		return meters[i - 1]->pulse() + pulses_to_m;
+	}
+	Meters const& meters;
+};
+
+/* the beat of a tempo section, in the meter @a m */
+template<typename Tempos>
+struct TempoBeatKey {
+	TempoBeatKey (Tempos const& t, const MeterSection& m) : tempos (t), meter (m) {}
+	double operator() (size_t i) const {
+		return ((tempos[i]->pulse() - meter.pulse()) * meter.note_divisor()) + meter.beat();
+	}
+	Tempos const& tempos;
+	const MeterSection& meter;
+};
+
+static BBT_Time
+bbt_at_beats_in_meter (const MeterSection& m, const double beats_in_ms)
+{
+	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / m.divisions_per_bar());
+	const uint32_t total_bars = bars_in_ms + (m.bbt().bars - 1);
+	const double remaining_beats = beats_in_ms - (bars_in_ms * m.divisions_per_bar());
+	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
+
+	BBT_Time ret;
+
+	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
+	ret.beats = (uint32_t) floor (remaining_beats);
+	ret.bars = total_bars;
+
+	/* 0 0 0 to 1 1 0 - based mapping*/
+	++ret.bars;
+	++ret.beats;
+
+	if (ret.ticks >= BBT_Time::ticks_per_beat) {
+		++ret.beats;
+		ret.ticks -= BBT_Time::ticks_per_beat;
+	}
+
+	if (ret.beats >= m.divisions_per_bar() + 1) {
+		++ret.bars;
+		ret.beats = 1;
+	}
+
+	return ret;
+}
+
+TempoMapSnapshot::TempoMapSnapshot (const Metrics& metrics)
+{
+	for (Metrics::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
+		if ((*i)->is_tempo()) {
+			const TempoSection* t = static_cast<const TempoSection*> (*i);
+			if (t->active()) {
+				_tempos.push_back (boost::shared_ptr<const TempoSection> (new TempoSection (*t)));
+			}
+		} else {
+			const MeterSection* m = static_cast<const MeterSection*> (*i);
+			_meters.push_back (boost::shared_ptr<const MeterSection> (new MeterSection (*m)));
+		}
+	}
+}
+
+const TempoSection&
+TempoMapSnapshot::tempo_section_at_minute (double minute) const
+{
+	assert (!_tempos.empty());
+	return *_tempos[section_index_at (_tempos.size(), MinuteKey<Tempos> (_tempos), minute)];
+}
+
+const TempoSection&
+TempoMapSnapshot::tempo_section_at_sample (samplepos_t sample, const TempoSection** next) const
+{
+	assert (!_tempos.empty());
+	const size_t i = section_index_at (_tempos.size(), SampleKey<Tempos> (_tempos), sample);
+	*next = i + 1 < _tempos.size() ? _tempos[i + 1].get() : 0;
+	return *_tempos[i];
+}
+
+const MeterSection&
+TempoMapSnapshot::meter_section_at_minute (double minute) const
+{
+	assert (!_meters.empty());
+	return *_meters[section_index_at (_meters.size(), MinuteKey<Meters> (_meters), minute)];
+}
+
+const MeterSection&
+TempoMapSnapshot::meter_section_at_beat (const double& beat) const
+{
+	assert (!_meters.empty());
+	return *_meters[section_index_at (_meters.size(), BeatKey<Meters> (_meters), beat)];
+}
+
+double
+TempoMapSnapshot::beat_at_minute (const double& minute) const
+{
+	const TempoSection& ts = tempo_section_at_minute (minute);
+	const size_t i = section_index_at (_meters.size(), MinuteKey<Meters> (_meters), minute);
+	const MeterSection& prev_m (*_meters[i]);
+
+	const double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* audio locked meters fake their beat */
+	if (i + 1 < _meters.size() && _meters[i + 1]->beat() < beat) {
+		return _meters[i + 1]->beat();
+	}
+
+	return beat;
+}
+
+double
+TempoMapSnapshot::minute_at_beat (const double& beat) const
+{
+	const MeterSection& prev_m = meter_section_at_beat (beat);
+	const size_t i = section_index_at (_tempos.size(), TempoBeatKey<Tempos> (_tempos, prev_m), beat);
+
+	return _tempos[i]->minute_at_pulse (((beat - prev_m.beat()) / prev_m.note_divisor()) + prev_m.pulse());
+}
+
+double
+TempoMapSnapshot::pulse_at_beat (const double& beat) const
+{
+	const MeterSection& prev_m = meter_section_at_beat (beat);
+
+	return prev_m.pulse() + ((beat - prev_m.beat()) / prev_m.note_divisor());
+}
+
+double
+TempoMapSnapshot::beat_at_pulse (const double& pulse) const
+{
+	const MeterSection& prev_m (*_meters[section_index_at (_meters.size(), PulseKey<Meters> (_meters), pulse)]);
+
+	return ((pulse - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat();
+}
+
+double
+TempoMapSnapshot::pulse_at_minute (const double& minute) const
+{
+	const size_t i = section_index_at (_tempos.size(), MinuteKey<Tempos> (_tempos), minute);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size()) {
+		const double ret = prev_t.pulse_at_minute (minute);
+		/* audio locked section in new meter*/
+		if (_tempos[i + 1]->pulse() < ret) {
+			return _tempos[i + 1]->pulse();
+		}
+		return ret;
+	}
+
+	/* treated as constant for this ts */
+	const double pulses_in_section = ((minute - prev_t.minute()) * prev_t.note_types_per_minute()) / prev_t.note_type();
+
+	return pulses_in_section + prev_t.pulse();
+}
+
+double
+TempoMapSnapshot::minute_at_pulse (const double& pulse) const
+{
+	const size_t i = section_index_at (_tempos.size(), PulseKey<Tempos> (_tempos), pulse);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size()) {
+		return prev_t.minute_at_pulse (pulse);
+	}
+
+	/* must be treated as constant, irrespective of _type */
+	double const dtime = ((pulse - prev_t.pulse()) * prev_t.note_type()) / prev_t.note_types_per_minute();
+
+	return dtime + prev_t.minute();
+}
+
+Tempo
+TempoMapSnapshot::tempo_at_minute (const double& minute) const
+{
+	const size_t i = section_index_at (_tempos.size(), MinuteKey<Tempos> (_tempos), minute);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size()) {
+		return prev_t.tempo_at_minute (minute);
+	}
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+Tempo
+TempoMapSnapshot::tempo_at_pulse (const double& pulse) const
+{
+	const size_t i = section_index_at (_tempos.size(), PulseKey<Tempos> (_tempos), pulse);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size()) {
+		return prev_t.tempo_at_pulse (pulse);
+	}
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+BBT_Time
+TempoMapSnapshot::bbt_at_minute (const double& minute) const
+{
+	if (minute < 0) {
+		BBT_Time bbt;
+		bbt.bars = 1;
+		bbt.beats = 1;
+		bbt.ticks = 0;
+		return bbt;
+	}
+
+	const TempoSection& ts = tempo_section_at_minute (minute);
+	const size_t i = section_index_at (_meters.size(), MinuteKey<Meters> (_meters), minute);
+	const MeterSection& prev_m (*_meters[i]);
+
+	double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* handle sample before first meter */
+	if (minute < prev_m.minute()) {
+		beat = 0.0;
+	}
+	/* audio locked meters fake their beat */
+	if (i + 1 < _meters.size() && _meters[i + 1]->beat() < beat) {
+		beat = _meters[i + 1]->beat();
+	}
+
+	beat = max (0.0, beat);
+
+	return bbt_at_beats_in_meter (prev_m, beat - prev_m.beat());
+}
+
+double
+TempoMapSnapshot::minute_at_bbt (const BBT_Time& bbt) const
+{
+	return minute_at_beat (beat_at_bbt (bbt));
+}
+
+double
+TempoMapSnapshot::beat_at_bbt (const BBT_Time& bbt) const
+{
+	/* because audio-locked meters have 'fake' integral beats,
+	   there is no pulse offset here.
+	*/
+	const MeterSection& prev_m (*_meters[section_index_at (_meters.size(), BarsToMeterKey<Meters> (_meters), bbt.bars - 1)]);
+
+	const double remaining_bars = bbt.bars - prev_m.bbt().bars;
+	const double remaining_bars_in_beats = remaining_bars * prev_m.divisions_per_bar();
+
+	return remaining_bars_in_beats + prev_m.beat() + (bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat);
+}
+
+BBT_Time
+TempoMapSnapshot::bbt_at_beat (const double& b) const
+{
+	const double beats = max (0.0, b);
+	const MeterSection& prev_m (*_meters[section_index_at (_meters.size(), BeatKey<Meters> (_meters), beats)]);
+
+	return bbt_at_beats_in_meter (prev_m, beats - prev_m.beat());
+}
+
+double
+TempoMapSnapshot::pulse_at_bbt (const BBT_Time& bbt) const
+{
+	const MeterSection& prev_m (*_meters[section_index_at (_meters.size(), BarKey<Meters> (_meters), bbt.bars)]);
+
+	const double remaining_bars = bbt.bars - prev_m.bbt().bars;
+	const double remaining_pulses = remaining_bars * prev_m.divisions_per_bar() / prev_m.note_divisor();
+
+	return remaining_pulses + prev_m.pulse() + (((bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat)) / prev_m.note_divisor());
+}
+
+BBT_Time
+TempoMapSnapshot::bbt_at_pulse (const double& pulse) const
+{
+	const MeterSection& prev_m (*_meters[section_index_at (_meters.size(), PulsesToMeterKey<Meters> (_meters), pulse)]);
+
+	return bbt_at_beats_in_meter (prev_m, (pulse - prev_m.pulse()) * prev_m.note_divisor());
+}
+
+double
+TempoMapSnapshot::quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const
+{
+	const size_t s = section_index_at (_tempos.size(), SampleKey<Tempos> (_tempos), start);
+	const double start_qn = _tempos[s]->pulse_at_sample (start);
+
+	/* the walk over the sections in TempoMap keeps the section at start
+	 * if all of them are after end.
+	 */
+	const size_t e = _tempos.front()->sample() > end ? s : section_index_at (_tempos.size(), SampleKey<Tempos> (_tempos), end);
+	const double end_qn = _tempos[e]->pulse_at_sample (end);
+
+	return (end_qn - start_qn) * 4.0;
+}
+
+double
+TempoMapSnapshot::exact_qn_at_minute (const double& minute, const int32_t sub_num) const
+{
+	double qn = pulse_at_minute (minute) * 4.0;
+
+	if (sub_num > 1) {
+		qn = floor (qn) + (floor (((qn - floor (qn)) * (double) sub_num) + 0.5) / sub_num);
+	} else if (sub_num == 1) {
+		/* the gui requested exact musical (BBT) beat */
+		qn = pulse_at_beat ((floor (beat_at_minute (minute) + 0.5))) * 4.0;
+	} else if (sub_num == -1) {
+		/* snap to  bar */
+		Timecode::BBT_Time bbt = bbt_at_pulse (qn / 4.0);
+		bbt.beats = 1;
+		bbt.ticks = 0;
+
+		const double prev_b = pulse_at_bbt (bbt) * 4.0;
+		++bbt.bars;
+		const double next_b = pulse_at_bbt (bbt) * 4.0;
+
+		if ((qn - prev_b) > (next_b - prev_b) / 2.0) {
+			qn = next_b;
+		} else {
+			qn = prev_b;
+		}
+	}
+
+	return qn;
+}
+
 TempoMap::TempoMap (samplecnt_t fr)
+	: _snapshot (new TempoMapSnapshot)
 {
 	_sample_rate = fr;
 	BBT_Time start (1, 1, 0);
@@ -740,6 +1137,7 @@ TempoMap::TempoMap (samplecnt_t fr)
 	_metrics.push_back (t);
 	_metrics.push_back (m);
 
+	publish_snapshot ();
 }
 
 TempoMap&
@@ -747,7 +1145,7 @@ TempoMap::operator= (TempoMap const & other)
 {
 	if (&other != this) {
 		Glib::Threads::RWLock::ReaderLock lr (other.lock);
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		_sample_rate = other._sample_rate;
 
 		Metrics::const_iterator d = _metrics.begin();
@@ -776,6 +1174,17 @@ TempoMap::operator= (TempoMap const & other)
 	return *this;
 }
 
+void
+TempoMap::publish_snapshot ()
+{
+	/* CALLER MUST HOLD WRITE LOCK */
+
+	RCUWriter<TempoMapSnapshot> writer (_snapshot);
+	boost::shared_ptr<TempoMapSnapshot> snapshot = writer.get_copy ();
+
+	*snapshot = TempoMapSnapshot (_metrics);
+}
+
 TempoMap::~TempoMap ()
 {
 	Metrics::const_iterator d = _metrics.begin();
@@ -804,7 +1213,7 @@ TempoMap::remove_tempo (const TempoSection& tempo, bool complete_operation)
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		if ((removed = remove_tempo_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -843,7 +1252,7 @@ TempoMap::remove_meter (const MeterSection& tempo, bool complete_operation)
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		if ((removed = remove_meter_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -1036,7 +1445,7 @@ TempoMap::add_tempo (const Tempo& tempo, const double& pulse, const samplepos_t
 
 	TempoSection* ts = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		/* here we default to not clamped for a new tempo section. preference? */
 		ts = add_tempo_locked (tempo, pulse, minute_at_sample (sample), pls, true, false, false);
 
@@ -1061,7 +1470,7 @@ TempoMap::replace_tempo (TempoSection& ts, const Tempo& tempo, const double& pul
 	TempoSection* new_ts = 0;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		TempoSection& first (first_tempo());
 		if (!ts.initial()) {
 			if (locked_to_meter) {
@@ -1138,7 +1547,7 @@ TempoMap::add_meter (const Meter& meter, const Timecode::BBT_Time& where, sample
 {
 	MeterSection* m = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		m = add_meter_locked (meter, where, sample, pls, true);
 	}
 
@@ -1157,7 +1566,7 @@ void
 TempoMap::replace_meter (const MeterSection& ms, const Meter& meter, const BBT_Time& where, samplepos_t sample, PositionLockStyle pls)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 
 		if (!ms.initial()) {
 			remove_meter_locked (ms);
@@ -1252,7 +1661,7 @@ TempoMap::change_initial_tempo (double note_types_per_minute, double note_type,
 				continue;
 			}
 			{
-				Glib::Threads::RWLock::WriterLock lm (lock);
+				MetricsWriter lm (*this);
 				*((Tempo*) t) = newtempo;
 				recompute_map (_metrics);
 			}
@@ -1305,7 +1714,7 @@ TempoMap::change_existing_tempo_at (samplepos_t where, double note_types_per_min
 	/* reset */
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		/* cannot move the first tempo section */
 		*((Tempo*)prev) = newtempo;
 		recompute_map (_metrics);
@@ -1607,9 +2016,7 @@ TempoMap::metric_at (BBT_Time bbt) const
 double
 TempoMap::beat_at_sample (const samplecnt_t sample) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return beat_at_minute_locked (_metrics, minute_at_sample (sample));
+	return _snapshot.reader()->beat_at_minute (minute_at_sample (sample));
 }
 
 /* This function uses both tempo and meter.*/
@@ -1651,9 +2058,7 @@ TempoMap::beat_at_minute_locked (const Metrics& metrics, const double& minute) c
 samplepos_t
 TempoMap::sample_at_beat (const double& beat) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return sample_at_minute (minute_at_beat_locked (_metrics, beat));
+	return sample_at_minute (_snapshot.reader()->minute_at_beat (beat));
 }
 
 /* meter & tempo section based */
@@ -1706,9 +2111,7 @@ TempoMap::minute_at_beat_locked (const Metrics& metrics, const double& beat) con
 Tempo
 TempoMap::tempo_at_sample (const samplepos_t sample) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return tempo_at_minute_locked (_metrics, minute_at_sample (sample));
+	return _snapshot.reader()->tempo_at_minute (minute_at_sample (sample));
 }
 
 Tempo
@@ -1860,9 +2263,7 @@ TempoMap::pulse_at_tempo_locked (const Metrics& metrics, const Tempo& tempo) con
 Tempo
 TempoMap::tempo_at_quarter_note (const double& qn) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return tempo_at_pulse_locked (_metrics, qn / 4.0);
+	return _snapshot.reader()->tempo_at_pulse (qn / 4.0);
 }
 
 /** Returns the position in quarter-note beats corresponding to the supplied Tempo.
@@ -1999,8 +2400,7 @@ TempoMap::minute_at_pulse_locked (const Metrics& metrics, const double& pulse) c
 double
 TempoMap::beat_at_bbt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	return beat_at_bbt_locked (_metrics, bbt);
+	return _snapshot.reader()->beat_at_bbt (bbt);
 }
 
 
@@ -2046,8 +2446,7 @@ TempoMap::beat_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 Timecode::BBT_Time
 TempoMap::bbt_at_beat (const double& beat)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	return bbt_at_beat_locked (_metrics, beat);
+	return _snapshot.reader()->bbt_at_beat (beat);
 }
 
 Timecode::BBT_Time
@@ -2114,21 +2513,13 @@ TempoMap::bbt_at_beat_locked (const Metrics& metrics, const double& b) const
 double
 TempoMap::quarter_note_at_bbt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+	return _snapshot.reader()->pulse_at_bbt (bbt) * 4.0;
 }
 
 double
 TempoMap::quarter_note_at_bbt_rt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::quarter_note_at_bbt_rt() could not lock tempo map");
-	}
-
-	return pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+	return _snapshot.reader()->pulse_at_bbt (bbt) * 4.0;
 }
 
 double
@@ -2174,9 +2565,7 @@ TempoMap::pulse_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 Timecode::BBT_Time
 TempoMap::bbt_at_quarter_note (const double& qn)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return bbt_at_pulse_locked (_metrics, qn / 4.0);
+	return _snapshot.reader()->bbt_at_pulse (qn / 4.0);
 }
 
 /** Returns the BBT time (meter-based) corresponding to the supplied whole-note pulse position.
@@ -2262,25 +2651,13 @@ TempoMap::bbt_at_sample (samplepos_t sample)
 		return bbt;
 	}
 
-	const double minute =  minute_at_sample (sample);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return bbt_at_minute_locked (_metrics, minute);
+	return _snapshot.reader()->bbt_at_minute (minute_at_sample (sample));
 }
 
 BBT_Time
 TempoMap::bbt_at_sample_rt (samplepos_t sample)
 {
-	const double minute =  minute_at_sample (sample);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::bbt_at_sample_rt() could not lock tempo map");
-	}
-
-	return bbt_at_minute_locked (_metrics, minute);
+	return _snapshot.reader()->bbt_at_minute (minute_at_sample (sample));
 }
 
 Timecode::BBT_Time
@@ -2374,13 +2751,7 @@ TempoMap::sample_at_bbt (const BBT_Time& bbt)
 		throw std::logic_error ("beats are counted from one");
 	}
 
-	double minute;
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-		minute = minute_at_bbt_locked (_metrics, bbt);
-	}
-
-	return sample_at_minute (minute);
+	return sample_at_minute (_snapshot.reader()->minute_at_bbt (bbt));
 }
 
 /* meter & tempo section based */
@@ -2403,25 +2774,13 @@ TempoMap::minute_at_bbt_locked (const Metrics& metrics, const BBT_Time& bbt) con
 double
 TempoMap::quarter_note_at_sample (const samplepos_t sample) const
 {
-	const double minute =  minute_at_sample (sample);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_minute_locked (_metrics, minute) * 4.0;
+	return _snapshot.reader()->pulse_at_minute (minute_at_sample (sample)) * 4.0;
 }
 
 double
 TempoMap::quarter_note_at_sample_rt (const samplepos_t sample) const
 {
-	const double minute =  minute_at_sample (sample);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::quarter_note_at_sample_rt() could not lock tempo map");
-	}
-
-	return pulse_at_minute_locked (_metrics, minute) * 4.0;
+	return _snapshot.reader()->pulse_at_minute (minute_at_sample (sample)) * 4.0;
 }
 
 /**
@@ -2435,14 +2794,7 @@ TempoMap::quarter_note_at_sample_rt (const samplepos_t sample) const
 samplepos_t
 TempoMap::sample_at_quarter_note (const double quarter_note) const
 {
-	double minute;
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-
-		minute = minute_at_pulse_locked (_metrics, quarter_note / 4.0);
-	}
-
-	return sample_at_minute (minute);
+	return sample_at_minute (_snapshot.reader()->minute_at_pulse (quarter_note / 4.0));
 }
 
 /** Returns the quarter-note beats corresponding to the supplied BBT (meter-based) beat.
@@ -2455,9 +2807,7 @@ TempoMap::sample_at_quarter_note (const double quarter_note) const
 double
 TempoMap::quarter_note_at_beat (const double beat) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_beat_locked (_metrics, beat) * 4.0;
+	return _snapshot.reader()->pulse_at_beat (beat) * 4.0;
 }
 
 /** Returns the BBT (meter-based) beat position corresponding to the supplied quarter-note beats.
@@ -2470,9 +2820,7 @@ TempoMap::quarter_note_at_beat (const double beat) const
 double
 TempoMap::beat_at_quarter_note (const double quarter_note) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return beat_at_pulse_locked (_metrics, quarter_note / 4.0);
+	return _snapshot.reader()->beat_at_pulse (quarter_note / 4.0);
 }
 
 /** Returns the duration in samples between two supplied quarter-note beat positions.
@@ -2488,14 +2836,9 @@ TempoMap::beat_at_quarter_note (const double quarter_note) const
 samplecnt_t
 TempoMap::samples_between_quarter_notes (const double start, const double end) const
 {
-	double minutes;
-
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-		minutes = minutes_between_quarter_notes_locked (_metrics, start, end);
-	}
+	boost::shared_ptr<TempoMapSnapshot> snapshot = _snapshot.reader();
 
-	return sample_at_minute (minutes);
+	return sample_at_minute (snapshot->minute_at_pulse (end / 4.0) - snapshot->minute_at_pulse (start / 4.0));
 }
 
 double
@@ -2508,9 +2851,7 @@ TempoMap::minutes_between_quarter_notes_locked (const Metrics& metrics, const do
 double
 TempoMap::quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return quarter_notes_between_samples_locked (_metrics, start, end);
+	return _snapshot.reader()->quarter_notes_between_samples (start, end);
 }
 
 double
@@ -3211,7 +3552,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const samplepos_t sample, co
 	if (ts->position_lock_style() == MusicTime) {
 		{
 			/* if we're snapping to a musical grid, set the pulse exactly instead of via the supplied sample. */
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriter lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 			tempo_copy->set_position_lock_style (AudioTime);
@@ -3230,7 +3571,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const samplepos_t sample, co
 	} else {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriter lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 
@@ -3283,7 +3624,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const samplepos_t sample)
 	if (ms->position_lock_style() == AudioTime) {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriter lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			if (solve_map_minute (future_map, copy, minute_at_sample (sample))) {
@@ -3293,7 +3634,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const samplepos_t sample)
 		}
 	} else {
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriter lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			const double beat = beat_at_minute_locked (_metrics, minute_at_sample (sample));
@@ -3321,7 +3662,7 @@ TempoMap::gui_change_tempo (TempoSection* ts, const Tempo& bpm)
 	Metrics future_map;
 	bool can_solve = false;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 		if (tempo_copy->type() == TempoSection::Constant) {
@@ -3388,7 +3729,7 @@ TempoMap::gui_stretch_tempo (TempoSection* ts, const samplepos_t sample, const s
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 
 		if (!ts) {
 			return;
@@ -3495,7 +3836,7 @@ TempoMap::gui_stretch_tempo_end (TempoSection* ts, const samplepos_t sample, con
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 
 		if (!ts) {
 			return;
@@ -3574,7 +3915,7 @@ TempoMap::gui_twist_tempi (TempoSection* ts, const Tempo& bpm, const samplepos_t
 	samplepos_t const min_dframe = 2;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		if (!ts) {
 			return false;
 		}
@@ -3791,9 +4132,9 @@ TempoMap::music_origin ()
 double
 TempoMap::exact_beat_at_sample (const samplepos_t sample, const int32_t sub_num) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
 
-	return exact_beat_at_sample_locked (_metrics, sample, sub_num);
+	return snapshot->beat_at_pulse (snapshot->exact_qn_at_minute (minute_at_sample (sample), sub_num) / 4.0);
 }
 
 double
@@ -3827,9 +4168,7 @@ TempoMap::exact_beat_at_sample_locked (const Metrics& metrics, const samplepos_t
 double
 TempoMap::exact_qn_at_sample (const samplepos_t sample, const int32_t sub_num) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return exact_qn_at_sample_locked (_metrics, sample, sub_num);
+	return _snapshot.reader()->exact_qn_at_minute (minute_at_sample (sample), sub_num);
 }
 
 double
@@ -3871,11 +4210,11 @@ TempoMap::exact_qn_at_sample_locked (const Metrics& metrics, const samplepos_t s
 samplecnt_t
 TempoMap::bbt_duration_at (samplepos_t pos, const BBT_Time& bbt, int dir)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
 
-	BBT_Time pos_bbt = bbt_at_minute_locked (_metrics, minute_at_sample (pos));
+	BBT_Time pos_bbt = snapshot->bbt_at_minute (minute_at_sample (pos));
 
-	const double divisions = meter_section_at_minute_locked (_metrics, minute_at_sample (pos)).divisions_per_bar();
+	const double divisions = snapshot->meter_section_at_minute (minute_at_sample (pos)).divisions_per_bar();
 
 	if (dir > 0) {
 		pos_bbt.bars += bbt.bars;
@@ -3891,7 +4230,7 @@ TempoMap::bbt_duration_at (samplepos_t pos, const BBT_Time& bbt, int dir)
 			pos_bbt.bars += 1;
 			pos_bbt.beats -= divisions;
 		}
-		const samplecnt_t pos_bbt_sample = sample_at_minute (minute_at_bbt_locked (_metrics, pos_bbt));
+		const samplecnt_t pos_bbt_sample = sample_at_minute (snapshot->minute_at_bbt (pos_bbt));
 
 		return pos_bbt_sample - pos;
 
@@ -3931,7 +4270,7 @@ TempoMap::bbt_duration_at (samplepos_t pos, const BBT_Time& bbt, int dir)
 			pos_bbt.beats -= bbt.beats;
 		}
 
-		return pos - sample_at_minute (minute_at_bbt_locked (_metrics, pos_bbt));
+		return pos - sample_at_minute (snapshot->minute_at_bbt (pos_bbt));
 	}
 
 	return 0;
@@ -3952,8 +4291,8 @@ TempoMap::round_to_beat (samplepos_t fr, RoundMode dir)
 MusicSample
 TempoMap::round_to_quarter_note_subdivision (samplepos_t fr, int sub_num, RoundMode dir)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	uint32_t ticks = (uint32_t) floor (max (0.0, pulse_at_minute_locked (_metrics, minute_at_sample (fr))) * BBT_Time::ticks_per_beat * 4.0);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
+	uint32_t ticks = (uint32_t) floor (max (0.0, snapshot->pulse_at_minute (minute_at_sample (fr))) * BBT_Time::ticks_per_beat * 4.0);
 	uint32_t beats = (uint32_t) floor (ticks / BBT_Time::ticks_per_beat);
 	uint32_t ticks_one_subdivisions_worth = (uint32_t) BBT_Time::ticks_per_beat / sub_num;
 
@@ -4049,7 +4388,7 @@ TempoMap::round_to_quarter_note_subdivision (samplepos_t fr, int sub_num, RoundM
 	}
 
 	MusicSample ret (0, 0);
-	ret.sample = sample_at_minute (minute_at_pulse_locked (_metrics, (beats + (ticks / BBT_Time::ticks_per_beat)) / 4.0));
+	ret.sample = sample_at_minute (snapshot->minute_at_pulse ((beats + (ticks / BBT_Time::ticks_per_beat)) / 4.0));
 	ret.division = sub_num;
 
 	return ret;
@@ -4058,10 +4397,10 @@ TempoMap::round_to_quarter_note_subdivision (samplepos_t fr, int sub_num, RoundM
 MusicSample
 TempoMap::round_to_type (samplepos_t sample, RoundMode dir, BBTPointType type)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
 	const double minute = minute_at_sample (sample);
-	const double beat_at_samplepos = max (0.0, beat_at_minute_locked (_metrics, minute));
-	BBT_Time bbt (bbt_at_beat_locked (_metrics, beat_at_samplepos));
+	const double beat_at_samplepos = max (0.0, snapshot->beat_at_minute (minute));
+	BBT_Time bbt (snapshot->bbt_at_beat (beat_at_samplepos));
 	MusicSample ret (0, 0);
 
 	switch (type) {
@@ -4075,7 +4414,7 @@ TempoMap::round_to_type (samplepos_t sample, RoundMode dir, BBTPointType type)
 			bbt.beats = 1;
 			bbt.ticks = 0;
 
-			ret.sample = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
+			ret.sample = sample_at_minute (snapshot->minute_at_bbt (bbt));
 
 			return ret;
 
@@ -4085,17 +4424,17 @@ TempoMap::round_to_type (samplepos_t sample, RoundMode dir, BBTPointType type)
 			bbt.beats = 1;
 			bbt.ticks = 0;
 
-			ret.sample = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
+			ret.sample = sample_at_minute (snapshot->minute_at_bbt (bbt));
 
 			return ret;
 		} else {
 			/* true rounding: find nearest bar */
-			samplepos_t raw_ft = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
+			samplepos_t raw_ft = sample_at_minute (snapshot->minute_at_bbt (bbt));
 			bbt.beats = 1;
 			bbt.ticks = 0;
-			samplepos_t prev_ft = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
+			samplepos_t prev_ft = sample_at_minute (snapshot->minute_at_bbt (bbt));
 			++bbt.bars;
-			samplepos_t next_ft = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
+			samplepos_t next_ft = sample_at_minute (snapshot->minute_at_bbt (bbt));
 
 			if ((raw_ft - prev_ft) > (next_ft - prev_ft) / 2) {
 				ret.sample = next_ft;
@@ -4115,15 +4454,15 @@ TempoMap::round_to_type (samplepos_t sample, RoundMode dir, BBTPointType type)
 		ret.division = 1;
 
 		if (dir < 0) {
-			ret.sample = sample_at_minute (minute_at_beat_locked (_metrics, floor (beat_at_samplepos)));
+			ret.sample = sample_at_minute (snapshot->minute_at_beat (floor (beat_at_samplepos)));
 
 			return ret;
 		} else if (dir > 0) {
-			ret.sample = sample_at_minute (minute_at_beat_locked (_metrics, ceil (beat_at_samplepos)));
+			ret.sample = sample_at_minute (snapshot->minute_at_beat (ceil (beat_at_samplepos)));
 
 			return ret;
 		} else {
-			ret.sample = sample_at_minute (minute_at_beat_locked (_metrics, floor (beat_at_samplepos + 0.5)));
+			ret.sample = sample_at_minute (snapshot->minute_at_beat (floor (beat_at_samplepos + 0.5)));
 
 			return ret;
 		}
@@ -4137,29 +4476,29 @@ void
 TempoMap::get_grid (vector<TempoMap::BBTPoint>& points,
 		    samplepos_t lower, samplepos_t upper, uint32_t bar_mod)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	int32_t cnt = ceil (beat_at_minute_locked (_metrics, minute_at_sample (lower)));
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
+	int32_t cnt = ceil (snapshot->beat_at_minute (minute_at_sample (lower)));
 	samplecnt_t pos = 0;
 	/* although the map handles negative beats, bbt doesn't. */
 	if (cnt < 0.0) {
 		cnt = 0.0;
 	}
 
-	if (minute_at_beat_locked (_metrics, cnt) >= minute_at_sample (upper)) {
+	if (snapshot->minute_at_beat (cnt) >= minute_at_sample (upper)) {
 		return;
 	}
 	if (bar_mod == 0) {
 		while (pos >= 0 && pos < upper) {
-			pos = sample_at_minute (minute_at_beat_locked (_metrics, cnt));
-			const MeterSection meter = meter_section_at_minute_locked (_metrics, minute_at_sample (pos));
-			const BBT_Time bbt = bbt_at_beat_locked (_metrics, cnt);
-			const double qn = pulse_at_beat_locked (_metrics, cnt) * 4.0;
+			pos = sample_at_minute (snapshot->minute_at_beat (cnt));
+			const MeterSection meter = snapshot->meter_section_at_minute (minute_at_sample (pos));
+			const BBT_Time bbt = snapshot->bbt_at_beat (cnt);
+			const double qn = snapshot->pulse_at_beat (cnt) * 4.0;
 
-			points.push_back (BBTPoint (meter, tempo_at_minute_locked (_metrics, minute_at_sample (pos)), pos, bbt.bars, bbt.beats, qn));
+			points.push_back (BBTPoint (meter, snapshot->tempo_at_minute (minute_at_sample (pos)), pos, bbt.bars, bbt.beats, qn));
 			++cnt;
 		}
 	} else {
-		BBT_Time bbt = bbt_at_minute_locked (_metrics, minute_at_sample (lower));
+		BBT_Time bbt = snapshot->bbt_at_minute (minute_at_sample (lower));
 		bbt.beats = 1;
 		bbt.ticks = 0;
 
@@ -4169,11 +4508,11 @@ TempoMap::get_grid (vector<TempoMap::BBTPoint>& points,
 		}
 
 		while (pos >= 0 && pos < upper) {
-			pos = sample_at_minute (minute_at_bbt_locked (_metrics, bbt));
-			const MeterSection meter = meter_section_at_minute_locked (_metrics, minute_at_sample (pos));
-			const double qn = pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+			pos = sample_at_minute (snapshot->minute_at_bbt (bbt));
+			const MeterSection meter = snapshot->meter_section_at_minute (minute_at_sample (pos));
+			const double qn = snapshot->pulse_at_bbt (bbt) * 4.0;
 
-			points.push_back (BBTPoint (meter, tempo_at_minute_locked (_metrics, minute_at_sample (pos)), pos, bbt.bars, bbt.beats, qn));
+			points.push_back (BBTPoint (meter, snapshot->tempo_at_minute (minute_at_sample (pos)), pos, bbt.bars, bbt.beats, qn));
 			bbt.bars += bar_mod;
 		}
 	}
@@ -4377,34 +4716,16 @@ TempoMap::next_tempo_section_locked (const Metrics& metrics, TempoSection* ts) c
 double
 TempoMap::samples_per_quarter_note_at (const samplepos_t sample, const samplecnt_t sr) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
 
-	const TempoSection* ts_at = 0;
 	const TempoSection* ts_after = 0;
-	Metrics::const_iterator i;
-	TempoSection* t;
-
-	for (i = _metrics.begin(); i != _metrics.end(); ++i) {
-
-		if ((*i)->is_tempo()) {
-			t = static_cast<TempoSection*> (*i);
-			if (!t->active()) {
-				continue;
-			}
-			if (ts_at && (*i)->sample() > sample) {
-				ts_after = t;
-				break;
-			}
-			ts_at = t;
-		}
-	}
-	assert (ts_at);
+	const TempoSection& ts_at = snapshot->tempo_section_at_sample (sample, &ts_after);
 
 	if (ts_after) {
-		return  (60.0 * _sample_rate) / ts_at->tempo_at_minute (minute_at_sample (sample)).quarter_notes_per_minute();
+		return  (60.0 * _sample_rate) / ts_at.tempo_at_minute (minute_at_sample (sample)).quarter_notes_per_minute();
 	}
 	/* must be treated as constant tempo */
-	return ts_at->samples_per_quarter_note (_sample_rate);
+	return ts_at.samples_per_quarter_note (_sample_rate);
 }
 
 const MeterSection&
@@ -4606,7 +4927,7 @@ int
 TempoMap::set_state (const XMLNode& node, int /*version*/)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 
 		XMLNodeList nlist;
 		XMLNodeConstIterator niter;
@@ -4811,7 +5132,7 @@ TempoMap::remove_time (samplepos_t where, samplecnt_t amount)
 	bool tempo_after = false; // is there a tempo marker at the first sample after the removed range?
 	bool meter_after = false; // is there a meter marker likewise?
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriter lm (*this);
 		for (Metrics::iterator i = _metrics.begin(); i != _metrics.end(); ++i) {
 			if ((*i)->sample() >= where && (*i)->sample() < where+amount) {
 				metric_kill_list.push_back(*i);
@@ -4866,18 +5187,18 @@ TempoMap::remove_time (samplepos_t where, samplecnt_t amount)
 samplepos_t
 TempoMap::samplepos_plus_qn (samplepos_t sample, Temporal::Beats beats) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	const double sample_qn = pulse_at_minute_locked (_metrics, minute_at_sample (sample)) * 4.0;
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
+	const double sample_qn = snapshot->pulse_at_minute (minute_at_sample (sample)) * 4.0;
 
-	return sample_at_minute (minute_at_pulse_locked (_metrics, (sample_qn + beats.to_double()) / 4.0));
+	return sample_at_minute (snapshot->minute_at_pulse ((sample_qn + beats.to_double()) / 4.0));
 }
 
 samplepos_t
 TempoMap::samplepos_plus_bbt (samplepos_t pos, BBT_Time op) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader());
 
-	BBT_Time pos_bbt = bbt_at_beat_locked (_metrics, beat_at_minute_locked (_metrics, minute_at_sample (pos)));
+	BBT_Time pos_bbt = snapshot->bbt_at_beat (snapshot->beat_at_minute (minute_at_sample (pos)));
 	pos_bbt.ticks += op.ticks;
 	if (pos_bbt.ticks >= BBT_Time::ticks_per_beat) {
 		++pos_bbt.beats;
@@ -4885,15 +5206,15 @@ TempoMap::samplepos_plus_bbt (samplepos_t pos, BBT_Time op) const
 	}
 	pos_bbt.beats += op.beats;
 	/* the meter in effect will start on the bar */
-	double divisions_per_bar = meter_section_at_beat (beat_at_bbt_locked (_metrics, BBT_Time (pos_bbt.bars + op.bars, 1, 0))).divisions_per_bar();
+	double divisions_per_bar = snapshot->meter_section_at_beat (snapshot->beat_at_bbt (BBT_Time (pos_bbt.bars + op.bars, 1, 0))).divisions_per_bar();
 	while (pos_bbt.beats >= divisions_per_bar + 1) {
 		++pos_bbt.bars;
-		divisions_per_bar = meter_section_at_beat (beat_at_bbt_locked (_metrics, BBT_Time (pos_bbt.bars + op.bars, 1, 0))).divisions_per_bar();
+		divisions_per_bar = snapshot->meter_section_at_beat (snapshot->beat_at_bbt (BBT_Time (pos_bbt.bars + op.bars, 1, 0))).divisions_per_bar();
 		pos_bbt.beats -= divisions_per_bar;
 	}
 	pos_bbt.bars += op.bars;
 
-	return sample_at_minute (minute_at_bbt_locked (_metrics, pos_bbt));
+	return sample_at_minute (snapshot->minute_at_bbt (pos_bbt));
 }
 
 /** Count the number of beats that are equivalent to distance when going forward,
@@ -4902,9 +5223,7 @@ TempoMap::samplepos_plus_bbt (samplepos_t pos, BBT_Time op) const
 Temporal::Beats
 TempoMap::framewalk_to_qn (samplepos_t pos, samplecnt_t distance) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return Temporal::Beats (quarter_notes_between_samples_locked (_metrics, pos, pos + distance));
+	return Temporal::Beats (_snapshot.reader()->quarter_notes_between_samples (pos, pos + distance));
 }
 
 struct bbtcmp {
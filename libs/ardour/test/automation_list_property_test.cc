@@ -24,6 +24,7 @@
 #include "pbd/properties.h"
 #include "pbd/stateful_diff_command.h"
 #include "ardour/automation_list.h"
+#include "ardour/automation_list_diff_command.h"
 #include "automation_list_property_test.h"
 #include "test_util.h"
 
@@ -164,3 +165,115 @@ AutomationListPropertyTest::undoTest ()
 	write_automation_list_xml (&sheila->get_state(), test_data_filename);
 	check_xml (&sheila->get_state(), test_data_file4, ignore_properties);
 }
+
+void
+AutomationListPropertyTest::diffCommandTest ()
+{
+	AutomationList al (Evoral::Parameter (GainAutomation));
+
+	al.freeze ();
+	for (int i = 0; i < 10000; ++i) {
+		al.fast_simple_add (i * 480, (i % 100) / 50.);
+	}
+	al.thaw ();
+
+	XMLNode* before = &al.get_state ();
+	XMLNode* before_copy = new XMLNode (*before);
+
+	/* move a single point */
+	AutomationList::iterator p = al.begin ();
+	std::advance (p, 5000);
+	al.modify (p, (*p)->when + 10, .25);
+
+	XMLNode* after = &al.get_state ();
+	XMLNode* after_copy = new XMLNode (*after);
+
+	AutomationListDiffCommand* cmd = new AutomationListDiffCommand (al, before, after);
+
+	/* only the modified event is kept */
+	XMLNode& history = cmd->get_state ();
+	CPPUNIT_ASSERT (history.child ("Removed"));
+	CPPUNIT_ASSERT (history.child ("Added"));
+	CPPUNIT_ASSERT (history.child ("Removed")->children ().front ()->content ().find ('\n') == history.child ("Removed")->children ().front ()->content ().size () - 1);
+	CPPUNIT_ASSERT (history.child ("Added")->children ().front ()->content ().find ('\n') == history.child ("Added")->children ().front ()->content ().size () - 1);
+
+	cmd->undo ();
+	CPPUNIT_ASSERT (al.get_state () == *before_copy);
+	(*cmd) ();
+	CPPUNIT_ASSERT (al.get_state () == *after_copy);
+
+	/* and the same, from a history file */
+	AutomationListDiffCommand* restored = new AutomationListDiffCommand (new SimpleMementoCommandBinder<AutomationList> (al), history);
+	restored->undo ();
+	CPPUNIT_ASSERT (al.get_state () == *before_copy);
+	(*restored) ();
+	CPPUNIT_ASSERT (al.get_state () == *after_copy);
+
+	/* clearing the list is the worst case, all events are kept once */
+	before = &al.get_state ();
+	al.clear ();
+	AutomationListDiffCommand* clear = new AutomationListDiffCommand (al, before, &al.get_state ());
+	clear->undo ();
+	CPPUNIT_ASSERT (al.get_state () == *after_copy);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 10000, al.size ());
+
+	delete clear;
+	delete restored;
+	delete cmd;
+	delete &history;
+	delete before_copy;
+	delete after_copy;
+}
+
+/** Record automation, which is thinned when the write pass finishes, and
+ *  undo and redo it as Automatable::non_realtime_transport_stop() does.
+ */
+void
+AutomationListPropertyTest::recordUndoTest ()
+{
+	AutomationList al (Evoral::Parameter (GainAutomation));
+
+	for (int i = 0; i < 100; ++i) {
+		al.fast_simple_add (i * 480, .5);
+	}
+
+	al.start_write_pass (0);
+	al.set_in_write_pass (true);
+
+	/* a ramp, which thinning reduces to its ends */
+	for (int i = 0; i < 100; ++i) {
+		al.add (48000 + i * 100, .1 + i / 1000., true);
+	}
+
+	XMLNode* before = al.before ();
+	CPPUNIT_ASSERT (before);
+	XMLNode* before_copy = new XMLNode (*before);
+
+	const size_t recorded = al.size ();
+	al.write_pass_finished (58000, 20);
+	CPPUNIT_ASSERT (al.size () < recorded);
+
+	XMLNode* after_copy = new XMLNode (al.get_state ());
+
+	Command* cmd = al.memento_command (before, &al.get_state ());
+	CPPUNIT_ASSERT (dynamic_cast<AutomationListDiffCommand*> (cmd));
+
+	cmd->undo ();
+	CPPUNIT_ASSERT (al.get_state () == *before_copy);
+	(*cmd) ();
+	CPPUNIT_ASSERT (al.get_state () == *after_copy);
+
+	/* an after-state which is not the list's falls back to a full memento */
+	before = &al.get_state ();
+	XMLNode* stale = new XMLNode (*before_copy);
+	Command* fallback = al.memento_command (before, stale);
+	CPPUNIT_ASSERT (!dynamic_cast<AutomationListDiffCommand*> (fallback));
+
+	fallback->undo ();
+	CPPUNIT_ASSERT (al.get_state () == *after_copy);
+
+	delete fallback;
+	delete cmd;
+	delete before_copy;
+	delete after_copy;
+}
@@ -24,9 +24,13 @@ class AutomationListPropertyTest : public CppUnit::TestFixture
 	CPPUNIT_TEST_SUITE (AutomationListPropertyTest);
 	CPPUNIT_TEST (basicTest);
 	CPPUNIT_TEST (undoTest);
+	CPPUNIT_TEST (diffCommandTest);
+	CPPUNIT_TEST (recordUndoTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 	void basicTest ();
 	void undoTest ();
+	void diffCommandTest ();
+	void recordUndoTest ();
 };
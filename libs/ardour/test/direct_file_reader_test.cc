@@ -0,0 +1,193 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sndfile.h>
+
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+
+#include "ardour/direct_file_reader.h"
+
+#include "direct_file_reader_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (DirectFileReaderTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const uint32_t    channels = 2;
+static const samplecnt_t frames   = 100003;
+
+void
+DirectFileReaderTest::setUp ()
+{
+	_dir    = new_test_output_dir ("direct_file_reader");
+	_fd     = -1;
+	_format = 0;
+	_length = 0;
+	_scratch.resize (frames * channels);
+}
+
+void
+DirectFileReaderTest::tearDown ()
+{
+	if (_fd >= 0) {
+		::close (_fd);
+	}
+}
+
+/** write random samples to a new file, open it for reading and
+ * keep what libsndfile reads from it to compare with.
+ */
+void
+DirectFileReaderTest::write_file (string const& name, int format)
+{
+	if (_fd >= 0) {
+		::close (_fd);
+	}
+
+	string const path = Glib::build_filename (_dir, name);
+
+	vector<float> data (frames * channels);
+	for (size_t i = 0; i < data.size (); ++i) {
+		data[i] = g_random_double_range (-1, 1);
+	}
+
+	SF_INFO info;
+	info.samplerate = 48000;
+	info.channels   = channels;
+	info.format     = format;
+
+	SNDFILE* sf = sf_open (path.c_str (), SFM_WRITE, &info);
+	CPPUNIT_ASSERT (sf);
+	CPPUNIT_ASSERT_EQUAL ((sf_count_t) frames, sf_writef_float (sf, &data[0], frames));
+	sf_close (sf);
+
+	info.format = 0;
+	sf = sf_open (path.c_str (), SFM_READ, &info);
+	CPPUNIT_ASSERT (sf);
+	_data.resize (frames * channels);
+	CPPUNIT_ASSERT_EQUAL ((sf_count_t) frames, sf_readf_float (sf, &_data[0], frames));
+	_format = info.format;
+	_length = info.frames;
+	sf_close (sf);
+
+	_fd = ::open (path.c_str (), O_RDONLY);
+	CPPUNIT_ASSERT (_fd >= 0);
+}
+
+void
+DirectFileReaderTest::check (DirectFileReader& reader, samplepos_t start, samplecnt_t cnt, uint32_t channel)
+{
+	vector<Sample> buf (cnt);
+
+	samplecnt_t const expected = min (cnt, _length - start);
+
+	CPPUNIT_ASSERT_EQUAL (expected, reader.read (&buf[0], start, cnt, _length, channel, 1.f, &_scratch[0]));
+
+	for (samplecnt_t n = 0; n < expected; ++n) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (_data[(start + n) * channels + channel], buf[n], 1e-7);
+	}
+}
+
+void
+DirectFileReaderTest::readTest ()
+{
+	int const formats[] = {
+		SF_FORMAT_WAV | SF_FORMAT_PCM_16,
+		SF_FORMAT_WAV | SF_FORMAT_PCM_24,
+		SF_FORMAT_WAV | SF_FORMAT_PCM_32,
+		SF_FORMAT_WAV | SF_FORMAT_FLOAT,
+		SF_FORMAT_RF64 | SF_FORMAT_FLOAT,
+		SF_FORMAT_CAF | SF_FORMAT_PCM_16,
+		SF_FORMAT_CAF | SF_FORMAT_PCM_24,
+		SF_FORMAT_CAF | SF_FORMAT_FLOAT,
+	};
+
+	for (size_t f = 0; f < sizeof (formats) / sizeof (formats[0]); ++f) {
+		write_file (string_compose ("format%1", f), formats[f]);
+
+		DirectFileReader* reader = DirectFileReader::create (_fd, _format, channels);
+		CPPUNIT_ASSERT (reader);
+
+		/* contiguous refills, served from the window and read ahead */
+		for (samplepos_t pos = 0; pos < _length; pos += 1024) {
+			check (*reader, pos, 1024, 0);
+			check (*reader, pos, 1024, 1);
+		}
+
+		/* larger than the window, and going back */
+		check (*reader, 1000, 70000, 1);
+		check (*reader, 10, 100, 0);
+		check (*reader, _length - 10, 100, 1);
+		check (*reader, 0, _length, 0);
+
+		delete reader;
+	}
+}
+
+/** many readers at once, more than the io_uring queue holds; all reads
+ * ahead which are not submitted have to fall back to reading synchronously.
+ */
+void
+DirectFileReaderTest::fullQueueTest ()
+{
+	write_file ("queue.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_16);
+
+	vector<DirectFileReader*> readers;
+
+	for (int i = 0; i < 600; ++i) {
+		readers.push_back (DirectFileReader::create (_fd, _format, channels));
+		CPPUNIT_ASSERT (readers.back ());
+	}
+
+	for (samplepos_t pos = 0; pos < 4 * 512; pos += 512) {
+		for (size_t i = 0; i < readers.size (); ++i) {
+			check (*readers[i], pos + i, 512, i % channels);
+		}
+	}
+
+	for (size_t i = 0; i < readers.size (); ++i) {
+		delete readers[i];
+	}
+}
+
+void
+DirectFileReaderTest::synchronousTest ()
+{
+	write_file ("sync.caf", SF_FORMAT_CAF | SF_FORMAT_FLOAT);
+
+	DirectFileReader::_async_enabled = false;
+
+	DirectFileReader* reader = DirectFileReader::create (_fd, _format, channels);
+	CPPUNIT_ASSERT (reader);
+
+	for (samplepos_t pos = 0; pos < _length; pos += 4096) {
+		check (*reader, pos, 4096, pos % channels);
+		/* nothing is read ahead */
+		CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, reader->_win_req_frames);
+	}
+
+	delete reader;
+
+	DirectFileReader::_async_enabled = true;
+}
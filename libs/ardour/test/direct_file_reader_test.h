@@ -0,0 +1,55 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ardour/types.h"
+
+namespace ARDOUR {
+	class DirectFileReader;
+}
+
+class DirectFileReaderTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (DirectFileReaderTest);
+	CPPUNIT_TEST (readTest);
+	CPPUNIT_TEST (fullQueueTest);
+	CPPUNIT_TEST (synchronousTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void readTest ();
+	void fullQueueTest ();
+	void synchronousTest ();
+
+private:
+	void write_file (std::string const& name, int format);
+	void check (ARDOUR::DirectFileReader&, ARDOUR::samplepos_t start, ARDOUR::samplecnt_t cnt, uint32_t channel);
+
+	std::string         _dir;
+	int                 _fd;
+	int                 _format;
+	ARDOUR::samplecnt_t _length;
+	std::vector<float>  _data; ///< interleaved, as libsndfile reads it
+	std::vector<float>  _scratch;
+};
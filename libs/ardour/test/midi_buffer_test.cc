@@ -0,0 +1,301 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "ardour/midi_buffer.h"
+
+#include "midi_buffer_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MidiBufferTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+namespace {
+
+const uint8_t commands[] = {
+	MIDI_CMD_CONTROL, MIDI_CMD_PGM_CHANGE, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_ON,
+	MIDI_CMD_NOTE_PRESSURE, MIDI_CMD_CHANNEL_PRESSURE, MIDI_CMD_BENDER
+};
+
+struct Event {
+	Event (MidiBuffer::TimeType t, uint8_t s, size_t i)
+		: time (t), index (i)
+	{
+		data[0] = s;
+		data[1] = 64;
+		data[2] = 100;
+		size = Evoral::midi_event_size (s);
+		priority = 0;
+		if (s < 0xf0) {
+			priority = find (commands, commands + 7, s & 0xf0) - commands;
+		}
+	}
+
+	MidiBuffer::TimeType time;
+	size_t               index;
+	uint8_t              data[3];
+	int                  size;
+	size_t               priority;
+};
+
+/* the order of events from buffers which are each in this order */
+bool
+merged_before (Event const& a, Event const& b)
+{
+	if (a.time != b.time) {
+		return a.time < b.time;
+	}
+	if (a.priority != b.priority) {
+		return a.priority < b.priority;
+	}
+	return a.index < b.index;
+}
+
+bool
+time_and_priority_before (Event const& a, Event const& b)
+{
+	if (a.time != b.time) {
+		return a.time < b.time;
+	}
+	return a.priority < b.priority;
+}
+
+vector<Event>
+random_events (size_t n, size_t index, MidiBuffer::TimeType nframes)
+{
+	vector<Event> events;
+
+	for (size_t i = 0; i < n; ++i) {
+		uint8_t status;
+		if (rand () % 10 == 0) {
+			status = 0xf8; // clock, a single byte
+		} else {
+			status = commands[rand () % 7] | (rand () % 4);
+		}
+		/* few distinct times, so that there are many simultaneous events */
+		events.push_back (Event (rand () % nframes, status, index));
+	}
+
+	stable_sort (events.begin (), events.end (), time_and_priority_before);
+	return events;
+}
+
+void
+fill (MidiBuffer& buf, vector<Event> const& events)
+{
+	buf.clear ();
+	for (vector<Event>::const_iterator e = events.begin (); e != events.end (); ++e) {
+		CPPUNIT_ASSERT (buf.push_back (e->time, e->size, e->data));
+	}
+}
+
+void
+check (MidiBuffer const& buf, vector<Event> const& expected)
+{
+	vector<Event>::const_iterator e = expected.begin ();
+
+	for (MidiBuffer::const_iterator i = buf.begin (); i != buf.end (); ++i, ++e) {
+		CPPUNIT_ASSERT (e != expected.end ());
+		CPPUNIT_ASSERT_EQUAL (e->time, (*i).time ());
+		CPPUNIT_ASSERT_EQUAL ((uint32_t) e->size, (*i).size ());
+		CPPUNIT_ASSERT_EQUAL (e->data[0], (*i).buffer ()[0]);
+	}
+
+	CPPUNIT_ASSERT (e == expected.end ());
+}
+
+void
+merge_and_check (size_t n_buffers, size_t n_events, bool one_at_a_time)
+{
+	MidiBuffer ours (32768);
+	vector<MidiBuffer*> theirs;
+	vector<Event> expected;
+
+	vector<Event> events (random_events (n_events, 0, 64));
+	fill (ours, events);
+	expected.insert (expected.end (), events.begin (), events.end ());
+
+	for (size_t i = 1; i < n_buffers; ++i) {
+		theirs.push_back (new MidiBuffer (4096));
+		/* some empty ones */
+		events = random_events ((i % 5) ? n_events : 0, one_at_a_time ? 0 : i, 64);
+		fill (*theirs.back (), events);
+		expected.insert (expected.end (), events.begin (), events.end ());
+	}
+
+	if (one_at_a_time) {
+		for (vector<MidiBuffer*>::const_iterator b = theirs.begin (); b != theirs.end (); ++b) {
+			CPPUNIT_ASSERT (ours.merge_in_place (**b));
+		}
+		/* the order of simultaneous events of the same priority depends
+		 * on the order of merging, so only compare the rest.
+		 */
+		stable_sort (expected.begin (), expected.end (), time_and_priority_before);
+		MidiBuffer const& merged (ours);
+		size_t n = 0;
+		MidiBuffer::const_iterator prev = merged.end ();
+		for (MidiBuffer::const_iterator i = merged.begin (); i != merged.end (); ++i, ++n) {
+			CPPUNIT_ASSERT_EQUAL (expected[n].time, (*i).time ());
+			if (prev != merged.end () && (*prev).time () == (*i).time ()) {
+				const uint8_t a = (*prev).buffer ()[0];
+				const uint8_t b = (*i).buffer ()[0];
+				if (a < 0xf0 && b < 0xf0 && (a & 0xf) == (b & 0xf)) {
+					/* b must not be one which had to go before a */
+					CPPUNIT_ASSERT (!MidiBuffer::second_simultaneous_midi_byte_is_first (a, b) || MidiBuffer::second_simultaneous_midi_byte_is_first (b, a));
+				}
+			}
+			prev = i;
+		}
+		CPPUNIT_ASSERT_EQUAL (expected.size (), n);
+	} else {
+		CPPUNIT_ASSERT (ours.merge_in_place (theirs.empty () ? 0 : &theirs[0], theirs.size ()));
+		stable_sort (expected.begin (), expected.end (), merged_before);
+		check (ours, expected);
+	}
+
+	for (vector<MidiBuffer*>::const_iterator b = theirs.begin (); b != theirs.end (); ++b) {
+		delete *b;
+	}
+}
+
+} // anon namespace
+
+void
+MidiBufferTest::mergeTest ()
+{
+	srand (1);
+
+	for (size_t n = 1; n < 8; ++n) {
+		merge_and_check (n, 50, false);
+		merge_and_check (n, 50, true);
+	}
+
+	/* into an empty buffer, and appending */
+	MidiBuffer ours (1024);
+	MidiBuffer theirs (1024);
+	const uint8_t on[] = { 0x90, 60, 100 };
+	const uint8_t off[] = { 0x80, 60, 0 };
+
+	theirs.push_back (10, 3, on);
+	CPPUNIT_ASSERT (ours.merge_in_place (theirs));
+	theirs.clear ();
+	theirs.push_back (20, 3, off);
+	CPPUNIT_ASSERT (ours.merge_in_place (theirs));
+
+	MidiBuffer::iterator i = ours.begin ();
+	CPPUNIT_ASSERT_EQUAL (MidiBuffer::TimeType (10), (*i).time ());
+	++i;
+	CPPUNIT_ASSERT_EQUAL (MidiBuffer::TimeType (20), (*i).time ());
+	++i;
+	CPPUNIT_ASSERT (i == ours.end ());
+}
+
+void
+MidiBufferTest::mergeManyTest ()
+{
+	srand (2);
+
+	/* more than are merged in one pass */
+	merge_and_check (MidiBuffer::max_merge_sources * 2 + 3, 20, false);
+	merge_and_check (MidiBuffer::max_merge_sources + 1, 20, false);
+}
+
+void
+MidiBufferTest::simultaneousTest ()
+{
+	for (size_t a = 0; a < 7; ++a) {
+		for (size_t b = 0; b < 7; ++b) {
+			for (uint8_t channel = 0; channel < 2; ++channel) {
+				MidiBuffer ours (1024);
+				MidiBuffer theirs (1024);
+				const uint8_t ev_a[] = { (uint8_t) (commands[a] | channel), 1, 1 };
+				const uint8_t ev_b[] = { commands[b], 1, 1 };
+
+				ours.push_back (100, Evoral::midi_event_size (ev_a[0]), ev_a);
+				theirs.push_back (100, Evoral::midi_event_size (ev_b[0]), ev_b);
+
+				MidiBuffer const* others[] = { &theirs };
+				CPPUNIT_ASSERT (ours.merge_in_place (others, 1));
+
+				const uint8_t first = (*ours.begin ()).buffer ()[0];
+				const bool b_first = MidiBuffer::second_simultaneous_midi_byte_is_first (ev_a[0], ev_b[0]);
+				const bool a_first = MidiBuffer::second_simultaneous_midi_byte_is_first (ev_b[0], ev_a[0]);
+
+				if (b_first && !a_first) {
+					CPPUNIT_ASSERT_EQUAL (ev_b[0], first);
+				} else if (a_first && !b_first) {
+					CPPUNIT_ASSERT_EQUAL (ev_a[0], first);
+				}
+			}
+		}
+	}
+}
+
+void
+MidiBufferTest::overflowTest ()
+{
+	MidiBuffer ours (64);
+	MidiBuffer theirs (64);
+	const uint8_t on[] = { 0x90, 60, 100 };
+
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT (ours.push_back (i, 3, on));
+		CPPUNIT_ASSERT (theirs.push_back (i, 3, on));
+	}
+
+	const size_t size = ours.size ();
+	MidiBuffer const* others[] = { &theirs };
+
+	CPPUNIT_ASSERT (!ours.merge_in_place (others, 1));
+	CPPUNIT_ASSERT_EQUAL (size, ours.size ());
+}
+
+/* one of several buffers, e.g. a dense send, does not fit */
+void
+MidiBufferTest::overflowOneTest ()
+{
+	MidiBuffer ours (64);
+	MidiBuffer sparse (64);
+	MidiBuffer dense (64);
+	MidiBuffer also_sparse (64);
+	const uint8_t on[] = { 0x90, 60, 100 };
+	const uint8_t off[] = { 0x80, 60, 0 };
+
+	CPPUNIT_ASSERT (ours.push_back (0, 3, on));
+	CPPUNIT_ASSERT (sparse.push_back (10, 3, off));
+	while (dense.push_back (5, 3, on)) {}
+	CPPUNIT_ASSERT (also_sparse.push_back (20, 3, off));
+
+	MidiBuffer const* others[] = { &sparse, &dense, &also_sparse };
+
+	CPPUNIT_ASSERT (!ours.merge_in_place (others, 3));
+
+	/* the note-offs of the others are not lost */
+	MidiBuffer::iterator i = ours.begin ();
+	CPPUNIT_ASSERT_EQUAL (MidiBuffer::TimeType (0), (*i).time ());
+	++i;
+	CPPUNIT_ASSERT_EQUAL (MidiBuffer::TimeType (10), (*i).time ());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 0x80, (*i).buffer ()[0]);
+	++i;
+	CPPUNIT_ASSERT_EQUAL (MidiBuffer::TimeType (20), (*i).time ());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 0x80, (*i).buffer ()[0]);
+	++i;
+	CPPUNIT_ASSERT (i == ours.end ());
+}
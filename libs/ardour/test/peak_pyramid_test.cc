@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "ardour/peak_pyramid.h"
+
+#include "peak_pyramid_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PeakPyramidTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const samplecnt_t fpp = 256;
+
+void
+PeakPyramidTest::setUp ()
+{
+	_peakpath = Glib::build_filename (new_test_output_dir ("peak_pyramid"), "test.peak");
+	::g_unlink (PeakPyramid::pyramid_path (_peakpath).c_str ());
+	write_peakfile (100003);
+}
+
+void
+PeakPyramidTest::write_peakfile (size_t n)
+{
+	_peaks.resize (n);
+	for (size_t i = 0; i < n; ++i) {
+		float const a = g_random_double_range (-1, 1);
+		float const b = g_random_double_range (-1, 1);
+		_peaks[i].max = max (a, b);
+		_peaks[i].min = min (a, b);
+	}
+
+	FILE* f = g_fopen (_peakpath.c_str (), "wb");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT_EQUAL (n, fwrite (&_peaks[0], sizeof (PeakData), n, f));
+	fclose (f);
+}
+
+void
+PeakPyramidTest::levelsTest ()
+{
+	PeakPyramid p (_peakpath, fpp);
+
+	CPPUNIT_ASSERT_EQUAL (0, p.open ());
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, p.n_levels ());
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) _peaks.size (), p.base_count ());
+	CPPUNIT_ASSERT (p.needs_build ());
+
+	CPPUNIT_ASSERT_EQUAL (0, PeakPyramid::build (_peakpath, fpp));
+
+	CPPUNIT_ASSERT_EQUAL (0, p.open ());
+	CPPUNIT_ASSERT_EQUAL (PeakPyramid::max_levels, p.n_levels ());
+	CPPUNIT_ASSERT (!p.needs_build ());
+}
+
+/** Every visual peak must contain the extrema of the level 0 peaks that it
+ *  covers; coarser levels may only widen it at the edges.
+ */
+void
+PeakPyramidTest::readTest ()
+{
+	CPPUNIT_ASSERT_EQUAL (0, PeakPyramid::build (_peakpath, fpp));
+
+	PeakPyramid p (_peakpath, fpp);
+	CPPUNIT_ASSERT_EQUAL (0, p.open ());
+
+	double const spvp[] = { 256, 300, 1024, 4096, 16384, 20000, 65536, 200000 };
+	samplecnt_t const npeaks = 100;
+	samplepos_t const start  = 12345;
+	vector<PeakData> out (npeaks);
+
+	for (size_t s = 0; s < sizeof (spvp) / sizeof (double); ++s) {
+
+		CPPUNIT_ASSERT (p.read (&out[0], npeaks, start, spvp[s]));
+
+		for (samplecnt_t n = 0; n < npeaks; ++n) {
+			double const s0 = start + n * spvp[s];
+			samplepos_t  i0 = floor (s0 / fpp);
+			samplepos_t  i1 = ceil ((s0 + spvp[s]) / fpp);
+			i1 = min (max (i1, i0 + 1), (samplepos_t) _peaks.size ());
+
+			PeakData ref = _peaks[i0];
+			for (samplepos_t i = i0 + 1; i < i1; ++i) {
+				ref.max = max (ref.max, _peaks[i].max);
+				ref.min = min (ref.min, _peaks[i].min);
+			}
+
+			if (spvp[s] < fpp * PeakPyramid::level_factor) {
+				/* served from level 0 */
+				CPPUNIT_ASSERT_EQUAL (ref.max, out[n].max);
+				CPPUNIT_ASSERT_EQUAL (ref.min, out[n].min);
+			} else {
+				CPPUNIT_ASSERT (out[n].max >= ref.max);
+				CPPUNIT_ASSERT (out[n].min <= ref.min);
+			}
+		}
+	}
+
+	/* beyond the end of the peakfile */
+	CPPUNIT_ASSERT (!p.read (&out[0], npeaks, (samplepos_t) _peaks.size () * fpp, 4096));
+}
+
+void
+PeakPyramidTest::staleTest ()
+{
+	CPPUNIT_ASSERT_EQUAL (0, PeakPyramid::build (_peakpath, fpp));
+
+	/* rewritten with a different length */
+	write_peakfile (_peaks.size () + 1);
+
+	PeakPyramid p (_peakpath, fpp);
+	CPPUNIT_ASSERT_EQUAL (0, p.open ());
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, p.n_levels ());
+	CPPUNIT_ASSERT (p.needs_build ());
+}
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/audioplaylist.h"
+#include "ardour/audioregion.h"
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "playlist_region_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRegionIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/** Compare the indexed lookups with a plain walk over all regions */
+void
+PlaylistRegionIndexTest::check_against_scan ()
+{
+	boost::shared_ptr<RegionList> all = _playlist->region_list ();
+
+	for (samplepos_t s = 0; s < 600; s += 7) {
+		for (samplepos_t l = 1; l < 300; l += 50) {
+			uint32_t expected = 0;
+			for (RegionList::const_iterator i = all->begin(); i != all->end(); ++i) {
+				if ((*i)->coverage (s, s + l - 1) != Evoral::OverlapNone) {
+					++expected;
+				}
+			}
+			CPPUNIT_ASSERT_EQUAL (size_t (expected), _playlist->regions_touched (s, s + l - 1)->size ());
+		}
+
+		uint32_t covering = 0;
+		for (RegionList::const_iterator i = all->begin(); i != all->end(); ++i) {
+			if ((*i)->covers (s)) {
+				++covering;
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL (size_t (covering), _playlist->regions_at (s)->size ());
+		CPPUNIT_ASSERT_EQUAL (covering, _playlist->count_regions_at (s));
+		CPPUNIT_ASSERT_EQUAL (covering > 0, _playlist->has_region_at (s));
+	}
+}
+
+void
+PlaylistRegionIndexTest::touchedTest ()
+{
+	/* a long region underneath a run of short, partly overlapping ones */
+	_r[0]->set_length (400);
+	_playlist->add_region (_r[0], 10);
+	for (int i = 1; i < 16; ++i) {
+		_playlist->add_region (_r[i], i * 37);
+	}
+
+	check_against_scan ();
+
+	boost::shared_ptr<RegionList> rl = _playlist->regions_touched (0, 9);
+	CPPUNIT_ASSERT (rl->empty ());
+
+	rl = _playlist->regions_touched (409, 409);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), rl->size ());
+	CPPUNIT_ASSERT_EQUAL (_r[0], rl->front ());
+}
+
+void
+PlaylistRegionIndexTest::moveTest ()
+{
+	for (int i = 0; i < 8; ++i) {
+		_playlist->add_region (_r[i], i * 100);
+	}
+
+	check_against_scan ();
+
+	_r[7]->set_position (0);
+	_r[0]->set_position (450);
+	_r[3]->set_length (10);
+
+	check_against_scan ();
+
+	_playlist->remove_region (_r[4]);
+
+	check_against_scan ();
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (450));
+}
+
+void
+PlaylistRegionIndexTest::readTest ()
+{
+	/* r[0] at the bottom, r[1] stacked on its second half */
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 50);
+
+	for (int i = 0; i < 2; ++i) {
+		_ar[i]->set_fade_in_active (false);
+		_ar[i]->set_fade_out_active (false);
+	}
+
+	Sample buf[200];
+	Sample mbuf[200];
+	float gbuf[200];
+
+	_audio_playlist->read (buf, mbuf, gbuf, 0, 200);
+
+	/* the staircase of r[0] up to r[1], then r[1] from its start, then silence */
+	for (int i = 0; i < 50; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (i), buf[i]);
+	}
+	for (int i = 50; i < 150; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (i - 50), buf[i]);
+	}
+	for (int i = 150; i < 200; ++i) {
+		CPPUNIT_ASSERT_EQUAL (0.0f, buf[i]);
+	}
+
+	/* moving the upper region must be reflected in the next read */
+	_r[1]->set_position (150);
+	_audio_playlist->read (buf, mbuf, gbuf, 0, 200);
+
+	for (int i = 0; i < 100; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (i), buf[i]);
+	}
+	for (int i = 150; i < 200; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (i - 150), buf[i]);
+	}
+}
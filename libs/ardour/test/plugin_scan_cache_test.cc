@@ -0,0 +1,268 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <ctime>
+
+#ifdef COMPILER_MSVC
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "ardour/filesystem_paths.h"
+#include "ardour/plugin_scan_cache.h"
+
+#include "plugin_scan_cache_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PluginScanCacheTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* cache_name = "plugin_scan_cache_test";
+
+static PluginScanCache::Entries
+test_entries ()
+{
+	PluginScanCache::Entries entries;
+	PluginScanCache::Entry   e;
+
+	e.name      = "Test <&> \"Plugin\"";
+	e.category  = "Delay";
+	e.creator   = "Someone";
+	e.unique_id = "urn:test:plugin";
+	e.index     = 3;
+	e.n_inputs.set_audio (2);
+	e.n_inputs.set_midi (1);
+	e.n_outputs.set_audio (4);
+	entries.push_back (e);
+
+	e.name      = "Other";
+	e.unique_id = "urn:test:other";
+	e.index     = 0;
+	e.n_inputs  = ChanCount ();
+	e.n_outputs.set_midi (1);
+	entries.push_back (e);
+
+	return entries;
+}
+
+void
+PluginScanCacheTest::setUp ()
+{
+	_dir    = new_test_output_dir ("plugin_scan_cache");
+	_plugin = Glib::build_filename (_dir, "plugin.so");
+	_bundle = Glib::build_filename (_dir, "plugin.lv2");
+
+	::g_rmdir (Glib::build_filename (_dir, "missing").c_str ());
+	g_mkdir_with_parents (_bundle.c_str (), 0755);
+	touch (_plugin, 100);
+	touch (Glib::build_filename (_bundle, "manifest.ttl"), 100);
+	touch (_bundle, 100);
+
+	PluginScanCache (cache_name).clear ();
+}
+
+void
+PluginScanCacheTest::tearDown ()
+{
+	PluginScanCache (cache_name).clear ();
+}
+
+/** create @param path if needed, and set its modification time to @param age seconds ago */
+void
+PluginScanCacheTest::touch (string const& path, int age)
+{
+	if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		FILE* f = g_fopen (path.c_str (), "w");
+		CPPUNIT_ASSERT (f);
+		fclose (f);
+	}
+
+	struct utimbuf t;
+	t.actime = t.modtime = time (0) - age;
+	CPPUNIT_ASSERT_EQUAL (0, g_utime (path.c_str (), &t));
+}
+
+void
+PluginScanCacheTest::roundTripTest ()
+{
+	PluginScanCache::Entries const entries = test_entries ();
+
+	{
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		CPPUNIT_ASSERT (!cache.lookup (_plugin));
+		CPPUNIT_ASSERT (!cache.lookup (_bundle));
+		cache.set (_plugin, entries);
+		cache.set (_bundle, PluginScanCache::Entries ());
+		cache.save ();
+	}
+
+	PluginScanCache cache (cache_name);
+	cache.load ();
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, cache.paths ().size ());
+
+	PluginScanCache::Entries const* cached = cache.lookup (_plugin);
+	CPPUNIT_ASSERT (cached);
+	CPPUNIT_ASSERT_EQUAL (entries.size (), cached->size ());
+
+	for (size_t i = 0; i < entries.size (); ++i) {
+		PluginScanCache::Entry const& a (entries[i]);
+		PluginScanCache::Entry const& b ((*cached)[i]);
+		CPPUNIT_ASSERT_EQUAL (a.name, b.name);
+		CPPUNIT_ASSERT_EQUAL (a.category, b.category);
+		CPPUNIT_ASSERT_EQUAL (a.creator, b.creator);
+		CPPUNIT_ASSERT_EQUAL (a.unique_id, b.unique_id);
+		CPPUNIT_ASSERT_EQUAL (a.index, b.index);
+		CPPUNIT_ASSERT (a.n_inputs == b.n_inputs);
+		CPPUNIT_ASSERT (a.n_outputs == b.n_outputs);
+	}
+
+	cached = cache.lookup (_bundle);
+	CPPUNIT_ASSERT (cached);
+	CPPUNIT_ASSERT (cached->empty ());
+}
+
+void
+PluginScanCacheTest::modifiedTest ()
+{
+	{
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		cache.lookup (_plugin);
+		cache.set (_plugin, test_entries ());
+		cache.lookup (_bundle);
+		cache.set (_bundle, test_entries ());
+		cache.save ();
+	}
+
+	/* a file is replaced */
+	touch (_plugin, 10);
+
+	/* a file inside a bundle is modified, the bundle directory's time does not change */
+	touch (Glib::build_filename (_bundle, "manifest.ttl"), 10);
+	touch (_bundle, 100);
+
+	PluginScanCache cache (cache_name);
+	cache.load ();
+
+	CPPUNIT_ASSERT (!cache.lookup (_plugin));
+	CPPUNIT_ASSERT (!cache.lookup (_bundle));
+
+	/* until they are scanned again */
+	cache.set (_plugin, test_entries ());
+	CPPUNIT_ASSERT (cache.lookup (_plugin));
+}
+
+void
+PluginScanCacheTest::missingTest ()
+{
+	string const missing = Glib::build_filename (_dir, "missing");
+
+	{
+		PluginScanCache cache (cache_name);
+		cache.load ();
+
+		/* directories which do not exist (yet) can be recorded */
+		CPPUNIT_ASSERT (!cache.lookup (missing));
+		cache.set (missing, PluginScanCache::Entries ());
+		cache.lookup (_plugin);
+		cache.set (_plugin, test_entries ());
+		cache.save ();
+	}
+
+	{
+		/* files which are not looked up are dropped */
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		CPPUNIT_ASSERT (cache.lookup (missing));
+		cache.save ();
+	}
+
+	PluginScanCache cache (cache_name);
+	cache.load ();
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, cache.paths ().size ());
+	CPPUNIT_ASSERT (!cache.lookup (_plugin));
+
+	/* it appears */
+	g_mkdir_with_parents (missing.c_str (), 0755);
+	CPPUNIT_ASSERT (!cache.lookup (missing));
+
+	/* it disappears */
+	cache.set (_plugin, test_entries ());
+	::g_unlink (_plugin.c_str ());
+	CPPUNIT_ASSERT (!cache.lookup (_plugin));
+}
+
+void
+PluginScanCacheTest::corruptTest ()
+{
+	string const path = Glib::build_filename (user_cache_directory (), cache_name);
+
+	{
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		cache.lookup (_plugin);
+		cache.set (_plugin, test_entries ());
+		cache.save ();
+	}
+
+	CPPUNIT_ASSERT (Glib::file_test (path, Glib::FILE_TEST_EXISTS));
+
+	/* truncated */
+	{
+		FILE* f = g_fopen (path.c_str (), "w");
+		CPPUNIT_ASSERT (f);
+		fputs ("<?xml version=\"1.0\"?>\n<PluginScanCache version=\"1\"><File path=", f);
+		fclose (f);
+
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		CPPUNIT_ASSERT (cache.paths ().empty ());
+		CPPUNIT_ASSERT (!cache.lookup (_plugin));
+	}
+
+	/* of another version */
+	{
+		FILE* f = g_fopen (path.c_str (), "w");
+		CPPUNIT_ASSERT (f);
+		fprintf (f, "<?xml version=\"1.0\"?>\n<PluginScanCache version=\"0\" revision=\"0\"><File path=\"%s\" mtime=\"0\"/></PluginScanCache>\n", _plugin.c_str ());
+		fclose (f);
+
+		PluginScanCache cache (cache_name);
+		cache.load ();
+		CPPUNIT_ASSERT (cache.paths ().empty ());
+	}
+
+	/* no cache file at all */
+	PluginScanCache (cache_name).clear ();
+	CPPUNIT_ASSERT (!Glib::file_test (path, Glib::FILE_TEST_EXISTS));
+
+	PluginScanCache cache (cache_name);
+	cache.load ();
+	CPPUNIT_ASSERT (cache.paths ().empty ());
+}
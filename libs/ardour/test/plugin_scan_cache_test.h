@@ -0,0 +1,46 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PluginScanCacheTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (PluginScanCacheTest);
+	CPPUNIT_TEST (roundTripTest);
+	CPPUNIT_TEST (modifiedTest);
+	CPPUNIT_TEST (missingTest);
+	CPPUNIT_TEST (corruptTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void roundTripTest ();
+	void modifiedTest ();
+	void missingTest ();
+	void corruptTest ();
+
+private:
+	void touch (std::string const& path, int age);
+
+	std::string _dir;
+	std::string _plugin;
+	std::string _bundle;
+};
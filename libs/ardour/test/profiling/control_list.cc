@@ -0,0 +1,202 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time common Evoral::ControlList operations on dense automation.
+ *
+ *   control_list [-e evals] [-a adds] [size ...]
+ *
+ * sizes default to 1000 100000 1000000 points. Output is one line per
+ * operation and size:
+ *   <operation> <points> <total msec> <usec per call>
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <glib.h>
+
+#include "evoral/ControlList.hpp"
+#include "evoral/Curve.hpp"
+#include "evoral/Parameter.hpp"
+#include "evoral/ParameterDescriptor.hpp"
+#include "evoral/Range.hpp"
+
+using namespace std;
+using namespace Evoral;
+
+/* samples between points, ~ one point per 10ms at 48kHz */
+static const double spacing = 480;
+
+static boost::shared_ptr<ControlList>
+make_list (uint64_t npoints)
+{
+	ParameterDescriptor desc;
+	boost::shared_ptr<ControlList> cl (new ControlList (Parameter (0), desc));
+
+	cl->freeze ();
+	for (uint64_t i = 0; i < npoints; ++i) {
+		/* slowly changing, so that thin() has something to do */
+		cl->fast_simple_add (i * spacing, .5 + .4 * sin (i * .001) + .01 * g_random_double ());
+	}
+	cl->thaw ();
+
+	return cl;
+}
+
+static void
+report (char const* op, uint64_t npoints, int64_t usec, uint64_t calls)
+{
+	cout << op << " " << npoints << " " << usec / 1000. << " " << usec / (double) max<uint64_t> (1, calls) << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint64_t n_evals = 1000000;
+	uint64_t n_adds  = 10000;
+	int      c;
+
+	while ((c = getopt (argc, argv, "e:a:")) != -1) {
+		switch (c) {
+			case 'e':
+				n_evals = atoll (optarg);
+				break;
+			case 'a':
+				n_adds = atoll (optarg);
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-e evals] [-a adds] [size ...]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	vector<uint64_t> sizes;
+	for (int i = optind; i < argc; ++i) {
+		sizes.push_back (atoll (argv[i]));
+	}
+	if (sizes.empty ()) {
+		sizes.push_back (1000);
+		sizes.push_back (100000);
+		sizes.push_back (1000000);
+	}
+
+	g_random_set_seed (1);
+
+	cout << "# operation points msec usec/call\n";
+
+	for (vector<uint64_t>::const_iterator s = sizes.begin (); s != sizes.end (); ++s) {
+		const uint64_t n   = *s;
+		const double   len = n * spacing;
+		int64_t        t0;
+		double         sum = 0;
+
+		t0 = g_get_monotonic_time ();
+		boost::shared_ptr<ControlList> cl = make_list (n);
+		report ("load", n, g_get_monotonic_time () - t0, n);
+
+		/* random access, e.g. the GUI or locating */
+		vector<double> xs (n_evals);
+		for (uint64_t i = 0; i < n_evals; ++i) {
+			xs[i] = g_random_double () * len;
+		}
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_evals; ++i) {
+			sum += cl->eval (xs[i]);
+		}
+		report ("eval-random", n, g_get_monotonic_time () - t0, n_evals);
+
+		/* playback, moving forward a period at a time */
+		const double step = len / n_evals;
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_evals; ++i) {
+			bool ok;
+			sum += cl->rt_safe_eval (i * step, ok);
+		}
+		report ("eval-sequential", n, g_get_monotonic_time () - t0, n_evals);
+
+		/* playback, a whole period of values at a time, as Amp and the panners do */
+		{
+			const int32_t  block    = 1024;
+			const uint64_t n_blocks = max<uint64_t> (1, n_evals / block);
+			const double   bstep    = len / n_blocks;
+			vector<float>  vec (block);
+
+			cl->create_curve ();
+			t0 = g_get_monotonic_time ();
+			for (uint64_t i = 0; i < n_blocks; ++i) {
+				cl->curve ().rt_safe_get_vector (i * bstep, (i + 1) * bstep, &vec[0], block);
+				sum += vec[block - 1];
+			}
+			report ("get-vector", n, g_get_monotonic_time () - t0, n_blocks * block);
+		}
+
+		/* overwrite the middle of the list, as a write pass would */
+		{
+			boost::shared_ptr<ControlList> wl (new ControlList (*cl));
+			const double start = len / 2;
+			const double wstep = spacing / 4;
+
+			t0 = g_get_monotonic_time ();
+			wl->start_write_pass (start);
+			wl->set_in_write_pass (true, true, start);
+			for (uint64_t i = 0; i < n_adds; ++i) {
+				wl->add (start + i * wstep, g_random_double ());
+			}
+			int64_t const t1 = g_get_monotonic_time ();
+			report ("write-pass-add", n, t1 - t0, n_adds);
+
+			wl->write_pass_finished (start + n_adds * wstep, 0.0);
+			report ("write-pass-finish", n, g_get_monotonic_time () - t1, 1);
+		}
+
+		{
+			boost::shared_ptr<ControlList> tl (new ControlList (*cl));
+			t0 = g_get_monotonic_time ();
+			tl->thin (20);
+			report ("thin", n, g_get_monotonic_time () - t0, 1);
+		}
+
+		{
+			/* copy 10% and paste it at 3/4 */
+			boost::shared_ptr<ControlList> pl (new ControlList (*cl));
+			boost::shared_ptr<ControlList> section = pl->copy (len * .1, len * .2);
+			t0 = g_get_monotonic_time ();
+			pl->paste (*section, len * .75);
+			report ("paste", n, g_get_monotonic_time () - t0, 1);
+		}
+
+		{
+			/* move 10% from the start to the end */
+			boost::shared_ptr<ControlList> ml (new ControlList (*cl));
+			list<RangeMove<double> > moves;
+			moves.push_back (RangeMove<double> (len * .1, len * .1, len * .8));
+			t0 = g_get_monotonic_time ();
+			ml->move_ranges (moves);
+			report ("move-ranges", n, g_get_monotonic_time () - t0, 1);
+		}
+
+		if (sum == 42) {
+			/* keep the evaluations */
+			cout << "#\n";
+		}
+	}
+
+	return 0;
+}
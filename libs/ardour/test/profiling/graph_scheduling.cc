@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Run a synthetic route graph of `width' parallel chains, each `depth'
+ * busses long, through the dummy backend and report the cost per cycle.
+ *
+ *   graph_scheduling [-w] [-j threads] [-s seconds] <width> <depth>
+ *
+ * -w uses the work-stealing scheduler instead of the shared trigger queue.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glibmm.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/failed_constructor.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audio_port.h"
+#include "ardour/audioengine.h"
+#include "ardour/io.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+usage (char const* argv0)
+{
+	cerr << "Syntax: " << argv0 << " [-w] [-j threads] [-s seconds] <width> <depth>\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	bool     work_stealing = false;
+	int32_t  threads       = 0;
+	double   seconds       = 10;
+	int      c;
+
+	while ((c = getopt (argc, argv, "wj:s:")) != -1) {
+		switch (c) {
+			case 'w':
+				work_stealing = true;
+				break;
+			case 'j':
+				threads = atoi (optarg);
+				break;
+			case 's':
+				seconds = atof (optarg);
+				break;
+			default:
+				usage (argv[0]);
+		}
+	}
+
+	if (argc - optind != 2) {
+		usage (argv[0]);
+	}
+
+	uint32_t const width = atoi (argv[optind]);
+	uint32_t const depth = atoi (argv[optind + 1]);
+
+	if (width < 1 || depth < 1) {
+		usage (argv[0]);
+	}
+
+	ARDOUR::init (false, true, localedir);
+
+	Config->set_graph_work_stealing (work_stealing);
+	Config->set_processor_usage (threads);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = 0;
+
+	try {
+		session = load_session (Glib::build_filename (new_test_output_dir ("graph"), "graph_scheduling"), "graph_scheduling");
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what () << "\n";
+		exit (EXIT_FAILURE);
+	}
+
+	/* width x depth busses; each chain feeds the next bus, the last one the master-bus */
+	RouteList busses = session->new_audio_route (1, 1, 0, width * depth, "Bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+	if (busses.size () != width * depth) {
+		cerr << "Could not create " << width * depth << " busses\n";
+		exit (EXIT_FAILURE);
+	}
+
+	RouteList::iterator r = busses.begin ();
+	for (uint32_t w = 0; w < width; ++w) {
+		for (uint32_t d = 0; d < depth; ++d, ++r) {
+			if (d + 1 == depth) {
+				continue;
+			}
+			RouteList::iterator next = r;
+			++next;
+			boost::shared_ptr<IO> out = (*r)->output ();
+			out->disconnect (0);
+			out->connect (out->audio (0), (*next)->input ()->audio (0)->name (), 0);
+		}
+	}
+
+	AudioEngine* engine = AudioEngine::instance ();
+
+	/* let the graph settle */
+	Glib::usleep (1000000);
+
+	double const cycle_usec = 1e6 * engine->samples_per_cycle () / (double) engine->sample_rate ();
+
+	double   sum   = 0;
+	double   peak  = 0;
+	uint64_t count = 0;
+
+	for (double t = 0; t < seconds; t += .1) {
+		Glib::usleep (100000);
+		double const load = engine->get_dsp_load ();
+		sum += load;
+		peak = max (peak, load);
+		++count;
+	}
+
+	cout << "scheduler: " << (work_stealing ? "work-stealing" : "shared-queue")
+	     << " threads: " << engine->process_thread_count ()
+	     << " routes: " << session->get_routes ()->size ()
+	     << " width: " << width << " depth: " << depth
+	     << " period: " << engine->samples_per_cycle () << "\n";
+
+	cout << "cycle cost [usec] mean: " << cycle_usec * sum / (100. * count)
+	     << " peak: " << cycle_usec * peak / 100.
+	     << " (of " << cycle_usec << ")\n";
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	stop_and_destroy_backend ();
+
+	return 0;
+}
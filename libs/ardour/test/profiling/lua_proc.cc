@@ -0,0 +1,211 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Compare the cost of LuaProc::connect_and_run() when dsp_run() is passed
+ * new tables each cycle, and when the tables are reused.
+ *
+ *   lua_proc [-c cycles] [-m midi-events] [-n period] [script.lua]
+ *
+ * Without a script, a built-in one that copies 2 audio channels and
+ * passes MIDI through is used. Output is one line per mode:
+ *   <mode> <usec per cycle> <Lua allocations per cycle>
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/failed_constructor.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/buffer_set.h"
+#include "ardour/chan_mapping.h"
+#include "ardour/luaproc.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/process_thread.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+static const char* default_script =
+	"ardour {\n"
+	"  [\"type\"]    = \"dsp\",\n"
+	"  name        = \"LuaProc Benchmark\",\n"
+	"  license     = \"MIT\",\n"
+	"  author      = \"Ardour\",\n"
+	"  description = [[copy audio, pass MIDI through]]\n"
+	"}\n"
+	"function dsp_ioconfig ()\n"
+	"  return { { audio_in = 2, audio_out = 2, midi_in = 1, midi_out = 1 }, }\n"
+	"end\n"
+	"function dsp_run (ins, outs, n_samples)\n"
+	"  for c = 1, #outs do\n"
+	"    if ins[c] ~= outs[c] then\n"
+	"      ARDOUR.DSP.copy_vector (outs[c], ins[c], n_samples)\n"
+	"    end\n"
+	"  end\n"
+	"  local i = 1\n"
+	"  for _, ev in pairs (midiin) do\n"
+	"    midiout[i] = ev\n"
+	"    i = i + 1\n"
+	"  end\n"
+	"end\n";
+
+static void
+usage (char const* argv0)
+{
+	cerr << "Syntax: " << argv0 << " [-c cycles] [-m midi-events] [-n period] [script.lua]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t cycles  = 100000;
+	uint32_t nevents = 16;
+	uint32_t period  = 256;
+	int      c;
+
+	while ((c = getopt (argc, argv, "c:m:n:")) != -1) {
+		switch (c) {
+			case 'c':
+				cycles = atoi (optarg);
+				break;
+			case 'm':
+				nevents = atoi (optarg);
+				break;
+			case 'n':
+				period = atoi (optarg);
+				break;
+			default:
+				usage (argv[0]);
+		}
+	}
+
+	if (argc - optind > 1 || cycles < 1 || period < 1) {
+		usage (argv[0]);
+	}
+
+	string script = default_script;
+	if (optind < argc) {
+		try {
+			script = Glib::file_get_contents (argv[optind]);
+		} catch (Glib::FileError const& e) {
+			cerr << "Cannot read " << argv[optind] << ": " << e.what () << "\n";
+			exit (EXIT_FAILURE);
+		}
+	}
+
+	ARDOUR::init (false, true, localedir);
+	create_and_start_dummy_backend ();
+
+	Session* session = 0;
+
+	try {
+		session = load_session (Glib::build_filename (new_test_output_dir ("luaproc"), "lua_proc"), "lua_proc");
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what () << "\n";
+		exit (EXIT_FAILURE);
+	}
+
+	/* this thread acts as a process thread */
+	SessionEvent::create_per_thread_pool ("lua_proc", 512);
+	ProcessThread* pt = new ProcessThread ();
+	pt->get_buffers ();
+
+	for (int reuse = 0; reuse < 2; ++reuse) {
+		boost::shared_ptr<LuaProc> lp;
+
+		try {
+			lp.reset (new LuaProc (session->engine (), *session, script));
+		} catch (failed_constructor& e) {
+			cerr << "Cannot instantiate script\n";
+			exit (EXIT_FAILURE);
+		}
+
+		ChanCount in (DataType::AUDIO, 2);
+		in.set (DataType::MIDI, 1);
+		ChanCount out;
+
+		if (!lp->can_support_io_configuration (in, out, 0) || !lp->configure_io (in, out)) {
+			cerr << "Script does not support 2 audio + 1 MIDI in\n";
+			exit (EXIT_FAILURE);
+		}
+
+		lp->set_reuse_tables (reuse);
+
+		BufferSet bufs;
+		bufs.ensure_buffers (DataType::AUDIO, max (in.n_audio (), out.n_audio ()), period);
+		bufs.ensure_buffers (DataType::MIDI, 1, 4096);
+		bufs.set_count (ChanCount::max (in, out));
+
+		ChanMapping map (ChanCount::max (in, out));
+
+		const samplecnt_t sr = session->nominal_sample_rate ();
+		int64_t usec = 0;
+		size_t  n_alloc = 0;
+
+		for (uint32_t i = 0; i < cycles; ++i) {
+			/* new input, the script replaced the MIDI buffer's content */
+			MidiBuffer& mb = bufs.get_midi (0);
+			mb.silence (period);
+			for (uint32_t e = 0; e < nevents; ++e) {
+				const uint8_t note_on[3] = { 0x90, (uint8_t) (e & 0x7f), 0x7f };
+				mb.push_back ((e * period) / max<uint32_t> (1, nevents), 3, note_on);
+			}
+
+			const samplepos_t start = (samplepos_t) i * period;
+			const size_t  a0 = lp->lua_state ()->n_allocations ();
+			const int64_t t0 = g_get_monotonic_time ();
+
+			lp->connect_and_run (bufs, start, start + period, 1.0, map, map, period, 0);
+
+			usec += g_get_monotonic_time () - t0;
+
+			if (i == 0) {
+				/* count from the second cycle on, the first one sets up tables */
+				lp->lua_state ()->count_allocations (true);
+			} else {
+				n_alloc += lp->lua_state ()->n_allocations () - a0;
+			}
+		}
+
+		cout << (reuse ? "reused-tables " : "new-tables ")
+		     << usec / (double) cycles << " "
+		     << n_alloc / (double) max<uint32_t> (1, cycles - 1)
+		     << " (" << 1e6 * period / (double) sr << " usec/cycle available)\n";
+	}
+
+	pt->drop_buffers ();
+	delete pt;
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	stop_and_destroy_backend ();
+
+	return 0;
+}
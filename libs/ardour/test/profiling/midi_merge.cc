@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time merging the MIDI of many inputs into one buffer, as a MIDI bus does
+ * every cycle, against the number of inputs and their event density.
+ *
+ *   midi_merge [-c cycles] [-i inputs ...] [events ...]
+ *
+ * inputs default to 1 4 16 64, events (per input and cycle) to 16 128 512.
+ * Every cycle the merged buffer is cleared and the inputs are merged into
+ * it one after the other ("pairwise"), all at once ("k-way"), or event by
+ * event with insert_event() ("insert"), which is slow enough to only be
+ * run for a hundredth of the cycles. Output is one line per method and size:
+ *   <method> <inputs> <events> <total msec> <nsec per event>
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "ardour/midi_buffer.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const samplecnt_t nframes = 1024;
+
+/* controller data, e.g. MPE or aftertouch */
+static void
+make_input (MidiBuffer& buf, uint32_t n_events)
+{
+	buf.clear ();
+
+	for (uint32_t i = 0; i < n_events; ++i) {
+		const uint8_t ev[] = { (uint8_t) (0xb0 | g_random_int_range (0, 16)), (uint8_t) g_random_int_range (0, 128), (uint8_t) g_random_int_range (0, 128) };
+		buf.push_back ((i * nframes) / n_events, 3, ev);
+	}
+}
+
+static void
+report (char const* method, uint32_t n_inputs, uint32_t n_events, int64_t usec, uint64_t events)
+{
+	cout << method << " " << n_inputs << " " << n_events << " " << usec / 1000. << " " << 1000. * usec / (double) max<uint64_t> (1, events) << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t         n_cycles = 1000;
+	vector<uint32_t> inputs;
+	int              c;
+
+	while ((c = getopt (argc, argv, "c:i:")) != -1) {
+		switch (c) {
+			case 'c':
+				n_cycles = atoi (optarg);
+				break;
+			case 'i':
+				inputs.push_back (atoi (optarg));
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-c cycles] [-i inputs ...] [events ...]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	vector<uint32_t> densities;
+	for (int i = optind; i < argc; ++i) {
+		densities.push_back (atoi (argv[i]));
+	}
+	if (inputs.empty ()) {
+		inputs.push_back (1);
+		inputs.push_back (4);
+		inputs.push_back (16);
+		inputs.push_back (64);
+	}
+	if (densities.empty ()) {
+		densities.push_back (16);
+		densities.push_back (128);
+		densities.push_back (512);
+	}
+
+	g_random_set_seed (1);
+
+	cout << "# method inputs events msec nsec/event\n";
+
+	for (vector<uint32_t>::const_iterator d = densities.begin (); d != densities.end (); ++d) {
+		for (vector<uint32_t>::const_iterator k = inputs.begin (); k != inputs.end (); ++k) {
+			const uint32_t n_inputs = max<uint32_t> (1, *k);
+			const uint32_t n_events = *d;
+			const uint64_t total    = (uint64_t) n_cycles * n_inputs * n_events;
+
+			vector<MidiBuffer*>       bufs;
+			vector<MidiBuffer const*> srcs;
+			for (uint32_t i = 0; i < n_inputs; ++i) {
+				bufs.push_back (new MidiBuffer (n_events * 16 + 16));
+				make_input (*bufs.back (), n_events);
+				srcs.push_back (bufs.back ());
+			}
+
+			MidiBuffer out (n_inputs * (n_events * 16 + 16));
+			size_t     size = 0;
+			int64_t    t0;
+
+			t0 = g_get_monotonic_time ();
+			for (uint32_t n = 0; n < n_cycles; ++n) {
+				out.clear ();
+				for (uint32_t i = 0; i < n_inputs; ++i) {
+					out.merge_in_place (*bufs[i]);
+				}
+				size += out.size ();
+			}
+			report ("pairwise", n_inputs, n_events, g_get_monotonic_time () - t0, total);
+
+			t0 = g_get_monotonic_time ();
+			for (uint32_t n = 0; n < n_cycles; ++n) {
+				out.clear ();
+				out.merge_in_place (&srcs[0], n_inputs);
+				size += out.size ();
+			}
+			report ("k-way", n_inputs, n_events, g_get_monotonic_time () - t0, total);
+
+			const uint32_t n_insert_cycles = max<uint32_t> (1, n_cycles / 100);
+			t0 = g_get_monotonic_time ();
+			for (uint32_t n = 0; n < n_insert_cycles; ++n) {
+				out.clear ();
+				for (uint32_t i = 0; i < n_inputs; ++i) {
+					for (MidiBuffer::iterator e = bufs[i]->begin (); e != bufs[i]->end (); ++e) {
+						out.insert_event (*e);
+					}
+				}
+				size += out.size ();
+			}
+			report ("insert", n_inputs, n_events, g_get_monotonic_time () - t0, (uint64_t) n_insert_cycles * n_inputs * n_events);
+
+			if (size == 42) {
+				/* keep the merges */
+				cout << "#\n";
+			}
+
+			for (vector<MidiBuffer*>::const_iterator b = bufs.begin (); b != bufs.end (); ++b) {
+				delete *b;
+			}
+		}
+	}
+
+	return 0;
+}
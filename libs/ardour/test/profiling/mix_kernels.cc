@@ -0,0 +1,314 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Compare all variants of the runtime_functions (mix.h) that the CPU
+ * supports, across buffer sizes, and check their results against the
+ * generic implementation.
+ *
+ *   mix_kernels [-s min-size] [-S max-size] [-n samples-per-test]
+ *
+ * Output is one line per kernel, variant and size:
+ *   <kernel> <variant> <nframes> <nsec per sample> <max. deviation>
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <getopt.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+
+#include "ardour/ardour.h"
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+struct Variant {
+	Variant (const char* n, bool a)
+		: name (n)
+		, available (a)
+		, compute_peak (0)
+		, find_peaks (0)
+		, apply_gain_to_buffer (0)
+		, mix_buffers_with_gain (0)
+		, mix_buffers_no_gain (0)
+		, copy_vector (0)
+		, apply_gain_ramp (0)
+		, mix_buffers_with_gain_ramp (0)
+	{}
+
+	const char*                  name;
+	bool                         available;
+	compute_peak_t               compute_peak;
+	find_peaks_t                 find_peaks;
+	apply_gain_to_buffer_t       apply_gain_to_buffer;
+	mix_buffers_with_gain_t      mix_buffers_with_gain;
+	mix_buffers_no_gain_t        mix_buffers_no_gain;
+	copy_vector_t                copy_vector;
+	apply_gain_ramp_t            apply_gain_ramp;
+	mix_buffers_with_gain_ramp_t mix_buffers_with_gain_ramp;
+};
+
+static vector<Variant>
+variants ()
+{
+	vector<Variant> rv;
+
+	Variant d ("default", true);
+	d.compute_peak               = default_compute_peak;
+	d.find_peaks                 = default_find_peaks;
+	d.apply_gain_to_buffer       = default_apply_gain_to_buffer;
+	d.mix_buffers_with_gain      = default_mix_buffers_with_gain;
+	d.mix_buffers_no_gain        = default_mix_buffers_no_gain;
+	d.copy_vector                = default_copy_vector;
+	d.apply_gain_ramp            = default_apply_gain_ramp;
+	d.mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
+	rv.push_back (d);
+
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
+	PBD::FPU* fpu = PBD::FPU::instance ();
+
+	Variant s ("sse", fpu->has_sse ());
+	s.compute_peak          = x86_sse_compute_peak;
+	s.find_peaks            = x86_sse_find_peaks;
+	s.apply_gain_to_buffer  = x86_sse_apply_gain_to_buffer;
+	s.mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
+	s.mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
+	rv.push_back (s);
+
+#ifdef PLATFORM_WINDOWS
+	Variant a ("avx", fpu->has_avx ());
+	a.compute_peak          = x86_sse_avx_compute_peak;
+	a.find_peaks            = x86_sse_avx_find_peaks;
+	a.apply_gain_to_buffer  = x86_sse_avx_apply_gain_to_buffer;
+	a.mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
+	a.mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
+	a.copy_vector           = x86_sse_avx_copy_vector;
+	rv.push_back (a);
+#endif
+
+	Variant f ("avx2-fma", fpu->has_avx2 () && fpu->has_fma ());
+	f.compute_peak               = x86_fma_compute_peak;
+	f.find_peaks                 = x86_fma_find_peaks;
+	f.apply_gain_to_buffer       = x86_fma_apply_gain_to_buffer;
+	f.mix_buffers_with_gain      = x86_fma_mix_buffers_with_gain;
+	f.mix_buffers_no_gain        = x86_fma_mix_buffers_no_gain;
+	f.copy_vector                = x86_fma_copy_vector;
+	f.apply_gain_ramp            = x86_fma_apply_gain_ramp;
+	f.mix_buffers_with_gain_ramp = x86_fma_mix_buffers_with_gain_ramp;
+	rv.push_back (f);
+
+	Variant x ("avx512f", fpu->has_avx512f ());
+	x.compute_peak               = x86_avx512f_compute_peak;
+	x.find_peaks                 = x86_avx512f_find_peaks;
+	x.apply_gain_to_buffer       = x86_avx512f_apply_gain_to_buffer;
+	x.mix_buffers_with_gain      = x86_avx512f_mix_buffers_with_gain;
+	x.mix_buffers_no_gain        = x86_avx512f_mix_buffers_no_gain;
+	x.copy_vector                = x86_avx512f_copy_vector;
+	x.apply_gain_ramp            = x86_avx512f_apply_gain_ramp;
+	x.mix_buffers_with_gain_ramp = x86_avx512f_mix_buffers_with_gain_ramp;
+	rv.push_back (x);
+#endif
+
+#if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
+	Variant v ("veclib", true);
+	v.compute_peak          = veclib_compute_peak;
+	v.find_peaks            = veclib_find_peaks;
+	v.apply_gain_to_buffer  = veclib_apply_gain_to_buffer;
+	v.mix_buffers_with_gain = veclib_mix_buffers_with_gain;
+	v.mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
+	rv.push_back (v);
+#endif
+
+	return rv;
+}
+
+enum Kernel {
+	ComputePeak,
+	FindPeaks,
+	ApplyGain,
+	MixWithGain,
+	MixNoGain,
+	CopyVector,
+	ApplyGainRamp,
+	MixWithGainRamp,
+	NKernels
+};
+
+static const char* kernel_names[NKernels] = {
+	"compute_peak",
+	"find_peaks",
+	"apply_gain_to_buffer",
+	"mix_buffers_with_gain",
+	"mix_buffers_no_gain",
+	"copy_vector",
+	"apply_gain_ramp",
+	"mix_buffers_with_gain_ramp",
+};
+
+static bool
+has_kernel (Variant const& v, Kernel k)
+{
+	switch (k) {
+		case ComputePeak:     return v.compute_peak != 0;
+		case FindPeaks:       return v.find_peaks != 0;
+		case ApplyGain:       return v.apply_gain_to_buffer != 0;
+		case MixWithGain:     return v.mix_buffers_with_gain != 0;
+		case MixNoGain:       return v.mix_buffers_no_gain != 0;
+		case CopyVector:      return v.copy_vector != 0;
+		case ApplyGainRamp:   return v.apply_gain_ramp != 0;
+		case MixWithGainRamp: return v.mix_buffers_with_gain_ramp != 0;
+		default:              return false;
+	}
+}
+
+/** Run kernel @a k of variant @a v once on @a dst (and @a src), @return a scalar result if any */
+static float
+run (Variant const& v, Kernel k, Sample* dst, Sample const* src, pframes_t n, bool flip)
+{
+	float a = -1.f;
+	float b = 1.f;
+
+	/* gains alternate between 2 and .5 so that repeated runs neither overflow nor underflow */
+	switch (k) {
+		case ComputePeak:
+			return v.compute_peak (src, n, 0);
+		case FindPeaks:
+			v.find_peaks (src, n, &a, &b);
+			return b - a;
+		case ApplyGain:
+			v.apply_gain_to_buffer (dst, n, flip ? .5f : 2.f);
+			break;
+		case MixWithGain:
+			v.mix_buffers_with_gain (dst, src, n, flip ? -.5f : .5f);
+			break;
+		case MixNoGain:
+			v.mix_buffers_no_gain (dst, src, n);
+			break;
+		case CopyVector:
+			v.copy_vector (dst, src, n);
+			break;
+		case ApplyGainRamp:
+			return v.apply_gain_ramp (dst, n, flip ? 2.f : .5f, flip ? .5f : 2.f, 0.003f);
+		case MixWithGainRamp:
+			v.mix_buffers_with_gain_ramp (dst, src, n, flip ? -.5f : .5f, flip ? -.25f : .25f);
+			break;
+		default:
+			break;
+	}
+	return 0;
+}
+
+int
+main (int argc, char* argv[])
+{
+	pframes_t min_size = 16;
+	pframes_t max_size = 8192;
+	uint64_t  n_total  = 1 << 24;
+	int       c;
+
+	while ((c = getopt (argc, argv, "s:S:n:")) != -1) {
+		switch (c) {
+			case 's':
+				min_size = atoi (optarg);
+				break;
+			case 'S':
+				max_size = atoi (optarg);
+				break;
+			case 'n':
+				n_total = atoll (optarg);
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-s min-size] [-S max-size] [-n samples-per-test]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	if (min_size < 1 || max_size < min_size) {
+		cerr << "Invalid buffer size range\n";
+		exit (EXIT_FAILURE);
+	}
+
+	/* sets up denormal handling and the runtime functions that are used by default */
+	ARDOUR::init (false, true, localedir);
+
+	vector<Variant> vv = variants ();
+
+	Sample* src;
+	Sample* dst;
+	Sample* ref;
+	cache_aligned_malloc ((void**) &src, max_size * sizeof (Sample));
+	cache_aligned_malloc ((void**) &dst, max_size * sizeof (Sample));
+	cache_aligned_malloc ((void**) &ref, max_size * sizeof (Sample));
+
+	for (pframes_t i = 0; i < max_size; ++i) {
+		src[i] = (float) (g_random_double () * 2 - 1);
+	}
+
+	cout << "# kernel variant nframes nsec/sample max-deviation\n";
+
+	for (int k = 0; k < NKernels; ++k) {
+		for (pframes_t n = min_size; n <= max_size; n *= 2) {
+
+			/* reference result */
+			memcpy (ref, src, n * sizeof (Sample));
+			float const ref_rv = run (vv[0], (Kernel)k, ref, src, n, false);
+
+			for (vector<Variant>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
+				if (!v->available || !has_kernel (*v, (Kernel)k)) {
+					continue;
+				}
+
+				/* check */
+				memcpy (dst, src, n * sizeof (Sample));
+				float dev = fabsf (run (*v, (Kernel)k, dst, src, n, false) - ref_rv);
+				for (pframes_t i = 0; i < n; ++i) {
+					dev = std::max (dev, fabsf (dst[i] - ref[i]));
+				}
+
+				/* measure */
+				uint64_t const reps = std::max<uint64_t> (1, n_total / n);
+				memcpy (dst, src, n * sizeof (Sample));
+
+				int64_t const t0 = g_get_monotonic_time ();
+				for (uint64_t r = 0; r < reps; ++r) {
+					run (*v, (Kernel)k, dst, src, n, r & 1);
+				}
+				int64_t const t1 = g_get_monotonic_time ();
+
+				cout << kernel_names[k] << " " << v->name << " " << n << " "
+				     << 1000. * (t1 - t0) / (double)(reps * n) << " "
+				     << dev << "\n";
+			}
+		}
+	}
+
+	cache_aligned_free (src);
+	cache_aligned_free (dst);
+	cache_aligned_free (ref);
+
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time LADSPA and LV2 plugin discovery at startup, without and with the
+ * plugin scan cache.
+ *
+ *   plugin_scan [-i iterations]
+ *
+ * Every scan runs in a process of its own, as at startup: a cold one
+ * with the cache removed first, then <iterations> warm ones which use
+ * the cache left by the previous scan. Output is one line per scan:
+ *   <cold|warm> <init msec> <refresh msec> <LADSPA plugins> <LV2 plugins>
+ * where init is ARDOUR::init(), which reads the cache, and refresh is
+ * PluginManager::refresh().
+ *
+ *   plugin_scan -s [-c]
+ *
+ * runs a single scan in this process, removing the cache first with -c,
+ * and prints the part of the line after cold/warm.
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <string>
+
+#include <glib.h>
+
+#include "ardour/ardour.h"
+#include "ardour/plugin_manager.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+scan (bool clear_cache)
+{
+	gint64 const t0 = g_get_monotonic_time ();
+	ARDOUR::init (false, true, localedir);
+	gint64 const t1 = g_get_monotonic_time ();
+
+	PluginManager& pm (PluginManager::instance ());
+
+	if (clear_cache) {
+		pm.clear_plugin_scan_cache ();
+	}
+
+	gint64 const t2 = g_get_monotonic_time ();
+	pm.refresh (true);
+	gint64 const t3 = g_get_monotonic_time ();
+
+	cout << (t1 - t0) / 1000. << " " << (t3 - t2) / 1000. << " "
+	     << pm.ladspa_plugin_info ().size () << " "
+	     << pm.lv2_plugin_info ().size () << "\n";
+
+	ARDOUR::cleanup ();
+}
+
+static bool
+run (char const* argv0, char const* label, bool clear_cache)
+{
+	gchar* argv[] = { const_cast<gchar*> (argv0), const_cast<gchar*> ("-s"), const_cast<gchar*> ("-c"), 0 };
+	gchar* out    = 0;
+	gint   status = 0;
+
+	if (!clear_cache) {
+		argv[2] = 0;
+	}
+
+	if (!g_spawn_sync (0, argv, 0, GSpawnFlags (G_SPAWN_SEARCH_PATH | G_SPAWN_STDERR_TO_DEV_NULL), 0, 0, &out, 0, &status, 0) || status != 0) {
+		cerr << "Could not run " << argv0 << "\n";
+		g_free (out);
+		return false;
+	}
+
+	cout << label << " " << out;
+	g_free (out);
+	return true;
+}
+
+static void
+usage (char const* argv0)
+{
+	cerr << "Syntax: " << argv0 << " [-i iterations] | -s [-c]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t iterations  = 5;
+	bool     single      = false;
+	bool     clear_cache = false;
+	int      c;
+
+	while ((c = getopt (argc, argv, "i:sc")) != -1) {
+		switch (c) {
+			case 'i':
+				iterations = atoi (optarg);
+				break;
+			case 's':
+				single = true;
+				break;
+			case 'c':
+				clear_cache = true;
+				break;
+			default:
+				usage (argv[0]);
+		}
+	}
+
+	if (optind != argc || (clear_cache && !single)) {
+		usage (argv[0]);
+	}
+
+	if (single) {
+		scan (clear_cache);
+		return 0;
+	}
+
+	cout << "# scan init-msec refresh-msec ladspa lv2\n";
+
+	if (!run (argv[0], "cold", true)) {
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t i = 0; i < iterations; ++i) {
+		if (!run (argv[0], "warm", false)) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	return 0;
+}
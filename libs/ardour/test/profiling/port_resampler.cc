@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time varispeed resampling of the inputs of a session, as PortManager does
+ * every cycle, against the number of ports, the quality and the speed.
+ *
+ *   port_resampler [-c cycles] [-q quality ...] [ports ...]
+ *
+ * ports default to 2 16 64, quality to 12 (the default of
+ * port-resampler-quality) and 48. Every cycle each port is resampled with
+ * a resampler of its own ("per-port") or the ports are resampled in groups
+ * which share one ("grouped"). Output is one line per method and size:
+ *   <method> <ports> <quality> <speed> <total msec> <nsec per port and sample>
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "zita-resampler/vmresampler.h"
+
+#include "ardour/audio_port.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const pframes_t nframes = 1024;
+
+static void
+report (char const* method, uint32_t n_ports, uint32_t quality, double speed, int64_t usec, uint64_t samples)
+{
+	cout << method << " " << n_ports << " " << quality << " " << speed << " " << usec / 1000. << " " << 1000. * usec / (double) max<uint64_t> (1, samples) << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t         n_cycles = 1000;
+	vector<uint32_t> qualities;
+	int              c;
+
+	while ((c = getopt (argc, argv, "c:q:")) != -1) {
+		switch (c) {
+			case 'c':
+				n_cycles = atoi (optarg);
+				break;
+			case 'q':
+				qualities.push_back (atoi (optarg));
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-c cycles] [-q quality ...] [ports ...]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	vector<uint32_t> sizes;
+	for (int i = optind; i < argc; ++i) {
+		sizes.push_back (atoi (argv[i]));
+	}
+	if (sizes.empty ()) {
+		sizes.push_back (2);
+		sizes.push_back (16);
+		sizes.push_back (64);
+	}
+	if (qualities.empty ()) {
+		qualities.push_back (12);
+		qualities.push_back (48);
+	}
+
+	/* unity is copied, the others are filtered */
+	const double speeds[] = { 1.0, 1.01, 0.5, 2.0 };
+
+	g_random_set_seed (1);
+
+	cout << "# method ports quality speed msec nsec/(port*sample)\n";
+
+	for (vector<uint32_t>::const_iterator q = qualities.begin (); q != qualities.end (); ++q) {
+		for (vector<uint32_t>::const_iterator k = sizes.begin (); k != sizes.end (); ++k) {
+			for (size_t s = 0; s < sizeof (speeds) / sizeof (speeds[0]); ++s) {
+				const uint32_t  n_ports    = max<uint32_t> (1, *k);
+				const pframes_t n_resample = nframes * speeds[s];
+				const uint64_t  total      = (uint64_t) n_cycles * n_ports * n_resample;
+
+				vector<Sample*> inputs;
+				vector<Sample*> outputs;
+				for (uint32_t i = 0; i < n_ports; ++i) {
+					inputs.push_back (new Sample[nframes]);
+					outputs.push_back (new Sample[n_resample]);
+					for (pframes_t n = 0; n < nframes; ++n) {
+						inputs.back ()[n] = g_random_double_range (-1, 1);
+					}
+				}
+
+				vector<ArdourZita::VMResampler*> per_port;
+				for (uint32_t i = 0; i < n_ports; ++i) {
+					per_port.push_back (new ArdourZita::VMResampler);
+					per_port.back ()->setup (*q);
+					per_port.back ()->set_rrfilt (10);
+				}
+
+				vector<AudioPortResampler*> grouped;
+				for (uint32_t i = 0; i < n_ports; i += AudioPortResampler::max_ports) {
+					grouped.push_back (new AudioPortResampler);
+					grouped.back ()->setup (*q);
+				}
+
+				int64_t t0;
+
+				t0 = g_get_monotonic_time ();
+				for (uint32_t n = 0; n < n_cycles; ++n) {
+					for (uint32_t i = 0; i < n_ports; ++i) {
+						ArdourZita::VMResampler* src = per_port[i];
+						src->inp_count = nframes;
+						src->out_count = n_resample;
+						src->set_rratio (n_resample / (double) nframes);
+						src->inp_data  = inputs[i];
+						src->out_data  = outputs[i];
+						src->process ();
+					}
+				}
+				report ("per-port", n_ports, *q, speeds[s], g_get_monotonic_time () - t0, total);
+
+				t0 = g_get_monotonic_time ();
+				for (uint32_t n = 0; n < n_cycles; ++n) {
+					AudioPortResampler* list = 0;
+					for (uint32_t i = 0; i < n_ports; ++i) {
+						grouped[i / AudioPortResampler::max_ports]->add (i % AudioPortResampler::max_ports, inputs[i], outputs[i], nframes, n_resample, n + 1, false, list);
+					}
+					for (AudioPortResampler* r = list; r; r = r->next ()) {
+						r->process ();
+					}
+				}
+				report ("grouped", n_ports, *q, speeds[s], g_get_monotonic_time () - t0, total);
+
+				for (uint32_t i = 0; i < n_ports; ++i) {
+					delete per_port[i];
+					delete [] inputs[i];
+					delete [] outputs[i];
+				}
+				for (vector<AudioPortResampler*>::const_iterator r = grouped.begin (); r != grouped.end (); ++r) {
+					delete *r;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
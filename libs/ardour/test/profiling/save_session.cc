@@ -0,0 +1,231 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time the parts of saving a session.
+ *
+ *   save_session [-i iterations] [-a points] [<dir> <snapshot-name>]
+ *
+ * Without a session, all sessions in $ARDOUR_TEST_PATH/sessions are
+ * copied and used. -a adds that many gain automation points to every
+ * route. Output is one line per session and operation:
+ *   <session> <operation> <msec per iteration>
+ * where write-libxml is the previous XMLTree::write(), which copied the
+ * tree into a libxml2 document first.
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <libxml/tree.h>
+
+#include "pbd/failed_constructor.h"
+#include "pbd/file_utils.h"
+#include "pbd/xml++.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/automation_list.h"
+#include "ardour/gain_control.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+libxml_writenode (xmlDocPtr doc, XMLNode const* n, xmlNodePtr p)
+{
+	xmlNodePtr node;
+
+	if (!p) {
+		node = doc->children = xmlNewDocNode (doc, 0, (const xmlChar*) n->name ().c_str (), 0);
+	} else {
+		node = xmlNewChild (p, 0, (const xmlChar*) n->name ().c_str (), 0);
+	}
+
+	if (n->is_content ()) {
+		node->type = XML_TEXT_NODE;
+		xmlNodeSetContentLen (node, (const xmlChar*) n->content ().c_str (), n->content ().length ());
+	}
+
+	for (XMLPropertyConstIterator i = n->properties ().begin (); i != n->properties ().end (); ++i) {
+		xmlSetProp (node, (const xmlChar*) (*i)->name ().c_str (), (const xmlChar*) (*i)->value ().c_str ());
+	}
+
+	for (XMLNodeConstIterator i = n->children ().begin (); i != n->children ().end (); ++i) {
+		libxml_writenode (doc, *i, node);
+	}
+}
+
+static bool
+write_libxml (XMLNode const* root, string const& path)
+{
+	xmlKeepBlanksDefault (0);
+	xmlDocPtr doc = xmlNewDoc ((const xmlChar*) "1.0");
+	libxml_writenode (doc, root, 0);
+	int result = xmlSaveFormatFileEnc (path.c_str (), doc, "UTF-8", 1);
+	xmlFreeDoc (doc);
+	return result != -1;
+}
+
+static void
+add_automation (Session* s, uint32_t points)
+{
+	boost::shared_ptr<RouteList> rl = s->get_routes ();
+	for (RouteList::iterator r = rl->begin (); r != rl->end (); ++r) {
+		boost::shared_ptr<AutomationList> al = (*r)->gain_control ()->alist ();
+		al->freeze ();
+		for (uint32_t i = 0; i < points; ++i) {
+			al->fast_simple_add (i * 480, g_random_double_range (0, 2));
+		}
+		al->thaw ();
+	}
+}
+
+static void
+report (string const& session, char const* op, int64_t usec, uint32_t iterations)
+{
+	cout << session << " " << op << " " << usec / (1000. * iterations) << "\n";
+}
+
+static void
+bench (string const& dir, string const& name, uint32_t iterations, uint32_t points)
+{
+	Session* s = 0;
+
+	try {
+		s = load_session (dir, name);
+	} catch (failed_constructor& e) {
+		cerr << name << ": failed_constructor: " << e.what () << "\n";
+		return;
+	}
+
+	if (points > 0) {
+		add_automation (s, points);
+	}
+
+	string const out = Glib::build_filename (new_test_output_dir ("save_session"), name + ".ardour");
+	int64_t t_state = 0;
+	int64_t t_stream = 0;
+	int64_t t_libxml = 0;
+	int64_t t_save = 0;
+
+	for (uint32_t i = 0; i < iterations; ++i) {
+		int64_t t0 = g_get_monotonic_time ();
+		/* Session::get_state() is private, Stateful's is not */
+		XMLNode& node (static_cast<PBD::Stateful*> (s)->get_state ());
+		int64_t t1 = g_get_monotonic_time ();
+
+		XMLTree tree;
+		tree.set_root (&node);
+		tree.write (out);
+		int64_t t2 = g_get_monotonic_time ();
+
+		write_libxml (&node, out);
+		int64_t t3 = g_get_monotonic_time ();
+
+		s->save_state ("");
+		int64_t t4 = g_get_monotonic_time ();
+
+		t_state  += t1 - t0;
+		t_stream += t2 - t1;
+		t_libxml += t3 - t2;
+		t_save   += t4 - t3;
+	}
+
+	report (name, "state", t_state, iterations);
+	report (name, "write-stream", t_stream, iterations);
+	report (name, "write-libxml", t_libxml, iterations);
+	report (name, "save-state", t_save, iterations);
+
+	AudioEngine::instance ()->remove_session ();
+	delete s;
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t iterations = 10;
+	uint32_t points     = 0;
+	int      c;
+
+	while ((c = getopt (argc, argv, "i:a:")) != -1) {
+		switch (c) {
+			case 'i':
+				iterations = atoi (optarg);
+				break;
+			case 'a':
+				points = atoi (optarg);
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-i iterations] [-a points] [<dir> <snapshot-name>]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	if ((argc - optind != 0 && argc - optind != 2) || iterations < 1) {
+		cerr << "Syntax: " << argv[0] << " [-i iterations] [-a points] [<dir> <snapshot-name>]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	ARDOUR::init (false, true, localedir);
+	create_and_start_dummy_backend ();
+
+	cout << "# session operation msec\n";
+
+	if (argc - optind == 2) {
+		bench (argv[optind], argv[optind + 1], iterations, points);
+	} else {
+		PBD::Searchpath const sp (test_search_path ());
+		string sessions;
+		for (PBD::Searchpath::const_iterator i = sp.begin (); i != sp.end (); ++i) {
+			if (Glib::file_test (Glib::build_filename (*i, "sessions"), Glib::FILE_TEST_IS_DIR)) {
+				sessions = Glib::build_filename (*i, "sessions");
+				break;
+			}
+		}
+		if (sessions.empty ()) {
+			cerr << "No test sessions found, set ARDOUR_TEST_PATH\n";
+			exit (EXIT_FAILURE);
+		}
+
+		Glib::Dir dir (sessions);
+		for (Glib::DirIterator i = dir.begin (); i != dir.end (); ++i) {
+			string const name = *i;
+			if (!Glib::file_test (Glib::build_filename (sessions, name, name + ".ardour"), Glib::FILE_TEST_EXISTS)) {
+				continue;
+			}
+			/* don't modify the test data */
+			string const copy = Glib::build_filename (new_test_output_dir ("save_session"), name);
+			PBD::copy_recurse (Glib::build_filename (sessions, name), copy);
+			bench (copy, name, iterations, points);
+		}
+	}
+
+	stop_and_destroy_backend ();
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time TempoMap conversions against the number of tempo and meter sections.
+ *
+ *   tempo_map [-c conversions] [-w] [sections ...]
+ *
+ * sections default to 10 100 1000. Each map has that many tempo sections,
+ * alternately ramped and constant, and a meter change every 8 of them.
+ * With -w, another thread keeps adding and removing a tempo section while
+ * the conversions run, as the GUI does while a tempo marker is dragged.
+ * Output is one line per conversion and size:
+ *   <conversion> <sections> <total msec> <nsec per call>
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/thread.h>
+#include <glibmm/threads.h>
+
+#include "ardour/tempo.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Timecode;
+
+static const samplecnt_t sample_rate = 48000;
+
+/* quarter notes between tempo sections */
+static const double spacing = 16;
+
+static gint stop_edits = 0;
+
+static void
+make_map (TempoMap& map, uint32_t n_sections)
+{
+	map.replace_meter (map.meter_section_at_sample (0), Meter (4, 4), BBT_Time (1, 1, 0), 0, AudioTime);
+	map.replace_tempo (map.tempo_section_at_sample (0), Tempo (120, 4, 140), 0.0, 0, AudioTime);
+
+	for (uint32_t i = 1; i < n_sections; ++i) {
+		const double npm = 80 + (i * 7) % 100;
+		map.add_tempo (Tempo (npm, 4, (i % 2) ? npm + 20 : npm), i * spacing / 4.0, 0, MusicTime);
+
+		if (i % 8 == 0) {
+			/* bar of the last quarter note of the section before */
+			const uint32_t bar = map.bbt_at_quarter_note (i * spacing - 1).bars;
+			map.add_meter (Meter ((i % 16) ? 3 : 4, 4), BBT_Time (bar + 1, 1, 0), 0, MusicTime);
+		}
+	}
+}
+
+static void
+edit (TempoMap* map, double qn)
+{
+	while (!g_atomic_int_get (&stop_edits)) {
+		TempoSection* ts = map->add_tempo (Tempo (100, 4), qn / 4.0, 0, MusicTime);
+		if (ts) {
+			map->remove_tempo (*ts, false);
+		}
+	}
+}
+
+static void
+report (char const* op, uint32_t n_sections, int64_t usec, uint64_t calls)
+{
+	cout << op << " " << n_sections << " " << usec / 1000. << " " << 1000. * usec / (double) max<uint64_t> (1, calls) << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint64_t n_conversions = 1000000;
+	bool     with_edits    = false;
+	int      c;
+
+	while ((c = getopt (argc, argv, "c:w")) != -1) {
+		switch (c) {
+			case 'c':
+				n_conversions = atoll (optarg);
+				break;
+			case 'w':
+				with_edits = true;
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-c conversions] [-w] [sections ...]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	vector<uint32_t> sizes;
+	for (int i = optind; i < argc; ++i) {
+		sizes.push_back (atoi (argv[i]));
+	}
+	if (sizes.empty ()) {
+		sizes.push_back (10);
+		sizes.push_back (100);
+		sizes.push_back (1000);
+	}
+
+	if (!Glib::thread_supported ()) {
+		Glib::thread_init ();
+	}
+
+	g_random_set_seed (1);
+
+	cout << "# conversion sections msec nsec/call\n";
+
+	for (vector<uint32_t>::const_iterator s = sizes.begin (); s != sizes.end (); ++s) {
+		const uint32_t n = max<uint32_t> (1, *s);
+		TempoMap       map (sample_rate);
+		int64_t        t0;
+		double         sum = 0;
+
+		t0 = g_get_monotonic_time ();
+		make_map (map, n);
+		report ("build", n, g_get_monotonic_time () - t0, n);
+
+		const double      len_qn = n * spacing;
+		const samplepos_t len    = map.sample_at_quarter_note (len_qn);
+
+		/* random positions, e.g. the GUI or locating */
+		vector<samplepos_t> samples (n_conversions);
+		vector<double>      qns (n_conversions);
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			samples[i] = g_random_double () * len;
+			qns[i] = g_random_double () * len_qn;
+		}
+
+		Glib::Threads::Thread* editor = 0;
+		if (with_edits) {
+			g_atomic_int_set (&stop_edits, 0);
+			editor = Glib::Threads::Thread::create (sigc::bind (sigc::ptr_fun (&edit), &map, len_qn / 2 + 1));
+		}
+
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			sum += map.quarter_note_at_sample (samples[i]);
+		}
+		report ("quarter-note-at-sample", n, g_get_monotonic_time () - t0, n_conversions);
+
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			sum += map.sample_at_quarter_note (qns[i]);
+		}
+		report ("sample-at-quarter-note", n, g_get_monotonic_time () - t0, n_conversions);
+
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			sum += map.bbt_at_sample (samples[i]).beats;
+		}
+		report ("bbt-at-sample", n, g_get_monotonic_time () - t0, n_conversions);
+
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			sum += map.sample_at_beat (qns[i]);
+		}
+		report ("sample-at-beat", n, g_get_monotonic_time () - t0, n_conversions);
+
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_conversions; ++i) {
+			sum += map.tempo_at_sample (samples[i]).note_types_per_minute ();
+		}
+		report ("tempo-at-sample", n, g_get_monotonic_time () - t0, n_conversions);
+
+		/* playback, moving forward a period at a time, as the MIDI clock and plugins do */
+		const samplecnt_t period = 1024;
+		const uint64_t    n_periods = min<uint64_t> (n_conversions, len / period);
+		t0 = g_get_monotonic_time ();
+		for (uint64_t i = 0; i < n_periods; ++i) {
+			sum += map.quarter_notes_between_samples (i * period, (i + 1) * period);
+			sum += map.samples_per_quarter_note_at (i * period, sample_rate);
+		}
+		report ("process-period", n, g_get_monotonic_time () - t0, n_periods);
+
+		if (editor) {
+			g_atomic_int_set (&stop_edits, 1);
+			editor->join ();
+		}
+
+		if (sum == 42) {
+			/* keep the conversions */
+			cout << "#\n";
+		}
+	}
+
+	return 0;
+}
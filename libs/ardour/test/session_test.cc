@@ -8,6 +8,10 @@
 #include "pbd/file_utils.h"
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
+#include "ardour/automation_list.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/gain_control.h"
+#include "ardour/route.h"
 #include "ardour/smf_source.h"
 #include "ardour/midi_model.h"
 
@@ -150,3 +154,75 @@ SessionTest::open_session_utf8_path ()
 	}
 
 }
+
+static std::string
+save_and_read (Session* session, std::string const& dir, std::string const& name)
+{
+	CPPUNIT_ASSERT (session->save_state ("") == 0);
+	return Glib::file_get_contents (Glib::build_filename (dir, name + statefile_suffix));
+}
+
+/* Saves that reuse cached state must be identical to saves from a freshly
+ * loaded session.
+ */
+void
+SessionTest::save_state_cached ()
+{
+	const string session_name ("save_state_cached");
+	std::string new_session_dir = Glib::build_filename (new_test_output_dir (), session_name);
+
+	CPPUNIT_ASSERT (!Glib::file_test (new_session_dir, Glib::FILE_TEST_EXISTS));
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (new_session_dir, session_name);
+	CPPUNIT_ASSERT (session);
+	CPPUNIT_ASSERT (session->master_out ());
+
+	boost::shared_ptr<AutomationList> al = session->master_out ()->gain_control ()->alist ();
+	al->freeze ();
+	for (int i = 0; i < 1000; ++i) {
+		al->fast_simple_add (i * 480, (i % 100) / 50.);
+	}
+	al->thaw ();
+
+	const string first = save_and_read (session, new_session_dir, session_name);
+
+	/* the text is not kept once the session is saved */
+	CPPUNIT_ASSERT (al->state_dirty ());
+	CPPUNIT_ASSERT_EQUAL (first, save_and_read (session, new_session_dir, session_name));
+
+	/* serializing between saves keeps it until the next save uses it */
+	XMLNode* node = &al->get_state ();
+	delete node;
+	CPPUNIT_ASSERT (!al->state_dirty ());
+	CPPUNIT_ASSERT_EQUAL (first, save_and_read (session, new_session_dir, session_name));
+	CPPUNIT_ASSERT (al->state_dirty ());
+
+	/* a single change invalidates the cache */
+	node = &al->get_state ();
+	delete node;
+	al->add (1000 * 480, .5, false);
+	CPPUNIT_ASSERT (al->state_dirty ());
+	const string second = save_and_read (session, new_session_dir, session_name);
+	CPPUNIT_ASSERT (first != second);
+
+	al->set_automation_state (Play);
+	const string third = save_and_read (session, new_session_dir, session_name);
+	CPPUNIT_ASSERT (second != third);
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	stop_and_destroy_backend ();
+
+	/* load-save round trip, without any cached state */
+	create_and_start_dummy_backend ();
+
+	session = load_session (new_session_dir, session_name);
+	CPPUNIT_ASSERT (session);
+	CPPUNIT_ASSERT_EQUAL (third, save_and_read (session, new_session_dir, session_name));
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	stop_and_destroy_backend ();
+}
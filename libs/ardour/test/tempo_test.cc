@@ -635,3 +635,81 @@ TempoTest::tempoFundamentalsTest ()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (164.0, tE->quarter_notes_per_minute (), 1e-17);
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (41.0, tE->pulses_per_minute (), 1e-17);
 }
+
+void
+TempoTest::snapshotTest ()
+{
+	int const sampling_rate = 48000;
+
+	TempoMap map (sampling_rate);
+	Meter meterA (4, 4);
+	Tempo tempoA (120.0, 4.0, 160.0);
+
+	map.replace_meter (map.first_meter(), meterA, BBT_Time (1, 1, 0), 0, AudioTime);
+	map.replace_tempo (map.first_tempo(), tempoA, 0.0, 0, AudioTime);
+
+	/* ramped and constant, music and audio locked tempi, and meters of
+	 * different lengths, some of them audio locked.
+	 */
+	for (int n = 1; n < 40; ++n) {
+		const double npm = 60.0 + (n * 37) % 140;
+		const double end_npm = (n % 3) ? npm + (n % 5) * 10.0 : npm;
+
+		if (n % 4 == 0) {
+			map.add_tempo (Tempo (npm, 4.0, end_npm), 0.0, (samplepos_t) n * 3 * sampling_rate, AudioTime);
+		} else {
+			map.add_tempo (Tempo (npm, (n % 2) ? 4.0 : 8.0, end_npm), n * 2.5, 0, MusicTime);
+		}
+	}
+
+	for (uint32_t n = 1; n < 10; ++n) {
+		Meter meter (3 + n % 5, (n % 2) ? 4 : 8);
+		if (n % 3 == 0) {
+			map.add_meter (meter, BBT_Time (), (samplepos_t) n * 11 * sampling_rate, AudioTime);
+		} else {
+			map.add_meter (meter, BBT_Time (1 + n * 6, 1, 0), 0, MusicTime);
+		}
+	}
+
+	const Metrics& metrics (map._metrics);
+	const samplepos_t end = 150 * sampling_rate;
+
+	for (samplepos_t s = -sampling_rate; s < end; s += 4799) {
+		const double minute = map.minute_at_sample (s);
+
+		CPPUNIT_ASSERT_EQUAL (map.beat_at_minute_locked (metrics, minute), map.beat_at_sample (s));
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_minute_locked (metrics, minute) * 4.0, map.quarter_note_at_sample (s));
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_minute_locked (metrics, minute) * 4.0, map.quarter_note_at_sample_rt (s));
+		CPPUNIT_ASSERT_EQUAL (map.tempo_at_minute_locked (metrics, minute).note_types_per_minute(), map.tempo_at_sample (s).note_types_per_minute());
+		CPPUNIT_ASSERT_EQUAL (map.tempo_at_minute_locked (metrics, minute).end_note_types_per_minute(), map.tempo_at_sample (s).end_note_types_per_minute());
+		CPPUNIT_ASSERT_EQUAL (map.quarter_notes_between_samples_locked (metrics, s, s + 98765), map.quarter_notes_between_samples (s, s + 98765));
+		CPPUNIT_ASSERT_EQUAL (map.quarter_notes_between_samples_locked (metrics, s + 98765, s), map.quarter_notes_between_samples (s + 98765, s));
+
+		for (int32_t sub_num = -1; sub_num < 5; ++sub_num) {
+			CPPUNIT_ASSERT_EQUAL (map.exact_qn_at_sample_locked (metrics, s, sub_num), map.exact_qn_at_sample (s, sub_num));
+		}
+
+		if (s >= 0) {
+			const BBT_Time bbt (map.bbt_at_minute_locked (metrics, minute));
+			CPPUNIT_ASSERT (bbt == map.bbt_at_sample (s));
+			CPPUNIT_ASSERT (bbt == map.bbt_at_sample_rt (s));
+			CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_bbt_locked (metrics, bbt)), map.sample_at_bbt (bbt));
+			CPPUNIT_ASSERT_EQUAL (map.beat_at_bbt_locked (metrics, bbt), map.beat_at_bbt (bbt));
+			CPPUNIT_ASSERT_EQUAL (map.pulse_at_bbt_locked (metrics, bbt) * 4.0, map.quarter_note_at_bbt (bbt));
+			CPPUNIT_ASSERT_EQUAL (map.pulse_at_bbt_locked (metrics, bbt) * 4.0, map.quarter_note_at_bbt_rt (bbt));
+		}
+	}
+
+	for (double qn = 0.0; qn < 400.0; qn += 0.37) {
+		const double beat = qn * 0.9;
+
+		CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_pulse_locked (metrics, qn / 4.0)), map.sample_at_quarter_note (qn));
+		CPPUNIT_ASSERT_EQUAL (map.tempo_at_pulse_locked (metrics, qn / 4.0).note_types_per_minute(), map.tempo_at_quarter_note (qn).note_types_per_minute());
+		CPPUNIT_ASSERT_EQUAL (map.beat_at_pulse_locked (metrics, qn / 4.0), map.beat_at_quarter_note (qn));
+		CPPUNIT_ASSERT (map.bbt_at_pulse_locked (metrics, qn / 4.0) == map.bbt_at_quarter_note (qn));
+
+		CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_beat_locked (metrics, beat)), map.sample_at_beat (beat));
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_beat_locked (metrics, beat) * 4.0, map.quarter_note_at_beat (beat));
+		CPPUNIT_ASSERT (map.bbt_at_beat_locked (metrics, beat) == map.bbt_at_beat (beat));
+	}
+}
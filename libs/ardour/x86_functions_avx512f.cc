@@ -0,0 +1,238 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* AVX-512F variants of the runtime functions.
+ *
+ * This file is compiled with -mavx512f, the functions must only be
+ * called when FPU::has_avx512f() is true.
+ *
+ * The last (nframes % 16) samples are processed using masked loads and
+ * stores, so there is no scalar tail.
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+static inline __mmask16
+tail_mask (uint32_t n)
+{
+	return (__mmask16) ((1u << n) - 1);
+}
+
+float
+x86_avx512f_compute_peak (const float* buf, uint32_t nframes, float current)
+{
+	__m512 m0 = _mm512_set1_ps (current);
+	__m512 m1 = m0;
+
+	while (nframes >= 32) {
+		m0 = _mm512_max_ps (m0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		m1 = _mm512_max_ps (m1, _mm512_abs_ps (_mm512_loadu_ps (buf + 16)));
+		buf += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		m0 = _mm512_max_ps (m0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		m1 = _mm512_max_ps (m1, _mm512_abs_ps (_mm512_maskz_loadu_ps (tail_mask (nframes), buf)));
+	}
+
+	const float rv = _mm512_reduce_max_ps (_mm512_max_ps (m0, m1));
+	_mm256_zeroupper ();
+	return rv;
+}
+
+void
+x86_avx512f_find_peaks (const float* buf, uint32_t nframes, float* minf, float* maxf)
+{
+	__m512 cmin = _mm512_set1_ps (*minf);
+	__m512 cmax = _mm512_set1_ps (*maxf);
+
+	while (nframes >= 16) {
+		const __m512 w = _mm512_loadu_ps (buf);
+		cmin = _mm512_min_ps (cmin, w);
+		cmax = _mm512_max_ps (cmax, w);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512    w = _mm512_maskz_loadu_ps (m, buf);
+		cmin = _mm512_mask_min_ps (cmin, m, cmin, w);
+		cmax = _mm512_mask_max_ps (cmax, m, cmax, w);
+	}
+
+	*minf = _mm512_reduce_min_ps (cmin);
+	*maxf = _mm512_reduce_max_ps (cmax);
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_apply_gain_to_buffer (float* buf, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_mix_buffers_with_gain (float* dst, const float* src, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_mix_buffers_no_gain (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, src)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_copy_vector (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 64) {
+		const __m512 a = _mm512_loadu_ps (src);
+		const __m512 b = _mm512_loadu_ps (src + 16);
+		const __m512 c = _mm512_loadu_ps (src + 32);
+		const __m512 d = _mm512_loadu_ps (src + 48);
+		_mm512_storeu_ps (dst, a);
+		_mm512_storeu_ps (dst + 16, b);
+		_mm512_storeu_ps (dst + 32, c);
+		_mm512_storeu_ps (dst + 48, d);
+		src += 64;
+		dst += 64;
+		nframes -= 64;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+
+	_mm256_zeroupper ();
+}
+
+float
+x86_avx512f_apply_gain_ramp (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	/* see x86_fma_apply_gain_ramp () */
+	const float r = 1.f - coeff;
+
+	float pw[16];
+	pw[0] = 1.f;
+	for (int i = 1; i < 16; ++i) {
+		pw[i] = pw[i - 1] * r;
+	}
+	const float r16 = pw[15] * r;
+
+	const __m512 vpw = _mm512_loadu_ps (pw);
+	const __m512 vtg = _mm512_set1_ps (target);
+	float delta      = initial - target;
+
+	while (nframes >= 16) {
+		const __m512 g = _mm512_fmadd_ps (_mm512_set1_ps (delta), vpw, vtg);
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		delta *= r16;
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512    g = _mm512_fmadd_ps (_mm512_set1_ps (delta), vpw, vtg);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+		delta *= pw[nframes - 1] * r;
+	}
+
+	_mm256_zeroupper ();
+	return target + delta;
+}
+
+void
+x86_avx512f_mix_buffers_with_gain_ramp (float* dst, const float* src, uint32_t nframes, float initial, float target)
+{
+	const float  delta = (target - initial) / nframes;
+	const __m512 iota  = _mm512_setr_ps (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m512 vd    = _mm512_set1_ps (delta);
+	const __m512 vi    = _mm512_set1_ps (initial);
+
+	uint32_t i = 0;
+	for (; i + 16 <= nframes; i += 16) {
+		const __m512 g = _mm512_fmadd_ps (_mm512_add_ps (_mm512_set1_ps ((float)i), iota), vd, vi);
+		_mm512_storeu_ps (dst + i, _mm512_fmadd_ps (_mm512_loadu_ps (src + i), g, _mm512_loadu_ps (dst + i)));
+	}
+
+	if (i < nframes) {
+		const __mmask16 m = tail_mask (nframes - i);
+		const __m512    g = _mm512_fmadd_ps (_mm512_add_ps (_mm512_set1_ps ((float)i), iota), vd, vi);
+		_mm512_mask_storeu_ps (dst + i, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src + i), g, _mm512_maskz_loadu_ps (m, dst + i)));
+	}
+
+	_mm256_zeroupper ();
+}
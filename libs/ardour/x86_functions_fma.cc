@@ -0,0 +1,285 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* AVX2 + FMA3 variants of the runtime functions.
+ *
+ * This file is compiled with -mavx2 -mfma, the functions must only be
+ * called when FPU::has_avx2() and FPU::has_fma() are true.
+ *
+ * Buffers need not be aligned: on CPUs with AVX2 unaligned loads and
+ * stores of aligned data are as fast as aligned ones.
+ */
+
+#include <immintrin.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+static inline float
+hmax (__m256 v)
+{
+	__m128 m = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_max_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_max_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+static inline float
+hmin (__m256 v)
+{
+	__m128 m = _mm_min_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_min_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_min_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+float
+x86_fma_compute_peak (const float* buf, uint32_t nframes, float current)
+{
+	const __m256 abs_mask = _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+
+	__m256 m0 = _mm256_set1_ps (current);
+	__m256 m1 = m0;
+
+	/* two independent accumulators to hide the latency of vmaxps */
+	while (nframes >= 16) {
+		m0 = _mm256_max_ps (m0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		m1 = _mm256_max_ps (m1, _mm256_and_ps (_mm256_loadu_ps (buf + 8), abs_mask));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		m0 = _mm256_max_ps (m0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	float rv = hmax (_mm256_max_ps (m0, m1));
+
+	while (nframes > 0) {
+		const float a = fabsf (*buf++);
+		rv = a > rv ? a : rv;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+	return rv;
+}
+
+void
+x86_fma_find_peaks (const float* buf, uint32_t nframes, float* minf, float* maxf)
+{
+	__m256 cmin = _mm256_set1_ps (*minf);
+	__m256 cmax = _mm256_set1_ps (*maxf);
+
+	while (nframes >= 8) {
+		const __m256 w = _mm256_loadu_ps (buf);
+		cmin = _mm256_min_ps (cmin, w);
+		cmax = _mm256_max_ps (cmax, w);
+		buf += 8;
+		nframes -= 8;
+	}
+
+	float lo = hmin (cmin);
+	float hi = hmax (cmax);
+
+	while (nframes > 0) {
+		lo = *buf < lo ? *buf : lo;
+		hi = *buf > hi ? *buf : hi;
+		++buf;
+		--nframes;
+	}
+
+	*minf = lo;
+	*maxf = hi;
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_apply_gain_to_buffer (float* buf, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm256_storeu_ps (buf,     _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		_mm256_storeu_ps (buf + 8, _mm256_mul_ps (_mm256_loadu_ps (buf + 8), g));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf++ *= gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_mix_buffers_with_gain (float* dst, const float* src, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst,     _mm256_fmadd_ps (_mm256_loadu_ps (src), g, _mm256_loadu_ps (dst)));
+		_mm256_storeu_ps (dst + 8, _mm256_fmadd_ps (_mm256_loadu_ps (src + 8), g, _mm256_loadu_ps (dst + 8)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_fmadd_ps (_mm256_loadu_ps (src), g, _mm256_loadu_ps (dst)));
+		src += 8;
+		dst += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_mix_buffers_no_gain (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst,     _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_loadu_ps (src)));
+		_mm256_storeu_ps (dst + 8, _mm256_add_ps (_mm256_loadu_ps (dst + 8), _mm256_loadu_ps (src + 8)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_loadu_ps (src)));
+		src += 8;
+		dst += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_copy_vector (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		const __m256 a = _mm256_loadu_ps (src);
+		const __m256 b = _mm256_loadu_ps (src + 8);
+		const __m256 c = _mm256_loadu_ps (src + 16);
+		const __m256 d = _mm256_loadu_ps (src + 24);
+		_mm256_storeu_ps (dst, a);
+		_mm256_storeu_ps (dst + 8, b);
+		_mm256_storeu_ps (dst + 16, c);
+		_mm256_storeu_ps (dst + 24, d);
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_loadu_ps (src));
+		src += 8;
+		dst += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ = *src++;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+float
+x86_fma_apply_gain_ramp (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	/* The one-pole low-pass towards a constant target has a closed form:
+	 *   g[n] = target + (initial - target) * (1 - coeff)^n
+	 * so eight consecutive gains are target + delta * [1, r, .. r^7],
+	 * and delta is scaled by r^8 for every block of eight samples.
+	 */
+	const float r = 1.f - coeff;
+
+	float pw[8];
+	pw[0] = 1.f;
+	for (int i = 1; i < 8; ++i) {
+		pw[i] = pw[i - 1] * r;
+	}
+	const float r8 = pw[7] * r;
+
+	const __m256 vpw = _mm256_loadu_ps (pw);
+	const __m256 vtg = _mm256_set1_ps (target);
+	float delta      = initial - target;
+
+	while (nframes >= 8) {
+		const __m256 g = _mm256_fmadd_ps (_mm256_set1_ps (delta), vpw, vtg);
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		delta *= r8;
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf++ *= target + delta;
+		delta *= r;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+	return target + delta;
+}
+
+void
+x86_fma_mix_buffers_with_gain_ramp (float* dst, const float* src, uint32_t nframes, float initial, float target)
+{
+	const float  delta = (target - initial) / nframes;
+	const __m256 iota  = _mm256_setr_ps (0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256 vd    = _mm256_set1_ps (delta);
+	const __m256 vi    = _mm256_set1_ps (initial);
+
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		/* initial + n * delta, calculated rather than accumulated to avoid drift */
+		const __m256 g = _mm256_fmadd_ps (_mm256_add_ps (_mm256_set1_ps ((float)i), iota), vd, vi);
+		_mm256_storeu_ps (dst + i, _mm256_fmadd_ps (_mm256_loadu_ps (src + i), g, _mm256_loadu_ps (dst + i)));
+	}
+
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * (initial + i * delta);
+	}
+
+	_mm256_zeroupper ();
+}
@@ -0,0 +1,318 @@
+#ifndef AUDIOGRAPHER_SPILL_BUFFER_H
+#define AUDIOGRAPHER_SPILL_BUFFER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/gstdio_compat.h"
+#include "pbd/signals.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "audiographer/visibility.h"
+#include "audiographer/exception.h"
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/throwing.h"
+#include "audiographer/types.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** Memory shared by several SpillBuffers, which may be written concurrently */
+class /*LIBAUDIOGRAPHER_API*/ MemoryBudget : public boost::noncopyable
+{
+  public:
+	/// \param bytes to share
+	MemoryBudget (size_t bytes) : available (bytes) {}
+
+	/// Takes up to \a bytes, \return the number of bytes taken
+	size_t take (size_t bytes)
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+		bytes = std::min (bytes, available);
+		available -= bytes;
+		return bytes;
+	}
+
+	/// Gives back \a bytes which were taken
+	void give (size_t bytes)
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+		available += bytes;
+	}
+
+  private:
+	Glib::Threads::Mutex lock;
+	size_t               available;
+};
+
+/** Stores all data it is given, to be read back (e.g. for a second pass).
+  * Data is kept in memory as long as a budget allows, the remainder is written
+  * to a raw temporary file, which is memory-mapped for reading back.
+  * Unlike TmpFile there is no format conversion, and nothing touches
+  * the disk unless the budget is exceeded.
+  */
+template<typename T = DefaultSampleType>
+class /*LIBAUDIOGRAPHER_API*/ SpillBuffer
+  : public ListedSource<T>
+  , public Sink<T>
+  , public Throwing<>
+  , public FlagDebuggable<>
+{
+  public:
+	/** Constructor
+	  * \n NOT RT safe
+	  * \param filename_template for the spill file, must match the requirements for mkstemp, i.e. end in "XXXXXX"
+	  * \param channels channel count of the (interleaved) data
+	  * \param ram_budget number of bytes to keep in memory
+	  */
+	SpillBuffer (std::string const & filename_template, ChannelCount channels, size_t ram_budget)
+	  : filename_template (filename_template)
+	  , budget (new MemoryBudget (ram_budget - ram_budget % (sizeof (T) * std::max<ChannelCount> (channels, 1))))
+	  , ram_samples (0)
+	  , samples_written (0)
+	  , read_position (0)
+	  , file (0)
+	  , map (0)
+	  , map_samples (0)
+	{
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+	}
+
+	/** Constructor
+	  * \n NOT RT safe
+	  * \param filename_template for the spill file, must match the requirements for mkstemp, i.e. end in "XXXXXX"
+	  * \param budget memory to take from while writing, shared with other buffers
+	  */
+	SpillBuffer (std::string const & filename_template, boost::shared_ptr<MemoryBudget> budget)
+	  : filename_template (filename_template)
+	  , budget (budget)
+	  , ram_samples (0)
+	  , samples_written (0)
+	  , read_position (0)
+	  , file (0)
+	  , map (0)
+	  , map_samples (0)
+	{
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+	}
+
+	~SpillBuffer ()
+	{
+		for (typename std::vector<T*>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+			delete [] *i;
+		}
+		budget->give (ram_samples * sizeof (T));
+		unmap ();
+		if (file) {
+			fclose (file);
+			std::remove (filename.c_str());
+		}
+	}
+
+	/// Appends data, emits Written at the end of input \n NOT RT safe
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		T const *   data = c.data();
+		samplecnt_t n    = c.samples();
+
+		while (n > 0 && !file) {
+			samplecnt_t const offset = samples_written % chunk_size;
+			if (samples_written == ram_samples) {
+				if (!reserve (chunk_size - offset)) {
+					break;
+				}
+				if (offset == 0) {
+					chunks.push_back (new T[chunk_size]);
+				}
+			}
+			samplecnt_t const cnt = std::min (n, ram_samples - samples_written);
+			memcpy (chunks.back() + offset, data, cnt * sizeof (T));
+			data += cnt;
+			n -= cnt;
+			samples_written += cnt;
+		}
+
+		if (n > 0) {
+			spill (data, n);
+			samples_written += n;
+		}
+
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			if (file) {
+				fflush (file);
+				map_file ();
+			}
+			Written ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	/** Read data into buffer in \a context, only the data is modified (not sample count)
+	  * Note that the data read is output to the outputs, as well as read into the context
+	  * \n RT safe, if the data is not spilled to disk
+	  * \return number of samples read
+	  */
+	samplecnt_t read (ProcessContext<T> & context)
+	{
+		T *         data = context.data();
+		samplecnt_t n    = std::min (context.samples(), samples_written - read_position);
+		samplecnt_t const samples_read = n;
+
+		while (n > 0 && read_position < ram_samples) {
+			samplecnt_t const offset = read_position % chunk_size;
+			samplecnt_t const cnt = std::min (n, std::min (chunk_size - offset, ram_samples - read_position));
+			memcpy (data, chunks[read_position / chunk_size] + offset, cnt * sizeof (T));
+			data += cnt;
+			n -= cnt;
+			read_position += cnt;
+		}
+
+		if (n > 0) {
+			read_spilled (data, read_position - ram_samples, n);
+			read_position += n;
+		}
+
+		ProcessContext<T> c_out = context.beginning (samples_read);
+		if (samples_read < context.samples()) {
+			c_out.set_flag (ProcessContext<T>::EndOfInput);
+		}
+		this->output (c_out);
+		return samples_read;
+	}
+
+	/// Starts reading from the beginning \n RT safe
+	void rewind () { read_position = 0; }
+
+	samplecnt_t get_samples_written () const { return samples_written; }
+
+	/// true if the memory budget was exceeded and a file is used
+	bool spilled () const { return file != 0; }
+
+	/// Emitted after the last sample was written
+	PBD::Signal0<void> Written;
+
+  private:
+	/** takes memory for up to \a cnt more samples from the budget,
+	  * never beyond the end of the current chunk
+	  * \return false if there is none left
+	  */
+	bool reserve (samplecnt_t cnt)
+	{
+		size_t const bytes = budget->take (cnt * sizeof (T));
+		budget->give (bytes % sizeof (T));
+		ram_samples += bytes / sizeof (T);
+		return bytes >= sizeof (T);
+	}
+
+	void spill (T const * data, samplecnt_t cnt)
+	{
+		if (!file) {
+			std::vector<char> tmpl (filename_template.begin(), filename_template.end());
+			tmpl.push_back ('\0');
+			int fd = g_mkstemp (&tmpl[0]);
+			if (fd >= 0) {
+				file = fdopen (fd, "w+b");
+				if (!file) {
+					::close (fd);
+					std::remove (&tmpl[0]);
+				}
+			}
+			if (!file) {
+				throw Exception (*this, boost::str (boost::format
+					("Could not create temporary file (%1%)") % filename_template));
+			}
+			filename = &tmpl[0];
+		}
+
+		if (fwrite (data, sizeof (T), cnt, file) != (size_t) cnt && throw_level (ThrowProcess)) {
+			throw Exception (*this, boost::str (boost::format
+				("Could not write data to temporary file (%1%)") % filename));
+		}
+	}
+
+	void map_file ()
+	{
+#ifndef PLATFORM_WINDOWS
+		unmap ();
+		samplecnt_t const cnt = samples_written - ram_samples;
+		void* addr = mmap (0, cnt * sizeof (T), PROT_READ, MAP_SHARED, fileno (file), 0);
+		if (addr == MAP_FAILED) {
+			/* fall back to reading the file */
+			return;
+		}
+		madvise (addr, cnt * sizeof (T), MADV_SEQUENTIAL);
+		map = static_cast<T*> (addr);
+		map_samples = cnt;
+#endif
+	}
+
+	void unmap ()
+	{
+#ifndef PLATFORM_WINDOWS
+		if (map) {
+			munmap (map, map_samples * sizeof (T));
+		}
+#endif
+		map = 0;
+		map_samples = 0;
+	}
+
+	void read_spilled (T * data, samplecnt_t offset, samplecnt_t cnt)
+	{
+		if (map) {
+			memcpy (data, map + offset, cnt * sizeof (T));
+			return;
+		}
+#ifdef PLATFORM_WINDOWS
+		int const rv = _fseeki64 (file, offset * sizeof (T), SEEK_SET);
+#else
+		int const rv = fseeko (file, offset * sizeof (T), SEEK_SET);
+#endif
+		if (rv != 0
+		    || fread (data, sizeof (T), cnt, file) != (size_t) cnt) {
+			if (throw_level (ThrowProcess)) {
+				throw Exception (*this, boost::str (boost::format
+					("Could not read data from temporary file (%1%)") % filename));
+			}
+			memset (data, 0, cnt * sizeof (T));
+		}
+	}
+
+	static const samplecnt_t chunk_size = 65536;
+
+	std::string      filename_template;
+	std::string      filename;
+	boost::shared_ptr<MemoryBudget> budget;
+	samplecnt_t      ram_samples; ///< taken from the budget
+	samplecnt_t      samples_written;
+	samplecnt_t      read_position;
+	std::vector<T*>  chunks;
+	FILE*            file;
+	T*               map;
+	samplecnt_t      map_samples;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_SPILL_BUFFER_H
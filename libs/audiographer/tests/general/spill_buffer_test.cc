@@ -0,0 +1,101 @@
+#include "tests/utils.h"
+
+#include <glib.h>
+
+#include "audiographer/general/spill_buffer.h"
+
+using namespace AudioGrapher;
+
+class SpillBufferTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (SpillBufferTest);
+  CPPUNIT_TEST (testInMemory);
+  CPPUNIT_TEST (testSpilled);
+  CPPUNIT_TEST (testSharedBudget);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 128 * 1024;
+		random_data = TestUtils::init_random_data(samples);
+		filename_template = std::string (g_get_tmp_dir ()) + G_DIR_SEPARATOR_S + "spillXXXXXX";
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testInMemory()
+	{
+		buffer.reset (new SpillBuffer<float> (filename_template, 2, samples * sizeof (float)));
+		write_and_compare ();
+		CPPUNIT_ASSERT (!buffer->spilled ());
+	}
+
+	void testSpilled()
+	{
+		/* an odd budget, that is not a multiple of the chunk size */
+		buffer.reset (new SpillBuffer<float> (filename_template, 2, 10001 * sizeof (float)));
+		write_and_compare ();
+		CPPUNIT_ASSERT (buffer->spilled ());
+	}
+
+	void testSharedBudget()
+	{
+		/* enough for one of them, written at the same time */
+		boost::shared_ptr<MemoryBudget> budget (new MemoryBudget (samples * sizeof (float)));
+		boost::shared_ptr<SpillBuffer<float> > other (new SpillBuffer<float> (filename_template, budget));
+		buffer.reset (new SpillBuffer<float> (filename_template, budget));
+
+		ConstProcessContext<float> c (random_data, samples / 2, 2);
+		other->process (c);
+		write_and_compare ();
+		CPPUNIT_ASSERT (buffer->spilled ());
+		CPPUNIT_ASSERT_EQUAL ((size_t) 0, budget->take (1));
+
+		/* the memory is given back */
+		other.reset ();
+		buffer.reset ();
+		CPPUNIT_ASSERT_EQUAL (samples * sizeof (float), budget->take (samples * sizeof (float) + 1));
+	}
+
+  private:
+	void write_and_compare ()
+	{
+		samplecnt_t const chunk = 4096;
+		for (samplecnt_t pos = 0; pos < samples; pos += chunk) {
+			ConstProcessContext<float> c (random_data + pos, chunk, 2);
+			if (pos + chunk == samples) {
+				c().set_flag (ProcessContext<float>::EndOfInput);
+			}
+			buffer->process (c);
+		}
+		CPPUNIT_ASSERT_EQUAL (samples, buffer->get_samples_written ());
+
+		/* read back twice, in a different chunk size, as a second pass would */
+		for (int pass = 0; pass < 2; ++pass) {
+			AllocatingProcessContext<float> c (3000, 2);
+			samplecnt_t pos = 0;
+			buffer->rewind ();
+			while (true) {
+				samplecnt_t const n = buffer->read (c);
+				CPPUNIT_ASSERT (TestUtils::array_equals (random_data + pos, c.data(), n));
+				pos += n;
+				if (n < c.samples ()) {
+					break;
+				}
+			}
+			CPPUNIT_ASSERT_EQUAL (samples, pos);
+		}
+	}
+
+	boost::shared_ptr<SpillBuffer<float> > buffer;
+	std::string filename_template;
+
+	float * random_data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SpillBufferTest);
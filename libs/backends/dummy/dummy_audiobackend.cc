@@ -88,6 +88,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("Unbounded"),    0.f));
 	}
 
 }
@@ -1385,7 +1386,9 @@ DummyAudioBackend::main_process_thread ()
 
 			const int64_t elapsed_time = _dsp_load_calc.elapsed_time_us ();
 			const int64_t nominal_time = _dsp_load_calc.get_max_time_us ();
-			if (elapsed_time < nominal_time) {
+			if (_speedup == 0) {
+				/* unbounded: start the next cycle right away */
+			} else if (elapsed_time < nominal_time) {
 				const int64_t sleepy = _speedup * (nominal_time - elapsed_time);
 				Glib::usleep (std::max ((int64_t) 100, sleepy));
 			} else {
@@ -1393,7 +1396,9 @@ DummyAudioBackend::main_process_thread ()
 			}
 		} else {
 			_dsp_load = 1.0f;
-			Glib::usleep (100); // don't hog cpu
+			if (_speedup != 0) {
+				Glib::usleep (100); // don't hog cpu
+			}
 		}
 
 		/* beginning of next cycle */
@@ -1657,6 +1662,12 @@ DummyPort::update_connected_latency (bool for_playback)
 
 void DummyPort::setup_random_number_generator ()
 {
+	if (_dummy_backend._speedup == 0) {
+		/* unbounded, for benchmarks: the same signals every run */
+		_rseed = g_str_hash (_name.c_str ()) % INT_MAX;
+		if (_rseed == 0) _rseed = 1;
+		return;
+	}
 #ifdef PLATFORM_WINDOWS
 	LARGE_INTEGER Count;
 	if (QueryPerformanceCounter (&Count)) {
@@ -0,0 +1,201 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Time rendering frames of an editor-like canvas against the number of
+ * items: tracks of regions or notes on a long timeline, of which a 1920x1080
+ * window shows about 2%.
+ *
+ *   frame_time [-f frames] [items ...]
+ *
+ * items default to 1000 10000 50000 100000. The tests are
+ *   full:   render the whole window
+ *   edit:   move 8 items in the window, render what they damaged
+ *   pick:   find the items at a point, as for enter/leave (per 100 points)
+ *   lookup: find the items of one track in the window, with the lookup
+ *           table used for rendering ("tree") and by visiting every
+ *           item ("dumb")
+ * Output is one line per test and size:
+ *   <test> <items> <msec per frame>
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <cairomm/surface.h>
+
+#include "canvas/canvas.h"
+#include "canvas/container.h"
+#include "canvas/lookup_table.h"
+#include "canvas/rectangle.h"
+
+using namespace std;
+using namespace ArdourCanvas;
+
+static const int    n_tracks = 64;
+static const Coord  track_height = 60;
+static const Coord  timeline_width = 100000;
+static const Rect   window (timeline_width / 2, 0, timeline_width / 2 + 1920, 1080);
+
+/** A canvas which notes what needs to be redrawn */
+class BenchmarkCanvas : public Canvas
+{
+public:
+	void request_redraw (Rect const & r) { damage.push_back (r); }
+	void request_size (Duple) {}
+	void grab (Item*) {}
+	void ungrab () {}
+	void focus (Item*) {}
+	void unfocus (Item*) {}
+	Rect visible_area () const { return window; }
+	Coord width () const { return window.width (); }
+	Coord height () const { return window.height (); }
+	bool get_mouse_position (Duple&) const { return false; }
+	void re_enter () {}
+	Glib::RefPtr<Pango::Context> get_pango_context () { return Glib::RefPtr<Pango::Context> (); }
+	void pick_current_item (int) {}
+	void pick_current_item (Duple const &, int) {}
+
+	vector<Rect> damage;
+};
+
+static void
+report (char const* test, uint32_t n_items, int64_t usec, uint32_t frames)
+{
+	cout << test << " " << n_items << " " << usec / (1000. * frames) << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_frames = 100;
+	int      c;
+
+	while ((c = getopt (argc, argv, "f:")) != -1) {
+		switch (c) {
+			case 'f':
+				n_frames = atoi (optarg);
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-f frames] [items ...]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	vector<uint32_t> sizes;
+	for (int i = optind; i < argc; ++i) {
+		sizes.push_back (atoi (argv[i]));
+	}
+	if (sizes.empty ()) {
+		sizes.push_back (1000);
+		sizes.push_back (10000);
+		sizes.push_back (50000);
+		sizes.push_back (100000);
+	}
+
+	Cairo::RefPtr<Cairo::ImageSurface> surface = Cairo::ImageSurface::create (Cairo::FORMAT_ARGB32, (int) window.width (), (int) window.height ());
+
+	cout << "# test items msec/frame\n";
+
+	for (vector<uint32_t>::const_iterator s = sizes.begin (); s != sizes.end (); ++s) {
+
+		g_random_set_seed (1);
+
+		BenchmarkCanvas canvas;
+		vector<Container*> tracks;
+		vector<Rectangle*> items;
+
+		for (int t = 0; t < n_tracks; ++t) {
+			tracks.push_back (new Container (canvas.root (), Duple (0, t * track_height)));
+		}
+
+		for (uint32_t i = 0; i < *s; ++i) {
+			const Coord x = g_random_double_range (0, timeline_width);
+			const Coord y = g_random_double_range (0, track_height - 4);
+			Rectangle* r = new Rectangle (tracks[i % n_tracks], Rect (0, 0, g_random_double_range (4, 200), 4));
+			r->set_position (Duple (x, y));
+			r->set_fill_color (0x8080ffff);
+			items.push_back (r);
+		}
+
+		Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create (surface);
+		context->translate (-window.x0, -window.y0);
+
+		/* once, to set up the lookup tables */
+		canvas.render (window, context);
+		canvas.damage.clear ();
+
+		int64_t t0;
+
+		t0 = g_get_monotonic_time ();
+		for (uint32_t f = 0; f < n_frames; ++f) {
+			canvas.render (window, context);
+		}
+		report ("full", *s, g_get_monotonic_time () - t0, n_frames);
+
+		t0 = g_get_monotonic_time ();
+		for (uint32_t f = 0; f < n_frames; ++f) {
+			for (int m = 0; m < 8; ++m) {
+				Rectangle* r = items[g_random_int_range (0, items.size ())];
+				r->set_position (Duple (g_random_double_range (window.x0, window.x1), r->position ().y));
+			}
+			for (vector<Rect>::const_iterator d = canvas.damage.begin (); d != canvas.damage.end (); ++d) {
+				Rect const area = d->intersection (window);
+				if (area) {
+					canvas.render (area, context);
+				}
+			}
+			canvas.damage.clear ();
+		}
+		report ("edit", *s, g_get_monotonic_time () - t0, n_frames);
+
+		t0 = g_get_monotonic_time ();
+		for (uint32_t f = 0; f < n_frames; ++f) {
+			for (int p = 0; p < 100; ++p) {
+				vector<Item const *> found;
+				canvas.root ()->add_items_at_point (Duple (g_random_double_range (window.x0, window.x1), g_random_double_range (window.y0, window.y1)), found);
+			}
+		}
+		report ("pick", *s, g_get_monotonic_time () - t0, n_frames);
+
+		TreeLookupTable tree (*tracks[0]);
+		DumbLookupTable dumb (*tracks[0]);
+		size_t n_found = 0;
+
+		tree.update ();
+
+		t0 = g_get_monotonic_time ();
+		for (uint32_t f = 0; f < n_frames; ++f) {
+			n_found += tree.find (window).size ();
+		}
+		report ("lookup-tree", *s, g_get_monotonic_time () - t0, n_frames);
+
+		t0 = g_get_monotonic_time ();
+		for (uint32_t f = 0; f < n_frames; ++f) {
+			n_found -= dumb.get (window).size ();
+		}
+		report ("lookup-dumb", *s, g_get_monotonic_time () - t0, n_frames);
+
+		if (n_found != 0) {
+			cerr << "lookup tables disagree\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	return 0;
+}
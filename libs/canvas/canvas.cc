@@ -435,7 +435,7 @@ GtkCanvas::GtkCanvas ()
 	, _new_current_item (0)
 	, _grabbed_item (0)
 	, _focused_item (0)
-	, _single_exposure (1)
+	, _single_exposure (false)
 	, current_tooltip_item (0)
 	, tooltip_window (0)
 	, _in_dtor (false)
@@ -907,7 +907,28 @@ GtkCanvas::on_expose_event (GdkEventExpose* ev)
 	Cairo::RefPtr<Cairo::Context> draw_context = get_window()->create_cairo_context ();
 #endif
 
-	draw_context->rectangle (ev->area.x, ev->area.y, ev->area.width, ev->area.height);
+	/* render only the damaged parts, unless they are many or cover most
+	 * of their extents anyway.
+	 */
+	GdkRectangle* rects;
+	gint nrects;
+	gdk_region_get_rectangles (ev->region, &rects, &nrects);
+
+	bool whole_area = _single_exposure || nrects < 2 || nrects > max_damage_rects;
+
+	if (!whole_area) {
+		double damaged = 0;
+		for (gint n = 0; n < nrects; ++n) {
+			damaged += (double) rects[n].width * rects[n].height;
+		}
+		whole_area = damaged > 0.75 * ev->area.width * ev->area.height;
+	}
+
+	if (whole_area) {
+		draw_context->rectangle (ev->area.x, ev->area.y, ev->area.width, ev->area.height);
+	} else {
+		gdk_cairo_region (draw_context->cobj (), ev->region);
+	}
 	draw_context->clip();
 
 #ifdef __APPLE__
@@ -932,22 +953,19 @@ GtkCanvas::on_expose_event (GdkEventExpose* ev)
 	draw_context->fill ();
 
 	/* render canvas */
-	if ( _single_exposure ) {
+	if (whole_area) {
 
 		Canvas::render (Rect (ev->area.x, ev->area.y, ev->area.x + ev->area.width, ev->area.y + ev->area.height), draw_context);
 
 	} else {
-		GdkRectangle* rects;
-		gint nrects;
-
-		gdk_region_get_rectangles (ev->region, &rects, &nrects);
 		for (gint n = 0; n < nrects; ++n) {
 			draw_context->set_identity_matrix();  //reset the cairo matrix, just in case someone left it transformed after drawing ( cough )
 			Canvas::render (Rect (rects[n].x, rects[n].y, rects[n].x + rects[n].width, rects[n].y + rects[n].height), draw_context);
 		}
-		g_free (rects);
 	}
 
+	g_free (rects);
+
 #ifdef __APPLE__
 	draw_context->pop_group_to_source ();
 	draw_context->paint ();
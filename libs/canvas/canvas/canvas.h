@@ -209,9 +209,15 @@ public:
 
 	bool get_mouse_position (Duple& winpos) const;
 
+	/** Render the bounding rectangle of what needs to be redrawn, rather
+	 *  than just what needs to be redrawn.
+	 */
 	void set_single_exposure (bool s) { _single_exposure = s; }
 	bool single_exposure () { return _single_exposure; }
 
+	/** More damaged rectangles than this are rendered as one */
+	static const int max_damage_rects = 16;
+
 	void re_enter ();
 
 	void start_tooltip_timeout (Item*);
@@ -308,10 +308,12 @@ protected:
 	/* nesting ("grouping") API */
 
 	void invalidate_lut () const;
+	/** Update @param child, whose bounding box or visibility changed, in our lookup table */
+	void invalidate_lut (Item* child) const;
 	void clear_items (bool with_delete);
 
 	void ensure_lut () const;
-	mutable LookupTable* _lut;
+	mutable TreeLookupTable* _lut;
 	/* our items, from lowest to highest in the stack */
 	std::list<Item*> _items;
 
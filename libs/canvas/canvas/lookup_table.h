@@ -20,8 +20,10 @@
 #ifndef __CANVAS_LOOKUP_TABLE_H__
 #define __CANVAS_LOOKUP_TABLE_H__
 
+#include <map>
 #include <vector>
 #include <boost/multi_array.hpp>
+#include <stdint.h>
 
 #include "canvas/visibility.h"
 #include "canvas/types.h"
@@ -84,6 +86,88 @@ public:
     bool _added;
 };
 
+/** A dynamic AABB tree of the visible children of an item, balanced like
+ *  an AVL tree. It is updated as children are added, removed, restacked or
+ *  change, rather than rebuilt.
+ *
+ *  Changed children are only noted; update() must be called before the
+ *  tree is queried.
+ */
+class LIBCANVAS_API TreeLookupTable : public LookupTable
+{
+public:
+    TreeLookupTable (Item const &);
+
+    std::vector<Item*> get (Rect const &);
+    std::vector<Item*> items_at_point (Duple const &) const;
+    bool has_item_at_point (Duple const & point) const;
+
+    /** As get(), into a vector which is reused by the next call, so that
+     *  nothing is allocated once it has grown large enough.
+     *  @param area Area in window coordinates
+     */
+    std::vector<Item*> const & find (Rect const & area);
+
+    /** @return union of the bounding boxes of the visible children,
+     *  in our item's coordinates
+     */
+    Rect bounding_box () const;
+
+    void add (Item *, bool front);
+    void remove (Item *);
+    /** @param item has changed its bounding box or visibility */
+    void changed (Item* item);
+    void raise_to_top (Item *);
+    void lower_to_bottom (Item *);
+    /** Take the stacking order of all children from our item again */
+    void restack ();
+
+    /** Bring the tree up to date with the children that changed */
+    void update ();
+
+  private:
+
+    struct Node {
+	    Rect    box;    ///< in our item's coordinates
+	    Item*   item;   ///< of leaves
+	    int64_t order;  ///< of leaves, lowest first
+	    int     parent; ///< or the next free node
+	    int     child1;
+	    int     child2;
+	    int     height; ///< 0 for leaves, -1 for free nodes
+    };
+
+    struct Entry {
+	    int     leaf;   ///< or -1 when not in the tree
+	    int64_t order;
+	    bool    stale;
+    };
+
+    typedef std::map<Item const *, Entry> Entries;
+
+    Rect window_to_children (Rect const &) const;
+    void query (Rect const &) const;
+
+    int  allocate_node ();
+    void free_node (int);
+    void insert_leaf (int);
+    void remove_leaf (int);
+    void refit (int);
+    int  balance (int);
+
+    Entries            _entries;
+    std::vector<Node>  _nodes;
+    int                _root;
+    int                _free;
+    int64_t            _bottom;
+    int64_t            _top;
+    std::vector<Item*> _stale;
+    std::vector<Item*> _found_items;
+
+    mutable std::vector<int>                         _stack;
+    mutable std::vector<std::pair<int64_t, Item*> >  _found;
+};
+
 }
 
 #endif
@@ -271,6 +271,14 @@ Item::set_position (Duple p)
 
 	_position = p;
 
+	/* the parent's lookup table is not updated by ::show() if one of
+	   our ancestors is hidden, so always do that.
+	*/
+
+	if (_parent) {
+		_parent->invalidate_lut (this);
+	}
+
 	/* only update canvas and parent if visible. Otherwise, this
 	   will be done when ::show() is called.
 	*/
@@ -378,6 +386,7 @@ Item::propagate_show_hide ()
 	/* bounding box may have changed while we were hidden */
 
 	if (_parent) {
+		_parent->invalidate_lut (this);
 		_parent->child_changed ();
 	}
 
@@ -575,6 +584,11 @@ void
 Item::size_allocate (Rect const & r)
 {
 	_allocation = r;
+
+	/* our parent is laying us out, and takes care of its own bounding box */
+	if (_parent) {
+		_parent->invalidate_lut (this);
+	}
 }
 
 /** @return Bounding box in this item's coordinates */
@@ -636,6 +650,11 @@ Item::begin_change ()
 void
 Item::end_change ()
 {
+	/* see ::set_position() */
+	if (_parent) {
+		_parent->invalidate_lut (this);
+	}
+
 	if (visible()) {
 		_canvas->item_changed (this, _pre_change_bounding_box);
 
@@ -748,7 +767,7 @@ Item::render_children (Rect const & area, Cairo::RefPtr<Cairo::Context> context)
 	}
 
 	ensure_lut ();
-	std::vector<Item*> items = _lut->get (area);
+	std::vector<Item*> const & items = _lut->find (area);
 
 #ifdef CANVAS_DEBUG
 	if (DEBUG_ENABLED(PBD::DEBUG::CanvasRender)) {
@@ -838,7 +857,7 @@ Item::prepare_for_render_children (Rect const & area) const
 	}
 
 	ensure_lut ();
-	std::vector<Item*> items = _lut->get (area);
+	std::vector<Item*> const & items = _lut->find (area);
 
 	for (std::vector<Item*>::const_iterator i = items.begin(); i != items.end(); ++i) {
 
@@ -879,6 +898,26 @@ Item::add_child_bounding_boxes (bool include_hidden) const
 		have_one = true;
 	}
 
+	if (!include_hidden) {
+		/* the lookup table has the union of the visible children, who
+		 * are only visible if we are.
+		 */
+		Rect children;
+
+		if (!_items.empty () && visible ()) {
+			ensure_lut ();
+			children = _lut->bounding_box ();
+		}
+
+		if (children) {
+			bbox = have_one ? bbox.extend (children) : children;
+			have_one = true;
+		}
+
+		_bounding_box = have_one ? bbox : Rect ();
+		return;
+	}
+
 	for (list<Item*>::const_iterator i = _items.begin(); i != _items.end(); ++i) {
 
 		if (!(*i)->visible() && !include_hidden) {
@@ -914,8 +953,19 @@ Item::add (Item* i)
 
 	_items.push_back (i);
 	i->reparent (this, true);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->add (i, false);
+	}
 	_bounding_box_dirty = true;
+
+	/* our bounding box may have grown, and our parent's lookup table
+	   has the old one. Not ::child_changed(), we may be laying out
+	   our children already.
+	*/
+	if (_parent) {
+		_parent->invalidate_lut (this);
+		_parent->child_changed ();
+	}
 }
 
 void
@@ -925,8 +975,19 @@ Item::add_front (Item* i)
 
 	_items.push_front (i);
 	i->reparent (this, true);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->add (i, true);
+	}
 	_bounding_box_dirty = true;
+
+	/* our bounding box may have grown, and our parent's lookup table
+	   has the old one. Not ::child_changed(), we may be laying out
+	   our children already.
+	*/
+	if (_parent) {
+		_parent->invalidate_lut (this);
+		_parent->child_changed ();
+	}
 }
 
 void
@@ -949,9 +1010,11 @@ Item::remove (Item* i)
 		_pre_change_bounding_box = Rect();
 	}
 
+	if (_lut) {
+		_lut->remove (i);
+	}
 	i->unparent ();
 	_items.remove (i);
-	invalidate_lut ();
 	_bounding_box_dirty = true;
 
 	end_change ();
@@ -973,6 +1036,9 @@ Item::clear (bool with_delete)
 void
 Item::clear_items (bool with_delete)
 {
+	/* deleted items must not stay in the lookup table */
+	invalidate_lut ();
+
 	for (list<Item*>::iterator i = _items.begin(); i != _items.end(); ) {
 
 		list<Item*>::iterator tmp = i;
@@ -1008,7 +1074,9 @@ Item::raise_child_to_top (Item* i)
 	_items.remove (i);
 	_items.push_back (i);
 
-	invalidate_lut ();
+	if (_lut) {
+		_lut->raise_to_top (i);
+	}
         redraw ();
 }
 
@@ -1027,7 +1095,9 @@ Item::raise_child (Item* i, int levels)
 	}
 
 	_items.insert (j, i);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->restack ();
+	}
         redraw ();
 }
 
@@ -1041,7 +1111,9 @@ Item::lower_child_to_bottom (Item* i)
 	}
 	_items.remove (i);
 	_items.push_front (i);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->lower_to_bottom (i);
+	}
         redraw ();
 }
 
@@ -1049,8 +1121,9 @@ void
 Item::ensure_lut () const
 {
 	if (!_lut) {
-		_lut = new DumbLookupTable (*this);
+		_lut = new TreeLookupTable (*this);
 	}
+	_lut->update ();
 }
 
 void
@@ -1060,13 +1133,21 @@ Item::invalidate_lut () const
 	_lut = 0;
 }
 
+void
+Item::invalidate_lut (Item* child) const
+{
+	if (_lut) {
+		_lut->changed (child);
+	}
+}
+
 void
 Item::child_changed ()
 {
-	invalidate_lut ();
 	_bounding_box_dirty = true;
 
 	if (_parent) {
+		_parent->invalidate_lut (this);
 		_parent->child_changed ();
 	}
 }
@@ -326,3 +326,512 @@ OptimizingLookupTable::get (Rect const & area)
 	return vitems;
 }
 
+
+/* half the perimeter, the cost of a box; in COORD_MAX range so that the
+ * costs of boxes of infinite items add up without overflowing.
+ */
+static double
+box_cost (Rect const & r)
+{
+	return min (r.width (), COORD_MAX) + min (r.height (), COORD_MAX);
+}
+
+static bool
+overlaps (Rect const & a, Rect const & b)
+{
+	return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+}
+
+TreeLookupTable::TreeLookupTable (Item const & item)
+	: LookupTable (item)
+	, _root (-1)
+	, _free (-1)
+	, _bottom (0)
+	, _top (-1)
+{
+	list<Item*> const & items = _item.items ();
+
+	for (list<Item*>::const_iterator i = items.begin(); i != items.end(); ++i) {
+		add (*i, false);
+	}
+}
+
+void
+TreeLookupTable::add (Item* item, bool front)
+{
+	remove (item);
+
+	Entry e;
+	e.leaf = -1;
+	e.order = front ? --_bottom : ++_top;
+	e.stale = true;
+
+	/* the item may still be under construction, so its bounding box is
+	 * only looked at by update()
+	 */
+	_entries.insert (make_pair (item, e));
+	_stale.push_back (item);
+}
+
+void
+TreeLookupTable::remove (Item* item)
+{
+	/* the item may be being deleted, don't ask it anything */
+
+	Entries::iterator e = _entries.find (item);
+
+	if (e == _entries.end ()) {
+		return;
+	}
+
+	if (e->second.leaf >= 0) {
+		remove_leaf (e->second.leaf);
+		free_node (e->second.leaf);
+	}
+
+	_entries.erase (e);
+}
+
+void
+TreeLookupTable::changed (Item* item)
+{
+	Entries::iterator e = _entries.find (item);
+
+	if (e != _entries.end () && !e->second.stale) {
+		e->second.stale = true;
+		_stale.push_back (item);
+	}
+}
+
+void
+TreeLookupTable::raise_to_top (Item* item)
+{
+	Entries::iterator e = _entries.find (item);
+
+	if (e != _entries.end ()) {
+		e->second.order = ++_top;
+		if (e->second.leaf >= 0) {
+			_nodes[e->second.leaf].order = e->second.order;
+		}
+	}
+}
+
+void
+TreeLookupTable::lower_to_bottom (Item* item)
+{
+	Entries::iterator e = _entries.find (item);
+
+	if (e != _entries.end ()) {
+		e->second.order = --_bottom;
+		if (e->second.leaf >= 0) {
+			_nodes[e->second.leaf].order = e->second.order;
+		}
+	}
+}
+
+void
+TreeLookupTable::restack ()
+{
+	list<Item*> const & items = _item.items ();
+
+	_bottom = 0;
+	_top = -1;
+
+	for (list<Item*>::const_iterator i = items.begin(); i != items.end(); ++i) {
+		Entries::iterator e = _entries.find (*i);
+		if (e != _entries.end ()) {
+			e->second.order = ++_top;
+			if (e->second.leaf >= 0) {
+				_nodes[e->second.leaf].order = e->second.order;
+			}
+		}
+	}
+}
+
+void
+TreeLookupTable::update ()
+{
+	/* asking children for their bounding box may add to _stale, so
+	 * don't iterate
+	 */
+	for (size_t n = 0; n < _stale.size (); ++n) {
+
+		Item* item = _stale[n];
+		Entries::iterator e = _entries.find (item);
+
+		if (e == _entries.end () || !e->second.stale) {
+			/* removed, or already done */
+			continue;
+		}
+
+		e->second.stale = false;
+
+		Rect box;
+
+		if (item->self_visible ()) {
+			Rect const item_bbox = item->bounding_box ();
+			if (item_bbox) {
+				box = item->item_to_parent (item_bbox);
+			}
+		}
+
+		int leaf = e->second.leaf;
+
+		if (leaf >= 0) {
+			if (box && !(box != _nodes[leaf].box)) {
+				continue;
+			}
+			remove_leaf (leaf);
+			if (!box) {
+				free_node (leaf);
+				e->second.leaf = -1;
+				continue;
+			}
+		} else {
+			if (!box) {
+				continue;
+			}
+			leaf = allocate_node ();
+			e->second.leaf = leaf;
+		}
+
+		Node& node (_nodes[leaf]);
+		node.box = box;
+		node.item = item;
+		node.order = e->second.order;
+		node.child1 = -1;
+		node.child2 = -1;
+		node.height = 0;
+		insert_leaf (leaf);
+	}
+
+	_stale.clear ();
+}
+
+Rect
+TreeLookupTable::bounding_box () const
+{
+	if (_root < 0) {
+		return Rect ();
+	}
+	return _nodes[_root].box;
+}
+
+/* all our children are in the same scroll group */
+Rect
+TreeLookupTable::window_to_children (Rect const & area) const
+{
+	Item const * child = _item.items ().front ();
+	return child->item_to_parent (child->window_to_item (area));
+}
+
+/** Find the leaves which overlap @param area, in our item's coordinates,
+ *  in stacking order into _found.
+ */
+void
+TreeLookupTable::query (Rect const & area) const
+{
+	_found.clear ();
+
+	if (_root < 0) {
+		return;
+	}
+
+	_stack.clear ();
+	_stack.push_back (_root);
+
+	while (!_stack.empty ()) {
+		Node const & node (_nodes[_stack.back ()]);
+		_stack.pop_back ();
+
+		if (!overlaps (node.box, area)) {
+			continue;
+		}
+
+		if (node.child1 < 0) {
+			_found.push_back (make_pair (node.order, node.item));
+		} else {
+			_stack.push_back (node.child1);
+			_stack.push_back (node.child2);
+		}
+	}
+
+	sort (_found.begin (), _found.end ());
+}
+
+/** @param area Area in window coordinates */
+vector<Item*> const &
+TreeLookupTable::find (Rect const & area)
+{
+	_found_items.clear ();
+
+	if (_root < 0) {
+		return _found_items;
+	}
+
+	/* window coordinates are rounded, see DumbLookupTable::get() for
+	 * the exact test
+	 */
+	query (window_to_children (area).expand (1));
+
+	for (vector<pair<int64_t, Item*> >::const_iterator i = _found.begin(); i != _found.end(); ++i) {
+		Rect const item = i->second->item_to_window (i->second->bounding_box ());
+		if (item.intersection (area)) {
+			_found_items.push_back (i->second);
+		}
+	}
+
+	return _found_items;
+}
+
+vector<Item*>
+TreeLookupTable::get (Rect const & area)
+{
+	return find (area);
+}
+
+vector<Item*>
+TreeLookupTable::items_at_point (Duple const & point) const
+{
+	/* Point is in window coordinate system */
+
+	vector<Item*> items;
+
+	if (_root < 0) {
+		return items;
+	}
+
+	query (window_to_children (Rect (point.x, point.y, point.x, point.y)).expand (1));
+
+	for (vector<pair<int64_t, Item*> >::const_iterator i = _found.begin(); i != _found.end(); ++i) {
+		if (i->second->covers (point)) {
+			items.push_back (i->second);
+		}
+	}
+
+	return items;
+}
+
+bool
+TreeLookupTable::has_item_at_point (Duple const & point) const
+{
+	/* Point is in window coordinate system */
+
+	if (_root < 0) {
+		return false;
+	}
+
+	query (window_to_children (Rect (point.x, point.y, point.x, point.y)).expand (1));
+
+	for (vector<pair<int64_t, Item*> >::const_iterator i = _found.begin(); i != _found.end(); ++i) {
+		if (i->second->visible () && i->second->covers (point)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+TreeLookupTable::allocate_node ()
+{
+	int n;
+
+	if (_free >= 0) {
+		n = _free;
+		_free = _nodes[n].parent;
+	} else {
+		n = _nodes.size ();
+		_nodes.push_back (Node ());
+	}
+
+	Node& node (_nodes[n]);
+	node.item = 0;
+	node.order = 0;
+	node.parent = -1;
+	node.child1 = -1;
+	node.child2 = -1;
+	node.height = 0;
+
+	return n;
+}
+
+void
+TreeLookupTable::free_node (int n)
+{
+	_nodes[n].parent = _free;
+	_nodes[n].height = -1;
+	_nodes[n].item = 0;
+	_free = n;
+}
+
+/** Recompute the box and height of @param n from its children */
+void
+TreeLookupTable::refit (int n)
+{
+	Node& node (_nodes[n]);
+	Node const & c1 (_nodes[node.child1]);
+	Node const & c2 (_nodes[node.child2]);
+
+	node.box = c1.box.extend (c2.box);
+	node.height = 1 + max (c1.height, c2.height);
+}
+
+/* Insert the leaf as the sibling of the node where that costs least, by
+ * the surface area heuristic, then rebalance towards the root.
+ */
+void
+TreeLookupTable::insert_leaf (int leaf)
+{
+	if (_root < 0) {
+		_root = leaf;
+		_nodes[leaf].parent = -1;
+		return;
+	}
+
+	Rect const box = _nodes[leaf].box;
+	int index = _root;
+
+	while (_nodes[index].child1 >= 0) {
+		Node const & node (_nodes[index]);
+
+		double const cost = box_cost (node.box);
+		double const combined_cost = box_cost (node.box.extend (box));
+
+		/* cost of making a new parent of this node and the leaf */
+		double const here = 2 * combined_cost;
+		/* cost of pushing the leaf further down */
+		double const inheritance = 2 * (combined_cost - cost);
+
+		double child_costs[2];
+		int const children[2] = { node.child1, node.child2 };
+
+		for (int c = 0; c < 2; ++c) {
+			Node const & child (_nodes[children[c]]);
+			if (child.child1 < 0) {
+				child_costs[c] = box_cost (child.box.extend (box)) + inheritance;
+			} else {
+				child_costs[c] = box_cost (child.box.extend (box)) - box_cost (child.box) + inheritance;
+			}
+		}
+
+		if (here < child_costs[0] && here < child_costs[1]) {
+			break;
+		}
+
+		index = child_costs[0] < child_costs[1] ? children[0] : children[1];
+	}
+
+	int const sibling = index;
+	int const old_parent = _nodes[sibling].parent;
+	int const new_parent = allocate_node ();
+
+	_nodes[new_parent].parent = old_parent;
+	_nodes[new_parent].child1 = sibling;
+	_nodes[new_parent].child2 = leaf;
+	_nodes[sibling].parent = new_parent;
+	_nodes[leaf].parent = new_parent;
+	refit (new_parent);
+
+	if (old_parent >= 0) {
+		if (_nodes[old_parent].child1 == sibling) {
+			_nodes[old_parent].child1 = new_parent;
+		} else {
+			_nodes[old_parent].child2 = new_parent;
+		}
+	} else {
+		_root = new_parent;
+	}
+
+	for (index = old_parent; index >= 0; index = _nodes[index].parent) {
+		index = balance (index);
+		refit (index);
+	}
+}
+
+void
+TreeLookupTable::remove_leaf (int leaf)
+{
+	if (leaf == _root) {
+		_root = -1;
+		return;
+	}
+
+	int const parent = _nodes[leaf].parent;
+	int const grand_parent = _nodes[parent].parent;
+	int const sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	free_node (parent);
+	_nodes[sibling].parent = grand_parent;
+
+	if (grand_parent < 0) {
+		_root = sibling;
+		return;
+	}
+
+	if (_nodes[grand_parent].child1 == parent) {
+		_nodes[grand_parent].child1 = sibling;
+	} else {
+		_nodes[grand_parent].child2 = sibling;
+	}
+
+	for (int index = grand_parent; index >= 0; index = _nodes[index].parent) {
+		index = balance (index);
+		refit (index);
+	}
+}
+
+/** If the subtrees of @param a differ in height by more than one, rotate
+ *  the higher one up.
+ *  @return the node which took the place of a
+ */
+int
+TreeLookupTable::balance (int a)
+{
+	if (_nodes[a].child1 < 0 || _nodes[a].height < 2) {
+		return a;
+	}
+
+	int const b = _nodes[a].child1;
+	int const c = _nodes[a].child2;
+	int const diff = _nodes[c].height - _nodes[b].height;
+
+	if (diff > 1 || diff < -1) {
+
+		/* the higher child moves up, a takes its lower child */
+		int const up = diff > 1 ? c : b;
+		int const f = _nodes[up].child1;
+		int const g = _nodes[up].child2;
+		int const keep = _nodes[f].height > _nodes[g].height ? f : g;
+		int const give = keep == f ? g : f;
+
+		_nodes[up].child1 = a;
+		_nodes[up].child2 = keep;
+		_nodes[up].parent = _nodes[a].parent;
+		_nodes[a].parent = up;
+
+		if (_nodes[up].parent >= 0) {
+			Node& p (_nodes[_nodes[up].parent]);
+			if (p.child1 == a) {
+				p.child1 = up;
+			} else {
+				p.child2 = up;
+			}
+		} else {
+			_root = up;
+		}
+
+		if (up == c) {
+			_nodes[a].child2 = give;
+		} else {
+			_nodes[a].child1 = give;
+		}
+		_nodes[give].parent = a;
+
+		refit (a);
+		refit (up);
+		return up;
+	}
+
+	return a;
+}
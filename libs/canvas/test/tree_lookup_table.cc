@@ -0,0 +1,282 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Randomized check of the TreeLookupTable that items keep of their children.
+ * Items are added, moved, resized, hidden, restacked, reparented and removed
+ * through the Item API, and after each step the lookup tables must find the
+ * same items, in the same order, as a DumbLookupTable which visits every
+ * child (minus the hidden children, which the tree leaves out).
+ *
+ *   tree_lookup_table [-s seed] [-n steps]
+ *
+ * Exits with an error on the first difference, printing the seed and step.
+ */
+
+#include <cstdlib>
+#include <ctime>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "canvas/canvas.h"
+#include "canvas/container.h"
+#include "canvas/lookup_table.h"
+#include "canvas/rectangle.h"
+
+using namespace std;
+using namespace ArdourCanvas;
+
+static const int    n_containers = 4;
+static const size_t max_items = 500;
+static const Coord  size = 1000;
+
+/** A canvas which does not draw anything */
+class TestCanvas : public Canvas
+{
+public:
+	void request_redraw (Rect const &) {}
+	void request_size (Duple) {}
+	void grab (Item*) {}
+	void ungrab () {}
+	void focus (Item*) {}
+	void unfocus (Item*) {}
+	Rect visible_area () const { return Rect (0, 0, size, size); }
+	Coord width () const { return size; }
+	Coord height () const { return size; }
+	bool get_mouse_position (Duple&) const { return false; }
+	void re_enter () {}
+	Glib::RefPtr<Pango::Context> get_pango_context () { return Glib::RefPtr<Pango::Context> (); }
+	void pick_current_item (int) {}
+	void pick_current_item (Duple const &, int) {}
+};
+
+/** A container which lets us at the lookup table it keeps up to date */
+class TestContainer : public Container
+{
+public:
+	TestContainer (Item* parent, Duple const & position)
+		: Container (parent, position)
+	{}
+
+	TreeLookupTable& lookup_table () {
+		ensure_lut ();
+		return *_lut;
+	}
+};
+
+static Coord
+random_coord ()
+{
+	return g_random_double_range (-size / 10, size);
+}
+
+static Rect
+random_rect ()
+{
+	const Coord x = random_coord ();
+	const Coord y = random_coord ();
+
+	/* some lines and points too */
+	const Coord w = g_random_int_range (0, 8) == 0 ? 0 : g_random_double_range (1, size / 5);
+	const Coord h = g_random_int_range (0, 8) == 0 ? 0 : g_random_double_range (1, size / 5);
+
+	return Rect (x, y, x + w, y + h);
+}
+
+static vector<Item*>
+visible_only (vector<Item*> const & items)
+{
+	vector<Item*> rv;
+	for (vector<Item*>::const_iterator i = items.begin (); i != items.end (); ++i) {
+		if ((*i)->self_visible ()) {
+			rv.push_back (*i);
+		}
+	}
+	return rv;
+}
+
+static Rect
+children_bounding_box (Item const & item)
+{
+	Rect bbox;
+	list<Item*> const & items (item.items ());
+
+	for (list<Item*>::const_iterator i = items.begin (); i != items.end (); ++i) {
+		if (!(*i)->self_visible ()) {
+			continue;
+		}
+		Rect const item_bbox = (*i)->bounding_box ();
+		if (!item_bbox) {
+			continue;
+		}
+		Rect const box = (*i)->item_to_parent (item_bbox);
+		bbox = bbox ? bbox.extend (box) : box;
+	}
+
+	return bbox;
+}
+
+static bool
+check (TestContainer& container, char const * name)
+{
+	TreeLookupTable& tree (container.lookup_table ());
+	DumbLookupTable  dumb (container);
+
+	if (children_bounding_box (container) != tree.bounding_box ()) {
+		cerr << name << ": bounding box " << tree.bounding_box () << " instead of " << children_bounding_box (container) << "\n";
+		return false;
+	}
+
+	if (container.items ().empty ()) {
+		return true;
+	}
+
+	for (int n = 0; n < 8; ++n) {
+		Rect const area = random_rect ();
+		if (tree.find (area) != visible_only (dumb.get (area))) {
+			cerr << name << ": find " << area << " found " << tree.find (area).size () << " instead of " << visible_only (dumb.get (area)).size () << " items\n";
+			return false;
+		}
+
+		Duple const point (random_coord (), random_coord ());
+		if (tree.items_at_point (point) != visible_only (dumb.items_at_point (point))) {
+			cerr << name << ": items_at_point " << point << " found " << tree.items_at_point (point).size () << " instead of " << visible_only (dumb.items_at_point (point)).size () << " items\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int
+main (int argc, char* argv[])
+{
+	guint32  seed    = time (0);
+	uint32_t n_steps = 10000;
+	int      c;
+
+	while ((c = getopt (argc, argv, "s:n:")) != -1) {
+		switch (c) {
+			case 's':
+				seed = atoi (optarg);
+				break;
+			case 'n':
+				n_steps = atoi (optarg);
+				break;
+			default:
+				cerr << "Syntax: " << argv[0] << " [-s seed] [-n steps]\n";
+				exit (EXIT_FAILURE);
+		}
+	}
+
+	g_random_set_seed (seed);
+
+	TestCanvas             canvas;
+	TestContainer          top (canvas.root (), Duple (0, 0));
+	vector<TestContainer*> containers;
+	vector<Rectangle*>     items;
+
+	for (int i = 0; i < n_containers; ++i) {
+		containers.push_back (new TestContainer (&top, Duple (random_coord (), random_coord ())));
+		/* from now on, the tables are updated rather than built */
+		containers.back ()->lookup_table ();
+	}
+	top.lookup_table ();
+
+	for (uint32_t step = 0; step < n_steps; ++step) {
+
+		TestContainer* container = containers[g_random_int_range (0, n_containers)];
+		Rectangle*     item      = items.empty () ? 0 : items[g_random_int_range (0, items.size ())];
+		int            op        = g_random_int_range (0, 11);
+
+		if (!item && op > 1) {
+			op = 0;
+		} else if (items.size () >= max_items && op < 2) {
+			op = 9;
+		}
+
+		switch (op) {
+			case 0:
+				items.push_back (new Rectangle (container, random_rect ()));
+				break;
+			case 1:
+				items.push_back (new Rectangle (&canvas, random_rect ()));
+				container->add_front (items.back ());
+				break;
+			case 2:
+				item->set_position (Duple (random_coord (), random_coord ()));
+				break;
+			case 3:
+				item->set (random_rect ());
+				break;
+			case 4:
+				if (item->self_visible ()) {
+					item->hide ();
+				} else {
+					item->show ();
+				}
+				break;
+			case 5:
+				item->raise_to_top ();
+				break;
+			case 6:
+				item->lower_to_bottom ();
+				break;
+			case 7:
+				item->raise (g_random_int_range (1, 4));
+				break;
+			case 8:
+				item->reparent (container);
+				break;
+			case 9:
+				for (vector<Rectangle*>::iterator i = items.begin (); i != items.end (); ++i) {
+					if (*i == item) {
+						items.erase (i);
+						break;
+					}
+				}
+				delete item;
+				break;
+			case 10:
+				if (g_random_boolean ()) {
+					container->set_position (Duple (random_coord (), random_coord ()));
+				} else if (container->self_visible ()) {
+					container->hide ();
+				} else {
+					container->show ();
+				}
+				break;
+		}
+
+		if (!check (top, "top")) {
+			cerr << "seed " << seed << ", step " << step << ", operation " << op << "\n";
+			return EXIT_FAILURE;
+		}
+
+		for (int i = 0; i < n_containers; ++i) {
+			if (!check (*containers[i], "container")) {
+				cerr << "seed " << seed << ", step " << step << ", operation " << op << "\n";
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	cout << n_steps << " steps with seed " << seed << ", " << items.size () << " items left\n";
+
+	return 0;
+}
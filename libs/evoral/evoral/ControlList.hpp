@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -276,6 +277,12 @@ public:
 
 	void mark_dirty () const;
 
+	/** true if events_index(), the events in contiguous storage,
+	 * reflects the event list. Only to be used while holding the lock.
+	 */
+	bool index_valid () const { return _index_valid; }
+	const std::vector<ControlEvent*>& events_index () const { return _index; }
+
 	enum InterpolationStyle {
 		Discrete,
 		Linear,
@@ -325,6 +332,11 @@ protected:
 
 	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
 	double multipoint_eval (double x) const;
+	double index_eval (double x) const;
+
+	void update_index ();
+	bool unlocked_erase_from_index (const_iterator start, const_iterator end);
+	void signal_dirty () const;
 
 	void build_search_cache_if_necessary (double start) const;
 
@@ -354,6 +366,18 @@ protected:
 
 	Curve* _curve;
 
+	/* The events of _events in contiguous storage, which evaluation
+	 * uses rather than walking the list. Since it holds the events
+	 * themselves, changes to an event's value or (order-preserving)
+	 * time need no update. Single-point modify() and erase() keep it
+	 * up to date, other edits invalidate it and it is rebuilt once
+	 * a batch of edits is done (see update_index()). Until then, and
+	 * during write passes, evaluation uses _events.
+	 */
+	mutable bool                _index_valid;
+	mutable uint64_t            _index_generation;
+	std::vector<ControlEvent*>  _index;
+
 private:
 	iterator   most_recent_insert_iterator;
 	double     insert_position;
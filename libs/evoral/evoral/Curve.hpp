@@ -33,8 +33,16 @@ class LIBEVORAL_API Curve : public boost::noncopyable
 public:
 	Curve (const ControlList& cl);
 
-	bool rt_safe_get_vector (double x0, double x1, float *arg, int32_t veclen) const;
-	void get_vector (double x0, double x1, float *arg, int32_t veclen) const;
+	/** Fill @a arg with @a veclen values, evaluated at equidistant
+	 * positions from @a x0 to @a x1.
+	 *
+	 * If @a constant is given, it is set to true if all values are
+	 * identical, so that callers can apply a scalar instead.
+	 *
+	 * @return false if the list could not be locked (nothing is written)
+	 */
+	bool rt_safe_get_vector (double x0, double x1, float *arg, int32_t veclen, bool* constant = 0) const;
+	void get_vector (double x0, double x1, float *arg, int32_t veclen, bool* constant = 0) const;
 
 	void solve () const;
 
@@ -43,7 +51,8 @@ public:
 private:
 	double multipoint_eval (double x) const;
 
-	void _get_vector (double x0, double x1, float *arg, int32_t veclen) const;
+	bool _get_vector (double x0, double x1, float *arg, int32_t veclen) const;
+	bool index_get_vector (double x, double dx, float *arg, int32_t veclen) const;
 
 	mutable bool       _dirty;
 	const ControlList& _list;
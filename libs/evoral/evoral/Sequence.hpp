@@ -305,6 +305,10 @@ public:
 
 	bool add_note_unlocked (const NotePtr note, void* arg = 0);
 	void remove_note_unlocked(const constNotePtr note);
+	/** Change the length of a note. Lengths of notes in the sequence
+	 *  must only be changed this way, since overlap queries depend on them.
+	 */
+	void set_note_length_unlocked (const NotePtr note, Time length);
 
 	void add_patch_change_unlocked (const PatchChangePtr);
 	void remove_patch_change_unlocked (const constPatchChangePtr);
@@ -327,9 +331,19 @@ protected:
 		return 0;
 	}
 
-	typedef std::multiset<NotePtr, NoteNumberComparator>  Pitches;
+	/** Orders notes by note number, and notes with the same number by time */
+	struct NoteNumberAndTimeComparator {
+		inline bool operator()(const boost::shared_ptr< const Note<Time> > a,
+		                       const boost::shared_ptr< const Note<Time> > b) const {
+			return a->note() < b->note() || (a->note() == b->note() && a->time() < b->time());
+		}
+	};
+
+	typedef std::multiset<NotePtr, NoteNumberAndTimeComparator>  Pitches;
 	inline       Pitches& pitches(uint8_t chan)       { return _pitches[chan&0xf]; }
 	inline const Pitches& pitches(uint8_t chan) const { return _pitches[chan&0xf]; }
+	/** @return an upper bound of the length of notes on a channel */
+	inline Time max_note_length(uint8_t chan) const { return _max_note_length[chan&0xf]; }
 
 	virtual void control_list_marked_dirty ();
 
@@ -351,7 +365,11 @@ private:
 	const TypeMap& _type_map;
 
 	Notes        _notes;       // notes indexed by time
-	Pitches      _pitches[16]; // notes indexed by channel+pitch
+	Pitches      _pitches[16]; // notes indexed by channel+pitch+time
+	/** Upper bound of the length of notes on each channel, so that notes
+	 *  overlapping a time range can be found by a range search in _pitches.
+	 */
+	Time         _max_note_length[16];
 	SysExes      _sysexes;
 	PatchChanges _patch_changes;
 
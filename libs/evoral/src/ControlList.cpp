@@ -35,9 +35,11 @@
 
 #define GUARD_POINT_DELTA 64
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <iterator>
 #include <utility>
 
 #include "evoral/ControlList.hpp"
@@ -65,6 +67,8 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	, _desc(desc)
 	, _interpolation (default_interpolation ())
 	, _curve(0)
+	, _index_valid (false)
+	, _index_generation (0)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -86,6 +90,8 @@ ControlList::ControlList (const ControlList& other)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _index_valid (false)
+	, _index_generation (0)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -108,6 +114,8 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _index_valid (false)
+	, _index_generation (0)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -115,6 +123,11 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	_lookup_cache.range.second = _events.end();
 	_search_cache.first = _events.end();
 	_sort_pending = false;
+	new_write_pass = true;
+	_in_write_pass = false;
+	did_write_during_pass = false;
+	insert_position = -1;
+	most_recent_insert_iterator = _events.end();
 
 	/* now grab the relevant points, and shift them back if necessary */
 
@@ -125,13 +138,10 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 		copy_events (*(section.get()));
 	}
 
-	new_write_pass = true;
-	_in_write_pass = false;
-	did_write_during_pass = false;
-	insert_position = -1;
-	most_recent_insert_iterator = _events.end();
-
 	mark_dirty ();
+
+	_index.assign (_events.begin(), _events.end());
+	_index_valid = true;
 }
 
 ControlList::~ControlList()
@@ -227,10 +237,15 @@ ControlList::default_interpolation () const
 void
 ControlList::maybe_signal_changed ()
 {
-	mark_dirty ();
+	/* edits have marked the list dirty with the lock held already,
+	 * leave an index which they kept up to date.
+	 */
+	signal_dirty ();
 
 	if (_frozen) {
 		_changed_when_thawed = true;
+	} else {
+		update_index ();
 	}
 }
 
@@ -500,6 +515,8 @@ ControlList::write_pass_finished (double /*when*/, double thinning_factor)
 	}
 	new_write_pass = true;
 	_in_write_pass = false;
+
+	update_index ();
 }
 
 void
@@ -559,6 +576,7 @@ ControlList::add_guard_point (double when, double offset)
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at end, adding eval-value there %2\n", this, eval_value));
 		_events.push_back (new ControlEvent (when, eval_value));
 		/* leave insert iterator at the end */
+		mark_dirty ();
 
 	} else if ((*most_recent_insert_iterator)->when == when) {
 
@@ -591,6 +609,7 @@ ControlList::add_guard_point (double when, double offset)
 		 */
 
 		++most_recent_insert_iterator;
+		mark_dirty ();
 	}
 }
 
@@ -886,8 +905,15 @@ ControlList::erase (iterator i)
 		if (most_recent_insert_iterator == i) {
 			unlocked_invalidate_insert_iterator ();
 		}
+		iterator next = i;
+		++next;
+		const bool indexed = unlocked_erase_from_index (i, next);
 		_events.erase (i);
-		mark_dirty ();
+		if (indexed) {
+			signal_dirty ();
+		} else {
+			mark_dirty ();
+		}
 	}
 	maybe_signal_changed ();
 }
@@ -897,9 +923,14 @@ ControlList::erase (iterator start, iterator end)
 {
 	{
 		Glib::Threads::RWLock::WriterLock lm (_lock);
+		const bool indexed = unlocked_erase_from_index (start, end);
 		_events.erase (start, end);
 		unlocked_invalidate_insert_iterator ();
-		mark_dirty ();
+		if (indexed) {
+			signal_dirty ();
+		} else {
+			mark_dirty ();
+		}
 	}
 	maybe_signal_changed ();
 }
@@ -1068,15 +1099,34 @@ ControlList::modify (iterator iter, double when, double val)
 			abort ();
 		}
 
-		if (!_frozen) {
-			_events.sort (event_time_less_than);
-			unlocked_remove_duplicates ();
-			unlocked_invalidate_insert_iterator ();
-		} else {
-			_sort_pending = true;
+		/* the common case, moving a point between its neighbours, needs
+		 * neither a sort nor an index rebuild.
+		 */
+		bool in_order = true;
+		if (iter != _events.begin()) {
+			iterator prev = iter;
+			--prev;
+			in_order = (*prev)->when < when;
+		}
+		iterator next = iter;
+		++next;
+		if (in_order && next != _events.end()) {
+			in_order = when < (*next)->when;
 		}
 
-		mark_dirty ();
+		if (in_order) {
+			signal_dirty ();
+		} else {
+			if (!_frozen) {
+				_events.sort (event_time_less_than);
+				unlocked_remove_duplicates ();
+				unlocked_invalidate_insert_iterator ();
+			} else {
+				_sort_pending = true;
+			}
+
+			mark_dirty ();
+		}
 	}
 
 	maybe_signal_changed ();
@@ -1138,12 +1188,25 @@ ControlList::thaw ()
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
+			mark_dirty ();
 		}
 	}
+
+	update_index ();
 }
 
 void
 ControlList::mark_dirty () const
+{
+	_index_valid = false;
+	++_index_generation;
+
+	signal_dirty ();
+}
+
+/** mark_dirty() for edits which leave the index valid */
+void
+ControlList::signal_dirty () const
 {
 	_lookup_cache.left = -1;
 	_lookup_cache.range.first = _events.end();
@@ -1158,6 +1221,71 @@ ControlList::mark_dirty () const
 	Dirty (); /* EMIT SIGNAL */
 }
 
+void
+ControlList::update_index ()
+{
+	std::vector<ControlEvent*> index;
+	uint64_t                   generation;
+
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_lock);
+
+		if (_frozen || _in_write_pass || _sort_pending || _index_valid) {
+			/* more edits to come, keep using the list until then */
+			return;
+		}
+
+		index.reserve (_events.size ());
+		index.assign (_events.begin(), _events.end());
+		generation = _index_generation;
+	}
+
+	Glib::Threads::RWLock::WriterLock lm (_lock);
+
+	if (_index_valid || generation != _index_generation) {
+		/* another thread was quicker, or the list was edited since */
+		return;
+	}
+
+	/* the old index is freed by index going out of scope, after the
+	 * lock is released.
+	 */
+	_index.swap (index);
+	_index_valid = true;
+}
+
+/** Remove the events [start, end) from a valid index.
+ * Must be called before they are erased from the list.
+ * @return true if the index is still valid
+ */
+bool
+ControlList::unlocked_erase_from_index (const_iterator start, const_iterator end)
+{
+	if (!_index_valid || start == end) {
+		return _index_valid;
+	}
+
+	std::vector<ControlEvent*>::iterator s = std::lower_bound (_index.begin(), _index.end(), *start, time_comparator);
+
+	/* skip events at the same time */
+	while (s != _index.end() && *s != *start && (*s)->when == (*start)->when) {
+		++s;
+	}
+
+	if (s == _index.end() || *s != *start) {
+		return false;
+	}
+
+	const size_t cnt = std::distance (start, end);
+
+	if ((size_t) (_index.end() - s) < cnt) {
+		return false;
+	}
+
+	_index.erase (s, s + cnt);
+	return true;
+}
+
 void
 ControlList::truncate_end (double last_coordinate)
 {
@@ -1434,6 +1562,10 @@ ControlList::multipoint_eval (double x) const
 	double uval, lval;
 	double fraction;
 
+	if (_index_valid) {
+		return index_eval (x);
+	}
+
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
@@ -1512,6 +1644,47 @@ ControlList::multipoint_eval (double x) const
 	return (*range.first)->value;
 }
 
+/** multipoint_eval() using binary search on the index, called with
+ * front()->when < x < back()->when.
+ */
+double
+ControlList::index_eval (double x) const
+{
+	const ControlEvent cp (x, 0);
+	const size_t       n = _index.size ();
+	const size_t       i = std::lower_bound (_index.begin(), _index.end(), &cp, time_comparator) - _index.begin();
+
+	if (i == n) {
+		return _index[n - 1]->value;
+	}
+
+	if (_index[i]->when == x || i == 0) {
+		/* x is a control point in the data */
+		return _index[i]->value;
+	}
+
+	const double lpos = _index[i - 1]->when;
+	const double lval = _index[i - 1]->value;
+	const double upos = _index[i]->when;
+	const double uval = _index[i]->value;
+
+	const double fraction = (double) (x - lpos) / (double) (upos - lpos);
+
+	switch (_interpolation) {
+		case Discrete:
+			return lval;
+		case Logarithmic:
+			return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
+		case Exponential:
+			return interpolate_gain (lval, uval, fraction, _desc.upper);
+		case Curved:
+			/* only used x-fade curves, never direct eval */
+			assert (0);
+		default: // Linear
+			return interpolate_linear (lval, uval, fraction);
+	}
+}
+
 void
 ControlList::build_search_cache_if_necessary (double start) const
 {
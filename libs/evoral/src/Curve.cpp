@@ -19,6 +19,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <float.h>
 #include <cmath>
@@ -174,50 +175,62 @@ Curve::solve () const
 }
 
 bool
-Curve::rt_safe_get_vector (double x0, double x1, float *vec, int32_t veclen) const
+Curve::rt_safe_get_vector (double x0, double x1, float *vec, int32_t veclen, bool* constant) const
 {
 	Glib::Threads::RWLock::ReaderLock lm(_list.lock(), Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
 		return false;
 	} else {
-		_get_vector (x0, x1, vec, veclen);
+		const bool c = _get_vector (x0, x1, vec, veclen);
+		if (constant) {
+			*constant = c;
+		}
 		return true;
 	}
 }
 
 void
-Curve::get_vector (double x0, double x1, float *vec, int32_t veclen) const
+Curve::get_vector (double x0, double x1, float *vec, int32_t veclen, bool* constant) const
 {
 	Glib::Threads::RWLock::ReaderLock lm(_list.lock());
-	_get_vector (x0, x1, vec, veclen);
+	const bool c = _get_vector (x0, x1, vec, veclen);
+	if (constant) {
+		*constant = c;
+	}
 }
 
-void
+static inline void
+fill_vector (float* vec, int32_t veclen, float val)
+{
+	for (int32_t i = 0; i < veclen; ++i) {
+		vec[i] = val;
+	}
+}
+
+/** @return true if all values written to vec are identical */
+bool
 Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 {
-	double rx, lx, hx, max_x, min_x;
+	double lx, hx, max_x, min_x;
 	int32_t i;
 	int32_t original_veclen;
 	int32_t npoints;
+	float* const original_vec = vec;
 
 	if (veclen == 0) {
-		return;
+		return true;
 	}
 
 	if ((npoints = _list.events().size()) == 0) {
 		/* no events in list, so just fill the entire array with the default value */
-		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.descriptor().normal;
-		}
-		return;
+		fill_vector (vec, veclen, _list.descriptor().normal);
+		return true;
 	}
 
 	if (npoints == 1) {
-		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
-		}
-		return;
+		fill_vector (vec, veclen, _list.events().front()->value);
+		return true;
 	}
 
 	/* events is now known not to be empty */
@@ -227,20 +240,16 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 
 	if (x0 > max_x) {
 		/* totally past the end - just fill the entire array with the final value */
-		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().back()->value;
-		}
-		return;
+		fill_vector (vec, veclen, _list.events().back()->value);
+		return true;
 	}
 
 	if (x1 < min_x) {
 		/* totally before the first event - fill the entire array with
 		 * the initial value.
 		 */
-		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
-		}
-		return;
+		fill_vector (vec, veclen, _list.events().front()->value);
+		return true;
 	}
 
 	original_veclen = veclen;
@@ -256,9 +265,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 
 		fill_len = min (fill_len, (int64_t)veclen);
 
-		for (i = 0; i < fill_len; ++i) {
-			vec[i] = _list.events().front()->value;
-		}
+		fill_vector (vec, fill_len, _list.events().front()->value);
 
 		veclen -= fill_len;
 		vec += fill_len;
@@ -275,9 +282,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		fill_len = min (fill_len, (int64_t)veclen);
 		val = _list.events().back()->value;
 
-		for (i = veclen - fill_len; i < veclen; ++i) {
-			vec[i] = val;
-		}
+		fill_vector (vec + veclen - fill_len, fill_len, val);
 
 		veclen -= fill_len;
 	}
@@ -292,6 +297,12 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		const double upos = _list.events().back()->when;
 		const double uval = _list.events().back()->value;
 
+		if (lval == uval) {
+			/* flat, prefix and suffix are filled with the same value */
+			fill_vector (vec, veclen, uval);
+			return true;
+		}
+
 		/* dx that we are using */
 		if (veclen > 1) {
 			const double dx_num = hx - lx;
@@ -351,23 +362,150 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 			}
 		}
 
-		return;
+		return false;
+	}
+
+	double dx = 0;
+	if (veclen > 1) {
+		dx = (hx - lx) / (veclen - 1);
+	}
+
+	if (_list.index_valid () && _list.interpolation () != ControlList::Curved) {
+		if (!index_get_vector (lx, dx, vec, veclen)) {
+			return false;
+		}
+		/* the middle section is constant, so are prefix and suffix */
+		return original_vec[0] == original_vec[original_veclen - 1] && (veclen == 0 || vec[0] == original_vec[0]);
 	}
 
 	if (_dirty) {
 		solve ();
 	}
 
-	rx = lx;
-
-	double dx = 0;
-	if (veclen > 1) {
-		dx = (hx - lx) / (veclen - 1);
+	/* not accumulated, to hit the same x as index_get_vector() */
+	for (i = 0; i < veclen; ++i) {
+		vec[i] = multipoint_eval (lx + i * dx);
 	}
 
-	for (i = 0; i < veclen; ++i, rx += dx) {
-		vec[i] = multipoint_eval (rx);
+	return false;
+}
+
+/** Evaluate @a veclen values at x, x + dx, ... from the list's index,
+ * one segment at a time: constant and discrete segments are filled,
+ * interpolated ones are computed with per-segment coefficients in loops
+ * that the compiler can vectorize.
+ *
+ * @return true if all values are identical
+ */
+bool
+Curve::index_get_vector (double x, double dx, float *vec, int32_t veclen) const
+{
+	std::vector<ControlEvent*> const& index = _list.events_index ();
+
+	const ControlEvent cp (x, 0);
+	const size_t       n     = index.size ();
+	const double       upper = _list.descriptor().upper;
+
+	bool    constant = true;
+	int32_t i        = 0;
+	size_t  s        = lower_bound (index.begin (), index.end (), &cp, ControlList::time_comparator) - index.begin ();
+
+	while (i < veclen) {
+
+		const double rx = x + i * dx;
+
+		/* first point at or after rx */
+		while (s < n && index[s]->when < rx) {
+			++s;
+		}
+
+		if (s == n) {
+			/* past the last point */
+			fill_vector (vec + i, veclen - i, index[n - 1]->value);
+			constant = constant && vec[i] == vec[0];
+			break;
+		}
+
+		if (s == 0 || index[s]->when == rx) {
+			/* before the first point, or exactly on a point */
+			vec[i] = index[s]->value;
+			constant = constant && vec[i] == vec[0];
+			++i;
+			continue;
+		}
+
+		/* index[s-1] < rx < index[s], find the number of values in this segment */
+		const double upos = index[s]->when;
+		int32_t      cnt;
+
+		if (dx > 0) {
+			int64_t end = (int64_t) ceil ((upos - x) / dx);
+			end = std::max ((int64_t) i + 1, std::min ((int64_t) veclen, end));
+			while (end < veclen && x + end * dx < upos) {
+				++end;
+			}
+			while (end > i + 1 && x + (end - 1) * dx >= upos) {
+				--end;
+			}
+			cnt = end - i;
+		} else {
+			cnt = veclen - i;
+		}
+
+		const double lpos  = index[s - 1]->when;
+		const double lval  = index[s - 1]->value;
+		const double uval  = index[s]->value;
+		const double range = upos - lpos;
+		const double f0    = (rx - lpos) / range;
+		const double df    = dx / range;
+		float* const v     = vec + i;
+
+		if (lval == uval || _list.interpolation () == ControlList::Discrete) {
+			fill_vector (v, cnt, lval);
+			constant = constant && v[0] == vec[0];
+			i += cnt;
+			continue;
+		}
+
+		switch (_list.interpolation ()) {
+			case ControlList::Logarithmic:
+				{
+					/* from * (to / from) ^ fraction, a geometric series */
+					const double q = pow (uval / lval, df);
+					double       y = lval * pow (uval / lval, f0);
+					for (int32_t j = 0; j < cnt; ++j, y *= q) {
+						v[j] = y;
+					}
+				}
+				break;
+			case ControlList::Exponential:
+				{
+					/* interpolate_gain() with the end-points mapped once */
+					const double g0 = gain_to_position (lval * 2. / upper);
+					const double g1 = gain_to_position (uval * 2. / upper);
+					const double p0 = g0 + f0 * (g1 - g0);
+					const double dp = df * (g1 - g0);
+					for (int32_t j = 0; j < cnt; ++j) {
+						v[j] = position_to_gain (p0 + j * dp) * upper / 2.;
+					}
+				}
+				break;
+			default: // Linear
+				{
+					const double y0 = lval + f0 * (uval - lval);
+					const double dy = df * (uval - lval);
+					for (int32_t j = 0; j < cnt; ++j) {
+						v[j] = y0 + j * dy;
+					}
+				}
+				break;
+		}
+
+		constant = constant && cnt == 1 && v[0] == vec[0];
+		i += cnt;
 	}
+
+	return constant;
 }
 
 double
@@ -380,7 +518,7 @@ Curve::multipoint_eval (double x) const
 	if ((lookup_cache.left < 0) ||
 	    ((lookup_cache.left > x) ||
 	     (lookup_cache.range.first == _list.events().end()) ||
-	     ((*lookup_cache.range.second)->when < x))) {
+	     ((*lookup_cache.range.second)->when <= x))) {
 
 		ControlEvent cp (x, 0.0);
 
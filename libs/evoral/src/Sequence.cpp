@@ -116,23 +116,14 @@ Sequence<Time>::const_iterator::const_iterator(const Sequence<Time>&
 	_note_iter = seq.note_lower_bound(t);
 
 	// Find first sysex event at or after t
-	for (typename Sequence<Time>::SysExes::const_iterator i = seq.sysexes().begin();
-	     i != seq.sysexes().end(); ++i) {
-		if ((*i)->time() >= t) {
-			_sysex_iter = i;
-			break;
-		}
+	if (!seq.sysexes().empty()) {
+		_sysex_iter = seq.sysex_lower_bound(t);
 	}
-	assert(_sysex_iter == seq.sysexes().end() || (*_sysex_iter)->time() >= t);
 
 	// Find first patch event at or after t
-	for (typename Sequence<Time>::PatchChanges::const_iterator i = seq.patch_changes().begin(); i != seq.patch_changes().end(); ++i) {
-		if ((*i)->time() >= t) {
-			_patch_change_iter = i;
-			break;
-		}
+	if (!seq.patch_changes().empty()) {
+		_patch_change_iter = seq.patch_change_lower_bound(t);
 	}
-	assert (_patch_change_iter == seq.patch_changes().end() || (*_patch_change_iter)->time() >= t);
 
 	// Find first control event after t
 	_control_iters.reserve(seq._controls.size());
@@ -483,6 +474,7 @@ Sequence<Time>::Sequence(const TypeMap& type_map)
 
 	for (int i = 0; i < 16; ++i) {
 		_bank[i] = 0;
+		_max_note_length[i] = Time();
 	}
 }
 
@@ -502,6 +494,7 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
 		NotePtr n (new Note<Time> (**i));
 		_notes.insert (n);
+		_pitches[n->channel()].insert (n);
 	}
 
 	for (typename SysExes::const_iterator i = other._sysexes.begin(); i != other._sysexes.end(); ++i) {
@@ -516,6 +509,7 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 
 	for (int i = 0; i < 16; ++i) {
 		_bank[i] = other._bank[i];
+		_max_note_length[i] = other._max_note_length[i];
 	}
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("Sequence copied: %1\n", this));
@@ -619,6 +613,10 @@ Sequence<Time>::clear()
 {
 	WriteLock lock(write_lock());
 	_notes.clear();
+	for (int i = 0; i < 16; ++i) {
+		_pitches[i].clear();
+		_max_note_length[i] = Time();
+	}
 	for (Controls::iterator li = _controls.begin(); li != _controls.end(); ++li)
 		li->second->list()->clear();
 }
@@ -678,7 +676,7 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 					     << when << " is before note on: " << (**n) << endl;
 					_notes.erase (*n);
 				} else {
-					(*n)->set_length (when - (*n)->time());
+					set_note_length_unlocked (*n, when - (*n)->time());
 					cerr << "WARNING: resolved note-on with no note-off to generate " << (**n) << endl;
 				}
 				break;
@@ -722,6 +720,10 @@ Sequence<Time>::add_note_unlocked(const NotePtr note, void* arg)
 	_notes.insert (note);
 	_pitches[note->channel()].insert (note);
 
+	if (note->length() > _max_note_length[note->channel()]) {
+		_max_note_length[note->channel()] = note->length();
+	}
+
 	_edited = true;
 
 	return true;
@@ -751,20 +753,6 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 
 			DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\terasing note #%2 %3 @ %4\n", this, (*i)->id(), (int)(*i)->note(), (*i)->time()));
 			_notes.erase (i);
-
-			if (note->note() == _lowest_note || note->note() == _highest_note) {
-
-				_lowest_note = 127;
-				_highest_note = 0;
-
-				for (typename Sequence<Time>::Notes::iterator ii = _notes.begin(); ii != _notes.end(); ++ii) {
-					if ((*ii)->note() < _lowest_note)
-						_lowest_note = (*ii)->note();
-					if ((*ii)->note() > _highest_note)
-						_highest_note = (*ii)->note();
-				}
-			}
-
 			erased = true;
 			break;
 		}
@@ -791,20 +779,6 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 
 				DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\tID-based pass, erasing note #%2 %3 @ %4\n", this, (*i)->id(), (int)(*i)->note(), (*i)->time()));
 				_notes.erase (i);
-
-				if (note->note() == _lowest_note || note->note() == _highest_note) {
-
-					_lowest_note = 127;
-					_highest_note = 0;
-
-					for (typename Sequence<Time>::Notes::iterator ii = _notes.begin(); ii != _notes.end(); ++ii) {
-						if ((*ii)->note() < _lowest_note)
-							_lowest_note = (*ii)->note();
-						if ((*ii)->note() > _highest_note)
-							_highest_note = (*ii)->note();
-					}
-				}
-
 				erased = true;
 				id_matched = true;
 				break;
@@ -836,11 +810,11 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 		} else {
 
 			/* Now find the same note in the "pitches" list (which indexes
-			 * notes by channel+time. We care only about its note number
-			 * so the search_note has all other properties unset.
+			 * notes by channel+pitch+time. We care only about its note number
+			 * and time, so the search_note has all other properties unset.
 			 */
 
-			NotePtr search_note (new Note<Time>(0, Time(), Time(), note->note(), 0));
+			NotePtr search_note (new Note<Time>(0, note->time(), Time(), note->note(), 0));
 
 			for (j = p.lower_bound (search_note); j != p.end() && (*j)->note() == note->note(); ++j) {
 
@@ -856,6 +830,21 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 			warning << string_compose ("erased note %1 not found in pitches for channel %2", *note, (int) note->channel()) << endmsg;
 		}
 
+		if (note->note() == _lowest_note || note->note() == _highest_note) {
+
+			/* the pitches are sorted by note number */
+
+			_lowest_note = 127;
+			_highest_note = 0;
+
+			for (int c = 0; c < 16; ++c) {
+				if (!_pitches[c].empty()) {
+					_lowest_note  = std::min (_lowest_note, (*_pitches[c].begin())->note());
+					_highest_note = std::max (_highest_note, (*_pitches[c].rbegin())->note());
+				}
+			}
+		}
+
 		_edited = true;
 
 	} else {
@@ -863,6 +852,17 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 	}
 }
 
+template<typename Time>
+void
+Sequence<Time>::set_note_length_unlocked (const NotePtr note, Time length)
+{
+	note->set_length (length);
+
+	if (length > _max_note_length[note->channel()]) {
+		_max_note_length[note->channel()] = length;
+	}
+}
+
 template<typename Time>
 void
 Sequence<Time>::remove_patch_change_unlocked (const constPatchChangePtr p)
@@ -1046,7 +1046,7 @@ Sequence<Time>::append_note_off_unlocked (const Event<Time>& ev)
 		if (ev.note() == nn->note() && nn->channel() == ev.channel()) {
 			assert(ev.time() >= nn->time());
 
-			nn->set_length (ev.time() - nn->time());
+			set_note_length_unlocked (nn, ev.time() - nn->time());
 			nn->set_off_velocity (ev.velocity());
 
 			_write_notes[ev.channel()].erase(n);
@@ -1139,10 +1139,10 @@ bool
 Sequence<Time>::contains_unlocked (const NotePtr& note) const
 {
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	NotePtr search_note(new Note<Time>(0, note->time(), Time(), note->note()));
 
 	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	     i != p.end() && (*i)->note() == note->note() && (*i)->time() == note->time(); ++i) {
 
 		if (**i == *note) {
 			return true;
@@ -1167,11 +1167,17 @@ Sequence<Time>::overlaps_unlocked (const NotePtr& note, const NotePtr& without)
 	Time sa = note->time();
 	Time ea  = note->end_time();
 
+	/* notes that start before sa - _max_note_length end before sa, and
+	 * notes that start after ea cannot overlap either.
+	 */
+	const Time max_length = _max_note_length[note->channel()];
+	const Time earliest   = sa > max_length ? sa - max_length : Time();
+
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	NotePtr search_note(new Note<Time>(0, earliest, Time(), note->note()));
 
 	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	     i != p.end() && (*i)->note() == note->note() && (*i)->time() <= ea; ++i) {
 
 		if (without && (**i) == *without) {
 			continue;
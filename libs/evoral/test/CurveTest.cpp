@@ -474,3 +474,161 @@ CurveTest::constrainedCubic ()
 		CPPUNIT_ASSERT_DOUBLES_EQUAL(v, g[x], 0.000008);
 	}
 }
+
+void
+CurveTest::indexedEval ()
+{
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	boost::shared_ptr<Evoral::ControlList> ref = TestCtrlList();
+
+	srand (42);
+	double when = 0;
+	for (int i = 0; i < 1000; ++i) {
+		const double value = rand () / (double) RAND_MAX;
+		cl->fast_simple_add (when, value);
+		ref->fast_simple_add (when, value);
+		when += 1 + rand () % 100;
+	}
+
+	/* fast_simple_add() leaves the index alone, freeze/thaw builds it */
+	CPPUNIT_ASSERT (!cl->index_valid ());
+	cl->freeze ();
+	cl->thaw ();
+	CPPUNIT_ASSERT (cl->index_valid ());
+	CPPUNIT_ASSERT (!ref->index_valid ());
+
+	const ControlList::InterpolationStyle styles[] = { ControlList::Discrete, ControlList::Linear };
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		cl->set_interpolation (styles[s]);
+		ref->set_interpolation (styles[s]);
+		for (double x = -10; x < when + 10; x += 7.5) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (ref->unlocked_eval (x), cl->unlocked_eval (x), 1e-12);
+		}
+		/* exactly on control points */
+		for (ControlList::const_iterator i = ref->begin (); i != ref->end (); ++i) {
+			CPPUNIT_ASSERT_EQUAL ((*i)->value, cl->unlocked_eval ((*i)->when));
+		}
+	}
+
+	/* edits invalidate the index and rebuild it once done */
+	cl->add (50.5, 0.25, false, false);
+	CPPUNIT_ASSERT (cl->index_valid ());
+	CPPUNIT_ASSERT_EQUAL (0.25, cl->unlocked_eval (50.5));
+
+	/* keep ref evaluating from the list */
+	ref->freeze ();
+	ref->add (50.5, 0.25, false, false);
+
+	/* moving a point between its neighbours and erasing points
+	 * update the index rather than invalidating it.
+	 */
+	ControlList::iterator c = cl->begin ();
+	ControlList::iterator r = ref->begin ();
+	for (int i = 0; i < 100; ++i, ++c, ++r) {}
+
+	ControlList::iterator next = c;
+	++next;
+	const double moved = ((*c)->when + (*next)->when) / 2;
+	cl->modify (c, moved, 0.75);
+	ref->modify (r, moved, 0.75);
+	CPPUNIT_ASSERT (cl->index_valid ());
+
+	cl->erase (next);
+	ref->erase (ref->begin ());
+	cl->erase (cl->begin ());
+	next = r;
+	++next;
+	ref->erase (next);
+	CPPUNIT_ASSERT (cl->index_valid ());
+	CPPUNIT_ASSERT (!ref->index_valid ());
+	CPPUNIT_ASSERT_EQUAL (ref->size (), cl->size ());
+
+	for (double x = -10; x < when + 10; x += 7.5) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (ref->unlocked_eval (x), cl->unlocked_eval (x), 1e-12);
+	}
+	CPPUNIT_ASSERT_EQUAL (0.75, cl->unlocked_eval (moved));
+
+	ref->thaw ();
+}
+
+void
+CurveTest::blockEval ()
+{
+	float vec[4096];
+	float ref[4096];
+
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	boost::shared_ptr<Evoral::ControlList> rl = TestCtrlList();
+
+	cl->create_curve ();
+	rl->create_curve ();
+
+	srand (23);
+	double when = 0;
+	double value = .5;
+	for (int i = 0; i < 200; ++i) {
+		/* every 5th segment is flat */
+		if (i % 5) {
+			value = .05 + .9 * rand () / (double) RAND_MAX;
+		}
+		cl->fast_simple_add (when, value);
+		rl->fast_simple_add (when, value);
+		when += 1 + rand () % 1000;
+	}
+
+	/* only cl is indexed, rl is evaluated point by point */
+	cl->freeze ();
+	cl->thaw ();
+	CPPUNIT_ASSERT (cl->index_valid ());
+	CPPUNIT_ASSERT (!rl->index_valid ());
+
+	/* Logarithmic needs a range that excludes zero, which the default descriptor does not */
+	const ControlList::InterpolationStyle styles[] = { ControlList::Discrete, ControlList::Linear, ControlList::Exponential };
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		cl->set_interpolation (styles[s]);
+		rl->set_interpolation (styles[s]);
+		for (int n = 0; n < 500; ++n) {
+			const double  x0     = -100 + rand () % (int) (when + 200);
+			const int32_t veclen = 1 + rand () % 4096;
+			const double  x1     = x0 + rand () % 8192;
+			bool          constant;
+
+			cl->curve ().get_vector (x0, x1, vec, veclen, &constant);
+			rl->curve ().get_vector (x0, x1, ref, veclen);
+
+			for (int32_t i = 0; i < veclen; ++i) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL (ref[i], vec[i], 1e-5);
+				if (constant) {
+					CPPUNIT_ASSERT_EQUAL (vec[0], vec[i]);
+				}
+			}
+		}
+	}
+
+	/* constant segment detection */
+	boost::shared_ptr<Evoral::ControlList> fl = TestCtrlList();
+	fl->create_curve ();
+	fl->freeze ();
+	fl->fast_simple_add (   0.0, 0.5);
+	fl->fast_simple_add ( 100.0, 0.5);
+	fl->fast_simple_add ( 200.0, 0.5);
+	fl->fast_simple_add ( 300.0, 1.0);
+	fl->thaw ();
+
+	bool constant = false;
+	fl->curve ().get_vector (-50.0, 199.0, vec, 1024, &constant);
+	CPPUNIT_ASSERT (constant);
+	CPPUNIT_ASSERT_EQUAL (0.5f, vec[1023]);
+
+	fl->curve ().get_vector (150.0, 250.0, vec, 1024, &constant);
+	CPPUNIT_ASSERT (!constant);
+
+	fl->curve ().get_vector (400.0, 500.0, vec, 1024, &constant);
+	CPPUNIT_ASSERT (constant);
+	CPPUNIT_ASSERT_EQUAL (1.0f, vec[0]);
+
+	CPPUNIT_ASSERT (fl->curve ().rt_safe_get_vector (0.0, 150.0, vec, 64, &constant));
+	CPPUNIT_ASSERT (constant);
+}
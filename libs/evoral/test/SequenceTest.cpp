@@ -194,3 +194,46 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::overlapTest ()
+{
+	typedef Sequence<Time>::NotePtr NotePtr;
+
+	seq->clear();
+
+	/* many short notes of the same pitch, and a long one on another channel */
+	for (int i = 0; i < 1000; ++i) {
+		seq->add_note_unlocked (NotePtr (new Note<Time> (0, Time (i * 2), Time (1), 60, 64)));
+	}
+	NotePtr long_note (new Note<Time> (1, Time (0), Time (1000), 60, 64));
+	seq->add_note_unlocked (long_note);
+
+	/* gap between two short notes */
+	CPPUNIT_ASSERT (!seq->overlaps (NotePtr (new Note<Time> (0, Time (1001.25), Time (0.5), 60, 64)), NotePtr ()));
+	/* a note on the same pitch */
+	CPPUNIT_ASSERT (seq->overlaps (NotePtr (new Note<Time> (0, Time (1000.5), Time (1), 60, 64)), NotePtr ()));
+	/* no notes of this pitch */
+	CPPUNIT_ASSERT (!seq->overlaps (NotePtr (new Note<Time> (0, Time (1000), Time (100), 61, 64)), NotePtr ()));
+	/* the long note, which starts long before */
+	CPPUNIT_ASSERT (seq->overlaps (NotePtr (new Note<Time> (1, Time (900), Time (1), 60, 64)), NotePtr ()));
+	CPPUNIT_ASSERT (!seq->overlaps (NotePtr (new Note<Time> (1, Time (1001), Time (1), 60, 64)), NotePtr ()));
+
+	/* ... until it is made longer */
+	seq->set_note_length_unlocked (long_note, Time (2000));
+	CPPUNIT_ASSERT (seq->overlaps (NotePtr (new Note<Time> (1, Time (1001), Time (1), 60, 64)), NotePtr ()));
+	CPPUNIT_ASSERT (seq->contains (long_note));
+
+	/* the copy is indexed, too */
+	MySequence<Time> copy (*seq);
+	CPPUNIT_ASSERT (copy.overlaps (NotePtr (new Note<Time> (1, Time (1001), Time (1), 60, 64)), NotePtr ()));
+
+	/* the range of note numbers follows removals */
+	NotePtr low (new Note<Time> (0, Time (10), Time (1), 20, 64));
+	seq->add_note_unlocked (low);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 20, seq->lowest_note ());
+	seq->remove_note_unlocked (low);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, seq->lowest_note ());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, seq->highest_note ());
+	CPPUNIT_ASSERT (!seq->contains (low));
+}
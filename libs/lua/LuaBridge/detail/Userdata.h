@@ -493,6 +493,39 @@ public:
     else
       lua_pushnil (L);
   }
+
+  /** Point an existing userdata, pushed for a pointer of the same type,
+      to another object. Returns false if the value at the given index
+      is not such a userdata.
+
+      This allows to update references (e.g. to buffers) that are passed
+      to Lua in place, without allocating a new userdata each time.
+  */
+  template <class T>
+  static inline bool rebind (lua_State* const L, int index, T* const p)
+  {
+    return rebind (L, index, p, ClassInfo <T>::getClassKey ());
+  }
+
+  template <class T>
+  static inline bool rebind (lua_State* const L, int index, T const* const p)
+  {
+    return rebind (L, index, const_cast <T*> (p), ClassInfo <T>::getConstKey ());
+  }
+
+private:
+  static bool rebind (lua_State* const L, int index, void* const p, void const* const key)
+  {
+    index = lua_absindex (L, index);
+    if (!p || !lua_isuserdata (L, index) || lua_islightuserdata (L, index) || !lua_getmetatable (L, index))
+      return false;
+    lua_rawgetp (L, LUA_REGISTRYINDEX, key);
+    bool const match = lua_rawequal (L, -1, -2);
+    lua_pop (L, 2);
+    if (match)
+      static_cast <UserdataPtr*> (lua_touserdata (L, index))->m_p = p;
+    return match;
+  }
 };
 
 //============================================================================
@@ -19,6 +19,7 @@
 #ifndef LUA_STATE_H
 #define LUA_STATE_H
 
+#include <stddef.h>
 #include <string>
 #include <sigc++/sigc++.h>
 
@@ -38,6 +39,18 @@ public:
 	void tweak_rt_gc ();
 	void sandbox (bool rt_safe = false);
 
+	/* Incremental garbage collection for realtime use, once per cycle.
+	 * Does nothing if memory use did not change since the previous call,
+	 * otherwise performs a step of the given budget (in KB of allocation
+	 * debt, 0: a single basic step).
+	 */
+	void collect_garbage_rt_step ();
+	void set_rt_gc_budget (int kbytes) { _rt_gc_budget = kbytes; }
+
+	/* statistics: count allocations (and reallocations that grow a block) */
+	void   count_allocations (bool yn);
+	size_t n_allocations () const { return _n_alloc; }
+
 	sigc::signal<void,std::string> Print;
 
 	lua_State* getState () { return L; }
@@ -47,6 +60,14 @@ protected:
 
 private:
 	void init ();
+
+	static void* _counting_alloc (void* ud, void* ptr, size_t osize, size_t nsize);
+
+	lua_Alloc _alloc;
+	void*     _alloc_ud;
+	size_t    _n_alloc;
+	size_t    _rt_gc_used;
+	int       _rt_gc_budget;
   static int _print (lua_State *L);
 	void print (std::string text);
 
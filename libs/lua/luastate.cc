@@ -28,6 +28,11 @@ static int panic (lua_State *L) {
 
 LuaState::LuaState()
 	: L (luaL_newstate ())
+	, _alloc (0)
+	, _alloc_ud (0)
+	, _n_alloc (0)
+	, _rt_gc_used (0)
+	, _rt_gc_budget (0)
 {
 	assert (L);
 	init ();
@@ -35,6 +40,11 @@ LuaState::LuaState()
 
 LuaState::LuaState(lua_State *ls)
 	: L (ls)
+	, _alloc (0)
+	, _alloc_ud (0)
+	, _n_alloc (0)
+	, _rt_gc_used (0)
+	, _rt_gc_budget (0)
 {
 	assert (L);
 	init ();
@@ -81,6 +91,39 @@ LuaState::collect_garbage_step (int debt) {
 	lua_gc (L, LUA_GCSTEP, debt);
 }
 
+void
+LuaState::collect_garbage_rt_step () {
+	const size_t used = lua_gc (L, LUA_GCCOUNT, 0) * 1024 + lua_gc (L, LUA_GCCOUNTB, 0);
+	if (used == _rt_gc_used) {
+		/* nothing was allocated (or freed), no new garbage */
+		return;
+	}
+	lua_gc (L, LUA_GCSTEP, _rt_gc_budget);
+	_rt_gc_used = lua_gc (L, LUA_GCCOUNT, 0) * 1024 + lua_gc (L, LUA_GCCOUNTB, 0);
+}
+
+void*
+LuaState::_counting_alloc (void* ud, void* ptr, size_t osize, size_t nsize) {
+	LuaState* self = static_cast<LuaState*> (ud);
+	/* for new blocks osize is the type of object, not a size */
+	if (nsize > 0 && (!ptr || nsize > osize)) {
+		++self->_n_alloc;
+	}
+	return self->_alloc (self->_alloc_ud, ptr, osize, nsize);
+}
+
+void
+LuaState::count_allocations (bool yn) {
+	if (yn && !_alloc) {
+		_alloc = lua_getallocf (L, &_alloc_ud);
+		lua_setallocf (L, &LuaState::_counting_alloc, this);
+	} else if (!yn && _alloc) {
+		lua_setallocf (L, _alloc, _alloc_ud);
+		_alloc = 0;
+		_alloc_ud = 0;
+	}
+}
+
 void
 LuaState::tweak_rt_gc () {
 	/* GC runs same speed as  memory allocation */
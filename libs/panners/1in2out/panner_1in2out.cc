@@ -272,10 +272,11 @@ Panner1in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	pan_t* pbuf;
 	Sample* const src = srcbuf.data();
         pan_t* const position = buffers[0];
+	bool constant;
 
 	/* fetch positional data */
 
-	if (!_pannable->pan_azimuth_control->list()->curve().rt_safe_get_vector (start, end, position, nframes)) {
+	if (!_pannable->pan_azimuth_control->list()->curve().rt_safe_get_vector (start, end, position, nframes, &constant)) {
 		/* fallback */
                 distribute_one (srcbuf, obufs, 1.0, nframes, which);
 		return;
@@ -288,6 +289,16 @@ Panner1in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	const float pan_law_attenuation = -3.0f;
 	const float scale = 2.0f - 4.0f * powf (10.0f,pan_law_attenuation/20.0f);
 
+	if (constant) {
+		/* the position does not change during this cycle, one pair of coefficients will do */
+		const float panR = position[0];
+		const float panL = 1 - panR;
+
+		mix_buffers_with_gain (obufs.get_audio(0).data(), src, nframes, panL * (scale * panL + 1.0f - scale));
+		mix_buffers_with_gain (obufs.get_audio(1).data(), src, nframes, panR * (scale * panR + 1.0f - scale));
+		return;
+	}
+
 	for (pframes_t n = 0; n < nframes; ++n) {
 
                 float panR = position[n];
@@ -398,16 +398,18 @@ Panner2in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	Sample* const src = srcbuf.data();
         pan_t* const position = buffers[0];
         pan_t* const width = buffers[1];
+	bool constant_position;
+	bool constant_width;
 
 	/* fetch positional data */
 
-	if (!_pannable->pan_azimuth_control->list()->curve().rt_safe_get_vector (start, end, position, nframes)) {
+	if (!_pannable->pan_azimuth_control->list()->curve().rt_safe_get_vector (start, end, position, nframes, &constant_position)) {
 		/* fallback */
                 distribute_one (srcbuf, obufs, 1.0, nframes, which);
 		return;
 	}
 
-	if (!_pannable->pan_width_control->list()->curve().rt_safe_get_vector (start, end, width, nframes)) {
+	if (!_pannable->pan_width_control->list()->curve().rt_safe_get_vector (start, end, width, nframes, &constant_width)) {
 		/* fallback */
                 distribute_one (srcbuf, obufs, 1.0, nframes, which);
 		return;
@@ -420,6 +422,25 @@ Panner2in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	const float pan_law_attenuation = -3.0f;
 	const float scale = 2.0f - 4.0f * powf (10.0f,pan_law_attenuation/20.0f);
 
+	if (constant_position && constant_width) {
+		/* nothing changes during this cycle, one pair of coefficients will do */
+		float panR;
+
+		if (which == 0) {
+			panR = position[0] - (width[0]/2.0f);
+		} else {
+			panR = position[0] + (width[0]/2.0f);
+		}
+
+		panR = max(0.f, min(1.f, panR));
+
+		const float panL = 1 - panR;
+
+		mix_buffers_with_gain (obufs.get_audio(0).data(), src, nframes, panL * (scale * panL + 1.0f - scale));
+		mix_buffers_with_gain (obufs.get_audio(1).data(), src, nframes, panR * (scale * panR + 1.0f - scale));
+		return;
+	}
+
 	for (pframes_t n = 0; n < nframes; ++n) {
 
                 float panR;
@@ -71,6 +71,32 @@ __cpuid(int regs[4], int cpuid_leaf)
 			"%ecx", "%edx", "memory");
 }
 
+/* CPUID leaves that have sub-leaves (e.g. 7: extended features) */
+
+static void
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
+{
+	asm volatile (
+#if defined(__i386__)
+			"pushl %%ebx;\n\t"
+#endif
+			"cpuid;\n\t"
+			"movl %%eax, (%2);\n\t"
+			"movl %%ebx, 4(%2);\n\t"
+			"movl %%ecx, 8(%2);\n\t"
+			"movl %%edx, 12(%2);\n\t"
+#if defined(__i386__)
+			"popl %%ebx;\n\t"
+#endif
+			:"=a" (cpuid_leaf), "=c" (cpuid_subleaf) /* %eax, %ecx clobbered by CPUID */
+			:"S" (regs), "a" (cpuid_leaf), "c" (cpuid_subleaf)
+			:
+#if !defined(__i386__)
+			"%ebx",
+#endif
+			"%edx", "memory");
+}
+
 #endif /* !PLATFORM_WINDOWS */
 
 #ifndef HAVE_XGETBV // Allow definition by build system
@@ -195,6 +221,25 @@ FPU::FPU ()
 		    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0x6) == 0x6)) { /* OS really supports XSAVE */
 			info << _("AVX-capable processor") << endmsg;
 			_flags = Flags (_flags | (HasAVX) );
+
+			if (cpu_info[2] & (1<<12) /* FMA */) {
+				_flags = Flags (_flags | (HasFMA) );
+			}
+		}
+
+		if ((_flags & HasAVX) && num_ids >= 7) {
+			int ext_info[4];
+			__cpuidex (ext_info, 7, 0);
+
+			if (ext_info[1] & (1<<5) /* AVX2 */) {
+				_flags = Flags (_flags | (HasAVX2) );
+			}
+
+			if ((ext_info[1] & (1<<16)) /* AVX512F */ &&
+			    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0xe6) == 0xe6)) { /* OS saves opmask and ZMM state */
+				info << _("AVX-512-capable processor") << endmsg;
+				_flags = Flags (_flags | (HasAVX512F) );
+			}
 		}
 
 		if (cpu_info[3] & (1<<25)) {
@@ -96,16 +96,18 @@ mountpoint (string path)
 }
 
 #elif defined(PLATFORM_WINDOWS)
-#include <assert.h>
+#include <windows.h>
 string
 mountpoint (string path)
 {
-	/* this function is currently only called from 'old_peak_path()'
-	 * via find_broken_peakfile() - only relevant for loading pre
-	 * libsndfile Ardour 2.0 sessions.
-	 */
-	assert(0);
-	return ""; // TODO ... if needed
+	/* the volume (drive root or mounted folder) that contains path */
+	char volume[MAX_PATH + 1];
+
+	if (!GetVolumePathNameA (path.c_str (), volume, sizeof (volume))) {
+		return "";
+	}
+
+	return volume;
 }
 
 #else // !HAVE_GETMNTENT
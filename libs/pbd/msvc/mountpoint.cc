@@ -94,10 +94,19 @@ mountpoint (string path)
 
 #else // !HAVE_GETMNTENT
 
+#include <windows.h>
+
 string
 mountpoint (string path)
 {
-return "";
+	/* the volume (drive root or mounted folder) that contains path */
+	char volume[MAX_PATH + 1];
+
+	if (!GetVolumePathNameA (path.c_str (), volume, sizeof (volume))) {
+		return "";
+	}
+
+	return volume;
 
 /*  // The rest is commented out temporarily by JE - 30-11-2009
     // (I think this must be the implementation for MacOS).
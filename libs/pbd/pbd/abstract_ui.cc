@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <iostream>
 #include <algorithm>
+#include <new>
 
 #include "pbd/stacktrace.h"
 #include "pbd/abstract_ui.h"
@@ -44,6 +45,9 @@ DECLARE_DEFAULT_COMPARISONS(ptw32_handle_t)
 
 using namespace std;
 
+/* number of handled heap requests that are kept for reuse */
+static const uint32_t max_request_pool_size = 64;
+
 template<typename RequestBuffer> void
 cleanup_request_buffer (void* ptr)
 {
@@ -69,6 +73,7 @@ Glib::Threads::Private<typename AbstractUI<R>::RequestBuffer> AbstractUI<R>::per
 template <typename RequestObject>
 AbstractUI<RequestObject>::AbstractUI (const string& name)
 	: BaseUI (name)
+	, request_pool_size (0)
 {
 	void (AbstractUI<RequestObject>::*pmf)(pthread_t,string,uint32_t) = &AbstractUI<RequestObject>::register_thread;
 
@@ -99,6 +104,10 @@ AbstractUI<RequestObject>::~AbstractUI ()
 			delete (*i).second;
 		}
 	}
+
+	for (typename std::list<RequestObject*>::iterator i = request_pool.begin(); i != request_pool.end(); ++i) {
+		delete *i;
+	}
 }
 
 template <typename RequestObject> void
@@ -187,19 +196,63 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 		return vec.buf[0];
 	}
 
-	/* calling thread has not registered, so just allocate a new request on
-	 * the heap. the lack of registration implies that realtime constraints
-	 * are not at work.
+	/* calling thread has not registered, so just reuse or allocate a
+	 * request on the heap. the lack of registration implies that realtime
+	 * constraints are not at work.
 	 */
 
-	DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: allocated normal heap request of type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+	RequestObject* req = 0;
+
+	{
+		Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
+		if (!request_pool.empty ()) {
+			req = request_pool.front ();
+			/* keep the list node, send_request() will use it */
+			request_nodes.splice (request_nodes.end (), request_pool, request_pool.begin ());
+			--request_pool_size;
+		}
+	}
+
+	if (req) {
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: reused heap request for type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+	} else {
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: allocated normal heap request of type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+		req = new RequestObject;
+	}
 
-	RequestObject* req = new RequestObject;
 	req->type = rt;
 
 	return req;
 }
 
+/** Make a handled heap request available to get_request() again, reset
+ * as if newly allocated. This must be called without request_buffer_map_lock
+ * held, since destroying the request's functor may destroy objects, which
+ * then invalidate requests.
+ */
+template <typename RequestObject> void
+AbstractUI<RequestObject>::recycle_request (RequestObject* req)
+{
+	req->~RequestObject ();
+	new (req) RequestObject;
+
+	Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
+
+	if (request_pool_size >= max_request_pool_size) {
+		delete req;
+		return;
+	}
+
+	if (request_nodes.empty ()) {
+		request_pool.push_back (req);
+	} else {
+		request_nodes.front () = req;
+		request_pool.splice (request_pool.end (), request_nodes, request_nodes.begin ());
+	}
+
+	++request_pool_size;
+}
+
 template <typename RequestObject> void
 AbstractUI<RequestObject>::handle_ui_requests ()
 {
@@ -317,7 +370,7 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 	while (!request_list.empty()) {
 		assert (rbml.locked ());
 		RequestObject* req = request_list.front ();
-		request_list.pop_front ();
+		request_nodes.splice (request_nodes.end (), request_list, request_list.begin ());
 
 		/* we're about to execute this request, so its
 		 * too late for any invalidation. mark
@@ -325,8 +378,10 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 		 */
 
 		if (req->invalidation && !req->invalidation->valid()) {
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 handling invalid heap request, type %3, deleting\n", event_loop_name(), pthread_name(), req->type));
-			delete req;
+			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 handling invalid heap request, type %3, recycling\n", event_loop_name(), pthread_name(), req->type));
+			rbml.release ();
+			recycle_request (req);
+			rbml.acquire ();
 			continue;
 		}
 
@@ -359,8 +414,8 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 
 		do_request (req);
 
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 delete heap request type %3\n", event_loop_name(), pthread_name(), req->type));
-		delete req;
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 recycle heap request type %3\n", event_loop_name(), pthread_name(), req->type));
+		recycle_request (req);
 
 		/* re-acquire the list lock so that we check again */
 
@@ -389,7 +444,7 @@ AbstractUI<RequestObject>::send_request (RequestObject *req)
 		*/
 		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 direct dispatch of request type %3\n", event_loop_name(), pthread_name(), req->type));
 		do_request (req);
-		delete req;
+		recycle_request (req);
 	} else {
 
 		/* If called from a different thread, we first check to see if
@@ -415,7 +470,12 @@ AbstractUI<RequestObject>::send_request (RequestObject *req)
 			 */
 			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 send heap request type %3 IR %4\n", event_loop_name(), pthread_name(), req->type, req->invalidation));
 			Glib::Threads::Mutex::Lock lm (request_buffer_map_lock);
-			request_list.push_back (req);
+			if (request_nodes.empty ()) {
+				request_list.push_back (req);
+			} else {
+				request_nodes.front () = req;
+				request_list.splice (request_list.end (), request_nodes, request_nodes.begin ());
+			}
 		}
 
 		/* send the UI event loop thread a wakeup so that it will look
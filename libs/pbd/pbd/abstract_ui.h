@@ -96,7 +96,16 @@ protected:
 
 	std::list<RequestObject*> request_list;
 
+	/* Requests from threads without a request buffer are allocated on the
+	 * heap. Once handled, they (and their list nodes) are kept for reuse.
+	 * Protected by request_buffer_map_lock.
+	 */
+	std::list<RequestObject*> request_pool;
+	std::list<RequestObject*> request_nodes; ///< unused nodes for request_list and request_pool
+	uint32_t request_pool_size;
+
 	RequestObject* get_request (RequestType);
+	void recycle_request (RequestObject*);
 	void handle_ui_requests ();
 	void send_request (RequestObject *);
 
@@ -31,6 +31,7 @@
 #undef nil
 #endif
 
+#include <glib.h>
 #include <glibmm/threads.h>
 
 #include <boost/noncopyable.hpp>
@@ -39,6 +40,7 @@
 #include <boost/function.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/event_loop.h"
@@ -60,19 +62,47 @@ class LIBPBD_API SignalBase
 {
 public:
 	SignalBase ()
+		: _generation (0)
+		, _emit_readers (0)
+		, _emit_slots (0)
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
-	: _debug_connection (false)
+		, _debug_connection (false)
 #endif
 	{}
-	virtual ~SignalBase () {}
+	virtual ~SignalBase ();
 	virtual void disconnect (boost::shared_ptr<Connection>) = 0;
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	void set_debug_connection (bool yn) { _debug_connection = yn; }
 #endif
 
 protected:
+	/* Emission does not lock _mutex or copy the slots. It uses a copy
+	 * of the slots which is shared by all emissions, and replaced
+	 * (read-copy-update) after connections have changed.
+	 */
+
+	/** @return the slots to use for an emission, or an empty pointer
+	 *  if they have changed since the copy was made.  Lock-free.
+	 */
+	boost::shared_ptr<void const> emit_slots () const;
+	/** Publish a copy of the slots for emission. Caller must hold _mutex */
+	void set_emit_slots (boost::shared_ptr<void const> const&);
+	/** Drop the emission copy after the slots changed. Caller must hold _mutex */
+	void slots_changed ();
+	/** @return a number that changes whenever the slots do */
+	gint generation () const { return g_atomic_int_get (&_generation); }
+
 	mutable Glib::Threads::Mutex _mutex;
+
+private:
+	void replace_emit_slots (boost::shared_ptr<void const>*);
+
+	gint _generation;
+	mutable gint _emit_readers;
+	boost::shared_ptr<void const>* volatile _emit_slots;
+
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
+protected:
 	bool _debug_connection;
 #endif
 };
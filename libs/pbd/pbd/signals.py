@@ -126,7 +126,7 @@ def signal(f, n, v):
         p = ", %s" % comma_separated(Anan)
         q = ", %s" % comma_separated(an)
     
-    print("\tstatic void compositor (%sboost::function<void(%s)> f, EventLoop* event_loop, EventLoop::InvalidationRecord* ir%s) {" % (typename, comma_separated(An), p), file=f)
+    print("\tstatic void compositor (%sboost::function<void(%s)> const& f, EventLoop* event_loop, EventLoop::InvalidationRecord* ir%s) {" % (typename, comma_separated(An), p), file=f)
     print("\t\tevent_loop->call_slot (ir, boost::bind (f%s));" % q, file=f)
     print("\t}", file=f)
 
@@ -230,25 +230,35 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
-    print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
-    print("", file=f)
+    print("""		/* First, get the list of slots as it is now. This is a copy that is
+		   shared by all emissions until the slots change, so usually this
+		   neither locks nor allocates.
+		*/
+
+		gint const generation = SignalBase::generation ();
+		boost::shared_ptr<Slots const> s = boost::static_pointer_cast<Slots const> (emit_slots ());
+
+		if (!s) {
+			Glib::Threads::Mutex::Lock lm (_mutex);
+			s = boost::static_pointer_cast<Slots const> (emit_slots ());
+			if (!s) {
+				s.reset (new Slots (_slots));
+				set_emit_slots (s);
+			}
+		}
+""", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+    print("\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
     print("""
 			/* We may have just called a slot, and this may have resulted in
 			   disconnection of other slots from us.  The list copy means that
-			   this won't cause any problems with invalidated iterators, but we
-			   must check to see if the slot we are about to call is still on the list.
+			   this won't cause any problems with invalidated iterators, but if
+			   the slots have changed since we got the copy, we must check to
+			   see if the slot we are about to call is still on the list.
 			*/
-			bool still_there = false;
-			{
+			bool still_there = true;
+			if (SignalBase::generation () != generation) {
 				Glib::Threads::Mutex::Lock lm (_mutex);
 				still_there = _slots.find (i->first) != _slots.end ();
 			}
@@ -295,6 +305,7 @@ def signal(f, n, v):
 		boost::shared_ptr<Connection> c (new Connection (this, ir));
 		Glib::Threads::Mutex::Lock lm (_mutex);
 		_slots[c] = f;
+		slots_changed ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
                 if (_debug_connection) {
                         std::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
@@ -310,6 +321,7 @@ def signal(f, n, v):
 		{
 			Glib::Threads::Mutex::Lock lm (_mutex);
     			_slots.erase (c);
+			slots_changed ();
     		}
 		c->disconnected ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
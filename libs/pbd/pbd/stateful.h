@@ -106,6 +106,9 @@ class LIBPBD_API Stateful {
 
 	bool property_changes_suspended() const { return g_atomic_int_get (const_cast<gint*>(&_stateful_frozen)) > 0; }
 
+	/** @return true if state was changed since it was last cached */
+	bool state_dirty () const;
+
   protected:
 
 	void add_instant_xml (XMLNode&, const std::string& directory_path);
@@ -136,12 +139,31 @@ class LIBPBD_API Stateful {
 
 	bool regenerate_xml_or_string_ids () const;
 
+	/* Serialized state cache, for objects whose get_state() is expensive.
+	 * Such an object keeps the expensive part of its state, and reuses it
+	 * while state_dirty() is false. Everything that modifies the serialized
+	 * state must call state_changed(); property changes and ID changes
+	 * already do.
+	 */
+
+	/** Mark the cached state as out of date. RT safe */
+	void state_changed ();
+	/** @return the current state generation, to be read before serializing,
+	 *  so that changes made meanwhile leave the cache out of date.
+	 */
+	gint state_generation () const;
+	/** Record that the state serialized at @param generation was cached */
+	void state_cached (gint generation);
+
   private:
 	friend struct ForceIDRegeneration;
 	static Glib::Threads::Private<bool> _regenerate_xml_or_string_ids;
 	PBD::ID  _id;
 	gint     _stateful_frozen;
 
+	gint     _state_generation;
+	gint     _cached_generation;
+
 	static void set_regenerate_xml_and_string_ids_in_this_thread (bool yn);
 };
 
@@ -50,6 +50,16 @@ LIBPBD_API bool float_to_string (float val, std::string& str);
 
 LIBPBD_API bool double_to_string (double val, std::string& str);
 
+/**
+ * Format @a val as double_to_string does, into @a buf without allocating,
+ * e.g. for large numbers of values.
+ *
+ * @param len size of @a buf, at least 40
+ * @return number of characters written (excluding the terminating null),
+ * or 0 on failure
+ */
+LIBPBD_API size_t double_to_cstr (double val, char* buf, size_t len);
+
 LIBPBD_API bool string_to_bool (const std::string& str, bool& val);
 
 LIBPBD_API bool string_to_int16 (const std::string& str, int16_t& val);
@@ -194,6 +194,62 @@ private:
 	double   _vs;
 };
 
+/**
+ * TimingStats which also count the elapsed times in a histogram, to
+ * find percentiles and the worst cases of e.g. process cycles.
+ *
+ * The buckets are a quarter octave wide, from 1 usec to about 16 sec;
+ * longer times are counted in the last bucket. Counting is realtime-safe.
+ */
+class LIBPBD_API TimingHistogram : public TimingStats
+{
+public:
+	static const int n_buckets = 96;
+
+	TimingHistogram ()
+	{
+		reset ();
+	}
+
+	void update ()
+	{
+		TimingStats::update ();
+		add (elapsed ());
+	}
+
+	void reset ()
+	{
+		TimingStats::reset ();
+		for (int i = 0; i < n_buckets; ++i) {
+			_buckets[i] = 0;
+		}
+	}
+
+	/** count a time [usec] which was measured elsewhere, without the TimingStats */
+	void add (uint64_t usec)
+	{
+		++_buckets[bucket_index (usec)];
+	}
+
+	uint64_t count () const;
+
+	/** @return number of times counted in bucket @param i */
+	uint64_t bucket (int i) const { return _buckets[i]; }
+
+	/** @return the longest time [usec] counted in bucket @param i */
+	static uint64_t bucket_limit (int i);
+
+	static int bucket_index (uint64_t usec);
+
+	/** @return the time [usec] which @param p (0..1) of all times do not exceed,
+	 * rounded up to the limit of its bucket
+	 */
+	uint64_t percentile (double p) const;
+
+private:
+	uint64_t _buckets[n_buckets];
+};
+
 class LIBPBD_API TimingData
 {
 public:
@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _pbd_ws_deque_h_
+#define _pbd_ws_deque_h_
+
+#include <cassert>
+#include <glib.h>
+#include <stdint.h>
+
+namespace PBD {
+
+/** Lock free, bounded work-stealing deque
+ *
+ * A single owner thread pushes and pops at the bottom (LIFO), any number
+ * of other threads may steal from the top (FIFO).
+ *
+ * After Chase & Lev, "Dynamic Circular Work-Stealing Deque" (SPAA 2005)
+ * and Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013), but with a fixed-size buffer: it never allocates
+ * after reserve(), which must only be called while no other thread uses
+ * the deque.
+ *
+ * The owner must reset() the deque whenever it is known to be empty and
+ * unused by thieves, so that the indices do not wrap.
+ */
+template <typename T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+public:
+	WorkStealingDeque (size_t buffer_size = 8)
+		: _buffer (0)
+		, _buffer_mask (0)
+	{
+		reserve (buffer_size);
+	}
+
+	~WorkStealingDeque ()
+	{
+		delete[] _buffer;
+	}
+
+	void
+	reserve (size_t buffer_size)
+	{
+		size_t sz;
+		for (sz = 2; sz < buffer_size; sz <<= 1) ;
+		if (_buffer_mask >= sz - 1) {
+			return;
+		}
+		delete[] _buffer;
+		_buffer      = new T[sz];
+		_buffer_mask = sz - 1;
+		reset ();
+	}
+
+	void
+	reset ()
+	{
+		g_atomic_int_set (&_top, 0);
+		g_atomic_int_set (&_bottom, 0);
+	}
+
+	/** number of entries, only a hint when called by a thief */
+	size_t
+	size () const
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		return b > t ? b - t : 0;
+	}
+
+	/** owner only */
+	bool
+	push (T const& data)
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		if ((size_t)(b - t) > _buffer_mask) {
+			assert (0);
+			return false;
+		}
+		_buffer[b & _buffer_mask] = data;
+		/* publish (full barrier) */
+		g_atomic_int_set (&_bottom, b + 1);
+		return true;
+	}
+
+	/** owner only */
+	bool
+	pop (T& data)
+	{
+		gint b = g_atomic_int_get (&_bottom) - 1;
+		g_atomic_int_set (&_bottom, b);
+		/* the store above must be visible before we read top,
+		 * g_atomic_* are sequentially consistent. */
+		gint t = g_atomic_int_get (&_top);
+
+		if (t > b) {
+			/* empty */
+			g_atomic_int_set (&_bottom, b + 1);
+			return false;
+		}
+
+		data = _buffer[b & _buffer_mask];
+
+		if (t == b) {
+			/* last element, race against thieves */
+			bool const won = g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+			g_atomic_int_set (&_bottom, b + 1);
+			return won;
+		}
+
+		return true;
+	}
+
+	/** any thread but the owner */
+	bool
+	steal (T& data)
+	{
+		gint t = g_atomic_int_get (&_top);
+		gint b = g_atomic_int_get (&_bottom);
+
+		if (t >= b) {
+			return false;
+		}
+
+		data = _buffer[t & _buffer_mask];
+		return g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+	}
+
+private:
+	T*     _buffer;
+	size_t _buffer_mask;
+
+	/* keep the thieves' index away from the owner's */
+	volatile gint _top;
+	char          _pad[64 - sizeof (gint)];
+	volatile gint _bottom;
+};
+
+} /* end namespace */
+
+#endif
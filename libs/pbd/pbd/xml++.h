@@ -104,6 +104,7 @@ public:
 
 private:
 	bool read_internal(bool validate);
+	bool write_stream() const;
 
 	std::string _filename;
 	XMLNode*    _root;
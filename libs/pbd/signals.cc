@@ -22,6 +22,67 @@
 
 using namespace PBD;
 
+SignalBase::~SignalBase ()
+{
+	delete _emit_slots;
+}
+
+boost::shared_ptr<void const>
+SignalBase::emit_slots () const
+{
+	boost::shared_ptr<void const> rv;
+
+	/* Count the readers, so that replace_emit_slots() can wait until the
+	 * pointer it swapped out is no longer being copied, before it deletes it.
+	 */
+	g_atomic_int_inc (&_emit_readers);
+	boost::shared_ptr<void const>* p = (boost::shared_ptr<void const>*) g_atomic_pointer_get (&_emit_slots);
+	if (p) {
+		rv = *p;
+	}
+	g_atomic_int_dec_and_test (&_emit_readers);
+
+	return rv;
+}
+
+void
+SignalBase::set_emit_slots (boost::shared_ptr<void const> const& s)
+{
+	replace_emit_slots (new boost::shared_ptr<void const> (s));
+}
+
+void
+SignalBase::slots_changed ()
+{
+	/* in this order: an emission that sees the old generation
+	 * either uses the old copy, and will notice the change of
+	 * generation, or finds no copy and makes a new one.
+	 */
+	replace_emit_slots (0);
+	g_atomic_int_inc (&_generation);
+}
+
+void
+SignalBase::replace_emit_slots (boost::shared_ptr<void const>* p)
+{
+	boost::shared_ptr<void const>* old = _emit_slots;
+
+	if (!old && !p) {
+		return;
+	}
+
+	g_atomic_pointer_set (&_emit_slots, p);
+
+	/* Readers only hold the pointer while copying the shared_ptr. Emissions
+	 * that already have a copy keep the slots alive as long as they need them.
+	 */
+	while (g_atomic_int_get (&_emit_readers) > 0) {
+		g_thread_yield ();
+	}
+
+	delete old;
+}
+
 ScopedConnectionList::ScopedConnectionList()
 {
 }
@@ -55,6 +55,8 @@ Stateful::Stateful ()
 	, _instant_xml (0)
 	, _properties (new OwnedPropertyList)
 	, _stateful_frozen (0)
+	, _state_generation (1)
+	, _cached_generation (0)
 {
 }
 
@@ -287,6 +289,8 @@ Stateful::send_change (const PropertyChange& what_changed)
 		return;
 	}
 
+	state_changed ();
+
 	{
 		Glib::Threads::Mutex::Lock lm (_lock);
 		if (property_changes_suspended ()) {
@@ -394,6 +398,7 @@ Stateful::set_id (const XMLNode& node)
 	}
 
 	if (node.get_property ("id", _id)) {
+		state_changed ();
 		return true;
 	}
 
@@ -404,6 +409,7 @@ void
 Stateful::reset_id ()
 {
 	_id = ID ();
+	state_changed ();
 }
 
 void
@@ -415,9 +421,34 @@ Stateful::set_id (const string& str)
 		reset_id ();
 	} else {
 		_id = str;
+		state_changed ();
 	}
 }
 
+void
+Stateful::state_changed ()
+{
+	g_atomic_int_inc (&_state_generation);
+}
+
+bool
+Stateful::state_dirty () const
+{
+	return g_atomic_int_get (const_cast<gint*>(&_state_generation)) != g_atomic_int_get (const_cast<gint*>(&_cached_generation));
+}
+
+gint
+Stateful::state_generation () const
+{
+	return g_atomic_int_get (const_cast<gint*>(&_state_generation));
+}
+
+void
+Stateful::state_cached (gint generation)
+{
+	g_atomic_int_set (&_cached_generation, generation);
+}
+
 bool
 Stateful::regenerate_xml_or_string_ids () const
 {
@@ -23,7 +23,9 @@
 #endif
 #include <inttypes.h>
 #include <cerrno>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 #include <glib.h>
@@ -362,4 +364,45 @@ bool double_to_string (double val, std::string& str)
 	return false;
 }
 
+size_t
+double_to_cstr (double val, char* buf, size_t len)
+{
+	if (len < G_ASCII_DTOSTR_BUF_SIZE) {
+		return 0;
+	}
+
+	/* Integral values, e.g. positions in samples, are common and "%.17g"
+	 * prints them without a decimal point or exponent when they have at
+	 * most 17 digits. Skip the printf machinery for those (but not -0).
+	 */
+	if (fabs (val) < 1e15 && val == floor (val) && !(val == 0 && 1.0 / val < 0)) {
+		char tmp[20];
+		char* p = tmp + sizeof (tmp);
+		uint64_t u = (uint64_t) fabs (val);
+		do {
+			*--p = '0' + (u % 10);
+			u /= 10;
+		} while (u);
+		if (val < 0) {
+			*--p = '-';
+		}
+		size_t const n = tmp + sizeof (tmp) - p;
+		memcpy (buf, p, n);
+		buf[n] = '\0';
+		return n;
+	}
+
+	std::string str;
+	if (_infinity_to_string (val, str)) {
+		strcpy (buf, str.c_str ());
+		return str.size ();
+	}
+
+	if (g_ascii_dtostr (buf, len, val) == NULL) {
+		DEBUG_SCONVERT (string_compose ("double_to_cstr conversion failure for %1", val));
+		return 0;
+	}
+	return strlen (buf);
+}
+
 } // namespace PBD
@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Measure the cost of emitting a PBD::Signal.
+ *
+ *   signals-bench [-e emissions] [-s max-slots] [-t max-threads] [-c]
+ *
+ * For 1, 4, 16 .. max-slots connected slots, 1, 2, 4 .. max-threads threads
+ * emit the same signal concurrently. With -c, another thread keeps
+ * connecting and disconnecting a slot meanwhile. Output is one line per
+ * combination:
+ *   <slots> <threads> <nsec per emission> <nsec per emission and slot>
+ */
+
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/thread.h>
+#include <glibmm/threads.h>
+
+#include "pbd/signals.h"
+
+using namespace std;
+
+static PBD::Signal1<void, int> bench_signal;
+static uint32_t n_emissions = 100000;
+static gint     running = 0;
+static gint     stop_churn = 0;
+static gint64   elapsed = 0; // usec, over all emitting threads
+static Glib::Threads::Mutex elapsed_lock;
+
+static void
+slot (int)
+{
+}
+
+static void
+emit ()
+{
+	/* start all threads at about the same time */
+	g_atomic_int_inc (&running);
+	while (g_atomic_int_get (&running) > 0) {
+		g_thread_yield ();
+	}
+
+	gint64 const t0 = g_get_monotonic_time ();
+	for (uint32_t i = 0; i < n_emissions; ++i) {
+		bench_signal (i);
+	}
+	gint64 const t1 = g_get_monotonic_time ();
+
+	Glib::Threads::Mutex::Lock lm (elapsed_lock);
+	elapsed += t1 - t0;
+}
+
+static void
+churn ()
+{
+	while (!g_atomic_int_get (&stop_churn)) {
+		PBD::ScopedConnection c;
+		bench_signal.connect_same_thread (c, boost::bind (&slot, _1));
+	}
+}
+
+static void
+usage (char const* argv0)
+{
+	cerr << "Syntax: " << argv0 << " [-e emissions] [-s max-slots] [-t max-threads] [-c]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t max_slots   = 256;
+	uint32_t max_threads = 8;
+	bool     with_churn  = false;
+	int      c;
+
+	while ((c = getopt (argc, argv, "e:s:t:c")) != -1) {
+		switch (c) {
+			case 'e':
+				n_emissions = atoi (optarg);
+				break;
+			case 's':
+				max_slots = atoi (optarg);
+				break;
+			case 't':
+				max_threads = atoi (optarg);
+				break;
+			case 'c':
+				with_churn = true;
+				break;
+			default:
+				usage (argv[0]);
+		}
+	}
+
+	if (optind != argc || n_emissions < 1 || max_slots < 1 || max_threads < 1) {
+		usage (argv[0]);
+	}
+
+	if (!Glib::thread_supported ()) {
+		Glib::thread_init ();
+	}
+
+	cout << "# slots threads nsec-per-emission nsec-per-slot\n";
+
+	PBD::ScopedConnectionList connections;
+	uint32_t n_slots = 0;
+
+	for (uint32_t s = 1; s <= max_slots; s *= 4) {
+		for (; n_slots < s; ++n_slots) {
+			bench_signal.connect_same_thread (connections, boost::bind (&slot, _1));
+		}
+
+		for (uint32_t t = 1; t <= max_threads; t *= 2) {
+			vector<Glib::Threads::Thread*> threads;
+
+			elapsed = 0;
+			g_atomic_int_set (&running, 0);
+			g_atomic_int_set (&stop_churn, 0);
+
+			Glib::Threads::Thread* churner = 0;
+			if (with_churn) {
+				churner = Glib::Threads::Thread::create (sigc::ptr_fun (&churn));
+			}
+
+			for (uint32_t i = 0; i < t; ++i) {
+				threads.push_back (Glib::Threads::Thread::create (sigc::ptr_fun (&emit)));
+			}
+
+			while (g_atomic_int_get (&running) < (gint) t) {
+				g_thread_yield ();
+			}
+			g_atomic_int_set (&running, 0);
+
+			for (vector<Glib::Threads::Thread*>::iterator i = threads.begin (); i != threads.end (); ++i) {
+				(*i)->join ();
+			}
+
+			if (churner) {
+				g_atomic_int_set (&stop_churn, 1);
+				churner->join ();
+			}
+
+			double const nsec = 1000. * elapsed / ((double) n_emissions * t);
+			cout << s << " " << t << " " << nsec << " " << nsec / s << "\n";
+		}
+	}
+
+	return 0;
+}
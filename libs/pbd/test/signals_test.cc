@@ -1,4 +1,7 @@
+#include <vector>
+
 #include <glibmm/thread.h>
+#include <glibmm/threads.h>
 
 #include "signals_test.h"
 #include "pbd/signals.h"
@@ -89,3 +92,117 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+static PBD::ScopedConnection victim;
+
+static void
+disconnect_victim ()
+{
+	victim.disconnect ();
+}
+
+void
+SignalsTest::testDisconnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection c;
+
+	e->Fred.connect_same_thread (c, boost::bind (&disconnect_victim));
+	e->Fred.connect_same_thread (victim, boost::bind (&receiver));
+
+	N = 0;
+	e->emit ();
+	e->emit ();
+
+	/* the order of the slots is undefined, so receiver() may have been
+	 * called before it was disconnected, but never after.
+	 */
+	CPPUNIT_ASSERT (N <= 1);
+
+	delete e;
+}
+
+static Emitter* connect_emitter;
+static PBD::ScopedConnectionList late_connections;
+
+static void
+connect_receiver ()
+{
+	connect_emitter->Fred.connect_same_thread (late_connections, boost::bind (&receiver));
+}
+
+void
+SignalsTest::testConnectDuringEmission ()
+{
+	connect_emitter = new Emitter;
+	PBD::ScopedConnection c;
+	connect_emitter->Fred.connect_same_thread (c, boost::bind (&connect_receiver));
+
+	N = 0;
+	connect_emitter->emit ();
+	/* new connections are not called by the emission that made them */
+	CPPUNIT_ASSERT_EQUAL (0, N);
+
+	connect_emitter->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	late_connections.drop_connections ();
+	delete connect_emitter;
+}
+
+static gint emissions = 0;
+static gint received = 0;
+static gint stop_emitting = 0;
+
+static void
+count_reception ()
+{
+	g_atomic_int_inc (&received);
+}
+
+static void
+ignore_reception ()
+{
+}
+
+static void
+emit_until_stopped (Emitter* e)
+{
+	while (!g_atomic_int_get (&stop_emitting)) {
+		e->emit ();
+		g_atomic_int_inc (&emissions);
+	}
+}
+
+void
+SignalsTest::testConcurrentEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection c;
+	e->Fred.connect_same_thread (c, boost::bind (&count_reception));
+
+	g_atomic_int_set (&emissions, 0);
+	g_atomic_int_set (&received, 0);
+	g_atomic_int_set (&stop_emitting, 0);
+
+	std::vector<Glib::Threads::Thread*> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.push_back (Glib::Threads::Thread::create (sigc::bind (sigc::ptr_fun (&emit_until_stopped), e)));
+	}
+
+	/* change the slots while they are being used */
+	for (int i = 0; i < 10000; ++i) {
+		PBD::ScopedConnection d;
+		e->Fred.connect_same_thread (d, boost::bind (&ignore_reception));
+	}
+
+	g_atomic_int_set (&stop_emitting, 1);
+	for (std::vector<Glib::Threads::Thread*>::iterator t = threads.begin (); t != threads.end (); ++t) {
+		(*t)->join ();
+	}
+
+	/* the permanent connection was called once by every emission */
+	CPPUNIT_ASSERT_EQUAL (g_atomic_int_get (&emissions), g_atomic_int_get (&received));
+
+	delete e;
+}
@@ -563,6 +563,36 @@ StringConvertTest::test_double_conversion ()
 	test_function_for_locales(&_test_double_conversion);
 }
 
+static void
+_test_double_to_cstr ()
+{
+	const double values[] = {
+		0.0, -0.0, 1.0, -1.0, 0.5, 480000.0, -480000.0, 99999999999999.0, 999999999999999.0,
+		1e15, 1e17, 1e20, 0.1, 1.0 / 3.0, 0.70794578438413791, 2e-310,
+		numeric_limits<double>::max (), numeric_limits<double>::min (),
+		numeric_limits<double>::infinity (), -numeric_limits<double>::infinity ()
+	};
+
+	char buf[64];
+	string str;
+
+	// must be the same as double_to_string
+	for (size_t i = 0; i < sizeof (values) / sizeof (values[0]); ++i) {
+		CPPUNIT_ASSERT (double_to_string (values[i], str));
+		size_t const len = double_to_cstr (values[i], buf, sizeof (buf));
+		CPPUNIT_ASSERT_EQUAL (str.size (), len);
+		CPPUNIT_ASSERT_EQUAL (str, string (buf));
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((size_t)0, double_to_cstr (1.0, buf, 8));
+}
+
+void
+StringConvertTest::test_double_to_cstr ()
+{
+	test_function_for_locales(&_test_double_to_cstr);
+}
+
 // we have to use these as CPPUNIT_ASSERT_EQUAL won't accept char arrays
 static const std::string BOOL_TRUE_STR ("1");
 static const std::string BOOL_FALSE_STR ("0");
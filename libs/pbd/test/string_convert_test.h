@@ -13,6 +13,7 @@ class StringConvertTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (test_uint64_conversion);
 	CPPUNIT_TEST (test_float_conversion);
 	CPPUNIT_TEST (test_double_conversion);
+	CPPUNIT_TEST (test_double_to_cstr);
 	CPPUNIT_TEST (test_bool_conversion);
 	CPPUNIT_TEST (test_convert_thread_safety);
 	CPPUNIT_TEST_SUITE_END ();
@@ -27,6 +28,7 @@ public:
 	void test_uint64_conversion ();
 	void test_float_conversion ();
 	void test_double_conversion ();
+	void test_double_to_cstr ();
 	void test_bool_conversion ();
 	void test_convert_thread_safety ();
 };
@@ -0,0 +1,42 @@
+#include "timing_histogram_test.h"
+#include "pbd/timing.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TimingHistogramTest);
+
+using namespace PBD;
+
+void
+TimingHistogramTest::testBuckets ()
+{
+	/* every time falls into the bucket which it does not exceed the limit of */
+	for (uint64_t usec = 0; usec < 100000; ++usec) {
+		const int i = TimingHistogram::bucket_index (usec);
+		CPPUNIT_ASSERT (usec <= TimingHistogram::bucket_limit (i));
+		if (i > 0) {
+			CPPUNIT_ASSERT (usec > TimingHistogram::bucket_limit (i - 1));
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL (TimingHistogram::n_buckets - 1, TimingHistogram::bucket_index (std::numeric_limits<uint64_t>::max ()));
+}
+
+void
+TimingHistogramTest::testPercentile ()
+{
+	TimingHistogram h;
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, h.count ());
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, h.percentile (0.5));
+
+	for (uint64_t usec = 1; usec <= 1000; ++usec) {
+		h.add (usec);
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1000, h.count ());
+	/* 500 is counted in [448, 511], 1000 in [896, 1023] */
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 511, h.percentile (0.5));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1023, h.percentile (1.0));
+
+	h.reset ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, h.count ());
+}
@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TimingHistogramTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (TimingHistogramTest);
+	CPPUNIT_TEST (testBuckets);
+	CPPUNIT_TEST (testPercentile);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testBuckets ();
+	void testPercentile ();
+};
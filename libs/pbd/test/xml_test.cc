@@ -53,6 +53,43 @@ write_xml(const string& filename)
 	return true;
 }
 
+/* what XMLTree::write() used to do, build a libxml2 document and save that */
+void
+libxml_writenode (xmlDocPtr doc, XMLNode* n, xmlNodePtr p)
+{
+	xmlNodePtr node;
+
+	if (!p) {
+		node = doc->children = xmlNewDocNode (doc, 0, (const xmlChar*) n->name().c_str(), 0);
+	} else {
+		node = xmlNewChild (p, 0, (const xmlChar*) n->name().c_str(), 0);
+	}
+
+	if (n->is_content()) {
+		node->type = XML_TEXT_NODE;
+		xmlNodeSetContentLen (node, (const xmlChar*)n->content().c_str(), n->content().length());
+	}
+
+	for (XMLPropertyConstIterator i = n->properties().begin (); i != n->properties().end (); ++i) {
+		xmlSetProp (node, (const xmlChar*)(*i)->name ().c_str (), (const xmlChar*)(*i)->value ().c_str ());
+	}
+
+	for (XMLNodeConstIterator i = n->children().begin (); i != n->children().end (); ++i) {
+		libxml_writenode (doc, *i, node);
+	}
+}
+
+bool
+write_libxml (XMLNode* root, const string& filename)
+{
+	xmlKeepBlanksDefault(0);
+	xmlDocPtr doc = xmlNewDoc(xml_version);
+	libxml_writenode (doc, root, 0);
+	int result = xmlSaveFormatFileEnc(filename.c_str(), doc, "UTF-8", 1);
+	xmlFreeDoc(doc);
+	return result != -1;
+}
+
 }
 
 void
@@ -83,6 +120,47 @@ XMLTest::testXMLFilenameEncoding ()
 	}
 }
 
+void
+XMLTest::testWriteFormat ()
+{
+	// XMLTree::write() must produce exactly what libxml2 produced, to keep
+	// session files diff-able and unchanged when nothing changed
+	XMLTree tree;
+	XMLNode* root = tree.set_root (new XMLNode ("Session"));
+
+	root->set_property ("name", std::string ("a<b>&c\"d'e"));
+	root->set_property ("ws", std::string ("tab\tnl\ncr\r"));
+	root->set_property ("utf8", std::string ("\303\274n\303\257c\303\270d\303\251"));
+
+	root->add_child ("Empty");
+
+	XMLNode* events = root->add_child ("Events");
+	events->add_content ("0 1\n48000 0.5 <&>\r\n");
+
+	XMLNode* mixed = root->add_child ("Mixed");
+	mixed->add_content ("text");
+	mixed->add_child ("Element")->set_property ("id", std::string ("1"));
+	mixed->add_content (" tail");
+
+	// deeper than libxml's indentation limit
+	XMLNode* node = root;
+	for (int i = 0; i < 40; ++i) {
+		node = node->add_child ("Deep");
+		node->set_property ("level", i);
+	}
+
+	const string output_dir = test_output_directory ("XMLWriteFormat");
+	const string stream_path = Glib::build_filename (output_dir, "stream.xml");
+	const string libxml_path = Glib::build_filename (output_dir, "libxml.xml");
+
+	CPPUNIT_ASSERT (tree.write (stream_path));
+	CPPUNIT_ASSERT (write_libxml (root, libxml_path));
+
+	CPPUNIT_ASSERT_EQUAL (Glib::file_get_contents (libxml_path), Glib::file_get_contents (stream_path));
+
+	XMLTree read_doc (stream_path);
+	CPPUNIT_ASSERT_EQUAL (events->children().front()->content(), read_doc.root()->child ("Events")->children().front()->content());
+}
 
 static const char * const root_node_name = "Session";
 static const char * const child_node_name = "Child";
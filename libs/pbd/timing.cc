@@ -19,6 +19,8 @@
 
 #include "pbd/timing.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <limits>
 
@@ -63,4 +65,80 @@ timing_summary (const std::vector<uint64_t>& values)
 	return oss.str();
 }
 
+uint64_t
+TimingHistogram::count () const
+{
+	uint64_t n = 0;
+	for (int i = 0; i < n_buckets; ++i) {
+		n += _buckets[i];
+	}
+	return n;
+}
+
+int
+TimingHistogram::bucket_index (uint64_t usec)
+{
+	if (usec == 0) {
+		return 0;
+	}
+
+	int b = 0;
+	while ((usec >> b) > 1) {
+		++b;
+	}
+
+	/* the two bits below the most significant one give the quarter octave */
+	const int f = b >= 2 ? (usec >> (b - 2)) & 3 : (usec << (2 - b)) & 3;
+
+	return std::min (1 + 4 * b + f, n_buckets - 1);
+}
+
+uint64_t
+TimingHistogram::bucket_limit (int i)
+{
+	if (i <= 0) {
+		return 0;
+	}
+	if (i >= n_buckets - 1) {
+		return std::numeric_limits<uint64_t>::max ();
+	}
+
+	const int b = (i - 1) / 4;
+	const int f = (i - 1) % 4;
+
+	/* the bucket holds [(4 + f) / 4, (5 + f) / 4) * 2^b */
+	return (((uint64_t) (5 + f) << b) + 3) / 4 - 1;
+}
+
+uint64_t
+TimingHistogram::percentile (double p) const
+{
+	const uint64_t n = count ();
+
+	if (n == 0) {
+		return 0;
+	}
+
+	const uint64_t target = std::max<uint64_t> (1, (uint64_t) ceil (p * n));
+
+	uint64_t sum = 0;
+	int      i   = 0;
+
+	for (; i < n_buckets - 1; ++i) {
+		sum += _buckets[i];
+		if (sum >= target) {
+			break;
+		}
+	}
+
+	/* no need to round up beyond the worst case, if it is known */
+	uint64_t min, max;
+	double   avg, dev;
+
+	if (get_stats (min, max, avg, dev)) {
+		return std::min (bucket_limit (i), max);
+	}
+	return bucket_limit (i);
+}
+
 } // namespace PBD
@@ -5,8 +5,12 @@
  * Modified for Ardour and released under the same terms.
  */
 
+#include <algorithm>
 #include <iostream>
 
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
 #include "pbd/stacktrace.h"
 #include "pbd/xml++.h"
 
@@ -151,6 +155,10 @@ XMLTree::read_buffer(const string& buffer, bool to_tree_doc)
 bool
 XMLTree::write() const
 {
+	if (_compression == 0) {
+		return write_stream ();
+	}
+
 	xmlDocPtr doc;
 	XMLNodeList children;
 	int result;
@@ -183,6 +191,187 @@ XMLTree::write() const
 	return true;
 }
 
+namespace {
+
+/** Serializes an XMLNode tree to a file, producing the same output as
+ * xmlSaveFormatFileEnc (path, doc, "UTF-8", 1) for the equivalent xmlDoc,
+ * without building one.
+ */
+class XMLStreamWriter
+{
+public:
+	XMLStreamWriter (FILE* f) : _file (f), _ok (true)
+	{
+		_buf.reserve (buffer_size + 1024);
+	}
+
+	bool write_document (XMLNode const& root)
+	{
+		_buf += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		write_node (root, 0, true);
+		_buf += '\n';
+		flush ();
+		return _ok;
+	}
+
+private:
+	void write_node (XMLNode const& n, int level, bool format)
+	{
+		if (n.is_content ()) {
+			escape_content (n.content ());
+			return;
+		}
+
+		_buf += '<';
+		_buf += n.name ();
+
+		XMLPropertyList const& props = n.properties ();
+		for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+			_buf += ' ';
+			_buf += (*i)->name ();
+			_buf += "=\"";
+			escape_attribute ((*i)->value ());
+			_buf += '"';
+		}
+
+		XMLNodeList const& children = n.children ();
+
+		if (children.empty ()) {
+			_buf += "/>";
+			return;
+		}
+
+		_buf += '>';
+
+		/* like libxml, do not indent mixed content */
+		bool child_format = format;
+		for (XMLNodeConstIterator i = children.begin (); i != children.end () && child_format; ++i) {
+			if ((*i)->is_content ()) {
+				child_format = false;
+			}
+		}
+
+		if (child_format) {
+			_buf += '\n';
+		}
+
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			if (child_format) {
+				indent (level + 1);
+			}
+			write_node (**i, level + 1, child_format);
+			if (child_format) {
+				_buf += '\n';
+			}
+			if (_buf.size () > buffer_size) {
+				flush ();
+			}
+		}
+
+		if (child_format) {
+			indent (level);
+		}
+
+		_buf += "</";
+		_buf += n.name ();
+		_buf += '>';
+	}
+
+	void indent (int level)
+	{
+		/* libxml2 limits indentation to 60 characters */
+		_buf.append (2 * std::min (level, 30), ' ');
+	}
+
+	void escape_content (std::string const& s)
+	{
+		std::string::size_type last = 0;
+		for (std::string::size_type i = 0; i < s.size (); ++i) {
+			char const* e;
+			switch (s[i]) {
+				case '<':  e = "&lt;"; break;
+				case '>':  e = "&gt;"; break;
+				case '&':  e = "&amp;"; break;
+				case '\r': e = "&#13;"; break;
+				default: continue;
+			}
+			_buf.append (s, last, i - last);
+			_buf += e;
+			last = i + 1;
+		}
+		_buf.append (s, last, std::string::npos);
+	}
+
+	void escape_attribute (std::string const& s)
+	{
+		std::string::size_type last = 0;
+		for (std::string::size_type i = 0; i < s.size (); ++i) {
+			char const* e;
+			switch (s[i]) {
+				case '<':  e = "&lt;"; break;
+				case '>':  e = "&gt;"; break;
+				case '&':  e = "&amp;"; break;
+				case '"':  e = "&quot;"; break;
+				case '\n': e = "&#10;"; break;
+				case '\r': e = "&#13;"; break;
+				case '\t': e = "&#9;"; break;
+				default: continue;
+			}
+			_buf.append (s, last, i - last);
+			_buf += e;
+			last = i + 1;
+		}
+		_buf.append (s, last, std::string::npos);
+	}
+
+	void flush ()
+	{
+		if (_ok && !_buf.empty () && fwrite (_buf.data (), 1, _buf.size (), _file) != _buf.size ()) {
+			_ok = false;
+		}
+		_buf.clear ();
+	}
+
+	static const std::string::size_type buffer_size = 65536;
+
+	FILE*       _file;
+	std::string _buf;
+	bool        _ok;
+};
+
+} // anonymous namespace
+
+bool
+XMLTree::write_stream() const
+{
+	if (!_root) {
+		return false;
+	}
+
+	FILE* f = g_fopen (_filename.c_str(), "wb");
+	if (!f) {
+#ifndef NDEBUG
+		std::cerr << "XMLTree::write: cannot open '" << _filename << "' for writing." << std::endl;
+#endif
+		return false;
+	}
+
+	XMLStreamWriter writer (f);
+	bool ok = writer.write_document (*_root);
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+#ifndef NDEBUG
+	if (!ok) {
+		std::cerr << "XMLTree::write: error writing '" << _filename << "'." << std::endl;
+	}
+#endif
+
+	return ok;
+}
+
 void
 XMLTree::debug(FILE* out) const
 {
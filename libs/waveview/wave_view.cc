@@ -85,6 +85,7 @@ WaveView::WaveView (Canvas* c, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, _shape_independent (false)
 	, _logscaled_independent (false)
 	, _gradient_depth_independent (false)
+	, _rendered (false)
 	, _draw_image_in_gui_thread (false)
 	, _always_draw_image_in_gui_thread (false)
 {
@@ -98,6 +99,7 @@ WaveView::WaveView (Item* parent, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, _shape_independent (false)
 	, _logscaled_independent (false)
 	, _gradient_depth_independent (false)
+	, _rendered (false)
 	, _draw_image_in_gui_thread (false)
 	, _always_draw_image_in_gui_thread (false)
 {
@@ -126,6 +128,7 @@ WaveView::~WaveView ()
 	WaveViewThreads::deinitialize ();
 #endif
 
+	cancel_draw_requests ();
 	reset_cache_group ();
 }
 
@@ -242,6 +245,14 @@ WaveView::create_draw_request (WaveViewProperties const& props) const
 	return request;
 }
 
+WaveViewProperties
+WaveView::tile_properties (int64_t tile) const
+{
+	WaveViewProperties props = *_props;
+	props.set_tile (tile);
+	return props;
+}
+
 void
 WaveView::prepare_for_render (Rect const& area) const
 {
@@ -266,21 +277,65 @@ WaveView::prepare_for_render (Rect const& area) const
 	required_props.set_sample_positions_from_pixel_offsets (image_start_pixel_offset,
 	                                                        image_end_pixel_offset);
 
-	if (!required_props.is_valid ()) {
+	if (!required_props.is_valid () || required_props.get_length_samples () == 0) {
 		return;
 	}
 
-	if (_image) {
-		if (_image->props.is_equivalent (required_props)) {
+	int64_t const first_tile = required_props.tile_at (required_props.get_sample_start ());
+	int64_t const last_tile = required_props.tile_at (required_props.get_sample_end () - 1);
+
+	/* Also request the tiles up to half the visible width on either side,
+	 * after the visible ones, so that they are ready when scrolled into view.
+	 */
+	int64_t const margin = (last_tile - first_tile) / 2 + 1;
+	int64_t const first_prefetch_tile = max (first_tile - margin, required_props.tile_at (_props->region_start));
+	int64_t const last_prefetch_tile = min (last_tile + margin, required_props.tile_at (max (_props->region_start, _props->region_end - 1)));
+
+	// Forget the requests which were finished or scrolled out of view since
+	for (DrawRequests::iterator i = _requests.begin (); i != _requests.end ();) {
+		DrawRequests::iterator tmp = i++;
+		if (tmp->second->finished ()) {
+			_requests.erase (tmp);
+		} else if (tmp->first < first_prefetch_tile || tmp->first > last_prefetch_tile) {
+			cancel_draw_request (tmp);
+		}
+	}
+
+	for (int64_t tile = first_tile; tile <= last_tile; ++tile) {
+		request_tile (tile, true);
+	}
+
+	for (int64_t tile = first_prefetch_tile; tile <= last_prefetch_tile; ++tile) {
+		if (tile < first_tile || tile > last_tile) {
+			request_tile (tile, false);
+		}
+	}
+}
+
+void
+WaveView::request_tile (int64_t tile, bool visible) const
+{
+	WaveViewProperties const props = tile_properties (tile);
+
+	DrawRequests::iterator r = _requests.find (tile);
+
+	if (r != _requests.end ()) {
+		if (r->second->image->props.is_equivalent (props)) {
+			if (visible) {
+				WaveViewThreads::prioritize_draw_request (r->second);
+			}
 			return;
-		} else {
-			// Image does not contain sample area required
 		}
+		cancel_draw_request (r);
 	}
 
-	boost::shared_ptr<WaveViewDrawRequest> request = create_draw_request (required_props);
+	if (get_cache_group ()->lookup_image (props)) {
+		// The image may not be finished at this point but that is fine, great in
+		// fact as it means it should only need to be drawn once.
+		return;
+	}
 
-	queue_draw_request (request);
+	queue_draw_request (tile, props, visible);
 }
 
 bool
@@ -330,38 +385,43 @@ WaveView::get_item_and_draw_rect_in_window_coords (Rect const& canvas_rect, Rect
 }
 
 void
-WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& request) const
+WaveView::queue_draw_request (int64_t tile, WaveViewProperties const& props, bool visible) const
 {
 	// Don't enqueue any requests without a thread to dequeue them.
 	assert (WaveViewThreads::enabled());
 
-	if (!request || !request->is_valid()) {
+	boost::shared_ptr<WaveViewDrawRequest> request = create_draw_request (props);
+
+	if (!request->is_valid()) {
 		return;
 	}
 
-	if (current_request) {
-		current_request->cancel ();
-	}
+	_requests[tile] = request;
 
-	boost::shared_ptr<WaveViewImage> cached_image =
-	    get_cache_group ()->lookup_image (request->image->props);
+	// Add it to the cache so that other WaveViews can refer to the same image
+	get_cache_group()->add_image (request->image);
 
-	if (cached_image) {
-		// The image may not be finished at this point but that is fine, great in
-		// fact as it means it should only need to be drawn once.
-		request->image = cached_image;
-		current_request = request;
-	} else {
-		// now we can finally set an optimal image now that we are not using the
-		// properties for comparisons.
-		request->image->props.set_width_samples (optimal_image_width_samples ());
+	WaveViewThreads::enqueue_draw_request (request, visible);
+}
 
-		current_request = request;
+void
+WaveView::cancel_draw_request (DrawRequests::iterator r) const
+{
+	r->second->cancel ();
 
-		// Add it to the cache so that other WaveViews can refer to the same image
-		get_cache_group()->add_image (current_request->image);
+	if (!r->second->finished ()) {
+		// Nobody else should wait for an image which will never be finished
+		get_cache_group ()->remove_image (r->second->image);
+	}
 
-		WaveViewThreads::enqueue_draw_request (current_request);
+	_requests.erase (r);
+}
+
+void
+WaveView::cancel_draw_requests () const
+{
+	while (!_requests.empty ()) {
+		cancel_draw_request (_requests.begin ());
 	}
 }
 
@@ -847,80 +907,6 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 	context->fill ();
 }
 
-samplecnt_t
-WaveView::optimal_image_width_samples () const
-{
-	/* Compute how wide the image should be in samples.
-	 *
-	 * The resulting image should be wider than the canvas width so that the
-	 * image does not have to be redrawn each time the canvas offset changes, but
-	 * drawing too much unnecessarily, for instance when zooming into the canvas
-	 * the part of the image that is outside of the visible canvas area may never
-	 * be displayed and will just increase apparent render time and reduce
-	 * responsiveness in non-threaded rendering and cause "flashing" waveforms in
-	 * threaded rendering mode.
-	 *
-	 * Another thing to consider is that if there are a number of waveforms on
-	 * the canvas that are the width of the canvas then we don't want to have to
-	 * draw the images for them all at once as it will cause a spike in render
-	 * time, or in threaded rendering mode it will mean all the draw requests will
-	 * the queued during the same sample/expose event. This issue can be
-	 * alleviated by using an element of randomness in selecting the image width.
-	 *
-	 * If the value of samples per pixel is less than 1/10th of a second, use
-	 * 1/10th of a second instead.
-	 */
-
-	samplecnt_t canvas_width_samples = _canvas->visible_area().width() * _props->samples_per_pixel;
-	const samplecnt_t one_tenth_of_second = _region->session().sample_rate() / 10;
-
-	/* If zoomed in where a canvas item interects with the canvas area but
-	 * stretches for many pages either side, to avoid having draw all images when
-	 * the canvas scrolls by a page width the multiplier would have to be a
-	 * randomized amount centered around 3 times the visible canvas width, but
-	 * for other operations like zooming or even with a stationary playhead it is
-	 * a lot of extra drawing that can affect performance.
-	 *
-	 * So without making things too complicated with different widths for
-	 * different operations, try to use a width that is a balance and will work
-	 * well for scrolling(non-page width) so all the images aren't redrawn at the
-	 * same time but also faster for sequential zooming operations.
-	 *
-	 * Canvas items that don't intersect with the edges of the visible canvas
-	 * will of course only draw images that are the pixel width of the item.
-	 *
-	 * It is a perhaps a coincidence that these values are centered roughly
-	 * around the golden ratio but they did work well in my testing.
-	 */
-	const double min_multiplier = 1.4;
-	const double max_multiplier = 1.8;
-
-	/**
-	 * A combination of high resolution screens, high samplerates and high
-	 * zoom levels(1 sample per pixel) can cause 1/10 of a second(in
-	 * pixels) to exceed the cairo image size limit.
-	 */
-	const double cairo_image_limit = 32767.0;
-	const double max_image_width = cairo_image_limit / max_multiplier;
-
-	samplecnt_t max_width_samples = floor (max_image_width / _props->samples_per_pixel);
-
-	const samplecnt_t one_tenth_of_second_limited = std::min (one_tenth_of_second, max_width_samples);
-
-	samplecnt_t new_sample_count = std::max (canvas_width_samples, one_tenth_of_second_limited);
-
-	const double multiplier = g_random_double_range (min_multiplier, max_multiplier);
-
-	return new_sample_count * multiplier;
-}
-
-void
-WaveView::set_image (boost::shared_ptr<WaveViewImage> img) const
-{
-	get_cache_group ()->add_image (img);
-	_image = img;
-}
-
 void
 WaveView::process_draw_request (boost::shared_ptr<WaveViewDrawRequest> req)
 {
@@ -1035,141 +1021,123 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 
 	assert (required_props.is_valid());
 
-	boost::shared_ptr<WaveViewImage> image_to_draw;
+	int64_t const first_tile = required_props.tile_at (required_props.get_sample_start ());
+	int64_t const last_tile = required_props.tile_at (max (required_props.get_sample_start (), required_props.get_sample_end () - 1));
 
-	if (current_request) {
-		if (!current_request->image->props.is_equivalent (required_props)) {
-			// The WaveView properties may have been updated during recording between
-			// prepare_for_render and render calls and the new required props have
-			// different end sample value.
-			current_request->cancel ();
-			current_request.reset ();
-		} else if (current_request->finished ()) {
-			image_to_draw = current_request->image;
-			current_request.reset ();
-		}
-	} else {
-		// No current Request
-	}
+	bool missing = false;
 
-	if (!image_to_draw && _image) {
-		if (_image->props.is_equivalent (required_props)) {
-			// Image contains required properties
-			image_to_draw = _image;
-		} else {
-			// Image does not contain properties required
-		}
-	}
+	for (int64_t tile = first_tile; tile <= last_tile; ++tile) {
+
+		boost::shared_ptr<WaveViewImage> const image = get_tile_image (tile);
 
-	if (!image_to_draw) {
-		image_to_draw = get_cache_group ()->lookup_image (required_props);
-		if (image_to_draw && !image_to_draw->finished ()) {
-			// Found equivalent but unfinished Image in cache
-			image_to_draw.reset ();
+		if (!image) {
+			missing = true;
+			continue;
 		}
-	}
 
-	if (!image_to_draw) {
-		// No existing image to draw
+		/* compute the first pixel of the image in self coordinates */
 
-		boost::shared_ptr<WaveViewDrawRequest> const request = create_draw_request (required_props);
+		double image_origin_in_self_coordinates =
+		    (image->props.get_sample_start () - _props->region_start) / _props->samples_per_pixel;
 
-		if (draw_image_in_gui_thread ()) {
-			// now that we have to draw something, draw more than required.
-			request->image->props.set_width_samples (optimal_image_width_samples ());
+		/* round image origin position to an exact pixel in device space to
+		 * avoid blurring
+		 */
 
-			process_draw_request (request);
+		double x  = self.x0 + image_origin_in_self_coordinates;
+		double y  = self.y0;
+		context->user_to_device (x, y);
+		x = floor (x);
+		y = floor (y);
+		context->device_to_user (x, y);
 
-			image_to_draw = request->image;
+		/* only draw the part of the tile which is within the area to draw */
 
-		} else if (current_request) {
-			if (current_request->finished ()) {
-				// There is a chance the request is now finished since checking above
-				image_to_draw = current_request->image;
-				current_request.reset ();
-			} else if (_canvas->get_microseconds_since_render_start () < 15000) {
-				current_request->cancel ();
-				current_request.reset ();
+		double const draw_start_pixel = max (draw.x0, x);
+		double const draw_end_pixel = min (draw.x1, x + image->cairo_image->get_width ());
 
-				// Drawing image in GUI thread as we have time
+		if (draw_end_pixel <= draw_start_pixel) {
+			continue;
+		}
 
-				// now that we have to draw something, draw more than required.
-				request->image->props.set_width_samples (optimal_image_width_samples ());
+		context->rectangle (draw_start_pixel, draw.y0, draw_end_pixel - draw_start_pixel, draw.height());
 
-				process_draw_request (request);
+		/* the coordinates specify where in "user coordinates" (i.e. what we
+		 * generally call "canvas coordinates" in this code) the image origin
+		 * will appear. So specifying (10,10) will put the upper left corner of
+		 * the image at (10,10) in user space.
+		 */
 
-				image_to_draw = request->image;
-			} else {
-				// Waiting for current request to finish
-				redraw ();
-				return;
-			}
-		} else {
-			// Defer the rendering to another thread or perhaps render pass if
-			// a thread cannot generate it in time.
-			queue_draw_request (request);
-			redraw ();
-			return;
-		}
+		context->set_source (image->cairo_image, x, y);
+		context->fill ();
 	}
 
 	/* reset this so that future missing images can be generated in a worker thread. */
 	_draw_image_in_gui_thread = false;
+	_rendered = true;
 
-	assert (image_to_draw);
+	if (missing) {
+		// Defer the rendering to another thread or perhaps render pass if
+		// a thread cannot generate it in time.
+		redraw ();
+	}
+}
 
-	/* compute the first pixel of the image that should be used when we
-	 * render the specified range.
-	 */
+boost::shared_ptr<WaveViewImage>
+WaveView::get_tile_image (int64_t tile) const
+{
+	WaveViewProperties const props = tile_properties (tile);
 
-	double image_origin_in_self_coordinates =
-	    (image_to_draw->props.get_sample_start () - _props->region_start) / _props->samples_per_pixel;
+	DrawRequests::iterator r = _requests.find (tile);
 
-	/* the image may only be a best-effort ... it may not span the entire
-	 * range requested, though it is guaranteed to cover the start. So
-	 * determine how many pixels we can actually draw.
-	 */
+	if (r != _requests.end ()) {
+		if (!r->second->image->props.is_equivalent (props)) {
+			// The WaveView properties may have been updated during recording between
+			// prepare_for_render and render calls and the new required props have
+			// different end sample value.
+			cancel_draw_request (r);
+			r = _requests.end ();
+		} else if (r->second->finished ()) {
+			boost::shared_ptr<WaveViewImage> image = r->second->image;
+			_requests.erase (r);
+			return image;
+		}
+	}
 
-	const double draw_start_pixel = draw.x0;
-	const double draw_end_pixel = draw.x1;
+	boost::shared_ptr<WaveViewImage> cached_image = get_cache_group ()->lookup_image (props);
 
-	double draw_width_pixels = draw_end_pixel - draw_start_pixel;
+	if (cached_image && cached_image->finished ()) {
+		return cached_image;
+	}
 
-	if (image_to_draw != _image) {
+	if (draw_image_in_gui_thread () ||
+	    (r != _requests.end () && _canvas->get_microseconds_since_render_start () < 15000)) {
 
-		/* the image is guaranteed to start at or before
-		 * draw_start. But if it starts before draw_start, that reduces
-		 * the maximum available width we can render with.
-		 *
-		 * so .. clamp the draw width to the smaller of what we need to
-		 * draw or the available width of the image.
-		 */
-		draw_width_pixels = min ((double)image_to_draw->cairo_image->get_width (), draw_width_pixels);
+		// Drawing image in GUI thread as we have time
 
-		set_image (image_to_draw);
-	}
+		if (r != _requests.end ()) {
+			cancel_draw_request (r);
+		}
 
-	context->rectangle (draw_start_pixel, draw.y0, draw_width_pixels, draw.height());
+		boost::shared_ptr<WaveViewDrawRequest> const request = create_draw_request (props);
 
-	/* round image origin position to an exact pixel in device space to
-	 * avoid blurring
-	 */
+		process_draw_request (request);
 
-	double x  = self.x0 + image_origin_in_self_coordinates;
-	double y  = self.y0;
-	context->user_to_device (x, y);
-	x = floor (x);
-	y = floor (y);
-	context->device_to_user (x, y);
-
-	/* the coordinates specify where in "user coordinates" (i.e. what we
-	 * generally call "canvas coordinates" in this code) the image origin
-	 * will appear. So specifying (10,10) will put the upper left corner of
-	 * the image at (10,10) in user space.
-	 */
+		if (!request->finished ()) {
+			return boost::shared_ptr<WaveViewImage> ();
+		}
 
-	context->set_source (image_to_draw->cairo_image, x, y);
-	context->fill ();
+		get_cache_group ()->add_image (request->image);
+		return request->image;
+	}
+
+	if (r == _requests.end () && !cached_image) {
+		queue_draw_request (tile, props, true);
+	} else {
+		// Waiting for a request to finish
+	}
+
+	return boost::shared_ptr<WaveViewImage> ();
 }
 
 void
@@ -1203,6 +1171,7 @@ WaveView::set_channel (int channel)
 {
 	if (_props->channel != channel) {
 		begin_change ();
+		cancel_draw_requests ();
 		_props->channel = channel;
 		reset_cache_group ();
 		_bounding_box_dirty = true;
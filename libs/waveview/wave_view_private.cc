@@ -17,6 +17,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 #include "ardour/lmath.h"
 
@@ -58,7 +59,7 @@ WaveViewImage::WaveViewImage (boost::shared_ptr<const ARDOUR::AudioRegion> const
                               WaveViewProperties const& properties)
 	: region (region_ptr)
 	, props (properties)
-	, timestamp (0)
+	, cache_group (0)
 {
 
 }
@@ -70,8 +71,16 @@ WaveViewImage::~WaveViewImage ()
 
 /*-------------------------------------------------*/
 
-WaveViewCacheGroup::WaveViewCacheGroup (WaveViewCache& parent_cache)
+WaveViewCacheGroup::TileKey::TileKey (WaveViewProperties const& props)
+	: samples_per_pixel (props.samples_per_pixel)
+	, channel (props.channel)
+	, tile (props.tile_at (props.get_sample_start ()))
+{
+}
+
+WaveViewCacheGroup::WaveViewCacheGroup (WaveViewCache& parent_cache, boost::shared_ptr<ARDOUR::AudioSource> source)
 	: _parent_cache (parent_cache)
+	, _source (source)
 {
 
 }
@@ -89,73 +98,90 @@ WaveViewCacheGroup::add_image (boost::shared_ptr<WaveViewImage> image)
 		return;
 	}
 
-	ImageCache::iterator oldest_image_it = _cached_images.begin();
-	ImageCache::iterator second_oldest_image_it = _cached_images.end();
-
-	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		if ((*it) == image) {
-			// Must never be more than one instance of the image in the cache
-			(*it)->timestamp = g_get_monotonic_time ();
-			return;
-		} else if ((*it)->props.is_equivalent (image->props)) {
-			// Equivalent Image already in cache, updating timestamp
-			(*it)->timestamp = g_get_monotonic_time ();
-			return;
-		}
-
-		if ((*it)->timestamp < (*oldest_image_it)->timestamp) {
-			second_oldest_image_it = oldest_image_it;
-			oldest_image_it = it;
-		}
+	if (image->cache_group) {
+		// Must never be more than one instance of the image in the cache
+		assert (image->cache_group == this);
+		_parent_cache.touch (image.get ());
+		return;
 	}
 
-	// no duplicate or equivalent image so we are definitely adding it to cache
-	image->timestamp = g_get_monotonic_time ();
-
-	if (_parent_cache.full () || full ()) {
-		if (oldest_image_it != _cached_images.end()) {
-			// Replacing oldest Image in cache
-			_parent_cache.decrease_size ((*oldest_image_it)->size_in_bytes ());
-			*oldest_image_it = image;
-			_parent_cache.increase_size (image->size_in_bytes ());
+	ImageList& images (_cached_images[TileKey (image->props)]);
 
-			if (second_oldest_image_it != _cached_images.end ()) {
-				// Removing second oldest Image in cache
-				_parent_cache.decrease_size ((*second_oldest_image_it)->size_in_bytes ());
-				_cached_images.erase (second_oldest_image_it);
-			}
-			return;
+	for (ImageList::iterator it = images.begin (); it != images.end ();) {
+		if (image->props.is_equivalent ((*it)->props)) {
+			// Replacing an image which the new one makes redundant
+			_parent_cache.remove ((*it).get ());
+			it = images.erase (it);
 		} else {
-			/**
-			 * Add the image to the cache even if the threshold is exceeded so that
-			 * new WaveViews can still cache images with a full cache, the size of
-			 * the cache will quickly equalize back to the threshold as new images
-			 * are added and the size of the cache is reduced.
-			 */
+			++it;
 		}
 	}
 
-	_cached_images.push_back (image);
-	_parent_cache.increase_size (image->size_in_bytes ());
+	images.push_back (image);
+	image->cache_group = this;
+
+	/**
+	 * The image is added even if it alone exceeds the threshold so that
+	 * WaveViews can still share it, it is the first to go when the next
+	 * image is added.
+	 */
+	_parent_cache.add (image.get ());
 }
 
 boost::shared_ptr<WaveViewImage>
 WaveViewCacheGroup::lookup_image (WaveViewProperties const& props)
 {
-	for (ImageCache::iterator i = _cached_images.begin (); i != _cached_images.end (); ++i) {
+	ImageCache::iterator t = _cached_images.find (TileKey (props));
+
+	if (t == _cached_images.end ()) {
+		return boost::shared_ptr<WaveViewImage>();
+	}
+
+	for (ImageList::iterator i = t->second.begin (); i != t->second.end (); ++i) {
 		if ((*i)->props.is_equivalent (props)) {
+			_parent_cache.touch ((*i).get ());
 			return (*i);
 		}
 	}
 	return boost::shared_ptr<WaveViewImage>();
 }
 
+void
+WaveViewCacheGroup::remove_image (boost::shared_ptr<WaveViewImage> const& image)
+{
+	if (image && image->cache_group == this) {
+		erase (image.get ());
+	}
+}
+
+void
+WaveViewCacheGroup::erase (WaveViewImage* image)
+{
+	ImageCache::iterator t = _cached_images.find (TileKey (image->props));
+	assert (t != _cached_images.end ());
+
+	for (ImageList::iterator i = t->second.begin (); i != t->second.end (); ++i) {
+		if ((*i).get () == image) {
+			// the list may hold the last reference to the image
+			_parent_cache.remove (image);
+			t->second.erase (i);
+			break;
+		}
+	}
+
+	if (t->second.empty ()) {
+		_cached_images.erase (t);
+	}
+}
+
 void
 WaveViewCacheGroup::clear_cache ()
 {
 	// Tell the parent cache about the images we are about to drop references to
-	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		_parent_cache.decrease_size ((*it)->size_in_bytes ());
+	for (ImageCache::iterator t = _cached_images.begin (); t != _cached_images.end (); ++t) {
+		for (ImageList::iterator it = t->second.begin (); it != t->second.end (); ++it) {
+			_parent_cache.remove ((*it).get ());
+		}
 	}
 	_cached_images.clear ();
 }
@@ -181,16 +207,36 @@ WaveViewCache::get_instance ()
 }
 
 void
-WaveViewCache::increase_size (uint64_t bytes)
+WaveViewCache::add (WaveViewImage* image)
 {
-	image_cache_size += bytes;
+	image_cache_size += image->size_in_bytes ();
+	image->lru_position = _lru.insert (_lru.begin (), image);
+	evict (image);
 }
 
 void
-WaveViewCache::decrease_size (uint64_t bytes)
+WaveViewCache::remove (WaveViewImage* image)
 {
-	assert (image_cache_size - bytes < image_cache_size);
+	uint64_t const bytes = image->size_in_bytes ();
+	assert (image_cache_size - bytes < image_cache_size || bytes == 0);
 	image_cache_size -= bytes;
+	_lru.erase (image->lru_position);
+	image->cache_group = 0;
+}
+
+void
+WaveViewCache::touch (WaveViewImage* image)
+{
+	_lru.splice (_lru.begin (), _lru, image->lru_position);
+}
+
+void
+WaveViewCache::evict (WaveViewImage const* keep)
+{
+	while (full () && !_lru.empty () && _lru.back () != keep) {
+		WaveViewImage* image = _lru.back ();
+		image->cache_group->erase (image);
+	}
 }
 
 boost::shared_ptr<WaveViewCacheGroup>
@@ -203,7 +249,7 @@ WaveViewCache::get_cache_group (boost::shared_ptr<ARDOUR::AudioSource> source)
 		return it->second;
 	}
 
-	boost::shared_ptr<WaveViewCacheGroup> new_group (new WaveViewCacheGroup (*this));
+	boost::shared_ptr<WaveViewCacheGroup> new_group (new WaveViewCacheGroup (*this, source));
 
 	bool inserted = cache_group_map.insert (std::make_pair (source, new_group)).second;
 
@@ -219,14 +265,7 @@ WaveViewCache::reset_cache_group (boost::shared_ptr<WaveViewCacheGroup>& group)
 		return;
 	}
 
-	CacheGroups::iterator it = cache_group_map.begin();
-
-	while (it != cache_group_map.end()) {
-		if (it->second == group) {
-			break;
-		}
-		++it;
-	}
+	CacheGroups::iterator it = cache_group_map.find (group->_source);
 
 	assert (it != cache_group_map.end ());
 
@@ -249,6 +288,7 @@ void
 WaveViewCache::set_image_cache_threshold (uint64_t sz)
 {
 	_image_cache_threshold = sz;
+	evict (0);
 }
 
 /*-------------------------------------------------*/
@@ -264,14 +304,33 @@ WaveViewDrawRequest::~WaveViewDrawRequest ()
 }
 
 void
-WaveViewDrawRequestQueue::enqueue (boost::shared_ptr<WaveViewDrawRequest>& request)
+WaveViewDrawRequestQueue::enqueue (boost::shared_ptr<WaveViewDrawRequest>& request, bool visible)
 {
 	Glib::Threads::Mutex::Lock lm (_queue_mutex);
 
-	_queue.push_back (request);
+	if (visible) {
+		_queue.push_back (request);
+	} else {
+		_prefetch_queue.push_back (request);
+	}
 	_cond.broadcast ();
 }
 
+void
+WaveViewDrawRequestQueue::prioritize (boost::shared_ptr<WaveViewDrawRequest> const& request)
+{
+	Glib::Threads::Mutex::Lock lm (_queue_mutex);
+
+	DrawRequestQueueType::iterator i = std::find (_prefetch_queue.begin (), _prefetch_queue.end (), request);
+
+	if (i != _prefetch_queue.end ()) {
+		_prefetch_queue.erase (i);
+		_queue.push_back (request);
+	} else {
+		// already visible, or being processed
+	}
+}
+
 void
 WaveViewDrawRequestQueue::wake_up ()
 {
@@ -293,7 +352,7 @@ WaveViewDrawRequestQueue::dequeue (bool block)
 
 	// _queue_mutex is always held at this point
 
-	if (_queue.empty()) {
+	if (_queue.empty() && _prefetch_queue.empty()) {
 		if (block) {
 			_cond.wait (_queue_mutex);
 		} else {
@@ -307,6 +366,9 @@ WaveViewDrawRequestQueue::dequeue (bool block)
 	if (!_queue.empty()) {
 		req = _queue.front ();
 		_queue.pop_front ();
+	} else if (!_prefetch_queue.empty()) {
+		req = _prefetch_queue.front ();
+		_prefetch_queue.pop_front ();
 	} else {
 		// Queue empty, returning empty DrawRequest
 	}
@@ -354,10 +416,17 @@ WaveViewThreads::deinitialize ()
 }
 
 void
-WaveViewThreads::enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request)
+WaveViewThreads::enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request, bool visible)
+{
+	assert (instance);
+	instance->_request_queue.enqueue (request, visible);
+}
+
+void
+WaveViewThreads::prioritize_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& request)
 {
 	assert (instance);
-	instance->_request_queue.enqueue (request);
+	instance->_request_queue.prioritize (request);
 }
 
 boost::shared_ptr<WaveViewDrawRequest>
@@ -21,6 +21,8 @@
 #ifndef _WAVEVIEW_WAVE_VIEW_H_
 #define _WAVEVIEW_WAVE_VIEW_H_
 
+#include <map>
+
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -164,8 +166,6 @@ private:
 
 	boost::scoped_ptr<WaveViewProperties> _props;
 
-	mutable boost::shared_ptr<WaveViewImage> _image;
-
 	mutable boost::shared_ptr<WaveViewCacheGroup> _cache_group;
 
 	bool _shape_independent;
@@ -185,9 +185,11 @@ private:
 	ARDOUR::samplepos_t region_end () const;
 
 	/**
-	 * _image stays non-null after the first time it is set
+	 * true after the first time images were drawn
 	 */
-	bool rendered () const { return _image.get(); }
+	bool rendered () const { return _rendered; }
+
+	mutable bool _rendered;
 
 	bool draw_image_in_gui_thread () const;
 
@@ -204,7 +206,13 @@ private:
 
 	void init();
 
-	mutable boost::shared_ptr<WaveViewDrawRequest> current_request;
+	typedef std::map<int64_t, boost::shared_ptr<WaveViewDrawRequest> > DrawRequests;
+
+	/** Requests for the tiles of this WaveView, by tile, which may not be
+	 * finished yet. Their images are in the cache meanwhile so that other
+	 * WaveViews of the same source use them rather than queueing their own.
+	 */
+	mutable DrawRequests _requests;
 
 	PBD::ScopedConnectionList invalidation_connection;
 
@@ -237,9 +245,15 @@ private:
 	                        boost::shared_ptr<WaveViewDrawRequest>);
 	static void draw_absent_image (Cairo::RefPtr<Cairo::ImageSurface>&, ARDOUR::PeakData*, int);
 
-	ARDOUR::samplecnt_t optimal_image_width_samples () const;
+	WaveViewProperties tile_properties (int64_t tile) const;
+
+	/** @return the image of a tile if it is available, or can be drawn
+	 * in the GUI thread, otherwise queue a request for it and return null.
+	 */
+	boost::shared_ptr<WaveViewImage> get_tile_image (int64_t tile) const;
 
-	void set_image (boost::shared_ptr<WaveViewImage> img) const;
+	// queue a request for a tile unless it is pending or cached already
+	void request_tile (int64_t tile, bool visible) const;
 
 	// @return true if item area intersects with draw area
 	bool get_item_and_draw_rect_in_window_coords (ArdourCanvas::Rect const& canvas_rect,
@@ -248,7 +262,10 @@ private:
 
 	boost::shared_ptr<WaveViewDrawRequest> create_draw_request (WaveViewProperties const&) const;
 
-	void queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const&) const;
+	void queue_draw_request (int64_t tile, WaveViewProperties const&, bool visible) const;
+
+	void cancel_draw_request (DrawRequests::iterator) const;
+	void cancel_draw_requests () const;
 
 	static void process_draw_request (boost::shared_ptr<WaveViewDrawRequest>);
 
@@ -20,6 +20,8 @@
 #define _WAVEVIEW_WAVE_VIEW_PRIVATE_H_
 
 #include <deque>
+#include <list>
+#include <map>
 
 #include "waveview/wave_view.h"
 
@@ -64,6 +66,30 @@ private: // member variables
 
 public: // methods
 
+	/** Images are rendered in tiles of this many pixels, at positions
+	 * fixed in the source, so that scrolling only needs to render the
+	 * tiles which come into view and all WaveViews of a source at the
+	 * same scale share the same tiles.
+	 */
+	static const int tile_width = 256;
+
+	/* ceil, so that tile_at (tile_start (tile)) == tile */
+	samplepos_t tile_start (int64_t tile) const
+	{
+		return (samplepos_t) ceil (tile * tile_width * samples_per_pixel);
+	}
+
+	int64_t tile_at (samplepos_t sample) const
+	{
+		return (int64_t) floor (sample / (tile_width * samples_per_pixel));
+	}
+
+	/* the tile, within the region limits */
+	void set_tile (int64_t tile)
+	{
+		set_sample_offsets (tile_start (tile), tile_start (tile + 1));
+	}
+
 	bool is_valid () const
 	{
 		return (sample_end != 0 && samples_per_pixel != 0);
@@ -144,7 +170,7 @@ public: // methods
 		return sample_start + (get_length_samples() / 2);
 	}
 
-	bool is_equivalent (WaveViewProperties const& other)
+	bool is_equivalent (WaveViewProperties const& other) const
 	{
 		return (samples_per_pixel == other.samples_per_pixel &&
 		        contains (other.sample_start, other.sample_end) && channel == other.channel &&
@@ -157,12 +183,14 @@ public: // methods
 		// region_start && start_shift??
 	}
 
-	bool contains (samplepos_t start, samplepos_t end)
+	bool contains (samplepos_t start, samplepos_t end) const
 	{
 		return (sample_start <= start && end <= sample_end);
 	}
 };
 
+class WaveViewCacheGroup;
+
 struct WaveViewImage {
 public: // ctors
 	WaveViewImage (boost::shared_ptr<const ARDOUR::AudioRegion> const& region_ptr,
@@ -174,7 +202,10 @@ public: // member variables
 	boost::weak_ptr<const ARDOUR::AudioRegion> region;
 	WaveViewProperties props;
 	Cairo::RefPtr<Cairo::ImageSurface> cairo_image;
-	uint64_t timestamp;
+
+	/* where the image is in the WaveViewCache, only used by the cache */
+	WaveViewCacheGroup* cache_group;
+	std::list<WaveViewImage*>::iterator lru_position;
 
 public: // methods
 	bool finished() { return static_cast<bool>(cairo_image); }
@@ -221,24 +252,26 @@ class WaveViewCache;
 class WaveViewCacheGroup
 {
 public:
-	WaveViewCacheGroup (WaveViewCache& parent_cache);
+	WaveViewCacheGroup (WaveViewCache& parent_cache, boost::shared_ptr<ARDOUR::AudioSource>);
 
 	~WaveViewCacheGroup ();
 
 public:
 
-	// @return image with matching properties or null
+	// @return image with matching properties or null, which becomes the most recently used image
 	boost::shared_ptr<WaveViewImage> lookup_image (WaveViewProperties const&);
 
+	// Add an image, replacing the images it contains
 	void add_image (boost::shared_ptr<WaveViewImage>);
 
-	bool full () const { return _cached_images.size() > max_size(); }
-
-	static uint32_t max_size () { return 16; }
+	void remove_image (boost::shared_ptr<WaveViewImage> const&);
 
 	void clear_cache ();
 
 private:
+	friend class WaveViewCache;
+
+	void erase (WaveViewImage*);
 
 	/**
 	 * At time of writing we don't strictly need a reference to the parent cache
@@ -247,7 +280,33 @@ private:
 	 */
 	WaveViewCache& _parent_cache;
 
-	typedef std::list<boost::shared_ptr<WaveViewImage> > ImageCache;
+	// the key of this group in the parent cache
+	boost::shared_ptr<ARDOUR::AudioSource> _source;
+
+	/* A tile of a channel at a scale. Images of the same tile only
+	 * differ in their appearance, or in the region limits they were
+	 * clipped to.
+	 */
+	struct TileKey {
+		TileKey (WaveViewProperties const&);
+
+		bool operator< (TileKey const& other) const {
+			if (samples_per_pixel != other.samples_per_pixel) {
+				return samples_per_pixel < other.samples_per_pixel;
+			}
+			if (channel != other.channel) {
+				return channel < other.channel;
+			}
+			return tile < other.tile;
+		}
+
+		double   samples_per_pixel;
+		uint16_t channel;
+		int64_t  tile;
+	};
+
+	typedef std::list<boost::shared_ptr<WaveViewImage> > ImageList;
+	typedef std::map<TileKey, ImageList> ImageCache;
 	ImageCache _cached_images;
 };
 
@@ -275,14 +334,22 @@ private:
 
 	CacheGroups cache_group_map;
 
+	// all cached images, the most recently used first
+	typedef std::list<WaveViewImage*> LRUList;
+	LRUList _lru;
+
 	uint64_t image_cache_size;
 	uint64_t _image_cache_threshold;
 
 private:
 	friend class WaveViewCacheGroup;
 
-	void increase_size (uint64_t bytes);
-	void decrease_size (uint64_t bytes);
+	void add (WaveViewImage*);
+	void remove (WaveViewImage*);
+	void touch (WaveViewImage*);
+
+	// remove the least recently used images until the cache fits the threshold
+	void evict (WaveViewImage const* keep);
 
 	bool full () { return image_cache_size > _image_cache_threshold; }
 };
@@ -291,7 +358,14 @@ class WaveViewDrawRequestQueue
 {
 public:
 
-	void enqueue (boost::shared_ptr<WaveViewDrawRequest>&);
+	/**
+	 * Requests for images which are not visible yet (prefetch) are only
+	 * processed when there are no requests for visible images.
+	 */
+	void enqueue (boost::shared_ptr<WaveViewDrawRequest>&, bool visible = true);
+
+	// Process a queued prefetch request with the visible ones
+	void prioritize (boost::shared_ptr<WaveViewDrawRequest> const&);
 
 	// @return valid request or null if non-blocking or no request is available
 	boost::shared_ptr<WaveViewDrawRequest> dequeue (bool block);
@@ -305,6 +379,7 @@ private:
 
 	typedef std::deque<boost::shared_ptr<WaveViewDrawRequest> > DrawRequestQueueType;
 	DrawRequestQueueType _queue;
+	DrawRequestQueueType _prefetch_queue;
 };
 
 class WaveViewDrawingThread
@@ -334,7 +409,8 @@ public:
 
 	static bool enabled () { return (instance); }
 
-	static void enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>&);
+	static void enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>&, bool visible = true);
+	static void prioritize_draw_request (boost::shared_ptr<WaveViewDrawRequest> const&);
 
 private:
 	friend class WaveViewDrawingThread;
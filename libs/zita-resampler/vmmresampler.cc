@@ -0,0 +1,410 @@
+// ----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "zita-resampler/vmmresampler.h"
+
+using namespace ArdourZita;
+
+VMMResampler::VMMResampler (void)
+	: _table (0)
+	, _nchan (0)
+	, _buff  (0)
+	, _c1 (0)
+	, _c2 (0)
+	, _acc (0)
+{
+	reset ();
+}
+
+VMMResampler::~VMMResampler (void)
+{
+	clear ();
+}
+
+int
+VMMResampler::setup (unsigned int nchan, unsigned int hlen)
+{
+	if ((hlen < 8) || (hlen > 96)) return 1;
+	return setup (nchan, hlen, 1.0 - 2.6 / hlen);
+}
+
+int
+VMMResampler::setup (unsigned int nchan, unsigned int hlen, double frel)
+{
+	unsigned int       h, k, n;
+	double             s;
+	Resampler_table    *T = 0;
+
+	if (!nchan) return 1;
+	n = NPHASE;
+	s = n;
+	h = hlen;
+	k = 250;
+	T = Resampler_table::create (frel, h, n);
+	clear ();
+	if (T) {
+		_table = T;
+		_nchan = nchan;
+		_buff  = new float [nchan * (2 * h - 1 + k)];
+		_c1 = new float [2 * h];
+		_c2 = new float [2 * h];
+		_acc = new float [nchan];
+		inp_list = new float* [nchan];
+		out_list = new float* [nchan];
+		_inmax = k;
+		_pstep = s;
+		_qstep = s;
+		_wstep = 1;
+		return reset ();
+	}
+	else return 1;
+}
+
+void
+VMMResampler::clear (void)
+{
+	Resampler_table::destroy (_table);
+	delete[] _buff;
+	delete[] _c1;
+	delete[] _c2;
+	delete[] _acc;
+	delete[] inp_list;
+	delete[] out_list;
+	_buff  = 0;
+	_c1 = 0;
+	_c2 = 0;
+	_acc = 0;
+	_table = 0;
+	_nchan = 0;
+	_inmax = 0;
+	_pstep = 0;
+	_qstep = 0;
+	_wstep = 1;
+	reset ();
+}
+
+void
+VMMResampler::set_phase (double p)
+{
+	if (!_table) return;
+	_phase = (p - floor (p)) * _table->_np;
+}
+
+void
+VMMResampler::set_rrfilt (double t)
+{
+	if (!_table) return;
+	_wstep =  (t < 1) ? 1 : 1 - exp (-1 / t);
+}
+
+double
+VMMResampler::set_rratio (double r)
+{
+	if (!_table) return 0;
+	if (r > 16.0) r = 16.0;
+	if (r < 0.02) r = 0.02;
+
+	_qstep = _table->_np / r;
+
+	if (_qstep < 4.) {
+		_qstep = 4.;
+	}
+	if (_qstep > 2. * _table->_np * _table->_hl) {
+		_qstep = 2. * _table->_np * _table->_hl;
+	}
+	return _table->_np / _qstep;
+}
+
+double
+VMMResampler::inpdist (void) const
+{
+	if (!_table) return 0;
+	return (int)(_table->_hl + 1 - _nread) - _phase / _table->_np;
+}
+
+int
+VMMResampler::inpsize (void) const
+{
+	if (!_table) return 0;
+	return 2 * _table->_hl;
+}
+
+int
+VMMResampler::reset (void)
+{
+	inp_count = 0;
+	out_count = 0;
+
+	if (!_table) {
+		inp_list = 0;
+		out_list = 0;
+		return 1;
+	}
+
+	for (unsigned int c = 0; c < _nchan; c++) {
+		inp_list[c] = 0;
+		out_list[c] = 0;
+	}
+	_index = 0;
+	_phase = 0;
+	_nread = 2 * _table->_hl;
+
+	memset (_buff, 0, sizeof(float) * _nchan * (_nread + 249));
+	_nread -= _table->_hl - 1;
+	return 0;
+}
+
+void
+VMMResampler::reset_channel (unsigned int c)
+{
+	if (!_table || c >= _nchan) return;
+	for (unsigned int j = 0; j < 2 * _table->_hl - 1 + _inmax; j++) {
+		_buff[j * _nchan + c] = 0.f;
+	}
+}
+
+#ifdef __GNUC__
+/* eight channels, as many as fit into an AVX register */
+typedef float lanes_t __attribute__ ((vector_size (32)));
+#endif
+
+/* Accumulate the filter with coefficients _c1, _c2 over p1 and p2 into
+ * _acc, for the first na channels at once, eight of them per vector. */
+void
+VMMResampler::filter (const float *p1, const float *p2, unsigned int na)
+{
+	const int hl = _table->_hl;
+	const unsigned int nc = _nchan;
+	const float *c1 = _c1;
+	const float *c2 = _c2;
+	unsigned int c = 0;
+
+#ifdef __GNUC__
+	for (; c + 8 <= na; c += 8) {
+		lanes_t a = { 1e-25f, 1e-25f, 1e-25f, 1e-25f, 1e-25f, 1e-25f, 1e-25f, 1e-25f };
+		const float *q1 = p1 + c;
+		const float *q2 = p2 + c - nc;
+		for (int i = 0; i < hl; i++) {
+			lanes_t x1, x2;
+			memcpy (&x1, q1, sizeof (x1));
+			memcpy (&x2, q2, sizeof (x2));
+			a += x1 * c1[i] + x2 * c2[i];
+			q1 += nc;
+			q2 -= nc;
+		}
+		memcpy (_acc + c, &a, sizeof (a));
+	}
+#endif
+
+	for (; c < na; c++) {
+		float a = 1e-25f;
+		const float *q1 = p1 + c;
+		const float *q2 = p2 + c - nc;
+		for (int i = 0; i < hl; i++) {
+			a += *q1 * c1[i] + *q2 * c2[i];
+			q1 += nc;
+			q2 -= nc;
+		}
+		_acc[c] = a;
+	}
+}
+
+int
+VMMResampler::process (void)
+{
+	unsigned int   in, nr, n, c;
+	double         ph, dp;
+	float          *p1, *p2;
+
+	if (!_table) return 1;
+
+	const int hl = _table->_hl;
+	const unsigned int np = _table->_np;
+	const unsigned int nc = _nchan;
+	in = _index;
+	nr = _nread;
+	ph = _phase;
+	dp = _pstep;
+	n = 2 * hl - nr;
+
+	/* channels after the last one with a buffer are left alone, rounded
+	 * up to whole vectors of channels as those cost the same */
+	unsigned int na = nc;
+	while (na && !inp_list[na - 1] && !out_list[na - 1]) {
+		na--;
+	}
+	na = std::min (nc, (na + 7) & ~7u);
+
+	/* optimized full-cycle no-resampling, see VMResampler::process() */
+	if (dp == np && _qstep == np && nr == 1 && inp_count == out_count) {
+
+		if (out_count >= n) {
+			const unsigned int h1 = hl - 1;
+			const unsigned int head = out_count - h1;
+			const unsigned int tail = out_count - n;
+
+			for (c = 0; c < na; c++) {
+				float *out = out_list[c];
+				const float *inp = inp_list[c];
+				if (out) {
+					for (unsigned int j = 0; j < h1; j++) {
+						out[j] = _buff[(in + hl + j) * nc + c];
+					}
+					if (inp) {
+						memcpy (&out[h1], inp, head * sizeof (float));
+					} else {
+						memset (&out[h1], 0, head * sizeof (float));
+					}
+					out_list[c] += out_count;
+				}
+				for (unsigned int j = 0; j < n; j++) {
+					_buff[j * nc + c] = inp ? inp[tail + j] : 0.f;
+				}
+				if (inp) {
+					inp_list[c] += out_count;
+				}
+			}
+			_index = 0;
+			inp_count = 0;
+			out_count = 0;
+			return 0;
+		}
+
+		while (out_count) {
+			unsigned int to_proc = std::min (out_count, _inmax - in);
+			for (c = 0; c < na; c++) {
+				float *out = out_list[c];
+				float *inp = inp_list[c];
+				for (unsigned int j = 0; j < to_proc; j++) {
+					_buff[(in + n + j) * nc + c] = inp ? inp[j] : 0.f;
+				}
+				if (out) {
+					for (unsigned int j = 0; j < to_proc; j++) {
+						out[j] = _buff[(in + hl + j) * nc + c];
+					}
+					out_list[c] += to_proc;
+				}
+				if (inp) {
+					inp_list[c] += to_proc;
+				}
+			}
+			out_count -= to_proc;
+			in        += to_proc;
+			if (in >= _inmax) {
+				memcpy (_buff, _buff + in * nc, (2 * hl - 1) * nc * sizeof (float));
+				in = 0;
+			}
+		}
+		inp_count = out_count;
+		_index = in;
+		return 0;
+	}
+
+	/* samples read and written, the buffers are advanced at the end */
+	unsigned int ni = 0;
+	unsigned int no = 0;
+
+	p1 = _buff + in * nc;
+	p2 = p1 + n * nc;
+
+	while (out_count) {
+		if (nr) {
+			if (inp_count == 0) break;
+			for (c = 0; c < na; c++) {
+				const float *inp = inp_list[c];
+				p2[c] = inp ? inp[ni] : 0.f;
+			}
+			ni++;
+			nr--;
+			p2 += nc;
+			inp_count--;
+		} else {
+			if (dp == np) {
+				const float *q = p1 + hl * nc;
+				for (c = 0; c < na; c++) {
+					float *out = out_list[c];
+					if (out) {
+						out[no] = q[c];
+					}
+				}
+			} else {
+				const unsigned int k = (unsigned int) ph;
+				const float bb = (float)(ph - k);
+				const float aa = 1.0f - bb;
+				float const* cq1 = _table->_ctab + hl * k;
+				float const* cq2 = _table->_ctab + hl * (np - k);
+				for (int i = 0; i < hl; i++) {
+					_c1 [i] = aa * cq1 [i] + bb * cq1 [i + hl];
+					_c2 [i] = aa * cq2 [i] + bb * cq2 [i - hl];
+				}
+
+				filter (p1, p2, na);
+
+				for (c = 0; c < na; c++) {
+					float *out = out_list[c];
+					if (out) {
+						out[no] = _acc[c] - 1e-25f;
+					}
+				}
+			}
+			no++;
+			out_count--;
+
+			const double dd = _qstep - dp;
+			if (fabs (dd) < 1e-12) {
+				dp = _qstep;
+			} else {
+				dp += _wstep * dd;
+			}
+			ph += dp;
+
+			if (ph >= np) {
+				nr = (unsigned int) floor (ph / np);
+				ph -= nr * np;
+				in += nr;
+				p1 += nr * nc;
+				if (in >= _inmax) {
+					n = (2 * hl - nr);
+					memcpy (_buff, p1, n * nc * sizeof (float));
+					in = 0;
+					p1 = _buff;
+					p2 = p1 + n * nc;
+				}
+			}
+		}
+	}
+	for (c = 0; c < na; c++) {
+		if (inp_list[c]) {
+			inp_list[c] += ni;
+		}
+		if (out_list[c]) {
+			out_list[c] += no;
+		}
+	}
+	_index = in;
+	_nread = nr;
+	_phase = ph;
+	_pstep = dp;
+
+	return 0;
+}
@@ -50,6 +50,7 @@ private:
 	friend class Resampler;
 	friend class VResampler;
 	friend class VMResampler;
+	friend class VMMResampler;
 
 	Resampler_table     *_next;
 	unsigned int         _refc;
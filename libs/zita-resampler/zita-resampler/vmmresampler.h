@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef _ZITA_VMMRESAMPLER_H_
+#define _ZITA_VMMRESAMPLER_H_
+
+#include "zita-resampler/zresampler_visibility.h"
+#include "zita-resampler/resampler-table.h"
+
+namespace ArdourZita {
+
+/* VMResampler for many separate (non-interleaved) channels at the same
+ * ratio. The ratio, phase and filter are shared, and the channels are
+ * kept interleaved internally so that the filter runs over all of them
+ * at once.
+ *
+ * inp_list and out_list point to nchan() buffers each, which process()
+ * advances. A null input buffer is read as silence, the output for a
+ * null output buffer is discarded. Channels after the last one with
+ * a buffer are not processed; reset_channel() clears what one of them
+ * had before it is used again.
+ */
+class LIBZRESAMPLER_API VMMResampler
+{
+public:
+	VMMResampler (void);
+	~VMMResampler (void);
+
+	int  setup (unsigned int nchan, unsigned int hlen);
+	int  setup (unsigned int nchan, unsigned int hlen, double frel);
+
+	void   clear (void);
+	int    reset (void);
+	void   reset_channel (unsigned int c);
+	int    nchan (void) const { return _nchan; }
+	int    inpsize (void) const;
+	double inpdist (void) const;
+	int    process (void);
+
+	void   set_phase (double p);
+	void   set_rrfilt (double t);
+	double set_rratio (double r);
+
+	unsigned int         inp_count;
+	unsigned int         out_count;
+	float              **inp_list;
+	float              **out_list;
+
+private:
+	enum { NPHASE = 256 };
+
+	void filter (const float *p1, const float *p2, unsigned int na);
+
+	Resampler_table     *_table;
+	unsigned int         _nchan;
+	unsigned int         _inmax;
+	unsigned int         _index;
+	unsigned int         _nread;
+	double               _phase;
+	double               _pstep;
+	double               _qstep;
+	double               _wstep;
+	float               *_buff;
+	float               *_c1;
+	float               *_c2;
+	float               *_acc;
+};
+
+};
+
+#endif